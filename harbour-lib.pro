@@ -5,14 +5,18 @@ QT += dbus
 QT-= gui
 
 CONFIG += link_pkgconfig
-PKGCONFIG += libglibutil libqrencode
+PKGCONFIG += libglibutil libqrencode zlib
 
 VERSION = 1.0
 
+CONFIG += c++11
+
 greaterThan(QT_MAJOR_VERSION, 4) {
 QT += qml quick
 } else {
 QT += declarative
+# Qt4 qmake doesn't know about CONFIG += c++11
+QMAKE_CXXFLAGS += -std=c++11
 }
 
 QMAKE_CXXFLAGS += -Wno-unused-parameter -Wno-unused-result -Wno-psabi
@@ -22,13 +26,20 @@ CONFIG(debug, debug|release) {
 }
 
 SOURCES += \
+    src/HarbourAsyncValue.cpp \
     src/HarbourBase32.cpp \
     src/HarbourBase45.cpp \
+    src/HarbourBase45CborTask.cpp \
     src/HarbourBattery.cpp \
+    src/HarbourCbor.cpp \
     src/HarbourClipboard.cpp \
     src/HarbourColorEditorModel.cpp \
     src/HarbourDisplayBlanking.cpp \
     src/HarbourJson.cpp \
+    src/HarbourJsonJournal.cpp \
+    src/HarbourJsonLoadTask.cpp \
+    src/HarbourJsonSaver.cpp \
+    src/HarbourJsonStream.cpp \
     src/HarbourLib.cpp \
     src/HarbourMce.cpp \
     src/HarbourObject.cpp \
@@ -45,6 +56,7 @@ SOURCES += \
     src/HarbourSystemState.cpp \
     src/HarbourSystemTime.cpp \
     src/HarbourTask.cpp \
+    src/HarbourTaskScheduler.cpp \
     src/HarbourTemporaryFile.cpp \
     src/HarbourTransferMethodInfo.cpp \
     src/HarbourTransferMethodsModel.cpp \
@@ -58,20 +70,28 @@ SOURCES += \
 
 INCLUDEPATH += include
 PUBLIC_HEADERS += \
+    include/HarbourAsyncValue.h \
     include/HarbourBase32.h \
     include/HarbourBase45.h \
+    include/HarbourBase45CborTask.h \
     include/HarbourBattery.h \
+    include/HarbourCbor.h \
     include/HarbourClipboard.h \
     include/HarbourColorEditorModel.h \
     include/HarbourDebug.h \
     include/HarbourDisplayBlanking.h \
     include/HarbourJson.h \
+    include/HarbourJsonJournal.h \
+    include/HarbourJsonLoadTask.h \
+    include/HarbourJsonSaver.h \
+    include/HarbourJsonSchema.h \
     include/HarbourLib.h \
     include/HarbourObject.h \
     include/HarbourOrganizeListModel.h \
     include/HarbourParentSignalQueueObject.h \
     include/HarbourProcessState.h \
     include/HarbourProtoBuf.h \
+    include/HarbourProtoBufSchema.h \
     include/HarbourQrCodeGenerator.h \
     include/HarbourQrCodeImageProvider.h \
     include/HarbourSelectionListModel.h \
@@ -82,6 +102,7 @@ PUBLIC_HEADERS += \
     include/HarbourSystemState.h \
     include/HarbourSystemTime.h \
     include/HarbourTask.h \
+    include/HarbourTaskScheduler.h \
     include/HarbourTemporaryFile.h \
     include/HarbourTransferMethodInfo.h \
     include/HarbourTransferMethodsModel.h \
@@ -96,7 +117,8 @@ OTHER_FILES += qml/*.qml
 
 HEADERS += \
   $$PUBLIC_HEADERS \
-  src/HarbourMce.h
+  src/HarbourMce.h \
+  src/HarbourSimd.h
 
 OTHER_FILES += \
   LICENSE \
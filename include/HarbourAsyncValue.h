@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef HARBOUR_ASYNC_VALUE_H
+#define HARBOUR_ASYNC_VALUE_H
+
+#include "HarbourTask.h"
+
+#include <QtCore/QObject>
+
+class QThreadPool;
+
+//
+// Computes a value from its input on a worker thread, the latest input
+// wins. Changing the input while the previous computation is running
+// abandons that computation, its result never shows up. The result is
+// only replaced (and resultChanged emitted) if it's actually different.
+//
+// The delay (zero by default) postpones the computation until the input
+// stops changing for that many milliseconds. running is true from the
+// moment the input changes until the result arrives.
+//
+// By default, all instances share one pool, so they don't spawn any
+// threads of their own. The shared pool is created (and must be used)
+// on the main thread.
+//
+// The computation is a plain function, it runs on the copy of the input:
+//
+//   static QString compute(const QString& aInput) { ... }
+//
+//   HarbourAsyncValue<QString,QString>* value =
+//       new HarbourAsyncValue<QString,QString>(compute, this);
+//   connect(value, SIGNAL(resultChanged()), SLOT(onResultChanged()));
+//   value->setInput(text);
+//
+class HarbourAsyncValueBase :
+    public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int delay READ delay WRITE setDelay NOTIFY delayChanged)
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+
+public:
+    ~HarbourAsyncValueBase();
+
+    static QThreadPool* sharedThreadPool();
+    QThreadPool* threadPool() const;
+
+    int delay() const;
+    void setDelay(int);
+
+    bool running() const;
+
+Q_SIGNALS:
+    void delayChanged();
+    void runningChanged();
+    void resultChanged();
+
+protected:
+    HarbourAsyncValueBase(QThreadPool*, QObject*);
+
+    // Invoked by the derived class whenever the input changes
+    void update();
+
+    // Creates the task for the current input
+    virtual HarbourTask* createTask(QThreadPool*) = 0;
+    // Picks up the result, returns true if it has changed
+    virtual bool finishTask(HarbourTask*) = 0;
+
+private Q_SLOTS:
+    void onTimeout();
+    void onTaskDone();
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+template <typename I, typename R>
+class HarbourAsyncValue :
+    public HarbourAsyncValueBase
+{
+public:
+    typedef R (*Function)(const I&);
+
+private:
+    class Task :
+        public HarbourTask
+    {
+    public:
+        Task(QThreadPool* aPool, Function aFunction, const I& aInput) :
+            HarbourTask(aPool), iFunction(aFunction), iInput(aInput),
+            iResult() {}
+
+        void performTask() Q_DECL_OVERRIDE
+            { iResult = iFunction(iInput); }
+
+    public:
+        const Function iFunction;
+        const I iInput;
+        R iResult;
+    };
+
+public:
+    explicit HarbourAsyncValue(Function aFunction,
+        QObject* aParent = Q_NULLPTR, QThreadPool* aPool = Q_NULLPTR) :
+        HarbourAsyncValueBase(aPool, aParent), iFunction(aFunction),
+        iInput(), iResult() {}
+
+    const I& input() const
+        { return iInput; }
+    const R& result() const
+        { return iResult; }
+
+    void setInput(const I& aInput)
+        {
+            iInput = aInput;
+            update();
+        }
+
+protected:
+    HarbourTask* createTask(QThreadPool* aPool) Q_DECL_OVERRIDE
+        { return new Task(aPool, iFunction, iInput); }
+
+    bool finishTask(HarbourTask* aTask) Q_DECL_OVERRIDE
+        {
+            const Task* task = static_cast<Task*>(aTask);
+
+            if (iResult != task->iResult) {
+                iResult = task->iResult;
+                return true;
+            }
+            return false;
+        }
+
+private:
+    const Function iFunction;
+    I iInput;
+    R iResult;
+};
+
+#endif // HARBOUR_ASYNC_VALUE_H
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2019-2025 Slava Monich <slava@monich.com>
+ * Copyright (C) 2019-2026 Slava Monich <slava@monich.com>
  * Copyright (C) 2019-2022 Jolla Ltd.
  *
  * You may use this file under the terms of the BSD license as follows:
@@ -43,6 +43,8 @@
 #include <QString>
 #include <QByteArray>
 
+class QIODevice;
+
 class HarbourBase32
 {
     class Private;
@@ -56,10 +58,127 @@ public:
     };
     Q_DECLARE_FLAGS(EncodeOptions, EncodeOption)
 
+    // RFC 4648 is the default. Crockford and z-base-32 don't use padding,
+    // EncodeNoPadding and aRequirePadding have no effect on those. Unless
+    // EncodeLowerCase is set, the output is in the canonical case of the
+    // alphabet (which is lower case for z-base-32 and upper for others).
+    // Decoding is always case insensitive.
+    enum Alphabet {
+        AlphabetRfc4648,
+        AlphabetBase32Hex,      // RFC 4648 "Extended Hex" alphabet
+        AlphabetCrockford,      // I and L decode as 1, O as 0, '-' ignored
+        AlphabetZBase32
+    };
+
+    enum DecodeStatus {
+        DecodeOk,
+        DecodeEmpty,            // Nothing but whitespace
+        DecodeInvalidChar,
+        DecodeInvalidLength,    // Incomplete last group
+        DecodeNonZeroBits,      // Unused bits in the last group aren't zero
+        DecodeInvalidPadding,
+        DecodeMissingPadding,   // Only if the padding is required
+        DecodeBufferTooSmall
+    };
+
+    // Incremental encoder. Input can be fed in chunks of any size,
+    // incomplete 40-bit groups are carried over to the next call.
+    // Output is plain ASCII. finish() flushes the remaining bits
+    // (with padding unless EncodeNoPadding is set) and resets the
+    // encoder so that it can be reused.
+    class Encoder
+    {
+        Q_DISABLE_COPY(Encoder)
+        class Private;
+
+    public:
+        Encoder(EncodeOptions aOptions = EncodeDefault);
+        ~Encoder();
+
+        void encode(const void*, int, QByteArray*);
+        QByteArray encode(const QByteArray);
+        void finish(QByteArray*);
+        QByteArray finish();
+        void reset();
+
+        // Encodes everything that can be read from the input device,
+        // only keeps a fixed size buffer in memory. Sequential input
+        // (e.g. a socket) is read until waitForReadyRead() fails, i.e.
+        // the call blocks until the other side closes the connection.
+        bool encode(QIODevice*, QIODevice*);
+
+    private:
+        Private* iPrivate;
+    };
+
+    // Incremental decoder, the counterpart of Encoder. Accepts the same
+    // input as fromBase32(), except that complete 40-bit groups are
+    // written to the output as soon as they are available. Once
+    // something goes wrong, all calls fail until reset() or finish().
+    class Decoder
+    {
+        Q_DISABLE_COPY(Decoder)
+        class Private;
+
+    public:
+        Decoder(bool aRequirePadding = false);
+        ~Decoder();
+
+        bool decode(const char*, int, QByteArray*);
+        bool decode(const QByteArray, QByteArray*);
+        bool decode(const QString, QByteArray*);
+        bool finish(QByteArray*);
+        void reset();
+
+        // Reads the input the same way as Encoder does
+        bool decode(QIODevice*, QIODevice*);
+
+    private:
+        Private* iPrivate;
+    };
+
     static bool isValidBase32(const QString, bool aRequirePadding = false);
     static QString toBase32(const QByteArray, bool aLowerCase);
     static QString toBase32(const QByteArray, EncodeOptions aOptions = EncodeDefault);
     static QByteArray fromBase32(const QString, bool aRequirePadding = false);
+
+    // Same thing for 8-bit (Latin-1, ASCII or UTF-8) input, without
+    // converting it to UTF-16 first. The const char* variant without
+    // the length expects a NULL-terminated string.
+    static bool isValidBase32(const QByteArray, bool aRequirePadding = false);
+    static bool isValidBase32(const char*, bool aRequirePadding = false);
+    static bool isValidBase32(const char*, int, bool aRequirePadding = false);
+    static QByteArray fromBase32(const QByteArray, bool aRequirePadding = false);
+    static QByteArray fromBase32(const char*, bool aRequirePadding = false);
+    static QByteArray fromBase32(const char*, int, bool aRequirePadding = false);
+
+    // Validates and decodes the input in one pass, writing the output
+    // to the caller's buffer. On failure, the error position receives
+    // the offset of the offending character (or the input length if
+    // something is missing at the end) and the output size is zero.
+    // maxDecodedSize() bytes are always enough.
+    static int maxDecodedSize(int aLength);
+    static DecodeStatus decode(const QString, void* aBuf, int aBufSize,
+        int* aSize, int* aErrorPos = Q_NULLPTR, bool aRequirePadding = false);
+    static DecodeStatus decode(const QByteArray, void* aBuf, int aBufSize,
+        int* aSize, int* aErrorPos = Q_NULLPTR, bool aRequirePadding = false);
+    static DecodeStatus decode(const char*, int, void* aBuf, int aBufSize,
+        int* aSize, int* aErrorPos = Q_NULLPTR, bool aRequirePadding = false);
+
+    // Other alphabets
+    static bool isValidBase32(Alphabet, const QString, bool aRequirePadding = false);
+    static bool isValidBase32(Alphabet, const QByteArray, bool aRequirePadding = false);
+    static bool isValidBase32(Alphabet, const char*, bool aRequirePadding = false);
+    static QString toBase32(Alphabet, const QByteArray, EncodeOptions aOptions = EncodeDefault);
+    static QByteArray fromBase32(Alphabet, const QString, bool aRequirePadding = false);
+    static QByteArray fromBase32(Alphabet, const QByteArray, bool aRequirePadding = false);
+    static QByteArray fromBase32(Alphabet, const char*, bool aRequirePadding = false);
+    static DecodeStatus decode(Alphabet, const QString, void* aBuf,
+        int aBufSize, int* aSize, int* aErrorPos = Q_NULLPTR,
+        bool aRequirePadding = false);
+    static DecodeStatus decode(Alphabet, const char*, int, void* aBuf,
+        int aBufSize, int* aSize, int* aErrorPos = Q_NULLPTR,
+        bool aRequirePadding = false);
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(HarbourBase32::EncodeOptions)
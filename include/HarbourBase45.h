@@ -1,6 +1,6 @@
 /*
  * Copyright (C) 2021-2022 Jolla Ltd.
- * Copyright (C) 2021-2022 Slava Monich <slava.monich@jolla.com>
+ * Copyright (C) 2021-2026 Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -46,6 +46,33 @@ public:
     static bool isValidBase45(const QString);
     static QString toBase45(const QByteArray);
     static QByteArray fromBase45(const QString);
+
+    // Same thing for 8-bit (Latin-1, ASCII or UTF-8) input, without
+    // converting it to UTF-16 first. The const char* variant without
+    // the length expects a NULL-terminated string.
+    static bool isValidBase45(const QByteArray);
+    static bool isValidBase45(const char*);
+    static bool isValidBase45(const char*, int);
+    static QByteArray fromBase45(const QByteArray);
+    static QByteArray fromBase45(const char*);
+    static QByteArray fromBase45(const char*, int);
+
+    // Validates and decodes the input in one pass, writing the output
+    // to the caller's buffer. Returns the decoded size, or -1 if the
+    // input is invalid or the buffer is too small. On failure, the error
+    // position receives the offset of the first character of the group
+    // that failed to decode (or -1 if it's the buffer which is too small).
+    // decodedSize() returns the exact size of the output, or -1 if the
+    // length of the input can't possibly be valid.
+    static int decodedSize(int aLength);
+    static int decode(const QString, void* aBuf, int aBufSize,
+        int* aErrorPos = Q_NULLPTR);
+    static int decode(const QByteArray, void* aBuf, int aBufSize,
+        int* aErrorPos = Q_NULLPTR);
+    static int decode(const char*, int, void* aBuf, int aBufSize,
+        int* aErrorPos = Q_NULLPTR);
+    static int decode(const QChar*, int, void* aBuf, int aBufSize,
+        int* aErrorPos = Q_NULLPTR);
 };
 
 #endif // HARBOUR_BASE45_H
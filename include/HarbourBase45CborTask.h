@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef HARBOUR_BASE45_CBOR_TASK_H
+#define HARBOUR_BASE45_CBOR_TASK_H
+
+#include "HarbourTask.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include <gutil_types.h>
+
+//
+// Decodes Base45 text (e.g. the contents of a health certificate QR code,
+// without the "HC1:" prefix) into CBOR on a worker thread. Base45 is
+// decoded chunk by chunk into a small fixed buffer which is fed directly
+// to zlib, so the only thing that gets allocated is the resulting CBOR.
+// If the decoded data doesn't start with a zlib header, it's assumed to
+// be uncompressed CBOR. Either way, it must be a single CBOR data item
+// with nothing after it.
+//
+// The results are available after done() has been emitted. GUtilData
+// views returned by the COSE_Sign1 getters point into cbor() and remain
+// valid for as long as the task (or a copy of cbor()) is alive.
+//
+class HarbourBase45CborTask :
+    public HarbourTask
+{
+    Q_OBJECT
+
+public:
+    enum Error {
+        NoError,
+        Base45Error,
+        InflateError,
+        TooLargeError,
+        CborError,
+        CanceledError
+    };
+
+    enum { DEFAULT_MAX_SIZE = 0x100000 };
+
+    HarbourBase45CborTask(QThreadPool*, const QString aBase45,
+        int aMaxSize = DEFAULT_MAX_SIZE);
+    ~HarbourBase45CborTask();
+
+    Error error() const;
+    int errorPos() const;   // Position in Base45 text, for Base45Error
+    bool isCompressed() const;
+    const QByteArray cbor() const;
+
+    // RFC 9052, section 4.2. The protected header is the encoded map
+    // wrapped in a byte string, the unprotected one is the encoded map
+    // itself, the payload and the signature are byte string contents.
+    bool isCoseSign1() const;
+    GUtilData coseProtectedHeader() const;
+    GUtilData coseUnprotectedHeader() const;
+    GUtilData cosePayload() const;
+    GUtilData coseSignature() const;
+
+protected:
+    void performTask() Q_DECL_OVERRIDE;
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // HARBOUR_BASE45_CBOR_TASK_H
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef HARBOUR_CBOR_H
+#define HARBOUR_CBOR_H
+
+#include <QtGlobal>
+
+#include <gutil_types.h>
+
+// https://www.rfc-editor.org/rfc/rfc8949
+//
+// Parsing happens in place. Byte and text strings are returned as
+// GUtilData pointing into the input, nothing gets copied or allocated.
+// On success, the range is advanced past the parsed item, on failure
+// it's left untouched.
+
+class HarbourCbor
+{
+    class Private;
+    HarbourCbor() Q_DECL_EQ_DELETE;
+
+public:
+    enum {
+        TYPE_UINT = 0,
+        TYPE_NEGINT = 1,
+        TYPE_BYTES = 2,
+        TYPE_TEXT = 3,
+        TYPE_ARRAY = 4,
+        TYPE_MAP = 5,
+        TYPE_TAG = 6,
+        TYPE_SIMPLE = 7         // Including floats and break
+    };
+
+    enum {
+        SIMPLE_FALSE = 20,
+        SIMPLE_TRUE = 21,
+        SIMPLE_NULL = 22,
+        SIMPLE_UNDEFINED = 23
+    };
+
+    enum {
+        INFO_HALF = 25,
+        INFO_FLOAT = 26,
+        INFO_DOUBLE = 27,
+        INFO_INDEFINITE = 31
+    };
+
+    enum {
+        TAG_DATETIME = 0,
+        TAG_EPOCH_DATETIME = 1,
+        TAG_COSE_SIGN1 = 18,
+        TAG_ENCODED_CBOR = 24,
+        TAG_SELF_DESCRIBED = 55799
+    };
+
+    // Array and map size of indefinite-length items
+    enum { INDEFINITE = -1 };
+
+    // The initial byte and the argument of a data item. The value is
+    // the length for strings, arrays and maps (unless the item is
+    // indefinite), the tag number for tags, and for TYPE_SIMPLE either
+    // the simple value or the raw bits of a floating point number.
+    struct Head {
+        int type;
+        int info;
+        quint64 value;
+        bool indefinite;
+    };
+
+    static int peekType(const GUtilRange*); // -1 at the end of input
+    static bool parseHead(GUtilRange*, Head*);
+    static bool parseUInt(GUtilRange*, quint64*);
+    static bool parseInt(GUtilRange*, qint64*);
+    static bool parseBool(GUtilRange*, bool*);
+    static bool parseNull(GUtilRange*);
+    static bool parseFloat(GUtilRange*, double*);
+    static bool parseTag(GUtilRange*, quint64*);
+
+    // Definite-length strings only. Chunks of an indefinite-length
+    // string can be parsed one by one after parseHead(), up to the break.
+    static bool parseBytes(GUtilRange*, GUtilData*);
+    static bool parseText(GUtilRange*, GUtilData*);
+
+    // The number of items (or key-value pairs) that follow, or INDEFINITE
+    // meaning that items follow until the break.
+    static bool parseArray(GUtilRange*, qint64*);
+    static bool parseMap(GUtilRange*, qint64*);
+    static bool parseBreak(GUtilRange*);
+
+    // Skips (or returns the encoding of) a complete data item, including
+    // everything nested inside it. The nesting depth is limited.
+    static bool skipItem(GUtilRange*);
+    static bool parseItem(GUtilRange*, GUtilData*);
+};
+
+#endif // HARBOUR_CBOR_H
@@ -1,6 +1,6 @@
 /*
  * Copyright (C) 2015-2020 Jolla Ltd.
- * Copyright (C) 2015-2020 Slava Monich <slava@monich.com>
+ * Copyright (C) 2015-2026 Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -38,12 +38,168 @@
 #ifndef HARBOUR_JSON_H
 #define HARBOUR_JSON_H
 
+#include <QByteArray>
 #include <QString>
 #include <QVariant>
 
 namespace HarbourJson {
+    enum SaveOption {
+        SaveDefault = 0x00,
+        SaveCompact = 0x01,     // No indentation (Qt5)
+        SaveAtomic = 0x02,      // Write a temporary file and rename it
+        SaveIfChanged = 0x04,   // Don't rewrite the file with the same data
+        SaveSidecar = 0x08      // Binary copy for faster loading (Qt5)
+    };
+    Q_DECLARE_FLAGS(SaveOptions, SaveOption)
+
     bool save(const QString& aPath, const QVariantMap& aMap);
+    bool save(const QString& aPath, const QVariantMap& aMap, SaveOptions);
+
+    // Writes JSON which has already been serialized. SaveCompact and
+    // SaveSidecar don't apply.
+    bool saveData(const QString& aPath, const QByteArray& aJson,
+        SaveOptions aOptions = SaveDefault);
+
+    // Uses the sidecar if there's one matching the file
     bool load(const QString& aPath, QVariantMap& aRoot);
+
+    // Building blocks for asynchronous loading. loadSidecar() fails if
+    // the sidecar is missing or stale, parse() fails if the root is not
+    // an object. Unlike load(), parse() accepts an empty object.
+    bool loadSidecar(const QString& aPath, QVariantMap& aRoot);
+    bool parse(const QByteArray& aJson, QVariantMap& aRoot,
+        QString* aError = Q_NULLPTR);
+
+    class Reader;
+    class Writer;
 }
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(HarbourJson::SaveOptions)
+
+// Pull parser for UTF-8 JSON. Parsing happens in place, without building
+// a document. next() returns tokens one by one, in the order they appear
+// in the input. Names and strings remain in the input until string() or
+// utf8() unescapes and copies them, tokenData() and tokenSize() give
+// the raw (possibly escaped) contents without the quotes.
+class HarbourJson::Reader
+{
+    Q_DISABLE_COPY(Reader)
+
+public:
+    enum Token {
+        TOKEN_ERROR = -1,
+        TOKEN_END,              // The end of the document
+        TOKEN_BEGIN_OBJECT,
+        TOKEN_END_OBJECT,
+        TOKEN_BEGIN_ARRAY,
+        TOKEN_END_ARRAY,
+        TOKEN_NAME,
+        TOKEN_STRING,
+        TOKEN_NUMBER,
+        TOKEN_TRUE,
+        TOKEN_FALSE,
+        TOKEN_NULL
+    };
+
+    enum { MAX_DEPTH = 1024 };
+
+    Reader(const QByteArray);   // Keeps a reference to the data
+    Reader(const char*, int);   // The data must stay alive
+
+    Token next();
+    Token token() const;
+    int position() const;       // Offset of the token (or the error)
+    int depth() const;          // Number of open objects and arrays
+
+    // The current token
+    const char* tokenData() const;
+    int tokenSize() const;
+    bool isEscaped() const;
+    bool equals(const char* aLatin1) const;  // TOKEN_NAME or TOKEN_STRING
+    QString string() const;
+    QByteArray utf8() const;
+    double number() const;
+    qint64 integer() const;     // Truncates fractions
+    bool integer(qint64*) const; // Fails unless integral and in range
+
+    // Skips the current value, including everything nested inside it
+    bool skipValue();
+
+private:
+    enum Expect {
+        EXPECT_VALUE,
+        EXPECT_NAME_OR_END,
+        EXPECT_VALUE_OR_END,
+        EXPECT_COMMA_OR_END,
+        EXPECT_NOTHING
+    };
+
+    void skipSpaces();
+    void valueDone();
+    Token parseValue();
+    Token parseString(Token);
+    Token parseNumber();
+    Token parseLiteral(const char*, int, Token);
+    Token parseClose(char);
+    Token error(const char*);
+
+private:
+    const QByteArray iData;
+    const char* iStart;
+    const char* iEnd;
+    const char* iPtr;
+    const char* iTokenPtr;
+    int iTokenSize;
+    Token iToken;
+    Expect iExpect;
+    bool iEscaped;
+    bool iInteger;
+    QByteArray iStack;      // '{' and '['
+};
+
+// Serializes JSON into UTF-8, compact or indented. Commas and colons
+// are inserted automatically, the caller is only expected to keep the
+// objects and arrays balanced and to give each object member a name.
+class HarbourJson::Writer
+{
+    Q_DISABLE_COPY(Writer)
+
+public:
+    Writer(bool aIndent = false);
+
+    void clear();
+    QByteArray data() const;
+    int depth() const;
+
+    Writer& beginObject();
+    Writer& endObject();
+    Writer& beginArray();
+    Writer& endArray();
+    Writer& name(const char* aLatin1);
+    Writer& name(const char* aLatin1, int aLength);
+    Writer& name(const QString&);
+    Writer& value(const QString&);
+    Writer& value(const char* aUtf8);
+    Writer& value(bool);
+    Writer& value(int);
+    Writer& value(uint);
+    Writer& value(qint64);
+    Writer& value(quint64);
+    Writer& value(double);
+    Writer& value(const QVariant&);   // Maps, lists and scalars
+    Writer& null();
+
+private:
+    void separate();
+    void newLine();
+    void appendString(const char*, int);
+
+private:
+    QByteArray iBuf;
+    int iDepth;
+    bool iIndent;
+    bool iNeedComma;
+    bool iAfterName;
+};
+
 #endif // HARBOUR_JSON_H
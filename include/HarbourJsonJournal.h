@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef HARBOUR_JSON_JOURNAL_H
+#define HARBOUR_JSON_JOURNAL_H
+
+#include "HarbourJson.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariantMap>
+
+//
+// QVariantMap persisted as a snapshot plus an append-only journal.
+//
+// The snapshot is a regular HarbourJson file. Each change is appended
+// to <path>.journal as a single line JSON Patch (RFC 6902) operation,
+// "add" or "remove", so the cost of a change is proportional to its
+// size rather than to the size of the whole thing. load() reads the
+// snapshot and replays the journal over it. Keys are given as lists
+// of nested map keys, lists are treated as values.
+//
+// When the journal grows beyond compactRatio times the snapshot, a new
+// snapshot is written by a worker thread. Changes made in the meantime
+// go to a new journal, the old one is deleted after the new snapshot
+// has been written. Replay tolerates changes which have already been
+// applied and drops a partially written last record.
+//
+// Records are flushed to the OS but not fsync'ed, syncing each change
+// would defeat the purpose. So an application crash loses at most the
+// change being written, a power loss may lose whatever the kernel has
+// not written back yet (the snapshot itself is written atomically).
+//
+class HarbourJsonJournal :
+    public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(qreal compactRatio READ compactRatio WRITE setCompactRatio NOTIFY compactRatioChanged)
+    Q_PROPERTY(bool busy READ busy NOTIFY busyChanged)
+
+public:
+    enum { MIN_COMPACT_SIZE = 0x1000 }; // Don't bother compacting less
+
+    explicit HarbourJsonJournal(const QString& aPath,
+        QObject* aParent = Q_NULLPTR);
+    ~HarbourJsonJournal();
+
+    QString path() const;
+    QString journalPath() const;
+
+    qreal compactRatio() const;
+    void setCompactRatio(qreal);
+
+    bool busy() const;
+
+    bool load();
+    QVariantMap data() const;
+    QVariant value(const QStringList& aKeys) const;
+    bool setValue(const QStringList& aKeys, const QVariant& aValue);
+    bool remove(const QStringList& aKeys);
+
+    inline QVariant value(const QString& aKey) const
+        { return value(QStringList(aKey)); }
+    inline bool setValue(const QString& aKey, const QVariant& aValue)
+        { return setValue(QStringList(aKey), aValue); }
+    inline bool remove(const QString& aKey)
+        { return remove(QStringList(aKey)); }
+
+    void compact();
+    void flush();
+
+Q_SIGNALS:
+    void compactRatioChanged();
+    void busyChanged();
+    void compacted(bool aSuccess);
+
+private:
+    class Task;
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // HARBOUR_JSON_JOURNAL_H
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef HARBOUR_JSON_LOAD_TASK_H
+#define HARBOUR_JSON_LOAD_TASK_H
+
+#include "HarbourTask.h"
+
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+//
+// Does what HarbourJson::load() does, on a worker thread. The sidecar
+// is used if it's up to date, otherwise the file is read in chunks and
+// parsed. The task gives up between the steps if it gets canceled.
+// Unlike load(), it treats a file containing an empty object as valid.
+// There's no progress reporting, done() is the only signal emitted.
+//
+// The results are available after done() has been emitted:
+//
+//   iLoadTask = new HarbourJsonLoadTask(pool, path);
+//   iLoadTask->submit(this, SLOT(onLoadTaskDone()));
+//   ...
+//   void Foo::onLoadTaskDone()
+//   {
+//       if (iLoadTask->error() == HarbourJsonLoadTask::NoError) {
+//           ... iLoadTask->data() ...
+//       }
+//       iLoadTask->release();
+//       iLoadTask = Q_NULLPTR;
+//   }
+//
+class HarbourJsonLoadTask :
+    public HarbourTask
+{
+    Q_OBJECT
+
+public:
+    enum Error {
+        NoError,
+        FileError,
+        ParseError,
+        CanceledError   // Including the case when it didn't even start
+    };
+
+    enum { CHUNK_SIZE = 0x10000 };
+
+    HarbourJsonLoadTask(QThreadPool*, const QString aPath);
+    ~HarbourJsonLoadTask();
+
+    QString path() const;
+    Error error() const;
+    QString errorString() const;
+    QVariantMap data() const;
+
+protected:
+    void performTask() Q_DECL_OVERRIDE;
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // HARBOUR_JSON_LOAD_TASK_H
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef HARBOUR_JSON_SAVER_H
+#define HARBOUR_JSON_SAVER_H
+
+#include "HarbourJson.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+//
+// Asynchronous HarbourJson::save()
+//
+// save() takes a snapshot of the map and returns immediately. Repeated
+// saves to the same path within the delay window are coalesced, only the
+// last snapshot gets written. Serialization and writing happen on a worker
+// thread, one file at a time. The result of each write is reported by
+// the saved() signal.
+//
+// flush() writes everything that's still pending and waits until it's
+// done. It should be called on aboutToQuit, the destructor does that too.
+//
+class HarbourJsonSaver :
+    public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int delay READ delay WRITE setDelay NOTIFY delayChanged)
+    Q_PROPERTY(bool busy READ busy NOTIFY busyChanged)
+
+public:
+    enum { DEFAULT_DELAY = 500 }; // milliseconds
+
+    explicit HarbourJsonSaver(QObject* aParent = Q_NULLPTR);
+    ~HarbourJsonSaver();
+
+    int delay() const;
+    void setDelay(int);
+
+    HarbourJson::SaveOptions saveOptions() const;
+    void setSaveOptions(HarbourJson::SaveOptions);
+
+    bool busy() const;
+
+    void save(const QString& aPath, const QVariantMap& aMap);
+    void flush();
+
+Q_SIGNALS:
+    void delayChanged();
+    void busyChanged();
+    void saved(QString aPath, bool aSuccess);
+
+private:
+    class Task;
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // HARBOUR_JSON_SAVER_H
@@ -0,0 +1,465 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef HARBOUR_JSON_SCHEMA_H
+#define HARBOUR_JSON_SCHEMA_H
+
+#include "HarbourJson.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QVector>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <string.h>
+
+//
+// Binds JSON objects to plain structs at compile time, without going
+// through QJsonDocument or QVariantMap. An object is described by a list
+// of fields, each field being a (kind, member) pair. The JSON name is the
+// name of the member unless specified otherwise:
+//
+//   struct Window { int width; int height; QString title; QList<int> tabs; };
+//   typedef HarbourJsonSchema::Object<Window,
+//       HARBOUR_JSON_FIELD(Int, Window, width),
+//       HARBOUR_JSON_FIELD(Int, Window, height),
+//       HARBOUR_JSON_NAMED_FIELD("window-title", String, Window, title),
+//       HARBOUR_JSON_LIST(Int, Window, tabs)> WindowSchema;
+//
+//   Window w = {};
+//   if (WindowSchema::load(path, &w)) ...
+//   WindowSchema::save(path, w, HarbourJson::SaveAtomic);
+//
+// Kinds are Int (any integer or enum type), Double (double or float), Bool,
+// String (QString) and Nested<Schema> for nested objects. Lists (QList
+// or QVector of those) are declared with HARBOUR_JSON_LIST. Names are
+// limited to 32 bytes.
+//
+// Decoding looks the names up in a table sorted once per schema, trying
+// the field following the previous one first. That's a single comparison
+// per field for the files written by the same schema. Unknown fields are
+// skipped, null values leave the members untouched, anything else of
+// the wrong type fails the whole thing. So does a number with a fraction
+// or out of range for an Int member. Decoding merges the object into
+// the struct, which is expected to be initialized by the caller. Lists
+// present in the JSON replace the lists in the struct, same as scalars.
+//
+
+#define HARBOUR_JSON_NAME_CHAR(s,i) \
+    (((i) < sizeof(s)) ? (s)[((i) < sizeof(s)) ? (i) : 0] : '\0')
+#define HARBOUR_JSON_NAME(s) HarbourJsonSchema::Name<sizeof(s) - 1, \
+    HARBOUR_JSON_NAME_CHAR(s,0), HARBOUR_JSON_NAME_CHAR(s,1), \
+    HARBOUR_JSON_NAME_CHAR(s,2), HARBOUR_JSON_NAME_CHAR(s,3), \
+    HARBOUR_JSON_NAME_CHAR(s,4), HARBOUR_JSON_NAME_CHAR(s,5), \
+    HARBOUR_JSON_NAME_CHAR(s,6), HARBOUR_JSON_NAME_CHAR(s,7), \
+    HARBOUR_JSON_NAME_CHAR(s,8), HARBOUR_JSON_NAME_CHAR(s,9), \
+    HARBOUR_JSON_NAME_CHAR(s,10), HARBOUR_JSON_NAME_CHAR(s,11), \
+    HARBOUR_JSON_NAME_CHAR(s,12), HARBOUR_JSON_NAME_CHAR(s,13), \
+    HARBOUR_JSON_NAME_CHAR(s,14), HARBOUR_JSON_NAME_CHAR(s,15), \
+    HARBOUR_JSON_NAME_CHAR(s,16), HARBOUR_JSON_NAME_CHAR(s,17), \
+    HARBOUR_JSON_NAME_CHAR(s,18), HARBOUR_JSON_NAME_CHAR(s,19), \
+    HARBOUR_JSON_NAME_CHAR(s,20), HARBOUR_JSON_NAME_CHAR(s,21), \
+    HARBOUR_JSON_NAME_CHAR(s,22), HARBOUR_JSON_NAME_CHAR(s,23), \
+    HARBOUR_JSON_NAME_CHAR(s,24), HARBOUR_JSON_NAME_CHAR(s,25), \
+    HARBOUR_JSON_NAME_CHAR(s,26), HARBOUR_JSON_NAME_CHAR(s,27), \
+    HARBOUR_JSON_NAME_CHAR(s,28), HARBOUR_JSON_NAME_CHAR(s,29), \
+    HARBOUR_JSON_NAME_CHAR(s,30), HARBOUR_JSON_NAME_CHAR(s,31)>
+
+#define HARBOUR_JSON_NAMED_FIELD(name,kind,Struct,member) \
+    HarbourJsonSchema::Field<Struct, decltype(Struct::member), \
+    &Struct::member, HarbourJsonSchema::kind, HARBOUR_JSON_NAME(name)>
+#define HARBOUR_JSON_FIELD(kind,Struct,member) \
+    HARBOUR_JSON_NAMED_FIELD(#member,kind,Struct,member)
+#define HARBOUR_JSON_NAMED_LIST(name,kind,Struct,member) \
+    HarbourJsonSchema::Field<Struct, decltype(Struct::member), \
+    &Struct::member, HarbourJsonSchema::List<HarbourJsonSchema::kind>, \
+    HARBOUR_JSON_NAME(name)>
+#define HARBOUR_JSON_LIST(kind,Struct,member) \
+    HARBOUR_JSON_NAMED_LIST(#member,kind,Struct,member)
+
+class HarbourJsonSchema
+{
+    HarbourJsonSchema() Q_DECL_EQ_DELETE;
+
+    // Recursion over the list of fields
+    template <typename S, typename... F> struct Dispatch;
+
+    // Range of Int members, enums are checked against the underlying type
+    template <typename T, bool E = std::is_enum<T>::value>
+    struct IntType { typedef T Type; };
+    template <typename T>
+    struct IntType<T,true>
+        { typedef typename std::underlying_type<T>::type Type; };
+
+public:
+    typedef HarbourJson::Reader Reader;
+    typedef HarbourJson::Writer Writer;
+
+    template <int N, char... C>
+    struct Name {
+        Q_STATIC_ASSERT(N <= 32);
+        enum { LENGTH = N };
+        static inline const char* str()
+            {
+                static const char s[] = { C..., '\0' };
+                return s;
+            }
+    };
+
+    // Each kind decodes the value starting at the current token
+    struct Int {
+        template <typename T>
+        static inline bool decode(Reader& aReader, T* aValue)
+            {
+                typedef typename IntType<T>::Type I;
+                qint64 value;
+
+                // Fractions and values not fitting the member are errors
+                if (aReader.token() == Reader::TOKEN_NUMBER &&
+                    aReader.integer(&value) &&
+                    value >= (qint64)std::numeric_limits<I>::min() &&
+                    (value < 0 || (quint64)value <=
+                        (quint64)std::numeric_limits<I>::max())) {
+                    *aValue = (T)value;
+                    return true;
+                }
+                return false;
+            }
+
+        template <typename T>
+        static inline void encode(Writer& aWriter, T aValue)
+            { aWriter.value((qint64)aValue); }
+    };
+
+    struct Double {
+        template <typename T>
+        static inline bool decode(Reader& aReader, T* aValue)
+            {
+                if (aReader.token() == Reader::TOKEN_NUMBER) {
+                    *aValue = (T)aReader.number();
+                    return true;
+                }
+                return false;
+            }
+
+        template <typename T>
+        static inline void encode(Writer& aWriter, T aValue)
+            { aWriter.value((double)aValue); }
+    };
+
+    struct Bool {
+        static inline bool decode(Reader& aReader, bool* aValue)
+            {
+                switch (aReader.token()) {
+                case Reader::TOKEN_TRUE:
+                    *aValue = true;
+                    return true;
+                case Reader::TOKEN_FALSE:
+                    *aValue = false;
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+        static inline void encode(Writer& aWriter, bool aValue)
+            { aWriter.value(aValue); }
+    };
+
+    struct String {
+        static inline bool decode(Reader& aReader, QString* aValue)
+            {
+                if (aReader.token() == Reader::TOKEN_STRING) {
+                    *aValue = aReader.string();
+                    return true;
+                }
+                return false;
+            }
+
+        static inline void encode(Writer& aWriter, const QString& aValue)
+            { aWriter.value(aValue); }
+    };
+
+    template <typename M>
+    struct Nested {
+        static inline bool decode(Reader& aReader, typename M::Type* aValue)
+            { return M::decode(aReader, aValue); }
+
+        static inline void encode(Writer& aWriter,
+            const typename M::Type& aValue)
+            { M::encode(aWriter, aValue); }
+    };
+
+    template <typename K>
+    struct List {
+        template <typename C>
+        static bool decode(Reader& aReader, C* aList)
+            {
+                if (aReader.token() == Reader::TOKEN_BEGIN_ARRAY) {
+                    // Replaces the list like any other member gets
+                    // replaced, and only if the whole array is good
+                    C list;
+
+                    while (aReader.next() != Reader::TOKEN_END_ARRAY) {
+                        typename C::value_type value = typename C::value_type();
+
+                        if (!K::decode(aReader, &value)) {
+                            return false;
+                        }
+                        list.append(value);
+                    }
+                    *aList = list;
+                    return true;
+                }
+                return false;
+            }
+
+        template <typename C>
+        static void encode(Writer& aWriter, const C& aList)
+            {
+                aWriter.beginArray();
+                for (typename C::const_iterator it = aList.constBegin();
+                     it != aList.constEnd(); ++it) {
+                    K::encode(aWriter, *it);
+                }
+                aWriter.endArray();
+            }
+    };
+
+    template <typename S, typename T, T S::*M, typename K, typename N>
+    struct Field {
+        enum { NAME_LENGTH = N::LENGTH };
+
+        static inline const char* name()
+            { return N::str(); }
+
+        static bool decode(Reader& aReader, S* aStruct)
+            { return K::decode(aReader, &(aStruct->*M)); }
+
+        static inline void encode(Writer& aWriter, const S& aStruct)
+            {
+                aWriter.name(N::str(), N::LENGTH);
+                K::encode(aWriter, aStruct.*M);
+            }
+    };
+
+    template <typename S, typename... F>
+    class Object {
+        typedef bool (*DecodeFunc)(Reader&, S*);
+
+        struct Entry {
+            const char* name;
+            int size;
+            DecodeFunc decode;
+        };
+
+        static inline int compare(const char* aName1, int aSize1,
+            const char* aName2, int aSize2)
+            {
+                const int r = memcmp(aName1, aName2, qMin(aSize1, aSize2));
+
+                return r ? r : (aSize1 - aSize2);
+            }
+
+        // Built once per schema
+        class Table {
+        public:
+            Table()
+                {
+                    const Entry entries[] = {
+                        { F::name(), F::NAME_LENGTH, &F::decode }...,
+                        { Q_NULLPTR, 0, Q_NULLPTR }
+                    };
+                    const int n = sizeof...(F);
+
+                    iFields.reserve(n);
+                    iSorted.reserve(n);
+                    for (int i = 0; i < n; i++) {
+                        iFields.append(entries[i]);
+                        iSorted.append(i);
+                    }
+                    std::sort(iSorted.begin(), iSorted.end(),
+                        [&entries](int a, int b) {
+                            return compare(entries[a].name, entries[a].size,
+                                entries[b].name, entries[b].size) < 0;
+                        });
+                }
+
+            // The expected field first, then binary search
+            int find(const char* aName, int aSize, int aHint) const
+                {
+                    if (aHint < iFields.size() && !compare(aName, aSize,
+                        iFields.at(aHint).name, iFields.at(aHint).size)) {
+                        return aHint;
+                    } else {
+                        int lo = 0, hi = iSorted.size();
+
+                        while (lo < hi) {
+                            const int mid = (lo + hi) / 2;
+                            const Entry& e = iFields.at(iSorted.at(mid));
+                            const int r = compare(aName, aSize, e.name,
+                                e.size);
+
+                            if (r < 0) {
+                                hi = mid;
+                            } else if (r > 0) {
+                                lo = mid + 1;
+                            } else {
+                                return iSorted.at(mid);
+                            }
+                        }
+                        return -1;
+                    }
+                }
+
+        public:
+            QVector<Entry> iFields;  // In the order of declaration
+            QVector<int> iSorted;    // Indices sorted by name
+        };
+
+        static const Table& table()
+            {
+                static const Table t;
+                return t;
+            }
+
+    public:
+        typedef S Type;
+
+        // The reader must be at the beginning of the object
+        static bool decode(Reader& aReader, S* aStruct)
+            {
+                if (aReader.token() != Reader::TOKEN_BEGIN_OBJECT) {
+                    return false;
+                }
+
+                const Table& t = table();
+                int i = -1;
+
+                while (aReader.next() == Reader::TOKEN_NAME) {
+                    if (aReader.isEscaped()) {
+                        const QByteArray name(aReader.utf8());
+
+                        i = t.find(name.constData(), name.size(), i + 1);
+                    } else {
+                        i = t.find(aReader.tokenData(), aReader.tokenSize(),
+                            i + 1);
+                    }
+
+                    if (aReader.next() == Reader::TOKEN_NULL) {
+                        continue;
+                    } else if (i >= 0) {
+                        if (!t.iFields.at(i).decode(aReader, aStruct)) {
+                            return false;
+                        }
+                    } else if (!aReader.skipValue()) {
+                        return false;
+                    }
+                }
+                return aReader.token() == Reader::TOKEN_END_OBJECT;
+            }
+
+        // The whole thing must be a valid JSON object
+        static bool decode(const char* aJson, int aSize, S* aStruct)
+            {
+                Reader reader(aJson, aSize);
+
+                reader.next();
+                return decode(reader, aStruct) &&
+                    reader.next() == Reader::TOKEN_END;
+            }
+
+        static bool decode(const QByteArray aJson, S* aStruct)
+            { return decode(aJson.constData(), aJson.size(), aStruct); }
+
+        static void encode(Writer& aWriter, const S& aStruct)
+            {
+                aWriter.beginObject();
+                Dispatch<S, F...>::encode(aWriter, aStruct);
+                aWriter.endObject();
+            }
+
+        static QByteArray encode(const S& aStruct, bool aIndent = false)
+            {
+                Writer writer(aIndent);
+
+                encode(writer, aStruct);
+                return writer.data();
+            }
+
+        static bool load(const QString& aPath, S* aStruct)
+            {
+                QFile f(aPath);
+
+                if (f.open(QIODevice::ReadOnly)) {
+                    const qint64 size = f.size();
+                    const uchar* data = (size > 0) ? f.map(0, size) :
+                        Q_NULLPTR;
+
+                    return data ? decode((const char*)data, (int)size,
+                        aStruct) : decode(f.readAll(), aStruct);
+                }
+                return false;
+            }
+
+        // Indented unless SaveCompact is given, like HarbourJson::save()
+        static bool save(const QString& aPath, const S& aStruct,
+            HarbourJson::SaveOptions aOptions = HarbourJson::SaveDefault)
+            {
+                return HarbourJson::saveData(aPath, encode(aStruct,
+                    !(aOptions & HarbourJson::SaveCompact)), aOptions);
+            }
+    };
+};
+
+template <typename S>
+struct HarbourJsonSchema::Dispatch<S> {
+    static inline void encode(Writer&, const S&) {}
+};
+
+template <typename S, typename F, typename... Rest>
+struct HarbourJsonSchema::Dispatch<S, F, Rest...> {
+    static inline void encode(Writer& aWriter, const S& aStruct)
+        {
+            F::encode(aWriter, aStruct);
+            Dispatch<S, Rest...>::encode(aWriter, aStruct);
+        }
+};
+
+#endif // HARBOUR_JSON_SCHEMA_H
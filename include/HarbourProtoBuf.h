@@ -1,6 +1,6 @@
 /*
  * Copyright (C) 2022 Jolla Ltd.
- * Copyright (C) 2022 Slava Monich <slava.monich@jolla.com>
+ * Copyright (C) 2022-2026 Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -35,13 +35,17 @@
 #define HARBOUR_PROTOBUF_H
 
 #include <QByteArray>
+#include <QVector>
 
 #include <gutil_types.h>
 
+class QIODevice;
+
 // https://developers.google.com/protocol-buffers/docs/encoding
 
 class HarbourProtoBuf
 {
+    class Private;
     HarbourProtoBuf() Q_DECL_EQ_DELETE;
 
 public:
@@ -49,16 +53,190 @@ public:
         TYPE_SHIFT = 3,
         TYPE_MASK = ((1 << TYPE_SHIFT)-1),
         TYPE_VARINT = 0,
-        TYPE_DELIMITED = 2
+        TYPE_FIXED64 = 1,
+        TYPE_DELIMITED = 2,
+        TYPE_FIXED32 = 5
     };
 
     static QByteArray* appendVarInt(QByteArray*, quint64);
     static QByteArray* appendVarIntKeyValue(QByteArray*, quint64, quint64);
     static QByteArray* appendDelimitedValue(QByteArray*, const QByteArray);
     static QByteArray* appendDelimitedKeyValue(QByteArray*, quint64, const QByteArray);
+    static QByteArray* appendSignedVarInt(QByteArray*, qint64);
+    static QByteArray* appendSignedVarIntKeyValue(QByteArray*, quint64, qint64);
+    static QByteArray* appendFixed32(QByteArray*, quint32);
+    static QByteArray* appendFixed32KeyValue(QByteArray*, quint64, quint32);
+    static QByteArray* appendFixed64(QByteArray*, quint64);
+    static QByteArray* appendFixed64KeyValue(QByteArray*, quint64, quint64);
+
+    // Packed repeated fields (the key must be of TYPE_DELIMITED)
+    static QByteArray* appendPackedVarIntKeyValue(QByteArray*, quint64, const quint64*, int);
+    static QByteArray* appendPackedSignedVarIntKeyValue(QByteArray*, quint64, const qint64*, int);
+    static QByteArray* appendPackedFixed32KeyValue(QByteArray*, quint64, const quint32*, int);
+    static QByteArray* appendPackedFixed64KeyValue(QByteArray*, quint64, const quint64*, int);
 
     static bool parseVarInt(GUtilRange*, quint64*);
+    static int parseVarInts(GUtilRange*, quint64*, int);
+    static bool parseSignedVarInt(GUtilRange*, qint64*);
+    static bool parseFixed32(GUtilRange*, quint32*);
+    static bool parseFixed64(GUtilRange*, quint64*);
     static bool parseDelimitedValue(GUtilRange*, GUtilData*);
+
+    // Packed values are parsed directly into the caller's array. These
+    // return the total number of values (which may exceed the size of
+    // the array, in which case the extra values are dropped) or -1 if
+    // the data is malformed, in which case the range isn't advanced.
+    static int parsePackedVarInt(GUtilRange*, quint64*, int);
+    static int parsePackedSignedVarInt(GUtilRange*, qint64*, int);
+    static int parsePackedFixed32(GUtilRange*, quint32*, int);
+    static int parsePackedFixed64(GUtilRange*, quint64*, int);
+
+    // Skips the value of an unknown field, the key has already been parsed
+    static bool skipField(GUtilRange*, quint64);
+
+    static quint64 zigZagEncode(qint64);
+    static qint64 zigZagDecode(quint64);
+
+    class Writer;
+    class StreamParser;
+    class Index;
+};
+
+// Serializes into a buffer which grows geometrically. Nested messages
+// are written in place: begin() reserves space for the largest possible
+// length and end() fills it in, padding the varint with 0x80 bytes.
+class HarbourProtoBuf::Writer
+{
+    Q_DISABLE_COPY(Writer)
+
+public:
+    enum { LENGTH_SLOT = 5 };  // Enough for a 32-bit length
+
+    Writer(int aInitialCapacity = 0);
+
+    int size() const;
+    int depth() const;
+    void clear();
+    QByteArray data();  // All nested messages must be closed
+
+    Writer& appendVarInt(quint64);
+    Writer& appendVarIntKeyValue(quint64, quint64);
+    Writer& appendDelimitedValue(const QByteArray);
+    Writer& appendDelimitedValue(const void*, int);
+    Writer& appendDelimitedKeyValue(quint64, const QByteArray);
+    Writer& appendDelimitedKeyValue(quint64, const void*, int);
+    Writer& appendSignedVarInt(qint64);
+    Writer& appendSignedVarIntKeyValue(quint64, qint64);
+    Writer& appendFixed32(quint32);
+    Writer& appendFixed32KeyValue(quint64, quint32);
+    Writer& appendFixed64(quint64);
+    Writer& appendFixed64KeyValue(quint64, quint64);
+    Writer& appendRaw(const void*, int);
+
+    Writer& begin(quint64);  // Key of TYPE_DELIMITED
+    bool end();
+
+private:
+    uchar* reserve(int);
+
+private:
+    QByteArray iBuf;
+    int iSize;
+    QVector<int> iOpen;
+};
+
+// Push parser for a sequence of fields (e.g. a huge message or a log of
+// records) which doesn't have to be in memory all at once. It can be fed
+// arbitrary pieces of data and picks up where it stopped. Delimited
+// payloads not exceeding the chunk size are delivered in one piece,
+// larger ones in chunks of that size (the last one may be shorter).
+// The memory usage doesn't depend on the size of the input.
+class HarbourProtoBuf::StreamParser
+{
+    Q_DISABLE_COPY(StreamParser)
+
+public:
+    class Listener {
+    public:
+        virtual ~Listener();
+        virtual void varIntField(quint64 aKey, quint64 aValue);
+        virtual void fixed32Field(quint64 aKey, quint32 aValue);
+        virtual void fixed64Field(quint64 aKey, quint64 aValue);
+        // The offset of the chunk within the payload of the given size
+        virtual void delimitedField(quint64 aKey, quint64 aSize,
+            quint64 aOffset, const GUtilData* aChunk);
+    };
+
+    enum { DEFAULT_CHUNK_SIZE = 0x10000 };
+
+    StreamParser(Listener*, int aChunkSize = DEFAULT_CHUNK_SIZE);
+
+    bool parse(const void*, int);
+    bool parse(QIODevice*);     // Reads whatever is available
+    bool isFailed() const;
+    bool atFieldBoundary() const;  // The stream may end here
+    quint64 position() const;   // Number of bytes consumed
+    void reset();
+
+private:
+    void deliver(const guint8*, int);
+
+private:
+    enum State {
+        STATE_KEY,
+        STATE_VARINT,
+        STATE_FIXED,
+        STATE_LENGTH,
+        STATE_PAYLOAD,
+        STATE_FAILED
+    };
+
+    Listener* iListener;
+    const int iChunkSize;
+    State iState;
+    quint64 iPosition;
+    quint64 iKey;
+    quint64 iVarInt;
+    int iVarIntBytes;
+    guint8 iFixed[8];
+    int iFixedSize;
+    int iFixedCount;
+    quint64 iPayloadSize;
+    quint64 iPayloadOffset;
+    QByteArray iBuffer;
+    int iBuffered;
+};
+
+// Fields of a message, indexed in one pass and sorted by field number,
+// for random access. Occurrences of the same field remain in the order
+// they appear in the message. The index points into the original data,
+// which must stay alive and unchanged while the index is in use.
+class HarbourProtoBuf::Index
+{
+public:
+    struct Field {
+        quint32 tag : 29;   // Field number
+        quint32 type : 3;   // Wire type
+        quint32 offset;     // Of the value (or the payload) in the message
+        quint32 length;
+    };
+
+    Index();
+    Index(const GUtilData*);
+
+    bool build(const GUtilData*);   // Fails if the message is malformed
+    void clear();
+
+    int count() const;
+    const Field* fieldAt(int) const;
+    const Field* find(quint32) const;       // The first occurrence
+    int findAll(quint32, const Field**) const;
+    GUtilData value(const Field*) const;
+    GUtilRange range(const Field*) const;
+
+private:
+    GUtilData iData;
+    QVector<Field> iFields;
 };
 
 #endif // HARBOUR_PROTOBUF_H
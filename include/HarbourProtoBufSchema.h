@@ -0,0 +1,483 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef HARBOUR_PROTOBUF_SCHEMA_H
+#define HARBOUR_PROTOBUF_SCHEMA_H
+
+#include "HarbourProtoBuf.h"
+
+#include <QString>
+
+#include <string.h>
+
+//
+// Binds protobuf messages to plain structs at compile time. A message
+// is described by a list of fields, each field being a (tag, kind,
+// member) triplet:
+//
+//   struct Point { qint32 x; qint32 y; QString label; };
+//   typedef HarbourProtoBufSchema::Message<Point,
+//       HARBOUR_PROTOBUF_FIELD(1, SInt, Point, x),
+//       HARBOUR_PROTOBUF_FIELD(2, SInt, Point, y),
+//       HARBOUR_PROTOBUF_FIELD(3, String, Point, label)> PointSchema;
+//
+//   Point p = {};
+//   if (PointSchema::decode(data, &p)) ...
+//   QByteArray encoded(PointSchema::encode(p));
+//
+// Kinds are UInt (int32/int64/uint32/uint64), SInt (sint32/sint64),
+// Bool, Fixed32, Fixed64, Float, Double, Bytes (QByteArray), String
+// (QString) and Nested<Schema> for nested messages. Repeated fields
+// (QVector or QList of those) are declared with HARBOUR_PROTOBUF_REPEATED.
+// Repeated scalars are encoded packed, both packed and unpacked ones
+// are accepted when decoding.
+//
+// Everything is resolved at compile time, the tag dispatch ends up
+// being a sequence of integer comparisons which the compiler can
+// inline into the decoding loop. Unknown fields are skipped. Decoding
+// merges the message into the struct, which is expected to be
+// initialized by the caller.
+//
+
+#define HARBOUR_PROTOBUF_FIELD(tag,kind,Struct,member) \
+    HarbourProtoBufSchema::Field<Struct, decltype(Struct::member), \
+    &Struct::member, tag, HarbourProtoBufSchema::kind>
+#define HARBOUR_PROTOBUF_REPEATED(tag,kind,Struct,member) \
+    HarbourProtoBufSchema::Field<Struct, decltype(Struct::member), \
+    &Struct::member, tag, HarbourProtoBufSchema::Repeated< \
+    HarbourProtoBufSchema::kind> >
+
+class HarbourProtoBufSchema
+{
+    HarbourProtoBufSchema() Q_DECL_EQ_DELETE;
+
+    // Recursion over the list of fields
+    template <typename S, typename... F> struct Dispatch;
+
+public:
+    typedef HarbourProtoBuf::Writer Writer;
+
+    static inline quint64 key(quint32 aTag, int aType)
+        { return ((quint64)aTag << HarbourProtoBuf::TYPE_SHIFT) | aType; }
+
+    // Scalar kinds provide decodeValue() and encodeValue(), the rest
+    // is common
+    template <typename K, int W>
+    struct Scalar {
+        enum { WIRE_TYPE = W };
+
+        template <typename T>
+        static inline bool decode(int aType, GUtilRange* aPos, T* aValue)
+            { return aType == W && K::decodeValue(aPos, aValue); }
+
+        template <typename T>
+        static inline void encode(Writer& aWriter, quint32 aTag,
+            const T& aValue)
+            {
+                aWriter.appendVarInt(key(aTag, W));
+                K::encodeValue(aWriter, aValue);
+            }
+    };
+
+    struct UInt : public Scalar<UInt, HarbourProtoBuf::TYPE_VARINT> {
+        template <typename T>
+        static inline bool decodeValue(GUtilRange* aPos, T* aValue)
+            {
+                quint64 value;
+
+                if (HarbourProtoBuf::parseVarInt(aPos, &value)) {
+                    *aValue = (T)value;
+                    return true;
+                }
+                return false;
+            }
+
+        // Negative values are sign-extended to 64 bits, like protobuf does
+        template <typename T>
+        static inline void encodeValue(Writer& aWriter, T aValue)
+            { aWriter.appendVarInt((quint64)(qint64)aValue); }
+    };
+
+    struct SInt : public Scalar<SInt, HarbourProtoBuf::TYPE_VARINT> {
+        template <typename T>
+        static inline bool decodeValue(GUtilRange* aPos, T* aValue)
+            {
+                qint64 value;
+
+                if (HarbourProtoBuf::parseSignedVarInt(aPos, &value)) {
+                    *aValue = (T)value;
+                    return true;
+                }
+                return false;
+            }
+
+        template <typename T>
+        static inline void encodeValue(Writer& aWriter, T aValue)
+            { aWriter.appendSignedVarInt(aValue); }
+    };
+
+    struct Bool : public Scalar<Bool, HarbourProtoBuf::TYPE_VARINT> {
+        static inline bool decodeValue(GUtilRange* aPos, bool* aValue)
+            {
+                quint64 value;
+
+                if (HarbourProtoBuf::parseVarInt(aPos, &value)) {
+                    *aValue = (value != 0);
+                    return true;
+                }
+                return false;
+            }
+
+        static inline void encodeValue(Writer& aWriter, bool aValue)
+            { aWriter.appendVarInt(aValue ? 1 : 0); }
+    };
+
+    struct Fixed32 : public Scalar<Fixed32, HarbourProtoBuf::TYPE_FIXED32> {
+        template <typename T>
+        static inline bool decodeValue(GUtilRange* aPos, T* aValue)
+            {
+                quint32 value;
+
+                if (HarbourProtoBuf::parseFixed32(aPos, &value)) {
+                    *aValue = (T)value;
+                    return true;
+                }
+                return false;
+            }
+
+        template <typename T>
+        static inline void encodeValue(Writer& aWriter, T aValue)
+            { aWriter.appendFixed32((quint32)aValue); }
+    };
+
+    struct Fixed64 : public Scalar<Fixed64, HarbourProtoBuf::TYPE_FIXED64> {
+        template <typename T>
+        static inline bool decodeValue(GUtilRange* aPos, T* aValue)
+            {
+                quint64 value;
+
+                if (HarbourProtoBuf::parseFixed64(aPos, &value)) {
+                    *aValue = (T)value;
+                    return true;
+                }
+                return false;
+            }
+
+        template <typename T>
+        static inline void encodeValue(Writer& aWriter, T aValue)
+            { aWriter.appendFixed64((quint64)aValue); }
+    };
+
+    struct Float : public Scalar<Float, HarbourProtoBuf::TYPE_FIXED32> {
+        static inline bool decodeValue(GUtilRange* aPos, float* aValue)
+            {
+                quint32 bits;
+
+                if (HarbourProtoBuf::parseFixed32(aPos, &bits)) {
+                    memcpy(aValue, &bits, sizeof(bits));
+                    return true;
+                }
+                return false;
+            }
+
+        static inline void encodeValue(Writer& aWriter, float aValue)
+            {
+                quint32 bits;
+
+                memcpy(&bits, &aValue, sizeof(bits));
+                aWriter.appendFixed32(bits);
+            }
+    };
+
+    struct Double : public Scalar<Double, HarbourProtoBuf::TYPE_FIXED64> {
+        static inline bool decodeValue(GUtilRange* aPos, double* aValue)
+            {
+                quint64 bits;
+
+                if (HarbourProtoBuf::parseFixed64(aPos, &bits)) {
+                    memcpy(aValue, &bits, sizeof(bits));
+                    return true;
+                }
+                return false;
+            }
+
+        static inline void encodeValue(Writer& aWriter, double aValue)
+            {
+                quint64 bits;
+
+                memcpy(&bits, &aValue, sizeof(bits));
+                aWriter.appendFixed64(bits);
+            }
+    };
+
+    struct Bytes {
+        enum { WIRE_TYPE = HarbourProtoBuf::TYPE_DELIMITED };
+
+        static inline bool decodeValue(GUtilRange* aPos, QByteArray* aValue)
+            {
+                GUtilData data;
+
+                if (HarbourProtoBuf::parseDelimitedValue(aPos, &data)) {
+                    *aValue = QByteArray((const char*)data.bytes, data.size);
+                    return true;
+                }
+                return false;
+            }
+
+        static inline bool decode(int aType, GUtilRange* aPos,
+            QByteArray* aValue)
+            { return aType == WIRE_TYPE && decodeValue(aPos, aValue); }
+
+        static inline void encode(Writer& aWriter, quint32 aTag,
+            const QByteArray& aValue)
+            { aWriter.appendDelimitedKeyValue(key(aTag, WIRE_TYPE), aValue); }
+    };
+
+    struct String {
+        enum { WIRE_TYPE = HarbourProtoBuf::TYPE_DELIMITED };
+
+        static inline bool decodeValue(GUtilRange* aPos, QString* aValue)
+            {
+                GUtilData data;
+
+                if (HarbourProtoBuf::parseDelimitedValue(aPos, &data)) {
+                    *aValue = QString::fromUtf8((const char*)data.bytes,
+                        data.size);
+                    return true;
+                }
+                return false;
+            }
+
+        static inline bool decode(int aType, GUtilRange* aPos,
+            QString* aValue)
+            { return aType == WIRE_TYPE && decodeValue(aPos, aValue); }
+
+        static inline void encode(Writer& aWriter, quint32 aTag,
+            const QString& aValue)
+            {
+                aWriter.appendDelimitedKeyValue(key(aTag, WIRE_TYPE),
+                    aValue.toUtf8());
+            }
+    };
+
+    template <typename M>
+    struct Nested {
+        enum { WIRE_TYPE = HarbourProtoBuf::TYPE_DELIMITED };
+
+        static inline bool decodeValue(GUtilRange* aPos,
+            typename M::Type* aValue)
+            {
+                GUtilData data;
+
+                if (HarbourProtoBuf::parseDelimitedValue(aPos, &data)) {
+                    GUtilRange range;
+
+                    range.end = (range.ptr = data.bytes) + data.size;
+                    return M::decode(&range, aValue);
+                }
+                return false;
+            }
+
+        static inline bool decode(int aType, GUtilRange* aPos,
+            typename M::Type* aValue)
+            { return aType == WIRE_TYPE && decodeValue(aPos, aValue); }
+
+        static inline void encode(Writer& aWriter, quint32 aTag,
+            const typename M::Type& aValue)
+            {
+                aWriter.begin(key(aTag, WIRE_TYPE));
+                M::encode(aWriter, aValue);
+                aWriter.end();
+            }
+    };
+
+    template <typename K>
+    struct Repeated {
+        enum {
+            WIRE_TYPE = HarbourProtoBuf::TYPE_DELIMITED,
+            PACKED = (int)K::WIRE_TYPE != HarbourProtoBuf::TYPE_DELIMITED
+        };
+
+        template <typename C>
+        static bool decode(int aType, GUtilRange* aPos, C* aList)
+            {
+                typename C::value_type value = typename C::value_type();
+
+                if (aType == K::WIRE_TYPE) {
+                    if (K::decodeValue(aPos, &value)) {
+                        aList->append(value);
+                        return true;
+                    }
+                } else if (PACKED && aType == HarbourProtoBuf::TYPE_DELIMITED) {
+                    GUtilData data;
+
+                    if (HarbourProtoBuf::parseDelimitedValue(aPos, &data)) {
+                        GUtilRange range;
+
+                        range.end = (range.ptr = data.bytes) + data.size;
+                        while (range.ptr < range.end) {
+                            if (!K::decodeValue(&range, &value)) {
+                                return false;
+                            }
+                            aList->append(value);
+                        }
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+        template <typename C>
+        static inline void encode(Writer& aWriter, quint32 aTag,
+            const C& aList)
+            { encodeList(aWriter, aTag, aList, Packing<PACKED>()); }
+
+    private:
+        template <bool> struct Packing {};
+
+        // Only scalars have encodeValue()
+        template <typename C>
+        static void encodeList(Writer& aWriter, quint32 aTag, const C& aList,
+            Packing<true>)
+            {
+                if (!aList.isEmpty()) {
+                    aWriter.begin(key(aTag, WIRE_TYPE));
+                    for (typename C::const_iterator it = aList.constBegin();
+                         it != aList.constEnd(); ++it) {
+                        K::encodeValue(aWriter, *it);
+                    }
+                    aWriter.end();
+                }
+            }
+
+        template <typename C>
+        static void encodeList(Writer& aWriter, quint32 aTag, const C& aList,
+            Packing<false>)
+            {
+                for (typename C::const_iterator it = aList.constBegin();
+                     it != aList.constEnd(); ++it) {
+                    K::encode(aWriter, aTag, *it);
+                }
+            }
+    };
+
+    template <typename S, typename T, T S::*M, quint32 TAG, typename K>
+    struct Field {
+        enum { FIELD_TAG = TAG };
+
+        static inline bool decode(int aType, GUtilRange* aPos, S* aStruct)
+            { return K::decode(aType, aPos, &(aStruct->*M)); }
+
+        static inline void encode(Writer& aWriter, const S& aStruct)
+            { K::encode(aWriter, TAG, aStruct.*M); }
+    };
+
+    template <typename S, typename... F>
+    struct Message {
+        typedef S Type;
+
+        // The whole range must be a valid message
+        static bool decode(GUtilRange* aPos, S* aStruct)
+            {
+                while (aPos->ptr < aPos->end) {
+                    quint64 key;
+
+                    if (!HarbourProtoBuf::parseVarInt(aPos, &key)) {
+                        return false;
+                    }
+
+                    const int r = Dispatch<S, F...>::decode((quint32)(key >>
+                        HarbourProtoBuf::TYPE_SHIFT), (int)(key &
+                        HarbourProtoBuf::TYPE_MASK), aPos, aStruct);
+
+                    if (r < 0 || (!r && !HarbourProtoBuf::skipField(aPos,
+                        key))) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+        static bool decode(const QByteArray aData, S* aStruct)
+            {
+                GUtilRange range;
+
+                range.ptr = (const guint8*)aData.constData();
+                range.end = range.ptr + aData.size();
+                return decode(&range, aStruct);
+            }
+
+        static void encode(Writer& aWriter, const S& aStruct)
+            { Dispatch<S, F...>::encode(aWriter, aStruct); }
+
+        static QByteArray encode(const S& aStruct)
+            {
+                Writer writer;
+
+                encode(writer, aStruct);
+                return writer.data();
+            }
+    };
+};
+
+// Returns 1 if the field was decoded, 0 if the tag is unknown and -1
+// if decoding has failed
+template <typename S>
+struct HarbourProtoBufSchema::Dispatch<S> {
+    static inline int decode(quint32, int, GUtilRange*, S*) { return 0; }
+    static inline void encode(Writer&, const S&) {}
+};
+
+template <typename S, typename F, typename... Rest>
+struct HarbourProtoBufSchema::Dispatch<S, F, Rest...> {
+    static inline int decode(quint32 aTag, int aType, GUtilRange* aPos,
+        S* aStruct)
+        {
+            return (aTag == F::FIELD_TAG) ?
+                (F::decode(aType, aPos, aStruct) ? 1 : -1) :
+                Dispatch<S, Rest...>::decode(aTag, aType, aPos, aStruct);
+        }
+
+    static inline void encode(Writer& aWriter, const S& aStruct)
+        {
+            F::encode(aWriter, aStruct);
+            Dispatch<S, Rest...>::encode(aWriter, aStruct);
+        }
+};
+
+#endif // HARBOUR_PROTOBUF_SCHEMA_H
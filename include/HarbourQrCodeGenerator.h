@@ -1,6 +1,6 @@
 /*
+ * Copyright (C) 2019-2026 Slava Monich <slava@monich.com>
  * Copyright (C) 2019-2021 Jolla Ltd.
- * Copyright (C) 2019-2021 Slava Monich <slava.monich@jolla.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -80,7 +80,6 @@ Q_SIGNALS:
     void runningChanged();
 
 private:
-    class Task;
     class Private;
     Private* iPrivate;
 };
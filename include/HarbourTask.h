@@ -46,19 +46,32 @@
 
 class QThread;
 class QThreadPool;
+class HarbourTaskScheduler;
 
 //
-// A Runnable that queues done() signal to the target thread when it's done.
+// A Runnable that emits done() signal on the main thread when it's done.
 //
 // run(), performTask() and isCanceled() are the only methods that are
 // supposed to be invoked on the worker thread. Everything else should
 // be happening in context of the main thread which created this object.
 //
+// isCanceled() returns true once the task has been released, skipped by
+// the scheduler, or if aboutToQuit has been emitted after the task was
+// created. Tasks created by aboutToQuit handlers (or later) do run.
+//
+// Finished tasks are collected by a single completion channel which
+// delivers them to the main thread in batches, one event per batch
+// rather than one per task.
+//
+// Tasks can also be submitted via HarbourTaskScheduler, which decides
+// when they actually get handed over to the thread pool.
+//
 class HarbourTask :
     public QObject,
     public QRunnable
 {
     Q_OBJECT
+    friend class HarbourTaskScheduler;
 
     // Cleanup template for QScopedPointer (used by AutoReleasePointer)
     template <typename Task>
@@ -90,18 +103,24 @@ public:
     };
 
 private:
+    class Channel;
     void released();
+    void setTarget(QObject*, const char*);
+    // These are used by HarbourTaskScheduler
+    void scheduled(HarbourTaskScheduler*);
+    void unscheduled();
+    void start();
+    void skip();
 
 protected:
     void run() Q_DECL_OVERRIDE;
     virtual void performTask() = 0;
 
 Q_SIGNALS:
-    void runFinished();
     void done();
 
-private Q_SLOTS:
-    void onAboutToQuit();
+private:
+    void runFinished();
     void onRunFinished();
 
 private:
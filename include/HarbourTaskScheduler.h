@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef HARBOUR_TASK_SCHEDULER_H
+#define HARBOUR_TASK_SCHEDULER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+class QThreadPool;
+class HarbourTask;
+
+//
+// Keeps HarbourTasks in its own queue and hands them over to the thread
+// pool one by one, as the pool threads become available. The tasks with
+// higher priority go first, the ones with the same priority are started
+// in the order of submission. Tasks must be created with the same pool
+// which is given to the scheduler.
+//
+// A task submitted with a non-empty key supersedes the queued task with
+// the same key (if there is one). The superseded task never runs, its
+// done() signal is emitted anyway (with isCanceled() returning true) so
+// that the owner can release it as usual. Releasing a queued task takes
+// it out of the queue too.
+//
+// The priority of a task can be changed for as long as it's queued.
+//
+class HarbourTaskScheduler :
+    public QObject
+{
+    Q_OBJECT
+    friend class HarbourTask;
+
+public:
+    enum Priority {
+        PriorityIdle,
+        PriorityBackground,
+        PriorityNormal,
+        PriorityVisible
+    };
+
+    explicit HarbourTaskScheduler(QThreadPool*, QObject* aParent = Q_NULLPTR);
+    ~HarbourTaskScheduler();
+
+    QThreadPool* threadPool() const;
+    int queuedCount() const;
+    int runningCount() const;
+
+    void submit(HarbourTask*, Priority aPriority = PriorityNormal,
+        const QString aKey = QString());
+    void submit(HarbourTask*, QObject* aTarget, const char* aSlot,
+        Priority aPriority = PriorityNormal, const QString aKey = QString());
+
+    bool isQueued(HarbourTask*) const;
+    bool setPriority(HarbourTask*, Priority);
+    bool setPriority(const QString aKey, Priority);
+
+private:
+    void taskFinished(HarbourTask*);
+    void taskReleased(HarbourTask*);
+    void taskDestroyed(HarbourTask*);
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // HARBOUR_TASK_SCHEDULER_H
@@ -66,11 +66,33 @@ public:
 
     // Static utilities
     static QRgb invertedRgb(QRgb);
+
+    // Lower case hex, two characters per byte
     static QByteArray toHexBytes(const void*, size_t);
     static QString toHex(const void*, size_t);
     static inline QString toHex(const QByteArray& aData)
         { return toHex(aData.constData(), aData.size()); }
 
+    // Validates and decodes hex (upper or lower case, no separators)
+    // in one pass. Returns an empty array if the input is invalid, the
+    // error position then receives the offset of the first bad character
+    // (the last one if the length of the input is odd).
+    static QByteArray fromHex(const QString, int* aErrorPos = Q_NULLPTR);
+    static QByteArray fromHex(const QByteArray, int* aErrorPos = Q_NULLPTR);
+    static QByteArray fromHex(const char*, int, int* aErrorPos = Q_NULLPTR);
+
+    // Same thing, writing the output to the caller's buffer. Returns the
+    // decoded size (half the length of the input), or -1 on failure. If
+    // it's the buffer which is too small, the error position is set to -1.
+    static int decodeHex(const QString, void* aBuf, int aBufSize,
+        int* aErrorPos = Q_NULLPTR);
+    static int decodeHex(const QByteArray, void* aBuf, int aBufSize,
+        int* aErrorPos = Q_NULLPTR);
+    static int decodeHex(const char*, int, void* aBuf, int aBufSize,
+        int* aErrorPos = Q_NULLPTR);
+    static int decodeHex(const QChar*, int, void* aBuf, int aBufSize,
+        int* aErrorPos = Q_NULLPTR);
+
     // Make sure that deleteLater() is invoked from Qt event loop.
     // See https://bugreports.qt.io/browse/QTBUG-18434 for details
     static void scheduleDeleteLater(QObject*);
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourAsyncValue.h"
+#include "HarbourDebug.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QPointer>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
+// ==========================================================================
+// HarbourAsyncValueBase::Private
+// ==========================================================================
+
+class HarbourAsyncValueBase::Private
+{
+public:
+    Private(QThreadPool*);
+
+    bool running() const;
+
+public:
+    QThreadPool* iThreadPool;
+    QTimer* iTimer;
+    HarbourTask* iTask;
+    int iDelay;
+    bool iRunning;
+};
+
+HarbourAsyncValueBase::Private::Private(
+    QThreadPool* aPool) :
+    iThreadPool(aPool ? aPool : sharedThreadPool()),
+    iTimer(Q_NULLPTR),
+    iTask(Q_NULLPTR),
+    iDelay(0),
+    iRunning(false)
+{
+}
+
+inline
+bool
+HarbourAsyncValueBase::Private::running() const
+{
+    return iTask || (iTimer && iTimer->isActive());
+}
+
+// ==========================================================================
+// HarbourAsyncValueBase
+// ==========================================================================
+
+HarbourAsyncValueBase::HarbourAsyncValueBase(
+    QThreadPool* aPool,
+    QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private(aPool))
+{
+}
+
+HarbourAsyncValueBase::~HarbourAsyncValueBase()
+{
+    // The task holds its own copy of the input, it can finish without us
+    if (iPrivate->iTask) {
+        iPrivate->iTask->release();
+    }
+    delete iPrivate;
+}
+
+QThreadPool*
+HarbourAsyncValueBase::sharedThreadPool()
+{
+    static QPointer<QThreadPool> pool;
+
+    if (!pool) {
+        // Waits for the tasks to finish when the app is destroyed
+        pool = new QThreadPool(qApp);
+    }
+    return pool.data();
+}
+
+QThreadPool*
+HarbourAsyncValueBase::threadPool() const
+{
+    return iPrivate->iThreadPool;
+}
+
+int
+HarbourAsyncValueBase::delay() const
+{
+    return iPrivate->iDelay;
+}
+
+void
+HarbourAsyncValueBase::setDelay(
+    int aDelay)
+{
+    const int delay = qMax(aDelay, 0);
+
+    if (iPrivate->iDelay != delay) {
+        iPrivate->iDelay = delay;
+        HDEBUG(delay);
+        Q_EMIT delayChanged();
+    }
+}
+
+bool
+HarbourAsyncValueBase::running() const
+{
+    return iPrivate->iRunning;
+}
+
+void
+HarbourAsyncValueBase::update()
+{
+    if (iPrivate->iTask) {
+        // Whatever it's computing is already stale
+        iPrivate->iTask->release();
+        iPrivate->iTask = Q_NULLPTR;
+    }
+
+    if (iPrivate->iDelay > 0) {
+        if (!iPrivate->iTimer) {
+            iPrivate->iTimer = new QTimer(this);
+            iPrivate->iTimer->setSingleShot(true);
+            connect(iPrivate->iTimer, SIGNAL(timeout()), SLOT(onTimeout()));
+        }
+        iPrivate->iTimer->start(iPrivate->iDelay);
+    } else {
+        if (iPrivate->iTimer) {
+            iPrivate->iTimer->stop();
+        }
+        onTimeout();
+    }
+
+    if (!iPrivate->iRunning) {
+        iPrivate->iRunning = true;
+        Q_EMIT runningChanged();
+    }
+}
+
+void
+HarbourAsyncValueBase::onTimeout()
+{
+    HASSERT(!iPrivate->iTask);
+    iPrivate->iTask = createTask(iPrivate->iThreadPool);
+    iPrivate->iTask->submit(this, SLOT(onTaskDone()));
+}
+
+void
+HarbourAsyncValueBase::onTaskDone()
+{
+    HarbourTask* task = iPrivate->iTask;
+
+    if (task && sender() == task) {
+        const bool changed = finishTask(task);
+
+        iPrivate->iTask = Q_NULLPTR;
+        task->release();
+        if (changed) {
+            Q_EMIT resultChanged();
+        }
+        if (iPrivate->iRunning && !iPrivate->running()) {
+            iPrivate->iRunning = false;
+            Q_EMIT runningChanged();
+        }
+    }
+}
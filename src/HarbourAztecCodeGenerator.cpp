@@ -1,6 +1,6 @@
 /*
+ * Copyright (C) 2019-2026 Slava Monich <slava@monich.com>
  * Copyright (C) 2019-2021 Jolla Ltd.
- * Copyright (C) 2019-2021 Slava Monich <slava.monich@jolla.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -33,45 +33,12 @@
 
 #include "HarbourAztecCodeGenerator.h"
 
+#include "HarbourAsyncValue.h"
 #include "HarbourBase32.h"
-#include "HarbourTask.h"
 #include "HarbourDebug.h"
 
-#include <QThreadPool>
-
 #include "aztec_encode.h"   // Requires https://github.com/monich/libaztec
 
-// ==========================================================================
-// HarbourAztecCodeGenerator::Task
-// ==========================================================================
-
-class HarbourAztecCodeGenerator::Task : public HarbourTask {
-    Q_OBJECT
-public:
-    Task(QThreadPool* aPool, QString aText, int aEcLevel);
-    void performTask() Q_DECL_OVERRIDE;
-public:
-    QString iText;
-    QString iCode;
-    int iEcLevel;
-};
-
-HarbourAztecCodeGenerator::Task::Task(QThreadPool* aPool, QString aText,
-    int aEcLevel) :
-    HarbourTask(aPool),
-    iText(aText),
-    iEcLevel(aEcLevel)
-{
-}
-
-void HarbourAztecCodeGenerator::Task::performTask()
-{
-    QByteArray bytes(generate(iText, iEcLevel));
-    if (!bytes.isEmpty()) {
-        iCode = HarbourBase32::toBase32(bytes);
-    }
-}
-
 // ==========================================================================
 // HarbourAztecCodeGenerator::Private
 // ==========================================================================
@@ -80,8 +47,14 @@ class HarbourAztecCodeGenerator::Private : public QObject {
     Q_OBJECT
 
 public:
+    struct Input {
+        QString iText;
+        int iEcLevel;
+    };
+
+    typedef HarbourAsyncValue<Input,QString> AsyncCode;
+
     Private(HarbourAztecCodeGenerator* aParent);
-    ~Private();
 
     HarbourAztecCodeGenerator* parentObject() const;
     void setText(QString aValue);
@@ -89,31 +62,21 @@ public:
     void regenerate();
 
     static int realEcLevel(int aEcLevel);
-
-public Q_SLOTS:
-    void onTaskDone();
+    static QString generateCode(const Input& aInput);
 
 public:
-    QThreadPool* iThreadPool;
-    Task* iTask;
+    AsyncCode* iCode;
     int iEcLevel;
     QString iText;
-    QString iCode;
 };
 
 HarbourAztecCodeGenerator::Private::Private(HarbourAztecCodeGenerator* aParent) :
     QObject(aParent),
-    iThreadPool(new QThreadPool(this)),
-    iTask(Q_NULLPTR),
+    iCode(new AsyncCode(generateCode, this)),
     iEcLevel(ECLevelDefault)
 {
-    // Serialize the tasks:
-    iThreadPool->setMaxThreadCount(1);
-}
-
-HarbourAztecCodeGenerator::Private::~Private()
-{
-    iThreadPool->waitForDone();
+    aParent->connect(iCode, SIGNAL(resultChanged()), SIGNAL(codeChanged()));
+    aParent->connect(iCode, SIGNAL(runningChanged()), SIGNAL(runningChanged()));
 }
 
 inline HarbourAztecCodeGenerator* HarbourAztecCodeGenerator::Private::parentObject() const
@@ -129,6 +92,13 @@ int HarbourAztecCodeGenerator::Private::realEcLevel(int aEcLevel)
         aEcLevel;
 }
 
+// Runs on a worker thread
+QString HarbourAztecCodeGenerator::Private::generateCode(const Input& aInput)
+{
+    QByteArray bytes(generate(aInput.iText, aInput.iEcLevel));
+    return bytes.isEmpty() ? QString() : HarbourBase32::toBase32(bytes);
+}
+
 void HarbourAztecCodeGenerator::Private::setText(QString aText)
 {
     if (iText != aText) {
@@ -154,28 +124,10 @@ void HarbourAztecCodeGenerator::Private::setEcLevel(int aValue)
 
 void HarbourAztecCodeGenerator::Private::regenerate()
 {
-    const bool wasRunning = (iTask != Q_NULLPTR);
-    if (iTask) iTask->release(this);
-    iTask = new Task(iThreadPool, iText, iEcLevel);
-    iTask->submit(this, SLOT(onTaskDone()));
-    if (!wasRunning) {
-        Q_EMIT parentObject()->runningChanged();
-    }
-}
-
-void HarbourAztecCodeGenerator::Private::onTaskDone()
-{
-    if (sender() == iTask) {
-        HarbourAztecCodeGenerator* obj = parentObject();
-        const bool changed = (iCode != iTask->iCode);
-        iCode = iTask->iCode;
-        iTask->release();
-        iTask = NULL;
-        if (changed) {
-            Q_EMIT obj->codeChanged();
-        }
-        Q_EMIT obj->runningChanged();
-    }
+    Input input;
+    input.iText = iText;
+    input.iEcLevel = iEcLevel;
+    iCode->setInput(input);
 }
 
 // ==========================================================================
@@ -216,12 +168,12 @@ void HarbourAztecCodeGenerator::setEcLevel(int aValue)
 
 QString HarbourAztecCodeGenerator::code() const
 {
-    return iPrivate->iCode;
+    return iPrivate->iCode->result();
 }
 
 bool HarbourAztecCodeGenerator::running() const
 {
-    return iPrivate->iTask != Q_NULLPTR;
+    return iPrivate->iCode->running();
 }
 
 QByteArray HarbourAztecCodeGenerator::generate(QString aText, int aEcLevel)
@@ -1,6 +1,6 @@
 /*
  * Copyright (C) 2019-2022 Jolla Ltd.
- * Copyright (C) 2019-2025 Slava Monich <slava@monich.com>
+ * Copyright (C) 2019-2026 Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -40,6 +40,11 @@
 #include "HarbourBase32.h"
 
 #include "HarbourDebug.h"
+#include "HarbourSimd.h"
+
+#include <QtCore/QIODevice>
+
+#include <string.h>
 
 #define BASE32_BITS_PER_NIBBLE (5)
 #define BASE32_BYTES_PER_CHUNK (5)
@@ -48,211 +53,1702 @@
 #define BASE32_NIBBLE_MASK  ((1 << BASE32_BITS_PER_NIBBLE) - 1)
 Q_STATIC_ASSERT(BASE32_BITS_PER_CHUNK == BASE32_BYTES_PER_CHUNK * 8);
 
-// ==========================================================================
-// HarbourBase32::Private
-// ==========================================================================
+// ==========================================================================
+// Vector kernels
+//
+// Encoders convert 10 bytes (two 40-bit chunks) into 16 characters per
+// 128-bit step, decoders go the other way. Vector loads may touch up to
+// 6 bytes past the data being converted, the callers make sure that those
+// are still inside the input buffer. Anything that doesn't fit (and any
+// input that's not plain upper or lower case BASE32 alphabet) is left to
+// the scalar code.
+// ==========================================================================
+
+#if HARBOUR_SIMD_X86
+
+HARBOUR_TARGET("ssse3")
+static inline
+__m128i
+base32EncodeSsse3(
+    const uchar* aIn,
+    __m128i aBase,
+    __m128i aDigits)
+{
+    const __m128i in = _mm_loadu_si128((const __m128i*)aIn);
+
+    // Each 16-bit lane receives two bytes containing the nibble (the first
+    // one in the upper half), the multiplication shifts the nibble to the
+    // top of the lane. The last nibble is fully contained in one byte.
+    const __m128i mul = _mm_setr_epi16(1, 32, 4, 128, 16, 2, 64, 8);
+    const __m128i a = _mm_srli_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(in,
+        _mm_setr_epi8(1,0, 1,0, 2,1, 2,1, 3,2, 4,3, 4,3, -1,4)), mul), 11);
+    const __m128i b = _mm_srli_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(in,
+        _mm_setr_epi8(6,5, 6,5, 7,6, 7,6, 8,7, 9,8, 9,8, -1,9)), mul), 11);
+    const __m128i v = _mm_packus_epi16(a, b);
+
+    // 0..25 => letters, 26..31 => digits
+    return _mm_add_epi8(_mm_add_epi8(v, aBase), _mm_and_si128(aDigits,
+        _mm_cmpgt_epi8(v, _mm_set1_epi8(25))));
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+void
+base32StoreSsse3(
+    char* aOut,
+    __m128i aChars)
+{
+    _mm_storeu_si128((__m128i*)aOut, aChars);
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+void
+base32StoreSsse3(
+    QChar* aOut,
+    __m128i aChars)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    _mm_storeu_si128((__m128i*)aOut, _mm_unpacklo_epi8(aChars, zero));
+    _mm_storeu_si128((__m128i*)(aOut + 8), _mm_unpackhi_epi8(aChars, zero));
+}
+
+template <typename C>
+HARBOUR_TARGET("ssse3")
+static
+int
+base32EncodeBlocksSsse3(
+    const uchar* aIn,
+    int aSize,
+    C* aOut,
+    char aBase)
+{
+    const __m128i base = _mm_set1_epi8(aBase);
+    const __m128i digits = _mm_set1_epi8('2' - 26 - aBase);
+    const uchar* in = aIn;
+    C* out = aOut;
+
+    // 40 bytes per iteration
+    while ((aSize - (in - aIn)) >= 46) {
+        base32StoreSsse3(out, base32EncodeSsse3(in, base, digits));
+        base32StoreSsse3(out + 16, base32EncodeSsse3(in + 10, base, digits));
+        base32StoreSsse3(out + 32, base32EncodeSsse3(in + 20, base, digits));
+        base32StoreSsse3(out + 48, base32EncodeSsse3(in + 30, base, digits));
+        in += 40;
+        out += 64;
+    }
+    while ((aSize - (in - aIn)) >= 16) {
+        base32StoreSsse3(out, base32EncodeSsse3(in, base, digits));
+        in += 10;
+        out += 16;
+    }
+    return in - aIn;
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+__m128i
+base32LoadSsse3(
+    const char* aIn)
+{
+    return _mm_loadu_si128((const __m128i*)aIn);
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+__m128i
+base32LoadSsse3(
+    const QChar* aIn)
+{
+    // Characters above 0xff saturate to either 0 or 0xff, both invalid
+    return _mm_packus_epi16(_mm_loadu_si128((const __m128i*)aIn),
+        _mm_loadu_si128((const __m128i*)(aIn + 8)));
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+bool
+base32DecodeSsse3(
+    __m128i aChars,
+    char* aOut)
+{
+    // Signed comparison, anything >= 0x80 fails all range checks
+    const __m128i c = aChars;
+    const __m128i upper = _mm_and_si128(
+        _mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)),
+        _mm_cmplt_epi8(c, _mm_set1_epi8('Z' + 1)));
+    const __m128i lower = _mm_and_si128(
+        _mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+        _mm_cmplt_epi8(c, _mm_set1_epi8('z' + 1)));
+    const __m128i digit = _mm_and_si128(
+        _mm_cmpgt_epi8(c, _mm_set1_epi8('2' - 1)),
+        _mm_cmplt_epi8(c, _mm_set1_epi8('7' + 1)));
+
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(upper, lower),
+        digit)) != 0xffff) {
+        return false;
+    }
+
+    const __m128i v = _mm_or_si128(_mm_or_si128(
+        _mm_and_si128(upper, _mm_sub_epi8(c, _mm_set1_epi8('A'))),
+        _mm_and_si128(lower, _mm_sub_epi8(c, _mm_set1_epi8('a')))),
+        _mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('2' - 26))));
+
+    // 5 bit => 10 bit => 20 bit => 40 bit
+    const __m128i x = _mm_madd_epi16(_mm_maddubs_epi16(v,
+        _mm_set1_epi16(0x0120)), _mm_set1_epi32(0x00010400));
+    const __m128i y = _mm_or_si128(_mm_slli_epi64(_mm_and_si128(x,
+        _mm_set_epi32(0, -1, 0, -1)), 20), _mm_srli_epi64(x, 32));
+
+    // Most significant bytes first
+    const __m128i z = _mm_shuffle_epi8(y, _mm_setr_epi8(4, 3, 2, 1, 0,
+        12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1));
+    const quint16 tail = (quint16)_mm_extract_epi16(z, 4);
+
+    _mm_storel_epi64((__m128i*)aOut, z);
+    memcpy(aOut + 8, &tail, 2);
+    return true;
+}
+
+template <typename C>
+HARBOUR_TARGET("ssse3")
+static
+int
+base32DecodeBlocksSsse3(
+    const C* aIn,
+    int aLength,
+    char* aOut)
+{
+    int i = 0;
+
+    while ((aLength - i) >= 16 &&
+        base32DecodeSsse3(base32LoadSsse3(aIn + i), aOut)) {
+        aOut += 10;
+        i += 16;
+    }
+    return i;
+}
+
+HARBOUR_TARGET("avx2")
+static inline
+__m256i
+base32EncodeAvx2(
+    const uchar* aIn,
+    __m256i aBase,
+    __m256i aDigits)
+{
+    // Same thing as base32EncodeSsse3, 10 bytes per 128-bit lane
+    const __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(
+        _mm_loadu_si128((const __m128i*)aIn)),
+        _mm_loadu_si128((const __m128i*)(aIn + 10)), 1);
+    const __m256i mul = _mm256_setr_epi16(1, 32, 4, 128, 16, 2, 64, 8,
+        1, 32, 4, 128, 16, 2, 64, 8);
+    const __m256i a = _mm256_srli_epi16(_mm256_mullo_epi16(
+        _mm256_shuffle_epi8(in, _mm256_setr_epi8(
+        1,0, 1,0, 2,1, 2,1, 3,2, 4,3, 4,3, -1,4,
+        1,0, 1,0, 2,1, 2,1, 3,2, 4,3, 4,3, -1,4)), mul), 11);
+    const __m256i b = _mm256_srli_epi16(_mm256_mullo_epi16(
+        _mm256_shuffle_epi8(in, _mm256_setr_epi8(
+        6,5, 6,5, 7,6, 7,6, 8,7, 9,8, 9,8, -1,9,
+        6,5, 6,5, 7,6, 7,6, 8,7, 9,8, 9,8, -1,9)), mul), 11);
+    const __m256i v = _mm256_packus_epi16(a, b);
+
+    return _mm256_add_epi8(_mm256_add_epi8(v, aBase), _mm256_and_si256(
+        aDigits, _mm256_cmpgt_epi8(v, _mm256_set1_epi8(25))));
+}
+
+HARBOUR_TARGET("avx2")
+static inline
+void
+base32StoreAvx2(
+    char* aOut,
+    __m256i aChars)
+{
+    _mm256_storeu_si256((__m256i*)aOut, aChars);
+}
+
+HARBOUR_TARGET("avx2")
+static inline
+void
+base32StoreAvx2(
+    QChar* aOut,
+    __m256i aChars)
+{
+    _mm256_storeu_si256((__m256i*)aOut,
+        _mm256_cvtepu8_epi16(_mm256_castsi256_si128(aChars)));
+    _mm256_storeu_si256((__m256i*)(aOut + 16),
+        _mm256_cvtepu8_epi16(_mm256_extracti128_si256(aChars, 1)));
+}
+
+template <typename C>
+HARBOUR_TARGET("avx2")
+static
+int
+base32EncodeBlocksAvx2(
+    const uchar* aIn,
+    int aSize,
+    C* aOut,
+    char aBase)
+{
+    const __m256i base = _mm256_set1_epi8(aBase);
+    const __m256i digits = _mm256_set1_epi8('2' - 26 - aBase);
+    const uchar* in = aIn;
+    C* out = aOut;
+
+    // 80 bytes per iteration
+    while ((aSize - (in - aIn)) >= 86) {
+        base32StoreAvx2(out, base32EncodeAvx2(in, base, digits));
+        base32StoreAvx2(out + 32, base32EncodeAvx2(in + 20, base, digits));
+        base32StoreAvx2(out + 64, base32EncodeAvx2(in + 40, base, digits));
+        base32StoreAvx2(out + 96, base32EncodeAvx2(in + 60, base, digits));
+        in += 80;
+        out += 128;
+    }
+    while ((aSize - (in - aIn)) >= 26) {
+        base32StoreAvx2(out, base32EncodeAvx2(in, base, digits));
+        in += 20;
+        out += 32;
+    }
+    const int done = in - aIn;
+    return done + base32EncodeBlocksSsse3(in, aSize - done, out, aBase);
+}
+
+HARBOUR_TARGET("avx2")
+static inline
+__m256i
+base32LoadAvx2(
+    const char* aIn)
+{
+    return _mm256_loadu_si256((const __m256i*)aIn);
+}
+
+HARBOUR_TARGET("avx2")
+static inline
+__m256i
+base32LoadAvx2(
+    const QChar* aIn)
+{
+    // Packing is done per 128-bit lane, fix the order of 64-bit blocks
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(
+        _mm256_loadu_si256((const __m256i*)aIn),
+        _mm256_loadu_si256((const __m256i*)(aIn + 16))), 0xd8);
+}
+
+HARBOUR_TARGET("avx2")
+static inline
+bool
+base32DecodeAvx2(
+    __m256i aChars,
+    char* aOut)
+{
+    const __m256i c = aChars;
+    const __m256i upper = _mm256_and_si256(
+        _mm256_cmpgt_epi8(c, _mm256_set1_epi8('A' - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), c));
+    const __m256i lower = _mm256_and_si256(
+        _mm256_cmpgt_epi8(c, _mm256_set1_epi8('a' - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), c));
+    const __m256i digit = _mm256_and_si256(
+        _mm256_cmpgt_epi8(c, _mm256_set1_epi8('2' - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8('7' + 1), c));
+
+    if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(upper, lower),
+        digit)) != -1) {
+        return false;
+    }
+
+    const __m256i v = _mm256_or_si256(_mm256_or_si256(
+        _mm256_and_si256(upper, _mm256_sub_epi8(c, _mm256_set1_epi8('A'))),
+        _mm256_and_si256(lower, _mm256_sub_epi8(c, _mm256_set1_epi8('a')))),
+        _mm256_and_si256(digit, _mm256_sub_epi8(c,
+        _mm256_set1_epi8('2' - 26))));
+    const __m256i x = _mm256_madd_epi16(_mm256_maddubs_epi16(v,
+        _mm256_set1_epi16(0x0120)), _mm256_set1_epi32(0x00010400));
+    const __m256i y = _mm256_or_si256(_mm256_slli_epi64(_mm256_and_si256(x,
+        _mm256_set_epi32(0, -1, 0, -1, 0, -1, 0, -1)), 20),
+        _mm256_srli_epi64(x, 32));
+    const __m256i z = _mm256_shuffle_epi8(y, _mm256_setr_epi8(
+        4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1,
+        4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1));
+    const __m128i lo = _mm256_castsi256_si128(z);
+    const __m128i hi = _mm256_extracti128_si256(z, 1);
+    const quint16 loTail = (quint16)_mm_extract_epi16(lo, 4);
+    const quint16 hiTail = (quint16)_mm_extract_epi16(hi, 4);
+
+    _mm_storel_epi64((__m128i*)aOut, lo);
+    memcpy(aOut + 8, &loTail, 2);
+    _mm_storel_epi64((__m128i*)(aOut + 10), hi);
+    memcpy(aOut + 18, &hiTail, 2);
+    return true;
+}
+
+template <typename C>
+HARBOUR_TARGET("avx2")
+static
+int
+base32DecodeBlocksAvx2(
+    const C* aIn,
+    int aLength,
+    char* aOut)
+{
+    int i = 0;
+
+    while ((aLength - i) >= 32 &&
+        base32DecodeAvx2(base32LoadAvx2(aIn + i), aOut)) {
+        aOut += 20;
+        i += 32;
+    }
+    return i + base32DecodeBlocksSsse3(aIn + i, aLength - i, aOut);
+}
+
+#endif // HARBOUR_SIMD_X86
+
+#if HARBOUR_SIMD_NEON
+
+static inline
+uint8x16_t
+base32EncodeNeon(
+    const uchar* aIn,
+    uint8x16_t aBase,
+    uint8x16_t aDigits)
+{
+    static const uchar index[32] = {
+        1,0, 1,0, 2,1, 2,1, 3,2, 4,3, 4,3, 0xff,4,
+        6,5, 6,5, 7,6, 7,6, 8,7, 9,8, 9,8, 0xff,9
+    };
+    static const qint16 shift[8] = { 0, 5, 2, 7, 4, 1, 6, 3 };
+    const uint8x16_t in = vld1q_u8(aIn);
+    const int16x8_t s = vld1q_s16(shift);
+    uint8x8x2_t t;
+
+    t.val[0] = vget_low_u8(in);
+    t.val[1] = vget_high_u8(in);
+
+    const uint16x8_t a = vshrq_n_u16(vshlq_u16(vreinterpretq_u16_u8(
+        vcombine_u8(vtbl2_u8(t, vld1_u8(index)),
+        vtbl2_u8(t, vld1_u8(index + 8)))), s), 11);
+    const uint16x8_t b = vshrq_n_u16(vshlq_u16(vreinterpretq_u16_u8(
+        vcombine_u8(vtbl2_u8(t, vld1_u8(index + 16)),
+        vtbl2_u8(t, vld1_u8(index + 24)))), s), 11);
+    const uint8x16_t v = vcombine_u8(vmovn_u16(a), vmovn_u16(b));
+
+    return vaddq_u8(vaddq_u8(v, aBase),
+        vandq_u8(aDigits, vcgtq_u8(v, vdupq_n_u8(25))));
+}
+
+static inline
+void
+base32StoreNeon(
+    char* aOut,
+    uint8x16_t aChars)
+{
+    vst1q_u8((uchar*)aOut, aChars);
+}
+
+static inline
+void
+base32StoreNeon(
+    QChar* aOut,
+    uint8x16_t aChars)
+{
+    vst1q_u16((ushort*)aOut, vmovl_u8(vget_low_u8(aChars)));
+    vst1q_u16((ushort*)(aOut + 8), vmovl_u8(vget_high_u8(aChars)));
+}
+
+template <typename C>
+static
+int
+base32EncodeBlocksNeon(
+    const uchar* aIn,
+    int aSize,
+    C* aOut,
+    char aBase)
+{
+    const uint8x16_t base = vdupq_n_u8((uchar)aBase);
+    const uint8x16_t digits = vdupq_n_u8((uchar)('2' - 26 - aBase));
+    const uchar* in = aIn;
+    C* out = aOut;
+
+    // 40 bytes per iteration
+    while ((aSize - (in - aIn)) >= 46) {
+        base32StoreNeon(out, base32EncodeNeon(in, base, digits));
+        base32StoreNeon(out + 16, base32EncodeNeon(in + 10, base, digits));
+        base32StoreNeon(out + 32, base32EncodeNeon(in + 20, base, digits));
+        base32StoreNeon(out + 48, base32EncodeNeon(in + 30, base, digits));
+        in += 40;
+        out += 64;
+    }
+    while ((aSize - (in - aIn)) >= 16) {
+        base32StoreNeon(out, base32EncodeNeon(in, base, digits));
+        in += 10;
+        out += 16;
+    }
+    return in - aIn;
+}
+
+static inline
+uint8x16_t
+base32LoadNeon(
+    const char* aIn)
+{
+    return vld1q_u8((const uchar*)aIn);
+}
+
+static inline
+uint8x16_t
+base32LoadNeon(
+    const QChar* aIn)
+{
+    const ushort* in = (const ushort*)aIn;
+
+    return vcombine_u8(vqmovn_u16(vld1q_u16(in)), vqmovn_u16(vld1q_u16(in + 8)));
+}
+
+static inline
+bool
+base32DecodeNeon(
+    uint8x16_t aChars,
+    char* aOut)
+{
+    const uint8x16_t u = vsubq_u8(aChars, vdupq_n_u8('A'));
+    const uint8x16_t l = vsubq_u8(aChars, vdupq_n_u8('a'));
+    const uint8x16_t d = vsubq_u8(aChars, vdupq_n_u8('2'));
+    const uint8x16_t upper = vcltq_u8(u, vdupq_n_u8(26));
+    const uint8x16_t lower = vcltq_u8(l, vdupq_n_u8(26));
+    const uint8x16_t digit = vcltq_u8(d, vdupq_n_u8(6));
+    const uint8x16_t valid = vorrq_u8(vorrq_u8(upper, lower), digit);
+    const uint8x8_t all = vand_u8(vget_low_u8(valid), vget_high_u8(valid));
+
+    if (vget_lane_u64(vreinterpret_u64_u8(all), 0) != ~Q_UINT64_C(0)) {
+        return false;
+    }
+
+    const uint8x16_t v = vorrq_u8(vorrq_u8(vandq_u8(upper, u),
+        vandq_u8(lower, l)), vandq_u8(digit, vaddq_u8(d, vdupq_n_u8(26))));
+
+    // 5 bit => 10 bit => 20 bit => 40 bit
+    const uint16x8_t x = vreinterpretq_u16_u8(v);
+    const uint32x4_t y = vreinterpretq_u32_u16(vorrq_u16(vshlq_n_u16(
+        vandq_u16(x, vdupq_n_u16(0xff)), 5), vshrq_n_u16(x, 8)));
+    const uint64x2_t z = vreinterpretq_u64_u32(vorrq_u32(vshlq_n_u32(
+        vandq_u32(y, vdupq_n_u32(0xffff)), 10), vshrq_n_u32(y, 16)));
+    const uint64x2_t w = vorrq_u64(vshlq_n_u64(vandq_u64(z,
+        vdupq_n_u64(0xffffffff)), 20), vshrq_n_u64(z, 32));
+    quint64 chunk = vgetq_lane_u64(w, 0);
+    int i;
+
+    // Most significant bytes first
+    for (i = 4; i >= 0; i--, chunk >>= 8) {
+        aOut[i] = (char)chunk;
+    }
+    chunk = vgetq_lane_u64(w, 1);
+    for (i = 9; i >= 5; i--, chunk >>= 8) {
+        aOut[i] = (char)chunk;
+    }
+    return true;
+}
+
+template <typename C>
+static
+int
+base32DecodeBlocksNeon(
+    const C* aIn,
+    int aLength,
+    char* aOut)
+{
+    int i = 0;
+
+    while ((aLength - i) >= 16 &&
+        base32DecodeNeon(base32LoadNeon(aIn + i), aOut)) {
+        aOut += 10;
+        i += 16;
+    }
+    return i;
+}
+
+#endif // HARBOUR_SIMD_NEON
+
+// ==========================================================================
+// HarbourBase32::Private
+// ==========================================================================
+
+class HarbourBase32::Private
+{
+public:
+    // Special values in the decoding tables, anything above 31 isn't
+    // a digit. SKIP is whitespace (and whatever else the alphabet wants
+    // to be ignored), PAD is the padding character.
+    enum {
+        SKIP = 0x40,
+        PAD = 0x80,
+        INVALID = 0xff
+    };
+
+    // Compile-time integer sequence (C++11 doesn't have one)
+    template <int... I> struct Seq {};
+    template <int N, int... I> struct MakeSeq : MakeSeq<N - 1, N - 1, I...> {};
+    template <int... I> struct MakeSeq<0, I...> { typedef Seq<I...> Type; };
+
+    // Alphabets. Digits are listed in their canonical case, decoding is
+    // case insensitive. Only the RFC 4648 alphabet has vector kernels.
+    struct Rfc4648 {
+        enum { PADDING = true, SIMD = true };
+        static constexpr char digit(int i)
+            { return "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567"[i]; }
+        static constexpr int alias(int c) { return c; }
+        static constexpr bool skip(int) { return false; }
+    };
+
+    struct Base32Hex {
+        enum { PADDING = true, SIMD = false };
+        static constexpr char digit(int i)
+            { return "0123456789ABCDEFGHIJKLMNOPQRSTUV"[i]; }
+        static constexpr int alias(int c) { return c; }
+        static constexpr bool skip(int) { return false; }
+    };
+
+    // https://www.crockford.com/base32.html
+    // I and L are decoded as 1, O as 0. Hyphens are ignored.
+    struct Crockford {
+        enum { PADDING = false, SIMD = false };
+        static constexpr char digit(int i)
+            { return "0123456789ABCDEFGHJKMNPQRSTVWXYZ"[i]; }
+        static constexpr int alias(int c)
+            { return (c == 'I' || c == 'i' || c == 'L' || c == 'l') ? '1' :
+                (c == 'O' || c == 'o') ? '0' : c; }
+        static constexpr bool skip(int c) { return c == '-'; }
+    };
+
+    // https://philzimmermann.com/docs/human-oriented-base-32-encoding.txt
+    struct ZBase32 {
+        enum { PADDING = false, SIMD = false };
+        static constexpr char digit(int i)
+            { return "ybndrfg8ejkmcpqxot1uwisza345h769"[i]; }
+        static constexpr int alias(int c) { return c; }
+        static constexpr bool skip(int) { return false; }
+    };
+
+    // Table generators
+    template <typename A>
+    struct Lookup {
+        static constexpr int upper(int c)
+            { return (c >= 'a' && c <= 'z') ? (c - 'a' + 'A') : c; }
+        static constexpr int lower(int c)
+            { return (c >= 'A' && c <= 'Z') ? (c - 'A' + 'a') : c; }
+        // Latin-1 characters for which QChar::isSpace() returns true
+        static constexpr bool space(int c)
+            { return (c >= 0x09 && c <= 0x0d) || c == 0x20 ||
+                c == 0x85 || c == 0xa0; }
+        static constexpr int find(int c, int i)
+            { return (i == 32) ? -1 : (upper(A::digit(i)) == upper(c)) ? i :
+                find(c, i + 1); }
+        static constexpr uchar decode(int c)
+            { return (A::PADDING && c == '=') ? uchar(PAD) :
+                (space(c) || A::skip(c)) ? uchar(SKIP) :
+                (find(A::alias(c), 0) < 0) ? uchar(INVALID) :
+                uchar(find(A::alias(c), 0)); }
+        static constexpr char encode(int i, bool aLowerCase)
+            { return aLowerCase ? char(lower(A::digit(i))) : A::digit(i); }
+    };
+
+    template <typename A, typename S> struct DecodeTable;
+    template <typename A, int... I> struct DecodeTable<A, Seq<I...> >
+        { static const uchar value[sizeof...(I)]; };
+
+    template <typename A, bool L, typename S> struct EncodeTable;
+    template <typename A, bool L, int... I> struct EncodeTable<A, L, Seq<I...> >
+        { static const char value[sizeof...(I)]; };
+
+    template <typename A>
+    static const uchar* decodeTable()
+        { return DecodeTable<A, typename MakeSeq<256>::Type>::value; }
+    template <typename A>
+    static const char* encodeTable(bool aLowerCase)
+        { return aLowerCase ?
+            EncodeTable<A, true, typename MakeSeq<32>::Type>::value :
+            EncodeTable<A, false, typename MakeSeq<32>::Type>::value; }
+
+    static uint code(QChar aChar) { return aChar.unicode(); }
+    static uint code(char aChar) { return (uchar)aChar; }
+    static bool isSpace(QChar aChar) { return aChar.isSpace(); }
+    static bool isSpace(char) { return false; } // Covered by the table
+    template <typename A, typename C> static uint lookup(C);
+    static bool hasPadding(Alphabet);
+    static char* storeChunk(char*, qint64, int);
+    template <typename C> static int encodeBlocks(const uchar*, int, C*, char);
+    template <typename C> static int decodeBlocks(const C*, int, char*);
+    template <typename A, typename C> static int encode(const uchar*, int, C*,
+        EncodeOptions);
+    template <typename C> static int encode(Alphabet, const uchar*, int, C*,
+        EncodeOptions);
+    template <typename A, typename C> static DecodeStatus decode(const C*, int,
+        char*, int, int*, int*, bool);
+    template <typename C> static DecodeStatus decode(Alphabet, const C*, int,
+        char*, int, int*, int*, bool);
+    template <typename C> static bool isValid(Alphabet, const C*, int, bool);
+    template <typename C> static QByteArray fromBase32(Alphabet, const C*,
+        int, bool);
+    static QString toBase32(Alphabet, const QByteArray, EncodeOptions);
+};
+
+// Both tables are filled in at compile time
+template <typename A, int... I>
+const uchar HarbourBase32::Private::DecodeTable<A,
+    HarbourBase32::Private::Seq<I...> >::value[sizeof...(I)] = {
+    HarbourBase32::Private::Lookup<A>::decode(I)...
+};
+
+template <typename A, bool L, int... I>
+const char HarbourBase32::Private::EncodeTable<A, L,
+    HarbourBase32::Private::Seq<I...> >::value[sizeof...(I)] = {
+    HarbourBase32::Private::Lookup<A>::encode(I, L)...
+};
+
+// Returns the digit value or one of the special values
+template <typename A, typename C>
+inline
+uint
+HarbourBase32::Private::lookup(
+    C aChar)
+{
+    const uint c = code(aChar);
+
+    return (c < 256) ? decodeTable<A>()[c] :
+        isSpace(aChar) ? uint(SKIP) : uint(INVALID);
+}
+
+// static
+bool
+HarbourBase32::Private::hasPadding(
+    Alphabet aAlphabet)
+{
+    switch (aAlphabet) {
+    case AlphabetRfc4648: return Rfc4648::PADDING;
+    case AlphabetBase32Hex: return Base32Hex::PADDING;
+    case AlphabetCrockford: return Crockford::PADDING;
+    case AlphabetZBase32: return ZBase32::PADDING;
+    }
+    return false;
+}
+
+// static
+inline
+char*
+HarbourBase32::Private::storeChunk(
+    char* aOut,
+    qint64 aChunk,
+    int aNumBytes /* <= BASE32_BYTES_PER_CHUNK */)
+{
+    // Most significant bytes first
+    for (int i = aNumBytes; i > 0; i--) {
+        aOut[i - 1] = (char) aChunk;
+        aChunk >>= 8;
+    }
+    return aOut + aNumBytes;
+}
+
+// Converts as many whole chunks as the vector code can handle,
+// returns the number of bytes consumed (a multiple of 5)
+template <typename C>
+inline
+int
+HarbourBase32::Private::encodeBlocks(
+    const uchar* aIn,
+    int aSize,
+    C* aOut,
+    char aBaseChar)
+{
+#if HARBOUR_SIMD_X86
+    if (HarbourSimd::has(HarbourSimd::AVX2)) {
+        return base32EncodeBlocksAvx2(aIn, aSize, aOut, aBaseChar);
+    } else if (HarbourSimd::has(HarbourSimd::SSSE3)) {
+        return base32EncodeBlocksSsse3(aIn, aSize, aOut, aBaseChar);
+    }
+#elif HARBOUR_SIMD_NEON
+    return base32EncodeBlocksNeon(aIn, aSize, aOut, aBaseChar);
+#endif
+    return 0;
+}
+
+// Decodes as many characters as the vector code can handle, stops at
+// anything unusual. Returns the number of characters consumed (always
+// a multiple of 8), the output size is 5 bytes per 8 characters.
+template <typename C>
+inline
+int
+HarbourBase32::Private::decodeBlocks(
+    const C* aIn,
+    int aLength,
+    char* aOut)
+{
+#if HARBOUR_SIMD_X86
+    if (HarbourSimd::has(HarbourSimd::AVX2)) {
+        return base32DecodeBlocksAvx2(aIn, aLength, aOut);
+    } else if (HarbourSimd::has(HarbourSimd::SSSE3)) {
+        return base32DecodeBlocksSsse3(aIn, aLength, aOut);
+    }
+#elif HARBOUR_SIMD_NEON
+    return base32DecodeBlocksNeon(aIn, aLength, aOut);
+#endif
+    return 0;
+}
+
+// Returns the number of characters written
+template <typename A, typename C>
+int
+HarbourBase32::Private::encode(
+    const uchar* aIn,
+    int aSize,
+    C* aOut,
+    EncodeOptions aOptions)
+{
+    const bool lowerCase = (aOptions & EncodeLowerCase) != 0;
+    const char* digits = encodeTable<A>(lowerCase);
+    const int done = A::SIMD ? encodeBlocks(aIn, aSize, aOut,
+        lowerCase ? 'a' : 'A') : 0;
+    const uchar* ptr = aIn + done;
+    const uchar* end = aIn + aSize;
+    C* out = aOut + (done / BASE32_BYTES_PER_CHUNK) * BASE32_NIBBLES_PER_CHUNK;
+    int k;
+
+    // The scalar code takes care of the rest
+    while ((end - ptr) >= BASE32_BYTES_PER_CHUNK) {
+        quint64 chunk = 0;
+
+        for (k = 0; k < BASE32_BYTES_PER_CHUNK; k++) {
+            chunk = (chunk << 8) | *ptr++;
+        }
+        for (k = BASE32_NIBBLES_PER_CHUNK; k > 0; k--) {
+            out[k - 1] = (uchar) digits[chunk & BASE32_NIBBLE_MASK];
+            chunk >>= BASE32_BITS_PER_NIBBLE;
+        }
+        out += BASE32_NIBBLES_PER_CHUNK;
+    }
+
+    // Add padding per RFC 4648
+    if (ptr < end) {
+        const int bits = (end - ptr) * 8;
+        const int outnibbles = (bits + BASE32_BITS_PER_NIBBLE - 1) /
+            BASE32_BITS_PER_NIBBLE;
+        quint64 chunk = 0;
+
+        while (ptr < end) {
+            chunk = (chunk << 8) | *ptr++;
+        }
+        chunk <<= (outnibbles * BASE32_BITS_PER_NIBBLE - bits);
+        for (k = outnibbles; k > 0; k--) {
+            out[k - 1] = (uchar) digits[chunk & BASE32_NIBBLE_MASK];
+            chunk >>= BASE32_BITS_PER_NIBBLE;
+        }
+        out += outnibbles;
+        if (A::PADDING && !(aOptions & EncodeNoPadding)) {
+            for (k = outnibbles; k < BASE32_NIBBLES_PER_CHUNK; k++) {
+                *out++ = '=';
+            }
+        }
+    }
+    return out - aOut;
+}
+
+template <typename C>
+int
+HarbourBase32::Private::encode(
+    Alphabet aAlphabet,
+    const uchar* aIn,
+    int aSize,
+    C* aOut,
+    EncodeOptions aOptions)
+{
+    switch (aAlphabet) {
+    case AlphabetRfc4648:
+        return encode<Rfc4648>(aIn, aSize, aOut, aOptions);
+    case AlphabetBase32Hex:
+        return encode<Base32Hex>(aIn, aSize, aOut, aOptions);
+    case AlphabetCrockford:
+        return encode<Crockford>(aIn, aSize, aOut, aOptions);
+    case AlphabetZBase32:
+        return encode<ZBase32>(aIn, aSize, aOut, aOptions);
+    }
+    return 0;
+}
+
+// Validates and (if the output buffer is provided) decodes the input in
+// a single pass. Without the output buffer, the input is only validated.
+template <typename A, typename C>
+HarbourBase32::DecodeStatus
+HarbourBase32::Private::decode(
+    const C* aChars,
+    int aLength,
+    char* aBuf,
+    int aBufSize,
+    int* aSize,
+    int* aErrorPos,
+    bool aRequirePadding)
+{
+    const int n = qMax(aLength, 0);
+    DecodeStatus status = DecodeOk;
+    qint64 buf = 0;
+    int i, size = 0, nibbles = 0, simd = 0, last = -1, pos = n;
+
+    for (i = 0; i < n; i++) {
+        // Let the vector code run through the chunk boundaries. If it
+        // bails out, have the scalar code handle at least one chunk
+        // before trying again.
+        if (A::SIMD && aBuf && !nibbles && i >= simd && (n - i) >= 16) {
+            const int room = ((aBufSize - size) / 10) * 16;
+            const int k = decodeBlocks(aChars + i, qMin(n - i, room),
+                aBuf + size);
+
+            if (k) {
+                size += (k / BASE32_NIBBLES_PER_CHUNK) * BASE32_BYTES_PER_CHUNK;
+                i += k;
+                last = i - 1;
+            }
+            simd = i + BASE32_NIBBLES_PER_CHUNK;
+            if (i == n) {
+                break;
+            }
+        }
+
+        const uint nibble = lookup<A>(aChars[i]);
+
+        if (nibble == PAD) {
+            break;
+        } else if (nibble == INVALID) {
+            HDEBUG("Invalid BASE32 character at" << i);
+            status = DecodeInvalidChar;
+            pos = i;
+            break;
+        } else if (nibble != SKIP) {
+            last = i;
+            nibbles++;
+            buf <<= BASE32_BITS_PER_NIBBLE;
+            buf += nibble;
+            if (nibbles == BASE32_NIBBLES_PER_CHUNK) {
+                if (aBuf) {
+                    if ((aBufSize - size) < BASE32_BYTES_PER_CHUNK) {
+                        HDEBUG("BASE32 output buffer is too small");
+                        status = DecodeBufferTooSmall;
+                        pos = i;
+                        break;
+                    }
+                    storeChunk(aBuf + size, buf, BASE32_BYTES_PER_CHUNK);
+                }
+                size += BASE32_BYTES_PER_CHUNK;
+                nibbles = 0;
+                buf = 0;
+            }
+        }
+    }
+
+    const int usedBytes = nibbles * BASE32_BITS_PER_NIBBLE / 8;
+    const int unusedBits = nibbles * BASE32_BITS_PER_NIBBLE - usedBytes * 8;
+
+    if (status == DecodeOk) {
+        switch (nibbles) {
+        case 0:
+        case 2: // 1 byte (8 => 10 bits)
+        case 4: // 2 bytes (16 => 20 bits)
+        case 5: // 3 bytes (24 => 25 bits)
+        case 7: // 4 bytes (32 => 35 bits)
+            break;
+        default:
+            HDEBUG("Invalid BASE32 length");
+            status = DecodeInvalidLength;
+            pos = last;
+            break;
+        }
+    }
+
+    // [RFC 4648]
+    // When fewer than 40 input bits are available in an input group,
+    // bits with value zero are added (on the right) to form an integral
+    // number of 5-bit groups.
+    if (status == DecodeOk && (buf & ((1 << unusedBits) - 1))) {
+        HDEBUG("Non-zero trailing BASE32 bits");
+        status = DecodeNonZeroBits;
+        pos = last;
+    }
+
+    // Handle padding per RFC 4648
+    const int padStart = i;
+    int padding = 0;
+
+    for (; i < n && status == DecodeOk; i++) {
+        const uint c = lookup<A>(aChars[i]);
+
+        if (c == PAD) {
+            if (last < 0) {
+                HDEBUG("Unexpected BASE32 padding");
+                status = DecodeInvalidPadding;
+                pos = i;
+            } else if ((nibbles + padding) == BASE32_NIBBLES_PER_CHUNK) {
+                // Too much padding
+                HDEBUG("Invalid BASE32 padding");
+                status = DecodeInvalidPadding;
+                pos = i;
+            }
+            padding++;
+        } else if (c != SKIP) {
+            HDEBUG("Invalid BASE32 padding");
+            status = DecodeInvalidPadding;
+            pos = i;
+        }
+    }
+
+    if (status == DecodeOk) {
+        if (padding) {
+            // If padding is there, it must be valid even if it wasn't required
+            if (!nibbles || (nibbles + padding) != BASE32_NIBBLES_PER_CHUNK) {
+                HDEBUG("Invalid BASE32 padding");
+                status = DecodeInvalidPadding;
+                pos = padStart;
+            }
+        } else if (A::PADDING && nibbles && aRequirePadding) {
+            // The padding was required but it's missing
+            HDEBUG("Missing BASE32 padding");
+            status = DecodeMissingPadding;
+        }
+    }
+
+    if (status == DecodeOk) {
+        if (aBuf) {
+            if ((aBufSize - size) < usedBytes) {
+                HDEBUG("BASE32 output buffer is too small");
+                status = DecodeBufferTooSmall;
+                pos = last;
+            } else {
+                storeChunk(aBuf + size, buf >> unusedBits, usedBytes);
+            }
+        }
+        size += usedBytes;
+        if (last < 0 && status == DecodeOk) {
+            status = DecodeEmpty;
+        }
+    }
+
+    const bool ok = (status == DecodeOk || status == DecodeEmpty);
+
+    if (aSize) {
+        *aSize = ok ? size : 0;
+    }
+    if (aErrorPos) {
+        *aErrorPos = ok ? -1 : pos;
+    }
+    return status;
+}
+
+template <typename C>
+HarbourBase32::DecodeStatus
+HarbourBase32::Private::decode(
+    Alphabet aAlphabet,
+    const C* aChars,
+    int aLength,
+    char* aBuf,
+    int aBufSize,
+    int* aSize,
+    int* aErrorPos,
+    bool aRequirePadding)
+{
+    switch (aAlphabet) {
+    case AlphabetRfc4648:
+        return decode<Rfc4648>(aChars, aLength, aBuf, aBufSize, aSize,
+            aErrorPos, aRequirePadding);
+    case AlphabetBase32Hex:
+        return decode<Base32Hex>(aChars, aLength, aBuf, aBufSize, aSize,
+            aErrorPos, aRequirePadding);
+    case AlphabetCrockford:
+        return decode<Crockford>(aChars, aLength, aBuf, aBufSize, aSize,
+            aErrorPos, aRequirePadding);
+    case AlphabetZBase32:
+        return decode<ZBase32>(aChars, aLength, aBuf, aBufSize, aSize,
+            aErrorPos, aRequirePadding);
+    }
+    return DecodeInvalidChar;
+}
+
+template <typename C>
+inline
+bool
+HarbourBase32::Private::isValid(
+    Alphabet aAlphabet,
+    const C* aChars,
+    int aLength,
+    bool aRequirePadding)
+{
+    // Validation only, no output
+    return decode(aAlphabet, aChars, aLength, Q_NULLPTR, 0, Q_NULLPTR,
+        Q_NULLPTR, aRequirePadding) == DecodeOk;
+}
+
+template <typename C>
+QByteArray
+HarbourBase32::Private::fromBase32(
+    Alphabet aAlphabet,
+    const C* aChars,
+    int aLength,
+    bool aRequirePadding)
+{
+    QByteArray out;
+    int size;
+
+    out.resize(maxDecodedSize(aLength));
+    switch (decode(aAlphabet, aChars, aLength, out.data(), out.size(), &size,
+        Q_NULLPTR, aRequirePadding)) {
+    case DecodeOk:
+    case DecodeEmpty:
+        out.resize(size);
+        return out;
+    default:
+        return QByteArray();
+    }
+}
+
+// static
+QString
+HarbourBase32::Private::toBase32(
+    Alphabet aAlphabet,
+    const QByteArray aBinary,
+    EncodeOptions aOptions)
+{
+    QString str;
+    const int n = aBinary.size();
+
+    if (n > 0) {
+        const int chunks = n / BASE32_BYTES_PER_CHUNK;
+        const int tail = n % BASE32_BYTES_PER_CHUNK;
+        const bool pad = hasPadding(aAlphabet) && !(aOptions & EncodeNoPadding);
+
+        // Output goes straight into the pre-sized string
+        str.resize(chunks * BASE32_NIBBLES_PER_CHUNK + (!tail ? 0 :
+            pad ? BASE32_NIBBLES_PER_CHUNK :
+            (tail * 8 + BASE32_BITS_PER_NIBBLE - 1) / BASE32_BITS_PER_NIBBLE));
+        encode(aAlphabet, (const uchar*)aBinary.constData(), n, str.data(),
+            aOptions);
+    }
+    return str;
+}
+
+// ==========================================================================
+// HarbourBase32
+// ==========================================================================
+
+// static
+int
+HarbourBase32::maxDecodedSize(
+    int aLength)
+{
+    // Every 8 characters produce at most 5 bytes
+    return (aLength > 0) ? ((aLength / BASE32_NIBBLES_PER_CHUNK) *
+        BASE32_BYTES_PER_CHUNK + (aLength % BASE32_NIBBLES_PER_CHUNK) *
+        BASE32_BYTES_PER_CHUNK / BASE32_NIBBLES_PER_CHUNK) : 0;
+}
+
+// static
+HarbourBase32::DecodeStatus
+HarbourBase32::decode(
+    const QString aBase32,
+    void* aBuf,
+    int aBufSize,
+    int* aSize,
+    int* aErrorPos,
+    bool aRequirePadding)
+{
+    return Private::decode<Private::Rfc4648>(aBase32.constData(),
+        aBase32.length(), (char*)aBuf, aBufSize, aSize, aErrorPos, aRequirePadding);
+}
+
+// static
+HarbourBase32::DecodeStatus
+HarbourBase32::decode(
+    const QByteArray aBase32,
+    void* aBuf,
+    int aBufSize,
+    int* aSize,
+    int* aErrorPos,
+    bool aRequirePadding)
+{
+    return Private::decode<Private::Rfc4648>(aBase32.constData(),
+        aBase32.size(), (char*)aBuf, aBufSize, aSize, aErrorPos, aRequirePadding);
+}
+
+// static
+HarbourBase32::DecodeStatus
+HarbourBase32::decode(
+    const char* aBase32,
+    int aLength,
+    void* aBuf,
+    int aBufSize,
+    int* aSize,
+    int* aErrorPos,
+    bool aRequirePadding)
+{
+    return Private::decode<Private::Rfc4648>(aBase32, aLength, (char*)aBuf,
+        aBufSize, aSize, aErrorPos, aRequirePadding);
+}
+
+// static
+bool
+HarbourBase32::isValidBase32(
+    const QString aBase32,
+    bool aRequirePadding)
+{
+    return Private::isValid(AlphabetRfc4648, aBase32.constData(), aBase32.length(),
+        aRequirePadding);
+}
+
+// static
+bool
+HarbourBase32::isValidBase32(
+    const QByteArray aBase32,
+    bool aRequirePadding)
+{
+    return Private::isValid(AlphabetRfc4648, aBase32.constData(), aBase32.size(),
+        aRequirePadding);
+}
+
+// static
+bool
+HarbourBase32::isValidBase32(
+    const char* aBase32,
+    bool aRequirePadding)
+{
+    return Private::isValid(AlphabetRfc4648, aBase32, aBase32 ? strlen(aBase32) : 0,
+        aRequirePadding);
+}
+
+// static
+bool
+HarbourBase32::isValidBase32(
+    const char* aBase32,
+    int aLength,
+    bool aRequirePadding)
+{
+    return Private::isValid(AlphabetRfc4648, aBase32, aLength, aRequirePadding);
+}
+
+// static
+QByteArray
+HarbourBase32::fromBase32(
+    const QString aBase32,
+    bool aRequirePadding)
+{
+    return Private::fromBase32(AlphabetRfc4648, aBase32.constData(), aBase32.length(),
+        aRequirePadding);
+}
+
+// static
+QByteArray
+HarbourBase32::fromBase32(
+    const QByteArray aBase32,
+    bool aRequirePadding)
+{
+    return Private::fromBase32(AlphabetRfc4648, aBase32.constData(), aBase32.size(),
+        aRequirePadding);
+}
+
+// static
+QByteArray
+HarbourBase32::fromBase32(
+    const char* aBase32,
+    bool aRequirePadding)
+{
+    return Private::fromBase32(AlphabetRfc4648, aBase32, aBase32 ? strlen(aBase32) : 0,
+        aRequirePadding);
+}
+
+// static
+QByteArray
+HarbourBase32::fromBase32(
+    const char* aBase32,
+    int aLength,
+    bool aRequirePadding)
+{
+    return Private::fromBase32(AlphabetRfc4648, aBase32, aLength, aRequirePadding);
+}
+
+// static
+QString
+HarbourBase32::toBase32(
+    const QByteArray aBinary,
+    bool aLowerCase)
+{
+    const EncodeOptions opts = aLowerCase ? EncodeLowerCase : EncodeDefault;
+
+    return toBase32(aBinary, opts);
+}
+
+// static
+QString
+HarbourBase32::toBase32(
+    const QByteArray aBinary,
+    EncodeOptions aOptions)
+{
+    return Private::toBase32(AlphabetRfc4648, aBinary, aOptions);
+}
+
+// static
+QString
+HarbourBase32::toBase32(
+    Alphabet aAlphabet,
+    const QByteArray aBinary,
+    EncodeOptions aOptions)
+{
+    return Private::toBase32(aAlphabet, aBinary, aOptions);
+}
+
+// static
+bool
+HarbourBase32::isValidBase32(
+    Alphabet aAlphabet,
+    const QString aBase32,
+    bool aRequirePadding)
+{
+    return Private::isValid(aAlphabet, aBase32.constData(), aBase32.length(),
+        aRequirePadding);
+}
+
+// static
+bool
+HarbourBase32::isValidBase32(
+    Alphabet aAlphabet,
+    const QByteArray aBase32,
+    bool aRequirePadding)
+{
+    return Private::isValid(aAlphabet, aBase32.constData(), aBase32.size(),
+        aRequirePadding);
+}
+
+// static
+bool
+HarbourBase32::isValidBase32(
+    Alphabet aAlphabet,
+    const char* aBase32,
+    bool aRequirePadding)
+{
+    return Private::isValid(aAlphabet, aBase32, aBase32 ? strlen(aBase32) : 0,
+        aRequirePadding);
+}
 
-class HarbourBase32::Private
+// static
+QByteArray
+HarbourBase32::fromBase32(
+    Alphabet aAlphabet,
+    const QString aBase32,
+    bool aRequirePadding)
 {
-public:
-    static char nibbleToBase32(int, char);
-    static int base32ToNibble(char);
-    static void appendChunk(QByteArray&, qint64, int);
-};
+    return Private::fromBase32(aAlphabet, aBase32.constData(),
+        aBase32.length(), aRequirePadding);
+}
 
 // static
-inline
-char
-HarbourBase32::Private::nibbleToBase32(
-    int aNibble,
-    char aBaseChar)
+QByteArray
+HarbourBase32::fromBase32(
+    Alphabet aAlphabet,
+    const QByteArray aBase32,
+    bool aRequirePadding)
 {
-    return (aNibble < 26) ? (aBaseChar + aNibble) : ('2' + (aNibble - 26));
+    return Private::fromBase32(aAlphabet, aBase32.constData(),
+        aBase32.size(), aRequirePadding);
 }
 
 // static
-inline
-int
-HarbourBase32::Private::base32ToNibble(
-    char aChar)
-{
-    if (aChar >= 'a' && aChar <= 'z') {
-        return aChar - 'a';
-    } else if (aChar >= 'A' && aChar <= 'Z') {
-        return aChar - 'A';
-    } else if (aChar >= '2' && aChar <= '7') {
-        return 26 + (aChar - '2');
-    } else {
-        return -1;
-    }
+QByteArray
+HarbourBase32::fromBase32(
+    Alphabet aAlphabet,
+    const char* aBase32,
+    bool aRequirePadding)
+{
+    return Private::fromBase32(aAlphabet, aBase32,
+        aBase32 ? strlen(aBase32) : 0, aRequirePadding);
 }
 
 // static
-void
-HarbourBase32::Private::appendChunk(
-    QByteArray& aOut,
-    qint64 aChunk,
-    int aNumBytes /* <= BASE32_BYTES_PER_CHUNK */)
+HarbourBase32::DecodeStatus
+HarbourBase32::decode(
+    Alphabet aAlphabet,
+    const QString aBase32,
+    void* aBuf,
+    int aBufSize,
+    int* aSize,
+    int* aErrorPos,
+    bool aRequirePadding)
 {
-    char bytes[BASE32_BYTES_PER_CHUNK];
+    return Private::decode(aAlphabet, aBase32.constData(), aBase32.length(),
+        (char*)aBuf, aBufSize, aSize, aErrorPos, aRequirePadding);
+}
 
-    // Most significant bytes first
-    for (int i = aNumBytes; i > 0; i--) {
-        bytes[i - 1] = (char) aChunk;
-        aChunk >>= 8;
-    }
-    aOut.append(bytes, aNumBytes);
+// static
+HarbourBase32::DecodeStatus
+HarbourBase32::decode(
+    Alphabet aAlphabet,
+    const char* aBase32,
+    int aLength,
+    void* aBuf,
+    int aBufSize,
+    int* aSize,
+    int* aErrorPos,
+    bool aRequirePadding)
+{
+    return Private::decode(aAlphabet, aBase32, aLength, (char*)aBuf,
+        aBufSize, aSize, aErrorPos, aRequirePadding);
 }
 
 // ==========================================================================
-// HarbourBase32
+// HarbourBase32::Encoder::Private
 // ==========================================================================
 
-// static
-bool
-HarbourBase32::isValidBase32(
-    const QString aBase32,
-    bool aRequirePadding)
+class HarbourBase32::Encoder::Private
 {
-    const int n = aBase32.length();
-    const QChar* chars = aBase32.constData();
-    qint64 buf = 0;
-    int i, nibbles = 0;
-    bool empty = true;
+public:
+    Private(EncodeOptions aOptions) :
+        iOptions(aOptions),
+        iPending(0)
+        {}
 
-    for (i = 0; i < n; i++) {
-        const QChar c = chars[i];
+    const EncodeOptions iOptions;
+    uchar iBuf[BASE32_BYTES_PER_CHUNK];
+    int iPending;
+};
 
-        if (!c.isSpace()) {
-            const char l = c.toLatin1();
+// ==========================================================================
+// HarbourBase32::Encoder
+// ==========================================================================
 
-            if (l == '=') {
-                break;
-            } else {
-                const int nibble = Private::base32ToNibble(l);
+HarbourBase32::Encoder::Encoder(
+    EncodeOptions aOptions) :
+    iPrivate(new Private(aOptions))
+{
+}
 
-                if (nibble < 0) {
-                    HDEBUG("Invalid BASE32 character" << c);
-                    return false;
-                }
-                nibbles++;
-                buf <<= BASE32_BITS_PER_NIBBLE;
-                buf += nibble;
-                empty = false;
-                if (nibbles == BASE32_NIBBLES_PER_CHUNK) {
-                    nibbles = 0;
-                    buf = 0;
-                }
-            }
+HarbourBase32::Encoder::~Encoder()
+{
+    delete iPrivate;
+}
+
+void
+HarbourBase32::Encoder::reset()
+{
+    iPrivate->iPending = 0;
+}
+
+void
+HarbourBase32::Encoder::encode(
+    const void* aData,
+    int aSize,
+    QByteArray* aOut)
+{
+    const uchar* ptr = (const uchar*)aData;
+    const uchar* end = ptr + qMax(aSize, 0);
+    const int pending = iPrivate->iPending;
+
+    if ((pending + (end - ptr)) < BASE32_BYTES_PER_CHUNK) {
+        // Not enough for a complete chunk
+        memcpy(iPrivate->iBuf + pending, ptr, end - ptr);
+        iPrivate->iPending += (end - ptr);
+    } else {
+        const int n = (pending + (end - ptr)) / BASE32_BYTES_PER_CHUNK;
+        const int size0 = aOut->size();
+
+        aOut->resize(size0 + n * BASE32_NIBBLES_PER_CHUNK);
+        char* out = aOut->data() + size0;
+
+        // Complete the pending chunk
+        if (pending) {
+            const int k = BASE32_BYTES_PER_CHUNK - pending;
+
+            memcpy(iPrivate->iBuf + pending, ptr, k);
+            out += HarbourBase32::Private::encode(AlphabetRfc4648,
+                iPrivate->iBuf, BASE32_BYTES_PER_CHUNK, out,
+                iPrivate->iOptions);
+            ptr += k;
         }
-    }
 
-    switch (nibbles) {
-    case 0:
-    case 2: // 1 byte (8 => 10 bits)
-    case 4: // 2 bytes (16 => 20 bits)
-    case 5: // 3 bytes (24 => 25 bits)
-    case 7: // 4 bytes (32 => 35 bits)
-        break;
-    default:
-        HDEBUG("Invalid BASE32 string" << aBase32);
-        return false;
+        // Then everything else
+        const int bulk = (end - ptr) - (end - ptr) % BASE32_BYTES_PER_CHUNK;
+
+        HarbourBase32::Private::encode(AlphabetRfc4648, ptr, bulk, out,
+            iPrivate->iOptions);
+        ptr += bulk;
+
+        // And keep the leftovers until the next time
+        memcpy(iPrivate->iBuf, ptr, end - ptr);
+        iPrivate->iPending = (end - ptr);
     }
+}
 
-    // [RFC 4648]
-    // When fewer than 40 input bits are available in an input group,
-    // bits with value zero are added (on the right) to form an integral
-    // number of 5-bit groups.
-    if (nibbles) {
-        int usedBytes = nibbles * BASE32_BITS_PER_NIBBLE / 8;
-        int unusedBits = nibbles * BASE32_BITS_PER_NIBBLE - usedBytes * 8;
-        if (buf & ((1 << unusedBits) - 1)) {
-            HDEBUG("Invalid BASE32 string" << aBase32);
-            return false;
-        }
+QByteArray
+HarbourBase32::Encoder::encode(
+    const QByteArray aData)
+{
+    QByteArray out;
+
+    encode(aData.constData(), aData.size(), &out);
+    return out;
+}
+
+void
+HarbourBase32::Encoder::finish(
+    QByteArray* aOut)
+{
+    if (iPrivate->iPending) {
+        const int size0 = aOut->size();
+
+        aOut->resize(size0 + BASE32_NIBBLES_PER_CHUNK);
+        aOut->resize(size0 + HarbourBase32::Private::encode(AlphabetRfc4648,
+            iPrivate->iBuf, iPrivate->iPending, aOut->data() + size0,
+            iPrivate->iOptions));
+        iPrivate->iPending = 0;
     }
+}
 
-    // Handle padding per RFC 4648
-    int padding = 0;
+QByteArray
+HarbourBase32::Encoder::finish()
+{
+    QByteArray out;
 
-    while (i < n) {
-        const QChar c = chars[i++];
+    finish(&out);
+    return out;
+}
 
-        if (c == '=') {
-            if (empty) {
-                HDEBUG("Unexpected BASE32 padding" << aBase32);
-                return false;
-            } else if ((nibbles + padding) == BASE32_NIBBLES_PER_CHUNK) {
-                // Too much padding
-                HDEBUG("Invalid BASE32 padding" << aBase32);
-                return false;
-            }
-            padding++;
-        } else if (!c.isSpace()) {
-            HDEBUG("Invalid BASE32 padding" << aBase32);
-            return false;
+// Returns zero only at the end of input. Sequential devices (sockets,
+// pipes and such) return zero when nothing has arrived yet, in which
+// case we block until more data arrives or the device says there's
+// no more coming. atEnd() doesn't help there, for a sequential device
+// it's true whenever there's nothing buffered.
+static
+qint64
+base32Read(
+    QIODevice* aIn,
+    char* aData,
+    qint64 aMaxSize)
+{
+    for (;;) {
+        const qint64 n = aIn->read(aData, aMaxSize);
+
+        if (n || !aIn->isSequential() || !aIn->waitForReadyRead(-1)) {
+            return n;
         }
     }
+}
+
+bool
+HarbourBase32::Encoder::encode(
+    QIODevice* aIn,
+    QIODevice* aOut)
+{
+    // Multiple of BASE32_BYTES_PER_CHUNK, so that nothing is carried over
+    const int chunk = 4096 * BASE32_BYTES_PER_CHUNK;
+    QByteArray in, out;
+    qint64 n;
 
-    if (padding) {
-        // If padding is there, it must be valid even if it wasn't required
-        if (!nibbles || (nibbles + padding) != BASE32_NIBBLES_PER_CHUNK) {
-            HDEBUG("Invalid BASE32 padding" << aBase32);
+    in.resize(chunk);
+    out.reserve(chunk / BASE32_BYTES_PER_CHUNK * BASE32_NIBBLES_PER_CHUNK +
+        BASE32_NIBBLES_PER_CHUNK);
+    while ((n = base32Read(aIn, in.data(), chunk)) > 0) {
+        out.resize(0);
+        encode(in.constData(), (int)n, &out);
+        if (aOut->write(out) != out.size()) {
+            HWARN("BASE32 write error");
+            reset();
             return false;
         }
-    } else if (nibbles && aRequirePadding) {
-        // The padding was required but it's missing
-        HDEBUG("Missing BASE32 padding" << aBase32);
+    }
+
+    out.resize(0);
+    finish(&out);
+    if (n < 0) {
+        HWARN("BASE32 read error");
         return false;
     }
+    return aOut->write(out) == out.size();
+}
+
+// ==========================================================================
+// HarbourBase32::Decoder::Private
+// ==========================================================================
+
+class HarbourBase32::Decoder::Private
+{
+public:
+    Private(bool aRequirePadding);
+
+    void reset();
+    template <typename C> bool decode(const C*, int, QByteArray*);
+
+public:
+    const bool iRequirePadding;
+    bool iFailed;
+    bool iHaveChunks;
+    qint64 iBuf;
+    int iNibbles;
+    int iPadding; // Negative until the first '=' is seen
+};
 
-    return !empty;
+HarbourBase32::Decoder::Private::Private(
+    bool aRequirePadding) :
+    iRequirePadding(aRequirePadding)
+{
+    reset();
 }
 
-// static
-QByteArray
-HarbourBase32::fromBase32(
-    const QString aBase32,
-    bool aRequirePadding)
+void
+HarbourBase32::Decoder::Private::reset()
 {
-    QByteArray out;
+    iFailed = false;
+    iHaveChunks = false;
+    iBuf = 0;
+    iNibbles = 0;
+    iPadding = -1;
+}
 
-    const int n = aBase32.length();
-    const QChar* chars = aBase32.constData();
+template <typename C>
+bool
+HarbourBase32::Decoder::Private::decode(
+    const C* aChars,
+    int aLength,
+    QByteArray* aOut)
+{
+    if (iFailed) {
+        return false;
+    }
 
-    qint64 buf = 0;
-    int i, nibbles = 0;
+    // Nibbles carried over from the previous call may complete a chunk
+    const int n = qMax(aLength, 0);
+    const int total = n + iNibbles;
+    const int size0 = aOut->size();
 
-    out.reserve((n * 5 + 7)/8);
+    aOut->resize(size0 + (total / BASE32_NIBBLES_PER_CHUNK) *
+        BASE32_BYTES_PER_CHUNK);
 
-    for (i = 0; i < n; i++) {
-        const QChar c = chars[i];
+    char* const start = aOut->data() + size0;
+    char* ptr = start;
+    int i = 0, simd = 0;
 
-        if (!c.isSpace()) {
-            const char l = c.toLatin1();
+    while (i < n && iPadding < 0) {
+        if (!iNibbles && i >= simd && (n - i) >= 16) {
+            const int k = HarbourBase32::Private::decodeBlocks(aChars + i,
+                n - i, ptr);
 
-            if (l == '=') {
+            ptr += (k / BASE32_NIBBLES_PER_CHUNK) * BASE32_BYTES_PER_CHUNK;
+            i += k;
+            simd = i + BASE32_NIBBLES_PER_CHUNK;
+            if (i == n) {
                 break;
+            }
+        }
+
+        const uint nibble = HarbourBase32::Private::lookup
+            <HarbourBase32::Private::Rfc4648>(aChars[i]);
+
+        if (nibble == HarbourBase32::Private::SKIP) {
+            i++;
+        } else if (nibble == HarbourBase32::Private::PAD) {
+            // Switch to padding, stay at the same character
+            iPadding = 0;
+        } else if (nibble == HarbourBase32::Private::INVALID) {
+            HDEBUG("Invalid BASE32 character at" << i);
+            iFailed = true;
+            break;
+        } else {
+            iNibbles++;
+            iBuf = (iBuf << BASE32_BITS_PER_NIBBLE) + nibble;
+            if (iNibbles == BASE32_NIBBLES_PER_CHUNK) {
+                ptr = HarbourBase32::Private::storeChunk(ptr, iBuf,
+                    BASE32_BYTES_PER_CHUNK);
+                iNibbles = 0;
+                iBuf = 0;
+            }
+            i++;
+        }
+    }
+
+    if (ptr > start) {
+        iHaveChunks = true;
+    }
+
+    // Handle padding per RFC 4648
+    while (i < n && !iFailed) {
+        const uint c = HarbourBase32::Private::lookup
+            <HarbourBase32::Private::Rfc4648>(aChars[i++]);
+
+        if (c == HarbourBase32::Private::PAD) {
+            if (!iHaveChunks && !iNibbles) {
+                HDEBUG("Unexpected BASE32 padding");
+                iFailed = true;
+            } else if ((iNibbles + iPadding) == BASE32_NIBBLES_PER_CHUNK) {
+                // Too much padding
+                HDEBUG("Invalid BASE32 padding");
+                iFailed = true;
             } else {
-                const int nibble = Private::base32ToNibble(l);
-
-                if (nibble < 0) {
-                    HDEBUG("Invalid BASE32 character" << c);
-                    return QByteArray();
-                } else {
-                    nibbles++;
-                    buf <<= BASE32_BITS_PER_NIBBLE;
-                    buf += nibble;
-                    if (nibbles == BASE32_NIBBLES_PER_CHUNK) {
-                        Private::appendChunk(out, buf, BASE32_BYTES_PER_CHUNK);
-                        nibbles = 0;
-                        buf = 0;
-                    }
-                }
+                iPadding++;
             }
+        } else if (c != HarbourBase32::Private::SKIP) {
+            HDEBUG("Invalid BASE32 padding");
+            iFailed = true;
         }
     }
 
+    aOut->resize(size0 + (ptr - start));
+    return !iFailed;
+}
+
+// ==========================================================================
+// HarbourBase32::Decoder
+// ==========================================================================
+
+HarbourBase32::Decoder::Decoder(
+    bool aRequirePadding) :
+    iPrivate(new Private(aRequirePadding))
+{
+}
+
+HarbourBase32::Decoder::~Decoder()
+{
+    delete iPrivate;
+}
+
+void
+HarbourBase32::Decoder::reset()
+{
+    iPrivate->reset();
+}
+
+bool
+HarbourBase32::Decoder::decode(
+    const char* aChars,
+    int aLength,
+    QByteArray* aOut)
+{
+    return iPrivate->decode(aChars, aLength, aOut);
+}
+
+bool
+HarbourBase32::Decoder::decode(
+    const QByteArray aChars,
+    QByteArray* aOut)
+{
+    return iPrivate->decode(aChars.constData(), aChars.size(), aOut);
+}
+
+bool
+HarbourBase32::Decoder::decode(
+    const QString aChars,
+    QByteArray* aOut)
+{
+    return iPrivate->decode(aChars.constData(), aChars.length(), aOut);
+}
+
+bool
+HarbourBase32::Decoder::finish(
+    QByteArray* aOut)
+{
+    Private* priv = iPrivate;
+    const int nibbles = priv->iNibbles;
+    const int padding = qMax(priv->iPadding, 0);
+    bool ok = !priv->iFailed;
+
     switch (nibbles) {
     case 0:
     case 2: // 1 byte (8 => 10 bits)
@@ -261,117 +1757,62 @@ HarbourBase32::fromBase32(
     case 7: // 4 bytes (32 => 35 bits)
         break;
     default:
-        HDEBUG("Invalid BASE32 string" << aBase32);
-        return QByteArray();
+        HDEBUG("Invalid BASE32 string");
+        ok = false;
+        break;
     }
 
     const int usedBytes = nibbles * BASE32_BITS_PER_NIBBLE / 8;
     const int unusedBits = nibbles * BASE32_BITS_PER_NIBBLE - usedBytes * 8;
 
-    // [RFC 4648]
-    // When fewer than 40 input bits are available in an input group,
-    // bits with value zero are added (on the right) to form an integral
-    // number of 5-bit groups.
-    if (buf & ((1 << unusedBits) - 1)) {
-        HDEBUG("Invalid BASE32 string" << aBase32);
-        return QByteArray();
+    if (ok && (priv->iBuf & ((1 << unusedBits) - 1))) {
+        HDEBUG("Invalid BASE32 string");
+        ok = false;
+    } else if (ok && padding && (!nibbles ||
+        (nibbles + padding) != BASE32_NIBBLES_PER_CHUNK)) {
+        HDEBUG("Invalid BASE32 padding");
+        ok = false;
+    } else if (ok && !padding && nibbles && priv->iRequirePadding) {
+        HDEBUG("Missing BASE32 padding");
+        ok = false;
     }
 
-    // Handle padding per RFC 4648
-    int padding = 0;
-
-    while (i < n) {
-        const QChar c = chars[i++];
-
-        if (c == '=') {
-            if (out.isEmpty() && !nibbles) {
-                HDEBUG("Unexpected BASE32 padding" << aBase32);
-                return QByteArray();
-            } else if ((nibbles + padding) == BASE32_NIBBLES_PER_CHUNK) {
-                // Too much padding
-                HDEBUG("Invalid BASE32 padding" << aBase32);
-                return QByteArray();
-            }
-            padding++;
-        } else if (!c.isSpace()) {
-            HDEBUG("Invalid BASE32 padding" << aBase32);
-            return QByteArray();
-        }
-    }
+    if (ok && usedBytes) {
+        const int size0 = aOut->size();
 
-    if (padding) {
-        // If padding is there, it must be valid even if it wasn't required
-        if ((nibbles + padding) % BASE32_NIBBLES_PER_CHUNK) {
-            HDEBUG("Invalid BASE32 padding" << aBase32);
-            return QByteArray();
-        }
-    } else if (nibbles && aRequirePadding) {
-        // The padding was required but it's missing
-        HDEBUG("Missing BASE32 padding" << aBase32);
-        return QByteArray();
+        aOut->resize(size0 + usedBytes);
+        HarbourBase32::Private::storeChunk(aOut->data() + size0,
+            priv->iBuf >> unusedBits, usedBytes);
     }
-
-    Private::appendChunk(out, buf >> unusedBits, usedBytes);
-    return out;
-}
-
-// static
-QString
-HarbourBase32::toBase32(
-    const QByteArray aBinary,
-    bool aLowerCase)
-{
-    const EncodeOptions opts = aLowerCase ? EncodeLowerCase : EncodeDefault;
-
-    return toBase32(aBinary, opts);
+    priv->reset();
+    return ok;
 }
 
-// static
-QString
-HarbourBase32::toBase32(
-    const QByteArray aBinary,
-    EncodeOptions aOptions)
+bool
+HarbourBase32::Decoder::decode(
+    QIODevice* aIn,
+    QIODevice* aOut)
 {
-    QString str;
-    const int n = aBinary.size();
-    const uchar* ptr = (uchar*)aBinary.constData();
-    char base32[BASE32_NIBBLES_PER_CHUNK + 1];
-    const char a = (aOptions & EncodeLowerCase) ? 'a' : 'A';
-    quint64 chunk = 0;
-    int i, k, bits = 0;
+    const int chunk = 8192 * BASE32_NIBBLES_PER_CHUNK;
+    QByteArray in, out;
+    qint64 n;
 
-    base32[BASE32_NIBBLES_PER_CHUNK] = 0;
-    for (i = 0; i < n; i++) {
-        chunk <<= 8;
-        chunk |= *ptr++;
-        bits += 8;
-        if (bits == BASE32_BITS_PER_CHUNK) {
-            for (k = BASE32_NIBBLES_PER_CHUNK; k > 0; k--) {
-                const int nibble = chunk & BASE32_NIBBLE_MASK;
-                base32[k - 1] = Private::nibbleToBase32(nibble, a);
-                chunk >>= BASE32_BITS_PER_NIBBLE;
-            }
-            str.append(base32);
-            bits = 0;
+    in.resize(chunk);
+    out.reserve(chunk / BASE32_NIBBLES_PER_CHUNK * BASE32_BYTES_PER_CHUNK +
+        BASE32_BYTES_PER_CHUNK);
+    while ((n = base32Read(aIn, in.data(), chunk)) > 0) {
+        out.resize(0);
+        if (!decode(in.constData(), (int)n, &out) ||
+            aOut->write(out) != out.size()) {
+            reset();
+            return false;
         }
     }
-    // Add padding per RFC 4648
-    if (bits) {
-        const int outnibbles = (bits + BASE32_BITS_PER_NIBBLE - 1) /
-            BASE32_BITS_PER_NIBBLE;
 
-        chunk <<= (outnibbles * BASE32_BITS_PER_NIBBLE - bits);
-        k = BASE32_NIBBLES_PER_CHUNK;
-        while (k > outnibbles) {
-            base32[--k] = (aOptions & EncodeNoPadding) ? '\0' : '=';
-        }
-        while (k > 0) {
-            const int nibble = chunk & BASE32_NIBBLE_MASK;
-
-            base32[--k] = Private::nibbleToBase32(nibble, a);
-            chunk >>= BASE32_BITS_PER_NIBBLE;
-        }
-        str.append(base32);
+    out.resize(0);
+    if (finish(&out) && n == 0) {
+        return aOut->write(out) == out.size();
+    } else {
+        return false;
     }
-    return str;
 }
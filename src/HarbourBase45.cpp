@@ -1,6 +1,6 @@
 /*
  * Copyright (C) 2021-2022 Jolla Ltd.
- * Copyright (C) 2021-2022 Slava Monich <slava.monich@jolla.com>
+ * Copyright (C) 2021-2026 Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -34,6 +34,401 @@
 #include "HarbourBase45.h"
 
 #include "HarbourDebug.h"
+#include "HarbourSimd.h"
+
+#include <string.h>
+
+// x / 45 == (x * 11651) >> 19 for any 16-bit x (verified exhaustively),
+// the vector code does the same thing with a 16-bit "multiply high" and
+// a shift by 3.
+#define BASE45_DIV_MUL (11651)
+#define BASE45_DIV_SHIFT (19)
+#define BASE45_DIV(x) (((x) * BASE45_DIV_MUL) >> BASE45_DIV_SHIFT)
+
+// ==========================================================================
+// Vector kernels
+//
+// Encoders convert 16 bytes (8 words) into 24 characters per step,
+// decoders go the other way. Loads and stores never go past the data
+// being converted. Decoders stop at the first block that contains
+// anything suspicious and let the scalar code figure out what's wrong
+// with it.
+// ==========================================================================
+
+#if HARBOUR_SIMD_X86 || HARBOUR_SIMD_NEON
+
+// Character values plus one (zero meaning invalid) for 0x20..0x3f,
+// letters are handled separately
+static const uchar base45Values[32] = {
+    37,  0,  0,  0, 38, 39,  0,  0,  0,  0, 40, 41,  0, 42, 43, 44,
+     1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 45,  0,  0,  0,  0,  0
+};
+
+// Characters for values 36..44
+static const uchar base45Specials[16] = {
+    ' ', '$', '%', '*', '+', '-', '.', '/', ':', 0, 0, 0, 0, 0, 0, 0
+};
+
+#endif
+
+#if HARBOUR_SIMD_X86
+
+HARBOUR_TARGET("ssse3")
+static inline
+__m128i
+base45CharsSsse3(
+    __m128i aValues)
+{
+    // 0..9 => digits, 10..35 => letters, 36..44 => the rest
+    const __m128i special = _mm_cmpgt_epi8(aValues, _mm_set1_epi8(35));
+    const __m128i s = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)
+        base45Specials), _mm_sub_epi8(aValues, _mm_set1_epi8(36)));
+    const __m128i c = _mm_add_epi8(_mm_add_epi8(aValues, _mm_set1_epi8('0')),
+        _mm_and_si128(_mm_cmpgt_epi8(aValues, _mm_set1_epi8(9)),
+        _mm_set1_epi8('A' - '0' - 10)));
+
+    return _mm_or_si128(_mm_andnot_si128(special, c),
+        _mm_and_si128(special, s));
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+__m128i
+base45Div45Ssse3(
+    __m128i aWords)
+{
+    return _mm_srli_epi16(_mm_mulhi_epu16(aWords,
+        _mm_set1_epi16(BASE45_DIV_MUL)), BASE45_DIV_SHIFT - 16);
+}
+
+HARBOUR_TARGET("ssse3")
+static
+int
+base45EncodeBlocksSsse3(
+    const uchar* aIn,
+    int aSize,
+    QChar* aOut)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i base = _mm_set1_epi16(45);
+    const __m128i swap = _mm_setr_epi8(1,0, 3,2, 5,4, 7,6,
+        9,8, 11,10, 13,12, 15,14);
+    const __m128i cd0 = _mm_setr_epi8(0,8,-1, 1,9,-1, 2,10,-1, 3,11,-1,
+        4,12,-1, 5);
+    const __m128i ee0 = _mm_setr_epi8(-1,-1,0, -1,-1,1, -1,-1,2, -1,-1,3,
+        -1,-1,4, -1);
+    const __m128i cd1 = _mm_setr_epi8(13,-1, 6,14,-1, 7,15,-1,
+        -1,-1,-1,-1,-1,-1,-1,-1);
+    const __m128i ee1 = _mm_setr_epi8(-1,5, -1,-1,6, -1,-1,7,
+        -1,-1,-1,-1,-1,-1,-1,-1);
+    __m128i* out = (__m128i*)aOut;
+    int i = 0;
+
+    for (; (aSize - i) >= 16; i += 16, out += 3) {
+        // Each word n becomes c + d*45 + e*45*45
+        const __m128i n = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)
+            (aIn + i)), swap);
+        const __m128i q = base45Div45Ssse3(n);
+        const __m128i e = base45Div45Ssse3(q);
+        const __m128i c = _mm_sub_epi16(n, _mm_mullo_epi16(q, base));
+        const __m128i d = _mm_sub_epi16(q, _mm_mullo_epi16(e, base));
+        const __m128i cd = base45CharsSsse3(_mm_packus_epi16(c, d));
+        const __m128i ee = base45CharsSsse3(_mm_packus_epi16(e, e));
+
+        // Interleave c0 d0 e0 c1 d1 e1 ...
+        const __m128i a = _mm_or_si128(_mm_shuffle_epi8(cd, cd0),
+            _mm_shuffle_epi8(ee, ee0));
+        const __m128i b = _mm_or_si128(_mm_shuffle_epi8(cd, cd1),
+            _mm_shuffle_epi8(ee, ee1));
+
+        _mm_storeu_si128(out, _mm_unpacklo_epi8(a, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(a, zero));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi8(b, zero));
+    }
+    return i;
+}
+
+// Returns character values plus one, zero for invalid characters
+HARBOUR_TARGET("ssse3")
+static inline
+__m128i
+base45ValuesSsse3(
+    __m128i aChars)
+{
+    const __m128i x = _mm_sub_epi8(aChars, _mm_set1_epi8(0x20));
+    const __m128i y = _mm_sub_epi8(x, _mm_set1_epi8(16));
+    const __m128i z = _mm_sub_epi8(aChars, _mm_set1_epi8('A'));
+    const __m128i f = _mm_set1_epi8(15);
+    const __m128i lo = _mm_and_si128(_mm_cmpeq_epi8(_mm_min_epu8(x, f), x),
+        _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)base45Values), x));
+    const __m128i hi = _mm_and_si128(_mm_cmpeq_epi8(_mm_min_epu8(y, f), y),
+        _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)
+        (base45Values + 16)), y));
+    const __m128i letter = _mm_and_si128(_mm_cmpeq_epi8(_mm_min_epu8(z,
+        _mm_set1_epi8(25)), z), _mm_add_epi8(z, _mm_set1_epi8(11)));
+
+    return _mm_or_si128(_mm_or_si128(lo, hi), letter);
+}
+
+// 24 characters are passed in as 16 + 8 bytes
+HARBOUR_TARGET("ssse3")
+static inline
+bool
+base45DecodeSsse3(
+    __m128i aChars0,
+    __m128i aChars1,
+    uchar* aOut)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i v0 = base45ValuesSsse3(aChars0);
+    const __m128i v1 = base45ValuesSsse3(aChars1);
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(v0, zero)) ||
+        (_mm_movemask_epi8(_mm_cmpeq_epi8(v1, zero)) & 0xff)) {
+        return false;
+    }
+
+    // Gather c, d and e into 16-bit lanes
+    const __m128i a = _mm_sub_epi8(v0, one);
+    const __m128i b = _mm_sub_epi8(v1, one);
+    const __m128i c = _mm_or_si128(_mm_shuffle_epi8(a,
+        _mm_setr_epi8(0,-1, 3,-1, 6,-1, 9,-1, 12,-1, 15,-1, -1,-1, -1,-1)),
+        _mm_shuffle_epi8(b,
+        _mm_setr_epi8(-1,-1, -1,-1, -1,-1, -1,-1, -1,-1, -1,-1, 2,-1, 5,-1)));
+    const __m128i d = _mm_or_si128(_mm_shuffle_epi8(a,
+        _mm_setr_epi8(1,-1, 4,-1, 7,-1, 10,-1, 13,-1, -1,-1, -1,-1, -1,-1)),
+        _mm_shuffle_epi8(b,
+        _mm_setr_epi8(-1,-1, -1,-1, -1,-1, -1,-1, -1,-1, 0,-1, 3,-1, 6,-1)));
+    const __m128i e = _mm_or_si128(_mm_shuffle_epi8(a,
+        _mm_setr_epi8(2,-1, 5,-1, 8,-1, 11,-1, 14,-1, -1,-1, -1,-1, -1,-1)),
+        _mm_shuffle_epi8(b,
+        _mm_setr_epi8(-1,-1, -1,-1, -1,-1, -1,-1, -1,-1, 1,-1, 4,-1, 7,-1)));
+
+    // c + d*45 is at most 2024, e*45*45 fits into 16 bits if e <= 32.
+    // The sum exceeds 0xffff if the 16-bit addition wraps around.
+    const __m128i sign = _mm_set1_epi16((short)0x8000);
+    const __m128i lo = _mm_add_epi16(c, _mm_mullo_epi16(d,
+        _mm_set1_epi16(45)));
+    const __m128i hi = _mm_mullo_epi16(e, _mm_set1_epi16(45 * 45));
+    const __m128i n = _mm_add_epi16(lo, hi);
+    const __m128i bad = _mm_or_si128(_mm_cmpgt_epi16(e, _mm_set1_epi16(32)),
+        _mm_cmpgt_epi16(_mm_xor_si128(hi, sign), _mm_xor_si128(n, sign)));
+
+    if (_mm_movemask_epi8(bad)) {
+        return false;
+    }
+    if (aOut) {
+        // Most significant bytes first
+        _mm_storeu_si128((__m128i*)aOut, _mm_shuffle_epi8(n,
+            _mm_setr_epi8(1,0, 3,2, 5,4, 7,6, 9,8, 11,10, 13,12, 15,14)));
+    }
+    return true;
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+bool
+base45DecodeSsse3(
+    const char* aIn,
+    uchar* aOut)
+{
+    return base45DecodeSsse3(_mm_loadu_si128((const __m128i*)aIn),
+        _mm_loadl_epi64((const __m128i*)(aIn + 16)), aOut);
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+bool
+base45DecodeSsse3(
+    const QChar* aIn,
+    uchar* aOut)
+{
+    // Anything outside of Latin-1 becomes 0x00 or 0xff, both invalid
+    const __m128i* in = (const __m128i*)aIn;
+
+    return base45DecodeSsse3(_mm_packus_epi16(_mm_loadu_si128(in),
+        _mm_loadu_si128(in + 1)), _mm_packus_epi16(_mm_loadu_si128(in + 2),
+        _mm_setzero_si128()), aOut);
+}
+
+template <typename C>
+HARBOUR_TARGET("ssse3")
+static
+int
+base45DecodeBlocksSsse3(
+    const C* aIn,
+    int aLength,
+    uchar* aOut)
+{
+    int i = 0;
+
+    while ((aLength - i) >= 24 && base45DecodeSsse3(aIn + i, aOut)) {
+        if (aOut) aOut += 16;
+        i += 24;
+    }
+    return i;
+}
+
+#endif // HARBOUR_SIMD_X86
+
+#if HARBOUR_SIMD_NEON
+
+static inline
+uint8x8_t
+base45CharsNeon(
+    uint16x8_t aValues)
+{
+    uint8x8x2_t t;
+
+    t.val[0] = vld1_u8(base45Specials);
+    t.val[1] = vld1_u8(base45Specials + 8);
+
+    // 0..9 => digits, 10..35 => letters, 36..44 => the rest
+    const uint8x8_t v = vmovn_u16(aValues);
+    const uint8x8_t c = vadd_u8(vadd_u8(v, vdup_n_u8('0')),
+        vand_u8(vcgt_u8(v, vdup_n_u8(9)), vdup_n_u8('A' - '0' - 10)));
+
+    return vbsl_u8(vcgt_u8(v, vdup_n_u8(35)),
+        vtbl2_u8(t, vsub_u8(v, vdup_n_u8(36))), c);
+}
+
+static inline
+uint16x8_t
+base45Div45Neon(
+    uint16x8_t aWords)
+{
+    const uint16x4_t k = vdup_n_u16(BASE45_DIV_MUL);
+
+    return vshrq_n_u16(vcombine_u16(
+        vshrn_n_u32(vmull_u16(vget_low_u16(aWords), k), 16),
+        vshrn_n_u32(vmull_u16(vget_high_u16(aWords), k), 16)),
+        BASE45_DIV_SHIFT - 16);
+}
+
+static
+int
+base45EncodeBlocksNeon(
+    const uchar* aIn,
+    int aSize,
+    QChar* aOut)
+{
+    ushort* out = (ushort*)aOut;
+    int i = 0;
+
+    for (; (aSize - i) >= 16; i += 16, out += 24) {
+        // Each word n becomes c + d*45 + e*45*45
+        const uint16x8_t n = vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(aIn + i)));
+        const uint16x8_t q = base45Div45Neon(n);
+        const uint16x8_t e = base45Div45Neon(q);
+        uint16x8x3_t t;
+
+        t.val[0] = vmovl_u8(base45CharsNeon(vmlsq_n_u16(n, q, 45)));
+        t.val[1] = vmovl_u8(base45CharsNeon(vmlsq_n_u16(q, e, 45)));
+        t.val[2] = vmovl_u8(base45CharsNeon(e));
+        vst3q_u16(out, t);
+    }
+    return i;
+}
+
+// Returns character values plus one, zero for invalid characters
+static inline
+uint8x8_t
+base45ValuesNeon(
+    uint8x8_t aChars)
+{
+    uint8x8x4_t t;
+
+    t.val[0] = vld1_u8(base45Values);
+    t.val[1] = vld1_u8(base45Values + 8);
+    t.val[2] = vld1_u8(base45Values + 16);
+    t.val[3] = vld1_u8(base45Values + 24);
+
+    const uint8x8_t z = vsub_u8(aChars, vdup_n_u8('A'));
+    const uint8x8_t letter = vand_u8(vclt_u8(z, vdup_n_u8(26)),
+        vadd_u8(z, vdup_n_u8(11)));
+
+    return vorr_u8(vtbl4_u8(t, vsub_u8(aChars, vdup_n_u8(0x20))), letter);
+}
+
+static inline
+bool
+base45DecodeNeon(
+    uint8x8x3_t aChars,
+    uchar* aOut)
+{
+    const uint8x8_t c1 = base45ValuesNeon(aChars.val[0]);
+    const uint8x8_t d1 = base45ValuesNeon(aChars.val[1]);
+    const uint8x8_t e1 = base45ValuesNeon(aChars.val[2]);
+    const uint8x8_t zero = vceq_u8(vmin_u8(vmin_u8(c1, d1), e1), vdup_n_u8(0));
+
+    if (vget_lane_u64(vreinterpret_u64_u8(zero), 0)) {
+        return false;
+    }
+
+    // c + d*45 is at most 2024, e*45*45 fits into 16 bits if e <= 32.
+    // The sum exceeds 0xffff if the 16-bit addition wraps around.
+    const uint8x8_t one = vdup_n_u8(1);
+    const uint8x8_t e = vsub_u8(e1, one);
+    const uint16x8_t lo = vmlaq_n_u16(vmovl_u8(vsub_u8(c1, one)),
+        vmovl_u8(vsub_u8(d1, one)), 45);
+    const uint16x8_t hi = vmulq_n_u16(vmovl_u8(e), 45 * 45);
+    const uint16x8_t n = vaddq_u16(lo, hi);
+    const uint8x8_t bad = vorr_u8(vcgt_u8(e, vdup_n_u8(32)),
+        vmovn_u16(vcltq_u16(n, hi)));
+
+    if (vget_lane_u64(vreinterpret_u64_u8(bad), 0)) {
+        return false;
+    }
+    if (aOut) {
+        // Most significant bytes first
+        vst1q_u8(aOut, vrev16q_u8(vreinterpretq_u8_u16(n)));
+    }
+    return true;
+}
+
+static inline
+uint8x8x3_t
+base45LoadNeon(
+    const char* aIn)
+{
+    return vld3_u8((const uchar*)aIn);
+}
+
+static inline
+uint8x8x3_t
+base45LoadNeon(
+    const QChar* aIn)
+{
+    // Anything outside of Latin-1 becomes 0xff which is invalid
+    const uint16x8x3_t w = vld3q_u16((const ushort*)aIn);
+    uint8x8x3_t t;
+
+    t.val[0] = vqmovn_u16(w.val[0]);
+    t.val[1] = vqmovn_u16(w.val[1]);
+    t.val[2] = vqmovn_u16(w.val[2]);
+    return t;
+}
+
+template <typename C>
+static
+int
+base45DecodeBlocksNeon(
+    const C* aIn,
+    int aLength,
+    uchar* aOut)
+{
+    int i = 0;
+
+    while ((aLength - i) >= 24 &&
+        base45DecodeNeon(base45LoadNeon(aIn + i), aOut)) {
+        if (aOut) aOut += 16;
+        i += 24;
+    }
+    return i;
+}
+
+#endif // HARBOUR_SIMD_NEON
 
 // ==========================================================================
 // HarbourBase45::Private
@@ -50,6 +445,16 @@ public:
     static const char mapBase45[BASE];
     static const int reverseMapBase45[REVERSE_MAP_SIZE];
     static bool isValidChar(uint);
+    static uint code(QChar aChar) { return aChar.unicode(); }
+    static uint code(char aChar) { return (uchar)aChar; }
+
+    static int encodeBlocks(const uchar*, int, QChar*);
+    template <typename C> static int decodeBlocks(const C*, int, uchar*);
+    static void encode(const uchar*, int, QChar*);
+    template <typename C>
+    static int decode(const C*, int, uchar*, int, int*);
+    template <typename C>
+    static QByteArray fromBase45(const C*, int);
 };
 
 const char HarbourBase45::Private::mapBase45[HarbourBase45::Private::BASE] = {
@@ -85,131 +490,305 @@ HarbourBase45::Private::isValidChar(
         Private::reverseMapBase45[aChar] >= 0;
 }
 
+// Converts as many whole 16-byte blocks as the vector code can handle,
+// returns the number of bytes consumed
+inline
+int
+HarbourBase45::Private::encodeBlocks(
+    const uchar* aIn,
+    int aSize,
+    QChar* aOut)
+{
+#if HARBOUR_SIMD_X86
+    if (HarbourSimd::has(HarbourSimd::SSSE3)) {
+        return base45EncodeBlocksSsse3(aIn, aSize, aOut);
+    }
+#elif HARBOUR_SIMD_NEON
+    return base45EncodeBlocksNeon(aIn, aSize, aOut);
+#endif
+    return 0;
+}
+
+// Decodes as many 24-character blocks as the vector code can handle
+// (or validates them if the output buffer is NULL), stops at anything
+// unusual. Returns the number of characters consumed.
+template <typename C>
+inline
+int
+HarbourBase45::Private::decodeBlocks(
+    const C* aIn,
+    int aLength,
+    uchar* aOut)
+{
+#if HARBOUR_SIMD_X86
+    if (HarbourSimd::has(HarbourSimd::SSSE3)) {
+        return base45DecodeBlocksSsse3(aIn, aLength, aOut);
+    }
+#elif HARBOUR_SIMD_NEON
+    return base45DecodeBlocksNeon(aIn, aLength, aOut);
+#endif
+    return 0;
+}
+
+// The output buffer must be large enough, which is 3 characters
+// per 2 bytes plus 2 characters for the odd byte
+void
+HarbourBase45::Private::encode(
+    const uchar* aIn,
+    int aSize,
+    QChar* aOut)
+{
+    int i = encodeBlocks(aIn, aSize, aOut);
+    QChar* out = aOut + i / 2 * 3;
+
+    // The scalar code takes care of the rest
+    for (; (i + 1) < aSize; i += 2) {
+        const uint n = ((uint)aIn[i] << 8) | aIn[i + 1];
+        const uint q = BASE45_DIV(n);
+        const uint e = BASE45_DIV(q);
+
+        *out++ = QChar::fromLatin1(mapBase45[n - q * BASE]);
+        *out++ = QChar::fromLatin1(mapBase45[q - e * BASE]);
+        *out++ = QChar::fromLatin1(mapBase45[e]);
+    }
+    if (i < aSize) {
+        const uint n = aIn[i];
+        const uint q = BASE45_DIV(n);
+
+        *out++ = QChar::fromLatin1(mapBase45[n - q * BASE]);
+        *out++ = QChar::fromLatin1(mapBase45[q]);
+    }
+}
+
+// Decodes (or only validates, if the output buffer is NULL) the input
+// in one pass. Returns the decoded size or -1 on failure.
+template <typename C>
+int
+HarbourBase45::Private::decode(
+    const C* aChars,
+    int aLength,
+    uchar* aOut,
+    int aOutSize,
+    int* aErrorPos)
+{
+    const int size = decodedSize(aLength);
+
+    if (size < 0) {
+        // Dangling character at the end
+        if (aErrorPos) *aErrorPos = aLength - 1;
+        return -1;
+    } else if (aOut && aOutSize < size) {
+        if (aErrorPos) *aErrorPos = -1;
+        return -1;
+    }
+
+    // Let the vector code go first. If it stops before the end of
+    // the input, the scalar code finds out what exactly went wrong.
+    int i = decodeBlocks(aChars, aLength - aLength % 3, aOut);
+    uchar* out = aOut ? (aOut + i / 3 * 2) : Q_NULLPTR;
+
+    while ((i + 2) < aLength) {
+        const uint c = code(aChars[i]);
+        const uint d = code(aChars[i + 1]);
+        const uint e = code(aChars[i + 2]);
+
+        if (!isValidChar(c) || !isValidChar(d) || !isValidChar(e)) {
+            if (aErrorPos) *aErrorPos = i;
+            return -1;
+        }
+        const uint n = reverseMapBase45[c] +
+            reverseMapBase45[d] * BASE +
+            reverseMapBase45[e] * BASE2;
+        if (n > 0xffff) {
+            if (aErrorPos) *aErrorPos = i;
+            return -1;
+        }
+        if (out) {
+            *out++ = (uchar)(n >> 8);
+            *out++ = (uchar)n;
+        }
+        i += 3;
+    }
+
+    if (i < aLength) {
+        const uint c = code(aChars[i]);
+        const uint d = code(aChars[i + 1]);
+
+        if (!isValidChar(c) || !isValidChar(d)) {
+            if (aErrorPos) *aErrorPos = i;
+            return -1;
+        }
+        const uint a = reverseMapBase45[c] + reverseMapBase45[d] * BASE;
+        if (a > 0xff) {
+            if (aErrorPos) *aErrorPos = i;
+            return -1;
+        }
+        if (out) {
+            *out++ = (uchar)a;
+        }
+    }
+
+    if (aErrorPos) *aErrorPos = -1;
+    return size;
+}
+
+template <typename C>
+QByteArray
+HarbourBase45::Private::fromBase45(
+    const C* aChars,
+    int aLength)
+{
+    const int size = decodedSize(aLength);
+
+    if (size > 0) {
+        QByteArray out;
+
+        out.resize(size);
+        if (decode(aChars, aLength, (uchar*)out.data(), size, Q_NULLPTR) == size) {
+            return out;
+        }
+    }
+    return QByteArray();
+}
+
 // ==========================================================================
-// HarbourBase45::Private
+// HarbourBase45
 // ==========================================================================
 
+// static
+int
+HarbourBase45::decodedSize(
+    int aLength)
+{
+    // Every 3 characters produce 2 bytes, 2 remaining characters
+    // produce 1 byte and a single remaining character is invalid
+    const int tail = aLength % 3;
+
+    return (aLength >= 0 && tail != 1) ? (aLength / 3 * 2 + tail / 2) : -1;
+}
+
+// static
+int
+HarbourBase45::decode(
+    const QString aBase45,
+    void* aBuf,
+    int aBufSize,
+    int* aErrorPos)
+{
+    return Private::decode(aBase45.constData(), aBase45.length(),
+        (uchar*)aBuf, aBufSize, aErrorPos);
+}
+
+// static
+int
+HarbourBase45::decode(
+    const QByteArray aBase45,
+    void* aBuf,
+    int aBufSize,
+    int* aErrorPos)
+{
+    return Private::decode(aBase45.constData(), aBase45.size(),
+        (uchar*)aBuf, aBufSize, aErrorPos);
+}
+
+// static
+int
+HarbourBase45::decode(
+    const char* aBase45,
+    int aLength,
+    void* aBuf,
+    int aBufSize,
+    int* aErrorPos)
+{
+    return Private::decode(aBase45, aLength, (uchar*)aBuf, aBufSize,
+        aErrorPos);
+}
+
+// static
+int
+HarbourBase45::decode(
+    const QChar* aBase45,
+    int aLength,
+    void* aBuf,
+    int aBufSize,
+    int* aErrorPos)
+{
+    return Private::decode(aBase45, aLength, (uchar*)aBuf, aBufSize,
+        aErrorPos);
+}
+
 bool
 HarbourBase45::isValidBase45(
     const QString aBase45)
 {
-    const int len = aBase45.length();
-
-    if (!((len % 3) % 2)) {
-        const QChar* chars = aBase45.constData();
-        int i = 0;
-
-        while ((i + 2) < len) {
-            const uint c = chars[i++].unicode();
-            const uint d = chars[i++].unicode();
-            const uint e = chars[i++].unicode();
-
-            if (!Private::isValidChar(c) ||
-                !Private::isValidChar(d) ||
-                !Private::isValidChar(e) ||
-                (Private::reverseMapBase45[c] +
-                 Private::reverseMapBase45[d] * Private::BASE +
-                 Private::reverseMapBase45[e] * Private::BASE2) > 0xffff) {
-                return false;
-            }
-        }
+    return Private::decode(aBase45.constData(), aBase45.length(),
+        Q_NULLPTR, 0, Q_NULLPTR) >= 0;
+}
 
-        if (i < len) {
-            const uint c = chars[i++].unicode();
-            const uint d = chars[i++].unicode();
+bool
+HarbourBase45::isValidBase45(
+    const QByteArray aBase45)
+{
+    return Private::decode(aBase45.constData(), aBase45.size(),
+        Q_NULLPTR, 0, Q_NULLPTR) >= 0;
+}
 
-            if (!Private::isValidChar(c) ||
-                !Private::isValidChar(d) ||
-                (Private::reverseMapBase45[c] +
-                 Private::reverseMapBase45[d] * Private::BASE) > 0xff) {
-                return false;
-            }
-        }
-        return true;
-    }
-    return false;
+bool
+HarbourBase45::isValidBase45(
+    const char* aBase45)
+{
+    return Private::decode(aBase45, aBase45 ? (int)strlen(aBase45) : 0,
+        Q_NULLPTR, 0, Q_NULLPTR) >= 0;
+}
+
+bool
+HarbourBase45::isValidBase45(
+    const char* aBase45,
+    int aLength)
+{
+    return Private::decode(aBase45, aLength, Q_NULLPTR, 0, Q_NULLPTR) >= 0;
 }
 
 QByteArray
 HarbourBase45::fromBase45(
     const QString aBase45)
 {
-    QByteArray out;
-    const int len = aBase45.length();
-    const int tail = (len % 3);
-
-    if (!(tail % 2)) {
-        const QChar* chars = aBase45.constData();
-        int i = 0;
-
-        out.reserve(len/3*2 + tail/2);
-        while ((i + 2) < len) {
-            const uint c = chars[i++].unicode();
-            const uint d = chars[i++].unicode();
-            const uint e = chars[i++].unicode();
-
-            if (!Private::isValidChar(c) ||
-                !Private::isValidChar(d) ||
-                !Private::isValidChar(e)) {
-                return QByteArray();
-            }
-            const uint n = Private::reverseMapBase45[c] +
-                Private::reverseMapBase45[d] * Private::BASE +
-                Private::reverseMapBase45[e] * Private::BASE2;
-            if (n > 0xffff) {
-                return QByteArray();
-            }
-            char ab[2];
-            ab[0] = (char)(n >> 8);
-            ab[1] = (char)n;
-            out.append(ab, sizeof(ab));
-        }
+    return Private::fromBase45(aBase45.constData(), aBase45.length());
+}
 
-        if (i < len) {
-            const uint c = chars[i++].unicode();
-            const uint d = chars[i++].unicode();
-
-            if (!Private::isValidChar(c) ||
-                !Private::isValidChar(d)) {
-                return QByteArray();
-            }
-            const uint a = Private::reverseMapBase45[c] +
-                Private::reverseMapBase45[d] * Private::BASE;
-            if (a > 0xff) {
-                return QByteArray();
-            }
-            out.append((char)a);
-        }
-    }
-    return out;
+QByteArray
+HarbourBase45::fromBase45(
+    const QByteArray aBase45)
+{
+    return Private::fromBase45(aBase45.constData(), aBase45.size());
+}
+
+QByteArray
+HarbourBase45::fromBase45(
+    const char* aBase45)
+{
+    return Private::fromBase45(aBase45, aBase45 ? (int)strlen(aBase45) : 0);
+}
+
+QByteArray
+HarbourBase45::fromBase45(
+    const char* aBase45,
+    int aLength)
+{
+    return Private::fromBase45(aBase45, aLength);
 }
 
 QString
 HarbourBase45::toBase45(
     const QByteArray aBinary)
 {
-    const uchar* ptr = (uchar*)aBinary.constData();
     const int n = aBinary.size();
-    int i;
-
     QString str;
-    str.reserve(3 * (n / 2) + 2 * (n % 2));
-    for (i = 0; (i + 1) < n; i += 2) {
-        uint e = (uint)(ptr[i]) * 256 + ptr[i+1];
-        const uchar c = (uchar)(e % Private::BASE);
-        e = (e - c)/Private::BASE;
-        const uchar d = (uchar)(e % Private::BASE);
-        e = (e - d)/Private::BASE;
-        str.append(QChar::fromLatin1(Private::mapBase45[c]));
-        str.append(QChar::fromLatin1(Private::mapBase45[d]));
-        str.append(QChar::fromLatin1(Private::mapBase45[e]));
-    }
-    if (i < n) {
-        uchar d = ptr[i];
-        const uchar c = d % Private::BASE;
-        d = (d - c)/Private::BASE;
-        str.append(QChar::fromLatin1(Private::mapBase45[c]));
-        str.append(QChar::fromLatin1(Private::mapBase45[d]));
+
+    if (n > 0) {
+        // Output goes straight into the pre-sized string
+        str.resize(n / 2 * 3 + (n % 2) * 2);
+        Private::encode((const uchar*)aBinary.constData(), n, str.data());
     }
     return str;
 }
@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourBase45CborTask.h"
+#include "HarbourBase45.h"
+#include "HarbourCbor.h"
+#include "HarbourDebug.h"
+
+#include <string.h>
+#include <zlib.h>
+
+// ==========================================================================
+// HarbourBase45CborTask::Private
+// ==========================================================================
+
+class HarbourBase45CborTask::Private
+{
+public:
+    enum {
+        CHUNK_SIZE = 1024,                  // Decoded bytes per chunk
+        CHUNK_CHARS = CHUNK_SIZE / 2 * 3,   // Base45 chars per chunk
+        MIN_OUTPUT_SIZE = 256
+    };
+
+    Private(const QString, int);
+    ~Private();
+
+    static bool isZlibHeader(const uchar*, int);
+
+    Error decode(const HarbourTask*);
+    Error inflate(const uchar*, int);
+    bool parseCoseSign1();
+
+public:
+    const QString iBase45;
+    const int iMaxSize;
+    Error iError;
+    int iErrorPos;
+    bool iCompressed;
+    QByteArray iCbor;
+    z_stream iStream;
+    bool iInflating;
+    bool iInflated;
+    int iOutputHint;
+    bool iCoseSign1;
+    GUtilData iCoseProtectedHeader;
+    GUtilData iCoseUnprotectedHeader;
+    GUtilData iCosePayload;
+    GUtilData iCoseSignature;
+};
+
+HarbourBase45CborTask::Private::Private(
+    const QString aBase45,
+    int aMaxSize) :
+    iBase45(aBase45),
+    iMaxSize(aMaxSize),
+    iError(NoError),
+    iErrorPos(-1),
+    iCompressed(false),
+    iInflating(false),
+    iInflated(false),
+    iOutputHint(0),
+    iCoseSign1(false)
+{
+    memset(&iStream, 0, sizeof(iStream));
+    memset(&iCoseProtectedHeader, 0, sizeof(iCoseProtectedHeader));
+    memset(&iCoseUnprotectedHeader, 0, sizeof(iCoseUnprotectedHeader));
+    memset(&iCosePayload, 0, sizeof(iCosePayload));
+    memset(&iCoseSignature, 0, sizeof(iCoseSignature));
+}
+
+HarbourBase45CborTask::Private::~Private()
+{
+    if (iInflating) {
+        inflateEnd(&iStream);
+    }
+}
+
+// RFC 1950, section 2.2
+bool
+HarbourBase45CborTask::Private::isZlibHeader(
+    const uchar* aData,
+    int aSize)
+{
+    return aSize >= 2 && (aData[0] & 0x0f) == Z_DEFLATED &&
+        (aData[0] >> 4) <= 7 && !(((aData[0] << 8) | aData[1]) % 31);
+}
+
+HarbourBase45CborTask::Error
+HarbourBase45CborTask::Private::decode(
+    const HarbourTask* aTask)
+{
+    const QChar* chars = iBase45.constData();
+    const int len = iBase45.length();
+    const int decodedSize = HarbourBase45::decodedSize(len);
+    uchar buf[CHUNK_SIZE];
+
+    if (decodedSize < 0) {
+        // Dangling character at the end
+        iErrorPos = len - 1;
+        return Base45Error;
+    }
+
+    // Base45 output never hits the heap, it goes through the fixed
+    // buffer either directly to inflate or to the output. The whole
+    // input gets validated, even what follows the compressed stream.
+    for (int pos = 0; pos < len; pos += CHUNK_CHARS) {
+        const int n = qMin(len - pos, (int)CHUNK_CHARS);
+        int err;
+        const int size = HarbourBase45::decode(chars + pos, n, buf,
+            sizeof(buf), &err);
+
+        if (aTask->isCanceled()) {
+            return CanceledError;
+        } else if (size < 0) {
+            iErrorPos = pos + err;
+            return Base45Error;
+        }
+
+        if (!pos) {
+            iCompressed = isZlibHeader(buf, size);
+            if (iCompressed) {
+                if (inflateInit(&iStream) != Z_OK) {
+                    HWARN("inflateInit failed");
+                    return InflateError;
+                }
+                iInflating = true;
+                iOutputHint = qMax(decodedSize * 4, (int)MIN_OUTPUT_SIZE);
+            } else if (decodedSize > iMaxSize) {
+                return TooLargeError;
+            } else {
+                iCbor.reserve(decodedSize);
+            }
+        }
+
+        if (iInflated) {
+            HDEBUG("Ignoring" << size << "trailing byte(s)");
+        } else if (iCompressed) {
+            const Error error = inflate(buf, size);
+
+            if (error != NoError) {
+                return error;
+            }
+        } else {
+            iCbor.append((const char*)buf, size);
+        }
+    }
+
+    if (iCompressed) {
+        if (!iInflated) {
+            HDEBUG("Compressed data is truncated");
+            return InflateError;
+        }
+        iCbor.resize((int)iStream.total_out);
+        inflateEnd(&iStream);
+        iInflating = false;
+    }
+
+    GUtilRange range;
+
+    range.ptr = (const guint8*)iCbor.constData();
+    range.end = range.ptr + iCbor.size();
+    if (!HarbourCbor::skipItem(&range)) {
+        HDEBUG("Malformed CBOR");
+        return CborError;
+    } else if (range.ptr != range.end) {
+        HDEBUG((int)(range.end - range.ptr) << "byte(s) after CBOR");
+        return CborError;
+    }
+
+    iCoseSign1 = parseCoseSign1();
+    return NoError;
+}
+
+// Output space grows geometrically up to iMaxSize
+HarbourBase45CborTask::Error
+HarbourBase45CborTask::Private::inflate(
+    const uchar* aData,
+    int aSize)
+{
+    iStream.next_in = (Bytef*)aData;
+    iStream.avail_in = aSize;
+    while (iStream.avail_in && !iInflated) {
+        if (!iStream.avail_out) {
+            const int used = (int)iStream.total_out;
+
+            if (used >= iMaxSize) {
+                HDEBUG("Inflated data is too large");
+                return TooLargeError;
+            }
+
+            const int size = qMin(qMax(used * 2, iOutputHint), iMaxSize);
+
+            iCbor.resize(size);
+            iStream.next_out = (Bytef*)iCbor.data() + used;
+            iStream.avail_out = size - used;
+        }
+
+        const int ret = ::inflate(&iStream, Z_NO_FLUSH);
+
+        if (ret == Z_STREAM_END) {
+            iInflated = true;
+            if (iStream.avail_in) {
+                HDEBUG("Ignoring" << iStream.avail_in << "trailing byte(s)");
+            }
+        } else if (ret != Z_OK) {
+            HDEBUG("inflate error" << ret << iStream.msg);
+            return InflateError;
+        }
+    }
+    return NoError;
+}
+
+// [ protected : bstr, unprotected : map, payload : bstr, signature : bstr ]
+// optionally tagged with TAG_COSE_SIGN1
+bool
+HarbourBase45CborTask::Private::parseCoseSign1()
+{
+    GUtilRange pos;
+    GUtilData prot, unprot, payload, signature;
+    quint64 tag;
+    qint64 count;
+
+    pos.ptr = (const guint8*)iCbor.constData();
+    pos.end = pos.ptr + iCbor.size();
+    if (HarbourCbor::parseTag(&pos, &tag) &&
+        tag != HarbourCbor::TAG_COSE_SIGN1) {
+        return false;
+    }
+
+    if (HarbourCbor::parseArray(&pos, &count) && count == 4 &&
+        HarbourCbor::parseBytes(&pos, &prot) &&
+        HarbourCbor::peekType(&pos) == HarbourCbor::TYPE_MAP &&
+        HarbourCbor::parseItem(&pos, &unprot) &&
+        HarbourCbor::parseBytes(&pos, &payload) &&
+        HarbourCbor::parseBytes(&pos, &signature)) {
+        iCoseProtectedHeader = prot;
+        iCoseUnprotectedHeader = unprot;
+        iCosePayload = payload;
+        iCoseSignature = signature;
+        return true;
+    }
+    return false;
+}
+
+// ==========================================================================
+// HarbourBase45CborTask
+// ==========================================================================
+
+HarbourBase45CborTask::HarbourBase45CborTask(
+    QThreadPool* aPool,
+    const QString aBase45,
+    int aMaxSize) :
+    HarbourTask(aPool),
+    iPrivate(new Private(aBase45, aMaxSize))
+{
+}
+
+HarbourBase45CborTask::~HarbourBase45CborTask()
+{
+    delete iPrivate;
+}
+
+void
+HarbourBase45CborTask::performTask()
+{
+    iPrivate->iError = iPrivate->decode(this);
+    if (iPrivate->iError != NoError) {
+        iPrivate->iCbor.clear();
+        iPrivate->iCoseSign1 = false;
+    }
+}
+
+HarbourBase45CborTask::Error
+HarbourBase45CborTask::error() const
+{
+    return iPrivate->iError;
+}
+
+int
+HarbourBase45CborTask::errorPos() const
+{
+    return iPrivate->iErrorPos;
+}
+
+bool
+HarbourBase45CborTask::isCompressed() const
+{
+    return iPrivate->iCompressed;
+}
+
+const QByteArray
+HarbourBase45CborTask::cbor() const
+{
+    return iPrivate->iCbor;
+}
+
+bool
+HarbourBase45CborTask::isCoseSign1() const
+{
+    return iPrivate->iCoseSign1;
+}
+
+GUtilData
+HarbourBase45CborTask::coseProtectedHeader() const
+{
+    return iPrivate->iCoseProtectedHeader;
+}
+
+GUtilData
+HarbourBase45CborTask::coseUnprotectedHeader() const
+{
+    return iPrivate->iCoseUnprotectedHeader;
+}
+
+GUtilData
+HarbourBase45CborTask::cosePayload() const
+{
+    return iPrivate->iCosePayload;
+}
+
+GUtilData
+HarbourBase45CborTask::coseSignature() const
+{
+    return iPrivate->iCoseSignature;
+}
@@ -0,0 +1,509 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourCbor.h"
+
+#include "HarbourDebug.h"
+
+#include <math.h>
+#include <string.h>
+
+// ==========================================================================
+// HarbourCbor::Private
+// ==========================================================================
+
+class HarbourCbor::Private
+{
+public:
+    enum {
+        MAX_DEPTH = 64,
+        INFO_BREAK = INFO_INDEFINITE
+    };
+
+    static bool parseHead(GUtilRange*, Head*);
+    static bool parseString(GUtilRange*, int, GUtilData*);
+    static bool parseCount(GUtilRange*, int, qint64*);
+    static bool skip(GUtilRange*, int);
+    static double halfToDouble(uint);
+};
+
+// Doesn't touch the range if anything goes wrong
+bool
+HarbourCbor::Private::parseHead(
+    GUtilRange* aPos,
+    Head* aHead)
+{
+    const guint8* ptr = aPos->ptr;
+
+    if (ptr < aPos->end) {
+        const int type = (*ptr >> 5);
+        const int info = (*ptr++ & 0x1f);
+        quint64 value = 0;
+        bool indefinite = false;
+
+        if (info < 24) {
+            value = info;
+        } else if (info <= 27) {
+            const int n = 1 << (info - 24);
+
+            if ((aPos->end - ptr) < n) {
+                return false;
+            }
+            for (int i = 0; i < n; i++) {
+                value = (value << 8) | *ptr++;
+            }
+            if (type == TYPE_SIMPLE && info == 24 && value < 32) {
+                // Not well-formed (RFC 8949, section 3.3)
+                return false;
+            }
+        } else if (info == INFO_INDEFINITE) {
+            switch (type) {
+            case TYPE_BYTES:
+            case TYPE_TEXT:
+            case TYPE_ARRAY:
+            case TYPE_MAP:
+                indefinite = true;
+                break;
+            case TYPE_SIMPLE:
+                // Break
+                break;
+            default:
+                return false;
+            }
+        } else {
+            // Reserved (28..30)
+            return false;
+        }
+
+        aHead->type = type;
+        aHead->info = info;
+        aHead->value = value;
+        aHead->indefinite = indefinite;
+        aPos->ptr = ptr;
+        return true;
+    }
+    return false;
+}
+
+bool
+HarbourCbor::Private::parseString(
+    GUtilRange* aPos,
+    int aType,
+    GUtilData* aData)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        Head head;
+
+        if (parseHead(&pos, &head) && head.type == aType &&
+            !head.indefinite && head.value <= (quint64)(pos.end - pos.ptr)) {
+            if (aData) {
+                aData->bytes = pos.ptr;
+                aData->size = (gsize)head.value;
+            }
+            aPos->ptr = pos.ptr + head.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+HarbourCbor::Private::parseCount(
+    GUtilRange* aPos,
+    int aType,
+    qint64* aCount)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        Head head;
+
+        if (parseHead(&pos, &head) && head.type == aType) {
+            if (head.indefinite) {
+                if (aCount) *aCount = INDEFINITE;
+                aPos->ptr = pos.ptr;
+                return true;
+            } else {
+                // Each item takes at least one byte, which also
+                // filters out insanely large values
+                const quint64 avail = pos.end - pos.ptr;
+                const quint64 items = (aType == TYPE_MAP) ? 2 : 1;
+
+                if (head.value <= avail / items) {
+                    if (aCount) *aCount = (qint64)head.value;
+                    aPos->ptr = pos.ptr;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// Recursive but the depth is limited
+bool
+HarbourCbor::Private::skip(
+    GUtilRange* aPos,
+    int aDepth)
+{
+    GUtilRange pos = *aPos;
+    Head head;
+
+    if (aDepth > MAX_DEPTH) {
+        HDEBUG("CBOR nesting is too deep");
+        return false;
+    } else if (!parseHead(&pos, &head)) {
+        return false;
+    }
+
+    switch (head.type) {
+    case TYPE_UINT:
+    case TYPE_NEGINT:
+        break;
+    case TYPE_BYTES:
+    case TYPE_TEXT:
+        if (head.indefinite) {
+            // Definite-length chunks of the same type until the break
+            while (!parseBreak(&pos)) {
+                if (!parseString(&pos, head.type, Q_NULLPTR)) {
+                    return false;
+                }
+            }
+        } else if (head.value <= (quint64)(pos.end - pos.ptr)) {
+            pos.ptr += head.value;
+        } else {
+            return false;
+        }
+        break;
+    case TYPE_ARRAY:
+    case TYPE_MAP:
+        if (head.indefinite) {
+            while (!parseBreak(&pos)) {
+                if (!skip(&pos, aDepth + 1) || (head.type == TYPE_MAP &&
+                    !skip(&pos, aDepth + 1))) {
+                    return false;
+                }
+            }
+        } else {
+            const quint64 items = (head.type == TYPE_MAP) ? 2 : 1;
+
+            if (head.value > (quint64)(pos.end - pos.ptr) / items) {
+                return false;
+            }
+            for (quint64 i = head.value * items; i > 0; i--) {
+                if (!skip(&pos, aDepth + 1)) {
+                    return false;
+                }
+            }
+        }
+        break;
+    case TYPE_TAG:
+        if (!skip(&pos, aDepth + 1)) {
+            return false;
+        }
+        break;
+    case TYPE_SIMPLE:
+        if (head.info == INFO_BREAK) {
+            // Break outside of an indefinite-length item
+            return false;
+        }
+        break;
+    }
+
+    aPos->ptr = pos.ptr;
+    return true;
+}
+
+// RFC 8949, Appendix D
+double
+HarbourCbor::Private::halfToDouble(
+    uint aHalf)
+{
+    const int exp = (aHalf >> 10) & 0x1f;
+    const int mant = aHalf & 0x3ff;
+    const double val = (exp == 0) ? ldexp(mant, -24) :
+        (exp != 31) ? ldexp(mant + 1024, exp - 25) :
+        (mant == 0) ? HUGE_VAL : NAN;
+
+    return (aHalf & 0x8000) ? -val : val;
+}
+
+// ==========================================================================
+// HarbourCbor
+// ==========================================================================
+
+int
+HarbourCbor::peekType(
+    const GUtilRange* aPos)
+{
+    return (aPos && aPos->ptr < aPos->end) ? (*aPos->ptr >> 5) : -1;
+}
+
+bool
+HarbourCbor::parseHead(
+    GUtilRange* aPos,
+    Head* aHead)
+{
+    if (aPos) {
+        Head head;
+
+        if (Private::parseHead(aPos, &head)) {
+            if (aHead) {
+                *aHead = head;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+HarbourCbor::parseUInt(
+    GUtilRange* aPos,
+    quint64* aValue)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        Head head;
+
+        if (Private::parseHead(&pos, &head) && head.type == TYPE_UINT) {
+            if (aValue) {
+                *aValue = head.value;
+            }
+            aPos->ptr = pos.ptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Fails if the value doesn't fit into qint64
+bool
+HarbourCbor::parseInt(
+    GUtilRange* aPos,
+    qint64* aValue)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        Head head;
+
+        if (Private::parseHead(&pos, &head) &&
+            (head.type == TYPE_UINT || head.type == TYPE_NEGINT) &&
+            head.value <= (quint64)Q_INT64_C(0x7fffffffffffffff)) {
+            if (aValue) {
+                // Negative integer is -1 minus the argument
+                *aValue = (head.type == TYPE_UINT) ? (qint64)head.value :
+                    (-1 - (qint64)head.value);
+            }
+            aPos->ptr = pos.ptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+HarbourCbor::parseBool(
+    GUtilRange* aPos,
+    bool* aValue)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        Head head;
+
+        if (Private::parseHead(&pos, &head) && head.type == TYPE_SIMPLE &&
+            head.info < 24 && (head.value == SIMPLE_FALSE ||
+            head.value == SIMPLE_TRUE)) {
+            if (aValue) {
+                *aValue = (head.value == SIMPLE_TRUE);
+            }
+            aPos->ptr = pos.ptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+HarbourCbor::parseNull(
+    GUtilRange* aPos)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        Head head;
+
+        if (Private::parseHead(&pos, &head) && head.type == TYPE_SIMPLE &&
+            head.info == SIMPLE_NULL) {
+            aPos->ptr = pos.ptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Half, single and double precision numbers are all accepted
+bool
+HarbourCbor::parseFloat(
+    GUtilRange* aPos,
+    double* aValue)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        Head head;
+
+        if (Private::parseHead(&pos, &head) && head.type == TYPE_SIMPLE) {
+            double value;
+
+            switch (head.info) {
+            case INFO_HALF:
+                value = Private::halfToDouble((uint)head.value);
+                break;
+            case INFO_FLOAT:
+                {
+                    const quint32 bits = (quint32)head.value;
+                    float f;
+
+                    memcpy(&f, &bits, sizeof(f));
+                    value = f;
+                }
+                break;
+            case INFO_DOUBLE:
+                memcpy(&value, &head.value, sizeof(value));
+                break;
+            default:
+                return false;
+            }
+            if (aValue) {
+                *aValue = value;
+            }
+            aPos->ptr = pos.ptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+HarbourCbor::parseTag(
+    GUtilRange* aPos,
+    quint64* aTag)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        Head head;
+
+        if (Private::parseHead(&pos, &head) && head.type == TYPE_TAG) {
+            if (aTag) {
+                *aTag = head.value;
+            }
+            aPos->ptr = pos.ptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+HarbourCbor::parseBytes(
+    GUtilRange* aPos,
+    GUtilData* aData)
+{
+    return Private::parseString(aPos, TYPE_BYTES, aData);
+}
+
+bool
+HarbourCbor::parseText(
+    GUtilRange* aPos,
+    GUtilData* aData)
+{
+    return Private::parseString(aPos, TYPE_TEXT, aData);
+}
+
+bool
+HarbourCbor::parseArray(
+    GUtilRange* aPos,
+    qint64* aCount)
+{
+    return Private::parseCount(aPos, TYPE_ARRAY, aCount);
+}
+
+bool
+HarbourCbor::parseMap(
+    GUtilRange* aPos,
+    qint64* aCount)
+{
+    return Private::parseCount(aPos, TYPE_MAP, aCount);
+}
+
+bool
+HarbourCbor::parseBreak(
+    GUtilRange* aPos)
+{
+    // The break is a single 0xff byte
+    if (aPos && aPos->ptr < aPos->end && *aPos->ptr == 0xff) {
+        aPos->ptr++;
+        return true;
+    }
+    return false;
+}
+
+bool
+HarbourCbor::skipItem(
+    GUtilRange* aPos)
+{
+    return aPos && Private::skip(aPos, 0);
+}
+
+bool
+HarbourCbor::parseItem(
+    GUtilRange* aPos,
+    GUtilData* aItem)
+{
+    if (aPos) {
+        const guint8* start = aPos->ptr;
+
+        if (Private::skip(aPos, 0)) {
+            if (aItem) {
+                aItem->bytes = start;
+                aItem->size = aPos->ptr - start;
+            }
+            return true;
+        }
+    }
+    return false;
+}
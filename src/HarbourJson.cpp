@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2015-2024 Slava Monich <slava@monich.com>
+ * Copyright (C) 2015-2026 Slava Monich <slava@monich.com>
  * Copyright (C) 2015-2020 Jolla Ltd.
  *
  * You may use this file under the terms of the BSD license as follows:
@@ -40,13 +40,21 @@
 #include "HarbourJson.h"
 #include "HarbourDebug.h"
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
 
 #if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+#  include "HarbourCbor.h"
+#  include <QtCore/QJsonArray>
 #  include <QtCore/QJsonDocument>
 #  include <QtCore/QJsonObject>
+#  include <zlib.h>
+#  include <math.h>
 #else
 #  include <qjson/parser.h>
 #  include <qjson/serializer.h>
@@ -54,65 +62,742 @@
 
 #include <unistd.h>
 #include <errno.h>
+#include <stdio.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
+// What we know about the files we have written (SaveIfChanged)
+struct JsonFileState {
+    QByteArray digest;
+    qint64 size;
+    qint64 mtime; // nanoseconds
+};
+
+typedef QHash<QString,JsonFileState> JsonFileStateMap;
+Q_GLOBAL_STATIC(JsonFileStateMap, jsonFileStates)
+Q_GLOBAL_STATIC(QMutex, jsonFileStatesMutex)
+
+static
+QByteArray
+jsonDigest(
+    const QByteArray& aJson)
+{
+    return QCryptographicHash::hash(aJson, QCryptographicHash::Sha1);
+}
+
+static
+qint64
+jsonMtime(
+    const struct stat* aStat)
+{
+    return (qint64)aStat->st_mtim.tv_sec * 1000000000 +
+        aStat->st_mtim.tv_nsec;
+}
+
+// Checks whether the file contains exactly this data. Cheap if the file
+// has been written by us and hasn't been touched since then, otherwise
+// compares the contents (only if the sizes match).
+static
+bool
+jsonUnchanged(
+    const QString& aPath,
+    const char* aLocalPath,
+    const QByteArray& aJson)
+{
+    struct stat st;
+
+    if (stat(aLocalPath, &st) == 0 && st.st_size == aJson.size()) {
+        QMutexLocker lock(jsonFileStatesMutex());
+        const JsonFileStateMap* states = jsonFileStates();
+        JsonFileStateMap::ConstIterator it = states->find(aPath);
+
+        if (it != states->constEnd() &&
+            it.value().size == st.st_size &&
+            it.value().mtime == jsonMtime(&st)) {
+            return it.value().digest == jsonDigest(aJson);
+        }
+        lock.unlock();
+
+        QFile f(aPath);
+
+        if (f.open(QIODevice::ReadOnly)) {
+            return f.readAll() == aJson;
+        }
+    }
+    return false;
+}
+
+// Updates the state of the file after writing it. Files which
+// are only saved without SaveIfChanged aren't tracked.
+static
+void
+jsonWritten(
+    const QString& aPath,
+    const char* aLocalPath,
+    const QByteArray& aJson,
+    bool aTrack)
+{
+    QMutexLocker lock(jsonFileStatesMutex());
+    JsonFileStateMap* states = jsonFileStates();
+    struct stat st;
+
+    if ((aTrack || states->contains(aPath)) && stat(aLocalPath, &st) == 0) {
+        JsonFileState state;
+
+        state.digest = jsonDigest(aJson);
+        state.size = st.st_size;
+        state.mtime = jsonMtime(&st);
+        states->insert(aPath, state);
+    } else {
+        states->remove(aPath);
+    }
+}
+
+static
+void
+jsonRestoreAttr(
+    int aFd,
+    const char* aPath,
+    const struct stat* aStat)
+{
+    // Try to restore ownership and mode
+    if ((aFd >= 0) ? fchown(aFd, aStat->st_uid, aStat->st_gid) :
+        chown(aPath, aStat->st_uid, aStat->st_gid)) {
+        HWARN("Failed to chown" << aPath << ":" << strerror(errno));
+    }
+    if ((aFd >= 0) ? fchmod(aFd, aStat->st_mode & ~S_IFMT) :
+        chmod(aPath, aStat->st_mode & ~S_IFMT)) {
+        HWARN("Failed to chmod" << aPath << ":" << strerror(errno));
+    }
+}
+
+// Writes a sibling file and renames it over the original one. A crash
+// in the middle leaves either the old or the new file, never a broken one.
+static
+bool
+jsonWriteAtomic(
+    const QString& aPath,
+    const char* aLocalPath,
+    const QByteArray& aJson,
+    const struct stat* aStat)
+{
+    static QAtomicInt jsonTempCount;
+    const QString tmpPath(aPath + QLatin1Char('.') +
+        QString::number(getpid()) + QLatin1Char('-') +
+        QString::number(jsonTempCount.fetchAndAddRelaxed(1)) +
+        QLatin1String(".tmp"));
+    const QByteArray tmpBytes(tmpPath.toLocal8Bit());
+    const char* tmp = tmpBytes.constData();
+    QFile f(tmpPath);
+    bool ok = false;
+
+    if (f.open(QIODevice::WriteOnly)) {
+        if (f.write(aJson) == aJson.size() && f.flush()) {
+            if (aStat) {
+                jsonRestoreAttr(f.handle(), tmp, aStat);
+            }
+            if (fsync(f.handle()) == 0) {
+                f.close();
+                if (rename(tmp, aLocalPath) == 0) {
+                    ok = true;
+                } else {
+                    HWARN("Failed to rename" << tmp << ":" << strerror(errno));
+                }
+            } else {
+                HWARN("Failed to sync" << tmp << ":" << strerror(errno));
+            }
+        } else {
+            HWARN("Error writing" << tmpPath << f.errorString());
+        }
+        if (!ok) {
+            f.remove();
+        }
+    } else {
+        HWARN("Error opening" << tmpPath << f.errorString());
+    }
+    return ok;
+}
+
+static
+bool
+jsonWrite(
+    const QString& aPath,
+    const char* aLocalPath,
+    const QByteArray& aJson,
+    const struct stat* aStat)
+{
+    QFile f(aPath);
+
+    if (f.open(QIODevice::WriteOnly)) {
+        if (f.write(aJson) >= 0) {
+            f.close();
+            if (aStat) {
+                jsonRestoreAttr(-1, aLocalPath, aStat);
+            }
+            return true;
+        } else {
+            HWARN("Error writing" << aPath << f.errorString());
+        }
+    } else {
+        HWARN("Error opening" << aPath << f.errorString());
+    }
+    return false;
+}
+
+// Writes the file unless it's unchanged (and SaveIfChanged is given)
+static
+bool
+jsonSave(
+    const QString& aPath,
+    const char* aLocalPath,
+    const QByteArray& aJson,
+    HarbourJson::SaveOptions aOptions,
+    bool* aWritten)
+{
+    if ((aOptions & HarbourJson::SaveIfChanged) &&
+        jsonUnchanged(aPath, aLocalPath, aJson)) {
+        HDEBUG(aPath << "is unchanged");
+        return true;
+    } else {
+        struct stat st;
+        const bool haveFileAttr = (stat(aLocalPath, &st) == 0);
+        const bool ok = (aOptions & HarbourJson::SaveAtomic) ?
+            jsonWriteAtomic(aPath, aLocalPath, aJson,
+                haveFileAttr ? &st : Q_NULLPTR) :
+            jsonWrite(aPath, aLocalPath, aJson,
+                haveFileAttr ? &st : Q_NULLPTR);
+
+        if (ok) {
+            jsonWritten(aPath, aLocalPath, aJson,
+                (aOptions & HarbourJson::SaveIfChanged) != 0);
+            *aWritten = true;
+        }
+        return ok;
+    }
+}
+
+#if QT_VERSION >= 0x050000
+
+// ==========================================================================
+// Binary sidecar
+//
+// A CBOR copy of the document which can be decoded straight into
+// QVariantMap, written next to the JSON file. The header ties it to
+// the particular version of the JSON file:
+//
+//   0  "HJSC"
+//   4  Format version (4 bytes)
+//   8  Size of the JSON file (8 bytes)
+//   16 Modification time of the JSON file, in nanoseconds (8 bytes)
+//   24 Size of the CBOR data (4 bytes)
+//   28 CRC32 of the CBOR data (4 bytes)
+//   32 CRC32 of the JSON file (4 bytes)
+//   36 Reserved, zero (4 bytes)
+//   40 CBOR data
+//
+// All numbers are little-endian. If anything doesn't match, the sidecar
+// is ignored and the JSON file gets parsed as usual. Checksumming the
+// JSON file is much cheaper than parsing it and catches modifications
+// which don't change the size and the timestamp.
+// ==========================================================================
+
+#define JSON_SIDECAR_SUFFIX ".cbor"
+#define JSON_SIDECAR_MAGIC "HJSC"
+#define JSON_SIDECAR_VERSION 2
+#define JSON_SIDECAR_HEADER_SIZE 40
+#define JSON_SIDECAR_MAX_DEPTH 256
+
+static
+QString
+jsonSidecarPath(
+    const QString& aPath)
+{
+    return aPath + QLatin1String(JSON_SIDECAR_SUFFIX);
+}
+
+static
+quint32
+jsonCrc32(
+    const void* aData,
+    qint64 aSize)
+{
+    return crc32(crc32(0, Z_NULL, 0), (const Bytef*)aData, (uInt)aSize);
+}
+
+static
+bool
+jsonFileCrc32(
+    const QString& aPath,
+    quint32* aCrc)
+{
+    QFile f(aPath);
+
+    if (f.open(QIODevice::ReadOnly)) {
+        const qint64 size = f.size();
+        const uchar* data = size ? f.map(0, size) : Q_NULLPTR;
+
+        if (data) {
+            *aCrc = jsonCrc32(data, size);
+        } else {
+            const QByteArray bytes(f.readAll());
+
+            *aCrc = jsonCrc32(bytes.constData(), bytes.size());
+        }
+        return true;
+    }
+    return false;
+}
+
+static
+void
+jsonPutLE(
+    uchar* aOut,
+    quint64 aValue,
+    int aSize)
+{
+    for (int i = 0; i < aSize; i++, aValue >>= 8) {
+        aOut[i] = (uchar)aValue;
+    }
+}
+
+static
+quint64
+jsonGetLE(
+    const uchar* aIn,
+    int aSize)
+{
+    quint64 value = 0;
+
+    for (int i = aSize - 1; i >= 0; i--) {
+        value = (value << 8) | aIn[i];
+    }
+    return value;
+}
+
+static
+void
+jsonCborAppendHead(
+    QByteArray* aOut,
+    int aType,
+    quint64 aValue)
+{
+    const int type = aType << 5;
+
+    if (aValue < 24) {
+        aOut->append((char)(type | (int)aValue));
+    } else {
+        // Shortest form, most significant byte first
+        const int n = (aValue <= 0xff) ? 1 : (aValue <= 0xffff) ? 2 :
+            (aValue <= 0xffffffff) ? 4 : 8;
+        char buf[9];
+
+        buf[0] = (char)(type | (24 + ((n == 1) ? 0 : (n == 2) ? 1 :
+            (n == 4) ? 2 : 3)));
+        for (int i = n; i > 0; i--, aValue >>= 8) {
+            buf[i] = (char)aValue;
+        }
+        aOut->append(buf, n + 1);
+    }
+}
+
+static
+void
+jsonCborAppendText(
+    QByteArray* aOut,
+    const QString& aText)
+{
+    const QByteArray utf8(aText.toUtf8());
+
+    jsonCborAppendHead(aOut, HarbourCbor::TYPE_TEXT, utf8.size());
+    aOut->append(utf8);
+}
+
+static
+void
+jsonCborAppendValue(
+    QByteArray* aOut,
+    const QJsonValue& aValue)
+{
+    switch (aValue.type()) {
+    case QJsonValue::Bool:
+        jsonCborAppendHead(aOut, HarbourCbor::TYPE_SIMPLE, aValue.toBool() ?
+            HarbourCbor::SIMPLE_TRUE : HarbourCbor::SIMPLE_FALSE);
+        break;
+    case QJsonValue::Double:
+        {
+            // Integers are more compact, they are still loaded as doubles
+            const double d = aValue.toDouble();
+
+            if (d == floor(d) && fabs(d) <= 9007199254740992.0 &&
+                (d != 0 || !signbit(d))) {
+                if (d >= 0) {
+                    jsonCborAppendHead(aOut, HarbourCbor::TYPE_UINT,
+                        (quint64)d);
+                } else {
+                    jsonCborAppendHead(aOut, HarbourCbor::TYPE_NEGINT,
+                        (quint64)(-d) - 1);
+                }
+            } else {
+                quint64 bits;
+
+                memcpy(&bits, &d, sizeof(bits));
+                aOut->append((char)((HarbourCbor::TYPE_SIMPLE << 5) |
+                    HarbourCbor::INFO_DOUBLE));
+                for (int shift = 56; shift >= 0; shift -= 8) {
+                    aOut->append((char)(bits >> shift));
+                }
+            }
+        }
+        break;
+    case QJsonValue::String:
+        jsonCborAppendText(aOut, aValue.toString());
+        break;
+    case QJsonValue::Array:
+        {
+            const QJsonArray array(aValue.toArray());
+            const int n = array.size();
+
+            jsonCborAppendHead(aOut, HarbourCbor::TYPE_ARRAY, n);
+            for (int i = 0; i < n; i++) {
+                jsonCborAppendValue(aOut, array.at(i));
+            }
+        }
+        break;
+    case QJsonValue::Object:
+        {
+            const QJsonObject object(aValue.toObject());
+            QJsonObject::ConstIterator it = object.constBegin();
+
+            jsonCborAppendHead(aOut, HarbourCbor::TYPE_MAP, object.size());
+            for (; it != object.constEnd(); ++it) {
+                jsonCborAppendText(aOut, it.key());
+                jsonCborAppendValue(aOut, it.value());
+            }
+        }
+        break;
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        jsonCborAppendHead(aOut, HarbourCbor::TYPE_SIMPLE,
+            HarbourCbor::SIMPLE_NULL);
+        break;
+    }
+}
+
+static
+bool
+jsonCborDecodeText(
+    GUtilRange* aPos,
+    QString* aText)
+{
+    GUtilData text;
+
+    if (HarbourCbor::parseText(aPos, &text)) {
+        *aText = QString::fromUtf8((const char*)text.bytes, (int)text.size);
+        return true;
+    }
+    return false;
+}
+
+// Produces the same thing as QJsonValue::toVariant() would
+static
+bool
+jsonCborDecodeValue(
+    GUtilRange* aPos,
+    QVariant* aValue,
+    int aDepth)
+{
+    switch (HarbourCbor::peekType(aPos)) {
+    case HarbourCbor::TYPE_UINT:
+        {
+            quint64 u;
+
+            if (HarbourCbor::parseUInt(aPos, &u)) {
+                *aValue = QVariant((double)u);
+                return true;
+            }
+        }
+        break;
+    case HarbourCbor::TYPE_NEGINT:
+        {
+            qint64 i;
+
+            if (HarbourCbor::parseInt(aPos, &i)) {
+                *aValue = QVariant((double)i);
+                return true;
+            }
+        }
+        break;
+    case HarbourCbor::TYPE_TEXT:
+        {
+            QString text;
+
+            if (jsonCborDecodeText(aPos, &text)) {
+                *aValue = QVariant(text);
+                return true;
+            }
+        }
+        break;
+    case HarbourCbor::TYPE_ARRAY:
+        {
+            qint64 n;
+
+            if (aDepth < JSON_SIDECAR_MAX_DEPTH &&
+                HarbourCbor::parseArray(aPos, &n) && n >= 0 &&
+                n <= (aPos->end - aPos->ptr)) {
+                QVariantList list;
+
+                list.reserve((int)n);
+                for (qint64 i = 0; i < n; i++) {
+                    QVariant value;
+
+                    if (!jsonCborDecodeValue(aPos, &value, aDepth + 1)) {
+                        return false;
+                    }
+                    list.append(value);
+                }
+                *aValue = QVariant(list);
+                return true;
+            }
+        }
+        break;
+    case HarbourCbor::TYPE_MAP:
+        {
+            qint64 n;
+
+            if (aDepth < JSON_SIDECAR_MAX_DEPTH &&
+                HarbourCbor::parseMap(aPos, &n) && n >= 0) {
+                QVariantMap map;
+
+                for (qint64 i = 0; i < n; i++) {
+                    QString key;
+                    QVariant value;
+
+                    if (!jsonCborDecodeText(aPos, &key) ||
+                        !jsonCborDecodeValue(aPos, &value, aDepth + 1)) {
+                        return false;
+                    }
+                    // Keys are written in order, append at the end
+                    map.insert(map.constEnd(), key, value);
+                }
+                *aValue = QVariant(map);
+                return true;
+            }
+        }
+        break;
+    case HarbourCbor::TYPE_SIMPLE:
+        {
+            bool b;
+            double d;
+
+            if (HarbourCbor::parseBool(aPos, &b)) {
+                *aValue = QVariant(b);
+                return true;
+            } else if (HarbourCbor::parseNull(aPos)) {
+                *aValue = QVariant();
+                return true;
+            } else if (HarbourCbor::parseFloat(aPos, &d)) {
+                *aValue = QVariant(d);
+                return true;
+            }
+        }
+        break;
+    }
+    return false;
+}
+
+static
+bool
+jsonSidecarHeaderValid(
+    const uchar* aHeader,
+    const struct stat* aJsonStat)
+{
+    return !memcmp(aHeader, JSON_SIDECAR_MAGIC, 4) &&
+        jsonGetLE(aHeader + 4, 4) == JSON_SIDECAR_VERSION &&
+        jsonGetLE(aHeader + 8, 8) == (quint64)aJsonStat->st_size &&
+        jsonGetLE(aHeader + 16, 8) == (quint64)jsonMtime(aJsonStat);
+}
+
+// Checks the header only, aJson is the current contents of the file
+static
+bool
+jsonSidecarValid(
+    const QString& aPath,
+    const char* aLocalPath,
+    const QByteArray& aJson)
+{
+    struct stat st;
+
+    if (stat(aLocalPath, &st) == 0) {
+        QFile f(jsonSidecarPath(aPath));
+        uchar header[JSON_SIDECAR_HEADER_SIZE];
+
+        return f.open(QIODevice::ReadOnly) &&
+            f.read((char*)header, sizeof(header)) == sizeof(header) &&
+            jsonSidecarHeaderValid(header, &st) &&
+            jsonGetLE(header + 32, 4) ==
+                jsonCrc32(aJson.constData(), aJson.size());
+    }
+    return false;
+}
+
+static
+bool
+jsonLoadSidecar(
+    const QString& aPath,
+    QVariantMap* aRoot)
+{
+    const QByteArray pathBytes(aPath.toLocal8Bit());
+    struct stat st;
+
+    if (stat(pathBytes.constData(), &st) == 0) {
+        QFile f(jsonSidecarPath(aPath));
+
+        if (f.open(QIODevice::ReadOnly) &&
+            f.size() > JSON_SIDECAR_HEADER_SIZE) {
+            const qint64 size = f.size();
+            const uchar* data = f.map(0, size);
+            quint32 jsonCrc;
+
+            if (data && jsonSidecarHeaderValid(data, &st) &&
+                jsonFileCrc32(aPath, &jsonCrc) &&
+                jsonGetLE(data + 32, 4) == jsonCrc) {
+                const uchar* payload = data + JSON_SIDECAR_HEADER_SIZE;
+                const qint64 payloadSize = size - JSON_SIDECAR_HEADER_SIZE;
+
+                if (jsonGetLE(data + 24, 4) == (quint64)payloadSize &&
+                    jsonGetLE(data + 28, 4) ==
+                        jsonCrc32(payload, payloadSize)) {
+                    GUtilRange range;
+                    QVariant root;
+
+                    range.ptr = payload;
+                    range.end = payload + payloadSize;
+                    if (jsonCborDecodeValue(&range, &root, 0) &&
+                        range.ptr == range.end &&
+                        root.type() == QVariant::Map) {
+                        HDEBUG("loaded" << f.fileName());
+                        *aRoot = root.toMap();
+                        return true;
+                    }
+                }
+                HWARN("Broken" << f.fileName());
+            } else if (data) {
+                HDEBUG(f.fileName() << "is stale");
+            }
+        }
+    }
+    return false;
+}
+
+static
+void
+jsonWriteSidecar(
+    const QString& aPath,
+    const char* aLocalPath,
+    const QByteArray& aJson,
+    const QJsonObject& aObject)
+{
+    struct stat st;
+
+    if (stat(aLocalPath, &st) == 0) {
+        QByteArray data(JSON_SIDECAR_HEADER_SIZE, '\0');
+
+        jsonCborAppendValue(&data, QJsonValue(aObject));
+
+        uchar* header = (uchar*)data.data();
+        const uchar* payload = header + JSON_SIDECAR_HEADER_SIZE;
+        const int payloadSize = data.size() - JSON_SIDECAR_HEADER_SIZE;
+        const QString path(jsonSidecarPath(aPath));
+
+        memcpy(header, JSON_SIDECAR_MAGIC, 4);
+        jsonPutLE(header + 4, JSON_SIDECAR_VERSION, 4);
+        jsonPutLE(header + 8, st.st_size, 8);
+        jsonPutLE(header + 16, jsonMtime(&st), 8);
+        jsonPutLE(header + 24, payloadSize, 4);
+        jsonPutLE(header + 28, jsonCrc32(payload, payloadSize), 4);
+        jsonPutLE(header + 32, jsonCrc32(aJson.constData(), aJson.size()), 4);
+        jsonWriteAtomic(path, path.toLocal8Bit().constData(), data, &st);
+    }
+}
+
+// Doesn't touch the file unless it looks like our sidecar
+static
+void
+jsonRemoveSidecar(
+    const QString& aPath)
+{
+    QFile f(jsonSidecarPath(aPath));
+    char magic[4];
+
+    // Most of the time it's not there
+    if (f.open(QIODevice::ReadOnly) &&
+        f.read(magic, sizeof(magic)) == sizeof(magic) &&
+        !memcmp(magic, JSON_SIDECAR_MAGIC, sizeof(magic))) {
+        f.close();
+        if (!f.remove()) {
+            HWARN("Error removing" << f.fileName() << f.errorString());
+        }
+    }
+}
+
+#endif // QT_VERSION >= 0x050000
+
 bool
 HarbourJson::save(
     const QString& aPath,
     const QVariantMap& aMap)
+{
+    return save(aPath, aMap, SaveDefault);
+}
+
+bool
+HarbourJson::save(
+    const QString& aPath,
+    const QVariantMap& aMap,
+    SaveOptions aOptions)
 {
     const QFileInfo file(aPath);
     QDir dir(file.dir());
     if (dir.mkpath(dir.absolutePath())) {
         const QString absPath(file.absoluteFilePath());
-        QFile f(absPath);
+        const QByteArray pathBytes(absPath.toLocal8Bit());
+        const char* path = pathBytes.constData();
         if (!aMap.isEmpty()) {
-            struct stat st;
-            const QByteArray pathBytes(absPath.toLocal8Bit());
-            const char* path = pathBytes.constData();
-            const bool haveFileAttr = (stat(path, &st) == 0);
-
-            if (f.open(QIODevice::WriteOnly)) {
-                bool ok = false;
 #if QT_VERSION >= 0x050000
-                if (f.write(QJsonDocument::fromVariant(aMap).toJson()) >= 0) {
-                    ok = true;
-                } else {
-                    HWARN("Error writing" << absPath << f.errorString());
-                }
+            const QJsonDocument doc(QJsonDocument::fromVariant(aMap));
+            const QByteArray json(doc.toJson((aOptions & SaveCompact) ?
+                QJsonDocument::Compact : QJsonDocument::Indented));
 #else
-                QJson::Serializer serializer;
-                QByteArray json = serializer.serialize(aMap);
-                if (!json.isNull()) {
-                    if (f.write(json) >= 0) {
-                        ok = true;
-                    } else {
-                        HWARN("Error writing" << absPath << f.errorString());
-                    }
-                } else {
-                    HWARN("Json serialization error");
-                }
+            QJson::Serializer serializer;
+            const QByteArray json(serializer.serialize(aMap));
+            if (json.isNull()) {
+                HWARN("Json serialization error");
+                return false;
+            }
 #endif
-                if (ok) {
-                    if (haveFileAttr) {
-                        // Try to restore ownership and mode
-                        if (chown(path, st.st_uid, st.st_gid)) {
-                            HWARN("Failed to chown" << path << ":" <<
-                                strerror(errno));
-                        }
-                        if (chmod(path, st.st_mode & ~S_IFMT)) {
-                            HWARN("Failed to chmod" << path << ":" <<
-                                strerror(errno));
-                        }
-                    }
-                    return true;
+            bool written = false;
+            const bool ok = jsonSave(absPath, path, json, aOptions, &written);
+
+#if QT_VERSION >= 0x050000
+            if (aOptions & SaveSidecar) {
+                if (written ||
+                    (ok && !jsonSidecarValid(absPath, path, json))) {
+                    jsonWriteSidecar(absPath, path, json, doc.object());
                 }
-            } else {
-                HWARN("Error opening" << absPath << f.errorString());
+            } else if (written) {
+                jsonRemoveSidecar(absPath);
+            }
+#endif
+            return ok;
+        } else {
+            QFile f(absPath);
+            if (!f.remove()) {
+                HWARN("Error removing" << absPath << f.errorString());
             }
-        } else if (!f.remove()) {
-            HWARN("Error removing" << absPath << f.errorString());
+            jsonWritten(absPath, path, QByteArray(), false);
+#if QT_VERSION >= 0x050000
+            jsonRemoveSidecar(absPath);
+#endif
         }
     } else {
         HWARN("Failed to create" << dir.absolutePath());
@@ -120,6 +805,33 @@ HarbourJson::save(
     return false;
 }
 
+bool
+HarbourJson::saveData(
+    const QString& aPath,
+    const QByteArray& aJson,
+    SaveOptions aOptions)
+{
+    const QFileInfo file(aPath);
+    QDir dir(file.dir());
+    if (dir.mkpath(dir.absolutePath())) {
+        const QString absPath(file.absoluteFilePath());
+        const QByteArray pathBytes(absPath.toLocal8Bit());
+        bool written = false;
+        const bool ok = jsonSave(absPath, pathBytes.constData(), aJson,
+            aOptions, &written);
+
+#if QT_VERSION >= 0x050000
+        if (written) {
+            jsonRemoveSidecar(absPath);
+        }
+#endif
+        return ok;
+    } else {
+        HWARN("Failed to create" << dir.absolutePath());
+    }
+    return false;
+}
+
 bool
 HarbourJson::load(
     const QString& aPath,
@@ -127,6 +839,11 @@ HarbourJson::load(
 {
     QFile f(aPath);
     if (f.exists()) {
+#if QT_VERSION >= 0x050000
+        if (jsonLoadSidecar(aPath, &aRoot)) {
+            return true;
+        }
+#endif
         if (f.open(QIODevice::ReadOnly)) {
             HDEBUG("reading" << aPath);
 #if QT_VERSION >= 0x050000
@@ -151,3 +868,52 @@ HarbourJson::load(
     }
     return false;
 }
+
+bool
+HarbourJson::loadSidecar(
+    const QString& aPath,
+    QVariantMap& aRoot)
+{
+#if QT_VERSION >= 0x050000
+    return jsonLoadSidecar(aPath, &aRoot);
+#else
+    Q_UNUSED(aPath);
+    Q_UNUSED(aRoot);
+    return false;
+#endif
+}
+
+bool
+HarbourJson::parse(
+    const QByteArray& aJson,
+    QVariantMap& aRoot,
+    QString* aError)
+{
+#if QT_VERSION >= 0x050000
+    QJsonParseError error;
+    const QJsonDocument doc(QJsonDocument::fromJson(aJson, &error));
+
+    if (doc.isObject()) {
+        aRoot = doc.object().toVariantMap();
+        return true;
+    } else if (aError) {
+        *aError = (error.error != QJsonParseError::NoError) ?
+            QString("%1 at %2").arg(error.errorString()).arg(error.offset) :
+            QString("Not an object");
+    }
+#else
+    QJson::Parser parser;
+    bool ok = false;
+    const QVariant result(parser.parse(aJson, &ok));
+
+    if (ok && result.type() == QVariant::Map) {
+        aRoot = result.toMap();
+        return true;
+    } else if (aError) {
+        *aError = ok ? QString("Not an object") :
+            QString("%1 at line %2").arg(parser.errorString()).
+                arg(parser.errorLine());
+    }
+#endif
+    return false;
+}
@@ -0,0 +1,712 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourJsonJournal.h"
+#include "HarbourTask.h"
+#include "HarbourDebug.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QThreadPool>
+
+#define JOURNAL_SUFFIX ".journal"
+#define OLD_JOURNAL_SUFFIX ".journal.old"
+#define DEFAULT_COMPACT_RATIO 1.0
+
+// JSON Pointer (RFC 6901)
+static
+QString
+journalPointer(
+    const QStringList& aKeys)
+{
+    QString pointer;
+    const int n = aKeys.count();
+
+    for (int i = 0; i < n; i++) {
+        QString key(aKeys.at(i));
+
+        key.replace(QChar('~'), QString("~0"));
+        key.replace(QChar('/'), QString("~1"));
+        pointer.append(QChar('/'));
+        pointer.append(key);
+    }
+    return pointer;
+}
+
+static
+bool
+journalParsePointer(
+    const QString& aPointer,
+    QStringList* aKeys)
+{
+    aKeys->clear();
+    if (aPointer.isEmpty()) {
+        return true;
+    } else if (aPointer.at(0) == QChar('/')) {
+        const QStringList keys(aPointer.mid(1).split(QChar('/')));
+        const int n = keys.count();
+
+        for (int i = 0; i < n; i++) {
+            QString key(keys.at(i));
+
+            key.replace(QString("~1"), QString("/"));
+            key.replace(QString("~0"), QString("~"));
+            aKeys->append(key);
+        }
+        return true;
+    }
+    return false;
+}
+
+// Creates the missing maps along the way (unless it's a removal) and
+// doesn't complain about removing what's not there. That makes it safe
+// to apply the same change more than once.
+static
+void
+journalApply(
+    QVariantMap* aMap,
+    const QStringList& aKeys,
+    int aIndex,
+    const QVariant* aValue)
+{
+    const QString& key = aKeys.at(aIndex);
+
+    if (aIndex == aKeys.count() - 1) {
+        if (aValue) {
+            aMap->insert(key, *aValue);
+        } else {
+            aMap->remove(key);
+        }
+    } else {
+        QVariantMap::Iterator it = aMap->find(key);
+
+        if (it == aMap->end() || it.value().type() != QVariant::Map) {
+            if (!aValue) {
+                return;
+            }
+            it = aMap->insert(key, QVariantMap());
+        }
+
+        QVariantMap child(it.value().toMap());
+
+        // Drop the reference held by the parent, so that modifying
+        // the child doesn't make a deep copy of it
+        it.value() = QVariant();
+        journalApply(&child, aKeys, aIndex + 1, aValue);
+        it.value() = child;
+    }
+}
+
+static
+QByteArray
+journalRecord(
+    const char* aOp,
+    const QStringList& aKeys,
+    const QVariant* aValue)
+{
+    HarbourJson::Writer writer;
+    QByteArray line;
+
+    writer.beginObject();
+    writer.name("op").value(aOp);
+    writer.name("path").value(journalPointer(aKeys));
+    if (aValue) {
+        writer.name("value").value(*aValue);
+    }
+    writer.endObject();
+    line = writer.data();
+    line.append('\n');
+    return line;
+}
+
+// Returns the size of the valid part of the journal, the rest gets
+// truncated (that would be a change interrupted by a crash)
+static
+qint64
+journalReplay(
+    const QString& aPath,
+    QVariantMap* aMap)
+{
+    QFile f(aPath);
+
+    if (f.open(QIODevice::ReadOnly)) {
+        const QByteArray data(f.readAll());
+        int pos = 0, eol;
+
+        f.close();
+        while ((eol = data.indexOf('\n', pos)) >= 0) {
+            QVariantMap record;
+            QStringList keys;
+
+            if (!HarbourJson::parse(data.mid(pos, eol - pos), record) ||
+                !journalParsePointer(record.value("path").toString(),
+                &keys)) {
+                break;
+            }
+
+            const QString op(record.value("op").toString());
+
+            if (op == QLatin1String("add") || op == QLatin1String("replace")) {
+                const QVariant value(record.value("value"));
+
+                if (keys.isEmpty()) {
+                    *aMap = value.toMap();
+                } else {
+                    journalApply(aMap, keys, 0, &value);
+                }
+            } else if (op == QLatin1String("remove")) {
+                if (keys.isEmpty()) {
+                    aMap->clear();
+                } else {
+                    journalApply(aMap, keys, 0, Q_NULLPTR);
+                }
+            } else {
+                HWARN("Unsupported operation" << op << "in" << aPath);
+            }
+            pos = eol + 1;
+        }
+
+        if (pos < data.size()) {
+            HWARN("Truncating" << aPath << "at" << pos);
+            QFile::resize(aPath, pos);
+        }
+        return pos;
+    }
+    return 0;
+}
+
+static
+bool
+journalSaveSnapshot(
+    const QString& aPath,
+    const QVariantMap& aMap)
+{
+    if (aMap.isEmpty()) {
+        // HarbourJson::save() would remove the file but return false
+        QFile f(aPath);
+
+        return !f.exists() || f.remove();
+    } else {
+        return HarbourJson::save(aPath, aMap, HarbourJson::SaveAtomic);
+    }
+}
+
+// ==========================================================================
+// HarbourJsonJournal::Task
+// ==========================================================================
+
+class HarbourJsonJournal::Task :
+    public HarbourTask
+{
+    Q_OBJECT
+
+public:
+    Task(QThreadPool*, const QString&, const QVariantMap&);
+
+    void performTask() Q_DECL_OVERRIDE;
+
+public:
+    const QString iPath;
+    const QVariantMap iMap;
+    // These are set on the worker thread
+    bool iWritten;
+    bool iSuccess;
+};
+
+HarbourJsonJournal::Task::Task(
+    QThreadPool* aPool,
+    const QString& aPath,
+    const QVariantMap& aMap) :
+    HarbourTask(aPool),
+    iPath(aPath),
+    iMap(aMap),
+    iWritten(false),
+    iSuccess(false)
+{
+}
+
+void
+HarbourJsonJournal::Task::performTask()
+{
+    HDEBUG(iPath);
+    iSuccess = journalSaveSnapshot(iPath, iMap);
+    iWritten = true;
+}
+
+// ==========================================================================
+// HarbourJsonJournal::Private
+// ==========================================================================
+
+class HarbourJsonJournal::Private :
+    public QObject
+{
+    Q_OBJECT
+
+public:
+    Private(HarbourJsonJournal*, const QString&);
+    ~Private();
+
+    HarbourJsonJournal* parentObject() const;
+    void updateBusy();
+    void closeJournal();
+    void restoreJournal();
+    bool append(const QByteArray&);
+    void checkSize();
+    void compact();
+    void finish(Task*);
+    void flush();
+    bool load();
+
+public Q_SLOTS:
+    void onTaskDone();
+
+public:
+    const QString iPath;
+    const QString iJournalPath;
+    const QString iOldJournalPath;
+    QThreadPool* iThreadPool;
+    QFile* iJournal;
+    Task* iTask;
+    QVariantMap iData;
+    qint64 iJournalSize;
+    qint64 iSnapshotSize;
+    qreal iCompactRatio;
+    bool iBusy;
+};
+
+HarbourJsonJournal::Private::Private(
+    HarbourJsonJournal* aParent,
+    const QString& aPath) :
+    QObject(aParent),
+    iPath(QFileInfo(aPath).absoluteFilePath()),
+    iJournalPath(iPath + JOURNAL_SUFFIX),
+    iOldJournalPath(iPath + OLD_JOURNAL_SUFFIX),
+    iThreadPool(new QThreadPool(this)),
+    iJournal(Q_NULLPTR),
+    iTask(Q_NULLPTR),
+    iJournalSize(0),
+    iSnapshotSize(0),
+    iCompactRatio(DEFAULT_COMPACT_RATIO),
+    iBusy(false)
+{
+    iThreadPool->setMaxThreadCount(1);
+}
+
+HarbourJsonJournal::Private::~Private()
+{
+    HASSERT(!iTask);
+    iThreadPool->waitForDone();
+    delete iJournal;
+}
+
+inline
+HarbourJsonJournal*
+HarbourJsonJournal::Private::parentObject() const
+{
+    return qobject_cast<HarbourJsonJournal*>(parent());
+}
+
+void
+HarbourJsonJournal::Private::updateBusy()
+{
+    const bool busy = (iTask != Q_NULLPTR);
+
+    if (iBusy != busy) {
+        iBusy = busy;
+        Q_EMIT parentObject()->busyChanged();
+    }
+}
+
+void
+HarbourJsonJournal::Private::closeJournal()
+{
+    if (iJournal) {
+        delete iJournal;
+        iJournal = Q_NULLPTR;
+    }
+}
+
+// Puts the old journal back in place after a failed compaction,
+// with whatever has been appended to the new one
+void
+HarbourJsonJournal::Private::restoreJournal()
+{
+    QFile current(iJournalPath);
+    QFile old(iOldJournalPath);
+    QByteArray data;
+
+    closeJournal();
+    if (current.open(QIODevice::ReadOnly)) {
+        data = current.readAll();
+        current.close();
+    }
+    if (old.open(QIODevice::WriteOnly | QIODevice::Append) &&
+        old.write(data) == data.size()) {
+        old.close();
+        current.remove();
+        if (old.rename(iJournalPath)) {
+            iJournalSize = QFileInfo(iJournalPath).size();
+            return;
+        }
+    }
+    HWARN("Failed to restore" << iJournalPath << old.errorString());
+}
+
+bool
+HarbourJsonJournal::Private::append(
+    const QByteArray& aRecord)
+{
+    if (!iJournal) {
+        QDir dir(QFileInfo(iJournalPath).dir());
+
+        dir.mkpath(dir.absolutePath());
+        iJournal = new QFile(iJournalPath);
+        if (!iJournal->open(QIODevice::WriteOnly | QIODevice::Append)) {
+            HWARN("Failed to open" << iJournalPath << iJournal->errorString());
+            closeJournal();
+            return false;
+        }
+    }
+
+    if (iJournal->write(aRecord) == aRecord.size() && iJournal->flush()) {
+        iJournalSize += aRecord.size();
+        return true;
+    } else {
+        // Don't leave a partial record behind, the next one would
+        // be glued to it
+        HWARN("Failed to write" << iJournalPath << iJournal->errorString());
+        iJournal->resize(iJournalSize);
+        return false;
+    }
+}
+
+void
+HarbourJsonJournal::Private::checkSize()
+{
+    if (!iTask && iJournalSize >= MIN_COMPACT_SIZE &&
+        iJournalSize > iSnapshotSize * iCompactRatio) {
+        HDEBUG(iJournalSize << "vs" << iSnapshotSize);
+        compact();
+    }
+}
+
+void
+HarbourJsonJournal::Private::compact()
+{
+    if (!iTask && iJournalSize > 0) {
+        // Everything from now on goes to a new journal
+        closeJournal();
+        if (QFile::rename(iJournalPath, iOldJournalPath)) {
+            iJournalSize = 0;
+            iTask = new Task(iThreadPool, iPath, iData);
+            iTask->submit(this, SLOT(onTaskDone()));
+            updateBusy();
+        } else {
+            HWARN("Failed to rename" << iJournalPath);
+        }
+    }
+}
+
+void
+HarbourJsonJournal::Private::finish(
+    Task* aTask)
+{
+    bool ok = aTask->iSuccess;
+
+    HASSERT(aTask == iTask);
+    if (!aTask->iWritten) {
+        // The task has been canceled (that happens on aboutToQuit)
+        HDEBUG("writing" << iPath);
+        ok = journalSaveSnapshot(aTask->iPath, aTask->iMap);
+    }
+    aTask->release();
+    iTask = Q_NULLPTR;
+    if (ok) {
+        QFile::remove(iOldJournalPath);
+        iSnapshotSize = QFileInfo(iPath).size();
+    } else {
+        HWARN("Failed to compact" << iPath);
+        restoreJournal();
+    }
+    Q_EMIT parentObject()->compacted(ok);
+}
+
+void
+HarbourJsonJournal::Private::flush()
+{
+    if (iTask) {
+        iThreadPool->waitForDone();
+        finish(iTask);
+        updateBusy();
+    }
+}
+
+bool
+HarbourJsonJournal::Private::load()
+{
+    flush();
+    closeJournal();
+    iData.clear();
+    HarbourJson::load(iPath, iData);
+
+    if (QFile::exists(iOldJournalPath)) {
+        // The last compaction didn't finish, finish it now
+        HDEBUG("recovering" << iPath);
+        journalReplay(iOldJournalPath, &iData);
+        iJournalSize = journalReplay(iJournalPath, &iData);
+        if (journalSaveSnapshot(iPath, iData)) {
+            QFile::remove(iOldJournalPath);
+            QFile::remove(iJournalPath);
+            iJournalSize = 0;
+        } else {
+            restoreJournal();
+        }
+    } else {
+        iJournalSize = journalReplay(iJournalPath, &iData);
+    }
+    iSnapshotSize = QFileInfo(iPath).size();
+    HDEBUG(iPath << iSnapshotSize << iJournalSize);
+    checkSize();
+    return !iData.isEmpty();
+}
+
+void
+HarbourJsonJournal::Private::onTaskDone()
+{
+    Task* task = qobject_cast<Task*>(sender());
+
+    if (task && task == iTask) {
+        finish(task);
+        updateBusy();
+        checkSize();
+    }
+}
+
+// ==========================================================================
+// HarbourJsonJournal
+// ==========================================================================
+
+HarbourJsonJournal::HarbourJsonJournal(
+    const QString& aPath,
+    QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private(this, aPath))
+{
+    iPrivate->load();
+}
+
+HarbourJsonJournal::~HarbourJsonJournal()
+{
+    iPrivate->flush();
+    delete iPrivate;
+}
+
+QString
+HarbourJsonJournal::path() const
+{
+    return iPrivate->iPath;
+}
+
+QString
+HarbourJsonJournal::journalPath() const
+{
+    return iPrivate->iJournalPath;
+}
+
+qreal
+HarbourJsonJournal::compactRatio() const
+{
+    return iPrivate->iCompactRatio;
+}
+
+void
+HarbourJsonJournal::setCompactRatio(
+    qreal aRatio)
+{
+    const qreal ratio = qMax(aRatio, (qreal)0);
+
+    if (iPrivate->iCompactRatio != ratio) {
+        iPrivate->iCompactRatio = ratio;
+        HDEBUG(ratio);
+        Q_EMIT compactRatioChanged();
+        iPrivate->checkSize();
+    }
+}
+
+bool
+HarbourJsonJournal::busy() const
+{
+    return iPrivate->iBusy;
+}
+
+// Returns false if there's nothing to load
+bool
+HarbourJsonJournal::load()
+{
+    return iPrivate->load();
+}
+
+QVariantMap
+HarbourJsonJournal::data() const
+{
+    return iPrivate->iData;
+}
+
+QVariant
+HarbourJsonJournal::value(
+    const QStringList& aKeys) const
+{
+    QVariant value(iPrivate->iData);
+    const int n = aKeys.count();
+
+    for (int i = 0; i < n && value.isValid(); i++) {
+        value = (value.type() == QVariant::Map) ?
+            value.toMap().value(aKeys.at(i)) : QVariant();
+    }
+    return value;
+}
+
+bool
+HarbourJsonJournal::setValue(
+    const QStringList& aKeys,
+    const QVariant& aValue)
+{
+    const int n = aKeys.count();
+    int i = 0;
+
+    if (!n) {
+        // Replacing the whole thing
+        if (aValue.type() != QVariant::Map) {
+            return false;
+        } else if (aValue.toMap() != iPrivate->iData) {
+            if (!iPrivate->append(journalRecord("add", aKeys, &aValue))) {
+                return false;
+            }
+            iPrivate->iData = aValue.toMap();
+            iPrivate->checkSize();
+        }
+        return true;
+    }
+
+    // Find the first parent which needs to be created
+    if (n > 1) {
+        QVariantMap map(iPrivate->iData);
+
+        for (; i < n - 1; i++) {
+            const QVariant child(map.value(aKeys.at(i)));
+
+            if (child.type() != QVariant::Map) {
+                break;
+            }
+            map = child.toMap();
+        }
+        if (i == n - 1 && map.contains(aKeys.last()) &&
+            map.value(aKeys.last()) == aValue) {
+            return true;
+        }
+    } else if (iPrivate->iData.contains(aKeys.first()) &&
+        iPrivate->iData.value(aKeys.first()) == aValue) {
+        return true;
+    }
+
+    // The record creates the missing part of the path, so that
+    // it can be applied by anything that understands JSON Patch
+    QVariant added(aValue);
+
+    for (int k = n - 1; k > i; k--) {
+        QVariantMap map;
+
+        map.insert(aKeys.at(k), added);
+        added = map;
+    }
+    if (!iPrivate->append(journalRecord("add", aKeys.mid(0, i + 1),
+        &added))) {
+        return false;
+    }
+
+    // Compaction (if it starts) must see this change
+    journalApply(&iPrivate->iData, aKeys, 0, &aValue);
+    iPrivate->checkSize();
+    return true;
+}
+
+bool
+HarbourJsonJournal::remove(
+    const QStringList& aKeys)
+{
+    if (aKeys.isEmpty()) {
+        if (!iPrivate->iData.isEmpty()) {
+            if (!iPrivate->append(journalRecord("remove", aKeys,
+                Q_NULLPTR))) {
+                return false;
+            }
+            iPrivate->iData.clear();
+            iPrivate->checkSize();
+        }
+    } else {
+        const QStringList parentKeys(aKeys.mid(0, aKeys.count() - 1));
+        const QVariant parent(value(parentKeys));
+
+        if (parent.type() == QVariant::Map &&
+            parent.toMap().contains(aKeys.last())) {
+            if (!iPrivate->append(journalRecord("remove", aKeys,
+                Q_NULLPTR))) {
+                return false;
+            }
+            journalApply(&iPrivate->iData, aKeys, 0, Q_NULLPTR);
+            iPrivate->checkSize();
+        }
+    }
+    return true;
+}
+
+void
+HarbourJsonJournal::compact()
+{
+    iPrivate->compact();
+}
+
+// Waits for the compaction to finish (if there's one going on)
+void
+HarbourJsonJournal::flush()
+{
+    iPrivate->flush();
+}
+
+#include "HarbourJsonJournal.moc"
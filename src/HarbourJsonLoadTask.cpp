@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourJsonLoadTask.h"
+#include "HarbourJson.h"
+#include "HarbourDebug.h"
+
+#include <QtCore/QFile>
+
+// ==========================================================================
+// HarbourJsonLoadTask::Private
+// ==========================================================================
+
+class HarbourJsonLoadTask::Private
+{
+public:
+    Private(const QString);
+
+    Error load(const HarbourTask*);
+
+public:
+    const QString iPath;
+    Error iError;
+    QString iErrorString;
+    QVariantMap iData;
+};
+
+HarbourJsonLoadTask::Private::Private(
+    const QString aPath) :
+    iPath(aPath),
+    iError(CanceledError)
+{
+}
+
+HarbourJsonLoadTask::Error
+HarbourJsonLoadTask::Private::load(
+    const HarbourTask* aTask)
+{
+    if (HarbourJson::loadSidecar(iPath, iData)) {
+        return NoError;
+    }
+
+    QFile f(iPath);
+
+    if (aTask->isCanceled()) {
+        return CanceledError;
+    } else if (!f.open(QIODevice::ReadOnly)) {
+        iErrorString = f.errorString();
+        HDEBUG("can't open" << iPath << iErrorString);
+        return FileError;
+    }
+
+    // Reading may take a while if the storage is slow, check
+    // the cancel flag after each chunk.
+    QByteArray json;
+    int n = 0;
+
+    HDEBUG("reading" << iPath);
+    json.reserve((int)f.size() + CHUNK_SIZE);
+    for (;;) {
+        json.resize(n + CHUNK_SIZE);
+        const qint64 bytes = f.read(json.data() + n, CHUNK_SIZE);
+
+        if (bytes < 0) {
+            iErrorString = f.errorString();
+            HWARN("Failed to read" << iPath << iErrorString);
+            return FileError;
+        }
+        n += (int)bytes;
+        json.truncate(n);
+        if (!bytes) {
+            break;
+        } else if (aTask->isCanceled()) {
+            return CanceledError;
+        }
+    }
+    f.close();
+
+    if (!HarbourJson::parse(json, iData, &iErrorString)) {
+        HWARN("Failed to parse" << iPath << iErrorString);
+        return ParseError;
+    }
+    return aTask->isCanceled() ? CanceledError : NoError;
+}
+
+// ==========================================================================
+// HarbourJsonLoadTask
+// ==========================================================================
+
+HarbourJsonLoadTask::HarbourJsonLoadTask(
+    QThreadPool* aPool,
+    const QString aPath) :
+    HarbourTask(aPool),
+    iPrivate(new Private(aPath))
+{
+}
+
+HarbourJsonLoadTask::~HarbourJsonLoadTask()
+{
+    delete iPrivate;
+}
+
+void
+HarbourJsonLoadTask::performTask()
+{
+    iPrivate->iError = iPrivate->load(this);
+    if (iPrivate->iError != NoError) {
+        iPrivate->iData.clear();
+    }
+}
+
+QString
+HarbourJsonLoadTask::path() const
+{
+    return iPrivate->iPath;
+}
+
+HarbourJsonLoadTask::Error
+HarbourJsonLoadTask::error() const
+{
+    return iPrivate->iError;
+}
+
+QString
+HarbourJsonLoadTask::errorString() const
+{
+    return iPrivate->iErrorString;
+}
+
+QVariantMap
+HarbourJsonLoadTask::data() const
+{
+    return iPrivate->iData;
+}
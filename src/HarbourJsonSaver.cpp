@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourJsonSaver.h"
+#include "HarbourTask.h"
+#include "HarbourDebug.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
+// ==========================================================================
+// HarbourJsonSaver::Task
+// ==========================================================================
+
+class HarbourJsonSaver::Task :
+    public HarbourTask
+{
+    Q_OBJECT
+
+public:
+    Task(QThreadPool*, const QString&, const QVariantMap&,
+        HarbourJson::SaveOptions);
+
+    void performTask() Q_DECL_OVERRIDE;
+
+public:
+    const QString iPath;
+    const QVariantMap iMap;
+    const HarbourJson::SaveOptions iOptions;
+    // These are set on the worker thread
+    bool iWritten;
+    bool iSuccess;
+};
+
+HarbourJsonSaver::Task::Task(
+    QThreadPool* aPool,
+    const QString& aPath,
+    const QVariantMap& aMap,
+    HarbourJson::SaveOptions aOptions) :
+    HarbourTask(aPool),
+    iPath(aPath),
+    iMap(aMap),
+    iOptions(aOptions),
+    iWritten(false),
+    iSuccess(false)
+{
+}
+
+void
+HarbourJsonSaver::Task::performTask()
+{
+    HDEBUG(iPath);
+    iSuccess = HarbourJson::save(iPath, iMap, iOptions);
+    iWritten = true;
+}
+
+// ==========================================================================
+// HarbourJsonSaver::Private
+// ==========================================================================
+
+class HarbourJsonSaver::Private :
+    public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Pending {
+        QVariantMap iMap;
+        qint64 iDeadline;
+    };
+
+    Private(HarbourJsonSaver*);
+    ~Private();
+
+    HarbourJsonSaver* parentObject() const;
+    void updateBusy();
+    void schedule();
+    void save(const QString&, const QVariantMap&);
+    void submit(const QString&, const QVariantMap&);
+    void finish(Task*);
+    void flush();
+
+public Q_SLOTS:
+    void onTimeout();
+    void onTaskDone();
+
+public:
+    QThreadPool* iThreadPool;
+    QTimer* iTimer;
+    QElapsedTimer iClock;
+    QMap<QString,Pending> iPending;
+    QList<Task*> iTasks;
+    HarbourJson::SaveOptions iOptions;
+    int iDelay;
+    bool iBusy;
+};
+
+HarbourJsonSaver::Private::Private(
+    HarbourJsonSaver* aParent) :
+    QObject(aParent),
+    iThreadPool(new QThreadPool(this)),
+    iTimer(new QTimer(this)),
+    iOptions(HarbourJson::SaveDefault),
+    iDelay(DEFAULT_DELAY),
+    iBusy(false)
+{
+    // Serialize the writes
+    iThreadPool->setMaxThreadCount(1);
+    iTimer->setSingleShot(true);
+    iClock.start();
+    connect(iTimer, SIGNAL(timeout()), SLOT(onTimeout()));
+}
+
+HarbourJsonSaver::Private::~Private()
+{
+    HASSERT(iPending.isEmpty());
+    HASSERT(iTasks.isEmpty());
+    iThreadPool->waitForDone();
+}
+
+inline
+HarbourJsonSaver*
+HarbourJsonSaver::Private::parentObject() const
+{
+    return qobject_cast<HarbourJsonSaver*>(parent());
+}
+
+void
+HarbourJsonSaver::Private::updateBusy()
+{
+    const bool busy = !iPending.isEmpty() || !iTasks.isEmpty();
+
+    if (iBusy != busy) {
+        iBusy = busy;
+        Q_EMIT parentObject()->busyChanged();
+    }
+}
+
+void
+HarbourJsonSaver::Private::schedule()
+{
+    if (iPending.isEmpty()) {
+        iTimer->stop();
+    } else {
+        QMap<QString,Pending>::ConstIterator it = iPending.constBegin();
+        qint64 deadline = it.value().iDeadline;
+
+        for (++it; it != iPending.constEnd(); ++it) {
+            deadline = qMin(deadline, it.value().iDeadline);
+        }
+        iTimer->start((int)qMax(deadline - iClock.elapsed(), Q_INT64_C(0)));
+    }
+}
+
+void
+HarbourJsonSaver::Private::save(
+    const QString& aPath,
+    const QVariantMap& aMap)
+{
+    QMap<QString,Pending>::Iterator it = iPending.find(aPath);
+
+    if (it == iPending.end()) {
+        Pending pending;
+
+        // The window starts with the first save, so that a steady stream
+        // of updates can't postpone the write forever
+        pending.iMap = aMap;
+        pending.iDeadline = iClock.elapsed() + iDelay;
+        iPending.insert(aPath, pending);
+        schedule();
+        updateBusy();
+    } else {
+        HDEBUG("coalescing" << aPath);
+        it.value().iMap = aMap;
+    }
+}
+
+void
+HarbourJsonSaver::Private::submit(
+    const QString& aPath,
+    const QVariantMap& aMap)
+{
+    Task* task = new Task(iThreadPool, aPath, aMap, iOptions);
+
+    iTasks.append(task);
+    task->submit(this, SLOT(onTaskDone()));
+}
+
+void
+HarbourJsonSaver::Private::finish(
+    Task* aTask)
+{
+    const QString path(aTask->iPath);
+    bool report = true;
+    bool ok = aTask->iSuccess;
+
+    iTasks.removeOne(aTask);
+    if (!aTask->iWritten) {
+        // The task has been canceled (that happens on aboutToQuit).
+        // Write the file here unless a newer snapshot is on its way.
+        bool superseded = iPending.contains(path);
+
+        for (int i = 0; i < iTasks.count() && !superseded; i++) {
+            superseded = (iTasks.at(i)->iPath == path);
+        }
+        if (superseded) {
+            report = false;
+        } else {
+            HDEBUG("writing" << path);
+            ok = HarbourJson::save(path, aTask->iMap, aTask->iOptions);
+        }
+    }
+    aTask->release();
+    if (report) {
+        Q_EMIT parentObject()->saved(path, ok);
+    }
+}
+
+void
+HarbourJsonSaver::Private::flush()
+{
+    QMap<QString,Pending>::ConstIterator it = iPending.constBegin();
+
+    iTimer->stop();
+    for (; it != iPending.constEnd(); ++it) {
+        submit(it.key(), it.value().iMap);
+    }
+    iPending.clear();
+
+    // Results are handled synchronously, in the order of submission
+    iThreadPool->waitForDone();
+    while (!iTasks.isEmpty()) {
+        finish(iTasks.first());
+    }
+    updateBusy();
+}
+
+void
+HarbourJsonSaver::Private::onTimeout()
+{
+    const qint64 now = iClock.elapsed();
+    QMap<QString,Pending>::Iterator it = iPending.begin();
+
+    while (it != iPending.end()) {
+        if (it.value().iDeadline <= now) {
+            submit(it.key(), it.value().iMap);
+            it = iPending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    schedule();
+}
+
+void
+HarbourJsonSaver::Private::onTaskDone()
+{
+    Task* task = qobject_cast<Task*>(sender());
+
+    if (task && iTasks.contains(task)) {
+        finish(task);
+        updateBusy();
+    }
+}
+
+// ==========================================================================
+// HarbourJsonSaver
+// ==========================================================================
+
+HarbourJsonSaver::HarbourJsonSaver(
+    QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private(this))
+{
+}
+
+HarbourJsonSaver::~HarbourJsonSaver()
+{
+    iPrivate->flush();
+    delete iPrivate;
+}
+
+int
+HarbourJsonSaver::delay() const
+{
+    return iPrivate->iDelay;
+}
+
+void
+HarbourJsonSaver::setDelay(
+    int aDelay)
+{
+    const int delay = qMax(aDelay, 0);
+
+    if (iPrivate->iDelay != delay) {
+        iPrivate->iDelay = delay;
+        HDEBUG(delay);
+        Q_EMIT delayChanged();
+    }
+}
+
+HarbourJson::SaveOptions
+HarbourJsonSaver::saveOptions() const
+{
+    return iPrivate->iOptions;
+}
+
+// Applies to the saves which haven't been handed to the worker yet
+void
+HarbourJsonSaver::setSaveOptions(
+    HarbourJson::SaveOptions aOptions)
+{
+    iPrivate->iOptions = aOptions;
+}
+
+bool
+HarbourJsonSaver::busy() const
+{
+    return iPrivate->iBusy;
+}
+
+void
+HarbourJsonSaver::save(
+    const QString& aPath,
+    const QVariantMap& aMap)
+{
+    // QVariantMap is implicitly shared, copying it is cheap and the
+    // caller can modify its map right away without affecting this one.
+    iPrivate->save(aPath, aMap);
+}
+
+void
+HarbourJsonSaver::flush()
+{
+    iPrivate->flush();
+}
+
+#include "HarbourJsonSaver.moc"
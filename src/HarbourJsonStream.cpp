@@ -0,0 +1,918 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourJson.h"
+#include "HarbourDebug.h"
+
+#include <math.h>
+#include <string.h>
+
+static inline
+bool
+jsonIsDigit(
+    char aChar)
+{
+    return aChar >= '0' && aChar <= '9';
+}
+
+// Returns -1 if it's not a hex digit
+static inline
+int
+jsonHexValue(
+    char aChar)
+{
+    return (aChar >= '0' && aChar <= '9') ? (aChar - '0') :
+        (aChar >= 'a' && aChar <= 'f') ? (aChar - 'a' + 10) :
+        (aChar >= 'A' && aChar <= 'F') ? (aChar - 'A' + 10) : -1;
+}
+
+// ==========================================================================
+// HarbourJson::Reader
+// ==========================================================================
+
+HarbourJson::Reader::Reader(
+    const QByteArray aData) :
+    iData(aData),
+    iStart(iData.constData()),
+    iEnd(iStart + iData.size()),
+    iPtr(iStart),
+    iTokenPtr(iStart),
+    iTokenSize(0),
+    iToken(TOKEN_END),
+    iExpect(EXPECT_VALUE),
+    iEscaped(false),
+    iInteger(false)
+{
+    // Skip UTF-8 BOM
+    if (iData.startsWith("\xef\xbb\xbf")) {
+        iPtr += 3;
+    }
+}
+
+HarbourJson::Reader::Reader(
+    const char* aData,
+    int aSize) :
+    iStart(aData),
+    iEnd(iStart + qMax(aSize, 0)),
+    iPtr(iStart),
+    iTokenPtr(iStart),
+    iTokenSize(0),
+    iToken(TOKEN_END),
+    iExpect(EXPECT_VALUE),
+    iEscaped(false),
+    iInteger(false)
+{
+    if ((iEnd - iPtr) >= 3 && !memcmp(iPtr, "\xef\xbb\xbf", 3)) {
+        iPtr += 3;
+    }
+}
+
+HarbourJson::Reader::Token
+HarbourJson::Reader::token() const
+{
+    return iToken;
+}
+
+int
+HarbourJson::Reader::position() const
+{
+    return iTokenPtr - iStart;
+}
+
+int
+HarbourJson::Reader::depth() const
+{
+    return iStack.size();
+}
+
+const char*
+HarbourJson::Reader::tokenData() const
+{
+    return iTokenPtr;
+}
+
+int
+HarbourJson::Reader::tokenSize() const
+{
+    return iTokenSize;
+}
+
+bool
+HarbourJson::Reader::isEscaped() const
+{
+    return iEscaped;
+}
+
+inline
+void
+HarbourJson::Reader::skipSpaces()
+{
+    while (iPtr < iEnd && (*iPtr == ' ' || *iPtr == '\n' ||
+        *iPtr == '\r' || *iPtr == '\t')) {
+        iPtr++;
+    }
+}
+
+inline
+void
+HarbourJson::Reader::valueDone()
+{
+    iExpect = iStack.isEmpty() ? EXPECT_NOTHING : EXPECT_COMMA_OR_END;
+}
+
+HarbourJson::Reader::Token
+HarbourJson::Reader::error(
+    const char* aWhat)
+{
+    HDEBUG(aWhat << "at" << (iPtr - iStart));
+    iTokenPtr = iPtr;
+    iTokenSize = 0;
+    return (iToken = TOKEN_ERROR);
+}
+
+HarbourJson::Reader::Token
+HarbourJson::Reader::next()
+{
+    if (iToken != TOKEN_ERROR) {
+        skipSpaces();
+        iTokenPtr = iPtr;
+        iTokenSize = 0;
+        iEscaped = false;
+        switch (iExpect) {
+        case EXPECT_VALUE:
+            return parseValue();
+        case EXPECT_NAME_OR_END:
+            if (iPtr < iEnd) {
+                if (*iPtr == '}') {
+                    return parseClose('}');
+                } else if (*iPtr == '"') {
+                    return parseString(TOKEN_NAME);
+                }
+            }
+            return error("Expecting name");
+        case EXPECT_VALUE_OR_END:
+            if (iPtr < iEnd && *iPtr == ']') {
+                return parseClose(']');
+            }
+            return parseValue();
+        case EXPECT_COMMA_OR_END:
+            if (iPtr < iEnd) {
+                const char c = *iPtr;
+
+                if (c == ',') {
+                    iPtr++;
+                    skipSpaces();
+                    iTokenPtr = iPtr;
+                    if (iStack.at(iStack.size() - 1) == '[') {
+                        return parseValue();
+                    } else if (iPtr < iEnd && *iPtr == '"') {
+                        return parseString(TOKEN_NAME);
+                    }
+                    return error("Expecting name");
+                } else if (c == '}' || c == ']') {
+                    return parseClose(c);
+                }
+            }
+            return error("Expecting comma");
+        case EXPECT_NOTHING:
+            if (iPtr == iEnd) {
+                return (iToken = TOKEN_END);
+            }
+            return error("Garbage at the end");
+        }
+    }
+    return TOKEN_ERROR;
+}
+
+HarbourJson::Reader::Token
+HarbourJson::Reader::parseValue()
+{
+    if (iPtr < iEnd) {
+        switch (*iPtr) {
+        case '{':
+        case '[':
+            if (iStack.size() < MAX_DEPTH) {
+                const char c = *iPtr++;
+
+                iStack.append(c);
+                iTokenSize = 1;
+                if (c == '{') {
+                    iExpect = EXPECT_NAME_OR_END;
+                    return (iToken = TOKEN_BEGIN_OBJECT);
+                } else {
+                    iExpect = EXPECT_VALUE_OR_END;
+                    return (iToken = TOKEN_BEGIN_ARRAY);
+                }
+            }
+            return error("Too deep");
+        case '"':
+            return parseString(TOKEN_STRING);
+        case 't':
+            return parseLiteral("true", 4, TOKEN_TRUE);
+        case 'f':
+            return parseLiteral("false", 5, TOKEN_FALSE);
+        case 'n':
+            return parseLiteral("null", 4, TOKEN_NULL);
+        default:
+            return parseNumber();
+        }
+    }
+    return error("Expecting value");
+}
+
+HarbourJson::Reader::Token
+HarbourJson::Reader::parseClose(
+    char aChar)
+{
+    const int n = iStack.size();
+
+    if (n > 0 && iStack.at(n - 1) == ((aChar == '}') ? '{' : '[')) {
+        iStack.truncate(n - 1);
+        iPtr++;
+        iTokenSize = 1;
+        valueDone();
+        return (iToken = (aChar == '}') ? TOKEN_END_OBJECT : TOKEN_END_ARRAY);
+    }
+    return error("Unbalanced");
+}
+
+HarbourJson::Reader::Token
+HarbourJson::Reader::parseString(
+    Token aToken)
+{
+    const char* p = iPtr + 1;
+    bool escaped = false;
+
+    while (p < iEnd) {
+        const uchar c = *p;
+
+        if (c == '"') {
+            break;
+        } else if (c == '\\') {
+            escaped = true;
+            if (++p < iEnd) {
+                switch (*p) {
+                case '"': case '\\': case '/':
+                case 'b': case 'f': case 'n': case 'r': case 't':
+                    p++;
+                    continue;
+                case 'u':
+                    if ((iEnd - p) > 4 && jsonHexValue(p[1]) >= 0 &&
+                        jsonHexValue(p[2]) >= 0 && jsonHexValue(p[3]) >= 0 &&
+                        jsonHexValue(p[4]) >= 0) {
+                        p += 5;
+                        continue;
+                    }
+                    break;
+                }
+            }
+            iPtr = p - 1;
+            return error("Invalid escape");
+        } else if (c < 0x20) {
+            iPtr = p;
+            return error("Control character");
+        } else {
+            p++;
+        }
+    }
+
+    if (p >= iEnd) {
+        return error("Unterminated string");
+    }
+
+    iTokenPtr = iPtr + 1;
+    iTokenSize = p - iTokenPtr;
+    iEscaped = escaped;
+    iPtr = p + 1;
+    if (aToken == TOKEN_NAME) {
+        skipSpaces();
+        if (iPtr < iEnd && *iPtr == ':') {
+            iPtr++;
+            iExpect = EXPECT_VALUE;
+        } else {
+            return error("Expecting colon");
+        }
+    } else {
+        valueDone();
+    }
+    return (iToken = aToken);
+}
+
+HarbourJson::Reader::Token
+HarbourJson::Reader::parseNumber()
+{
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    const char* p = iPtr;
+    bool integer = true;
+
+    if (p < iEnd && *p == '-') {
+        p++;
+    }
+    if (p < iEnd && *p == '0') {
+        p++;
+    } else if (p < iEnd && *p >= '1' && *p <= '9') {
+        while (++p < iEnd && jsonIsDigit(*p));
+    } else {
+        iPtr = p;
+        return error("Expecting value");
+    }
+    if (p < iEnd && *p == '.') {
+        integer = false;
+        if (++p < iEnd && jsonIsDigit(*p)) {
+            while (++p < iEnd && jsonIsDigit(*p));
+        } else {
+            iPtr = p;
+            return error("Invalid number");
+        }
+    }
+    if (p < iEnd && (*p == 'e' || *p == 'E')) {
+        integer = false;
+        if (++p < iEnd && (*p == '+' || *p == '-')) {
+            p++;
+        }
+        if (p < iEnd && jsonIsDigit(*p)) {
+            while (++p < iEnd && jsonIsDigit(*p));
+        } else {
+            iPtr = p;
+            return error("Invalid number");
+        }
+    }
+    iTokenSize = p - iPtr;
+    iInteger = integer;
+    iPtr = p;
+    valueDone();
+    return (iToken = TOKEN_NUMBER);
+}
+
+HarbourJson::Reader::Token
+HarbourJson::Reader::parseLiteral(
+    const char* aLiteral,
+    int aLength,
+    Token aToken)
+{
+    if ((iEnd - iPtr) >= aLength && !memcmp(iPtr, aLiteral, aLength)) {
+        iTokenSize = aLength;
+        iPtr += aLength;
+        valueDone();
+        return (iToken = aToken);
+    }
+    return error("Expecting value");
+}
+
+bool
+HarbourJson::Reader::equals(
+    const char* aLatin1) const
+{
+    if (iToken == TOKEN_NAME || iToken == TOKEN_STRING) {
+        if (!iEscaped) {
+            return (int)strlen(aLatin1) == iTokenSize &&
+                !memcmp(aLatin1, iTokenPtr, iTokenSize);
+        }
+        return string() == QLatin1String(aLatin1);
+    }
+    return false;
+}
+
+QString
+HarbourJson::Reader::string() const
+{
+    if (iToken != TOKEN_NAME && iToken != TOKEN_STRING) {
+        return QString();
+    } else if (!iEscaped) {
+        return QString::fromUtf8(iTokenPtr, iTokenSize);
+    } else {
+        // The escape sequences have been validated by the parser
+        const char* p = iTokenPtr;
+        const char* end = p + iTokenSize;
+        const char* run = p;
+        QString s;
+
+        s.reserve(iTokenSize);
+        while (p < end) {
+            if (*p == '\\') {
+                if (p > run) {
+                    s.append(QString::fromUtf8(run, p - run));
+                }
+                p++;
+                switch (*p++) {
+                case 'b': s.append(QLatin1Char('\b')); break;
+                case 'f': s.append(QLatin1Char('\f')); break;
+                case 'n': s.append(QLatin1Char('\n')); break;
+                case 'r': s.append(QLatin1Char('\r')); break;
+                case 't': s.append(QLatin1Char('\t')); break;
+                case 'u':
+                    // Surrogate pairs come out right by themselves
+                    s.append(QChar((ushort)((jsonHexValue(p[0]) << 12) |
+                        (jsonHexValue(p[1]) << 8) | (jsonHexValue(p[2]) << 4) |
+                        jsonHexValue(p[3]))));
+                    p += 4;
+                    break;
+                default:
+                    s.append(QLatin1Char(p[-1]));
+                    break;
+                }
+                run = p;
+            } else {
+                p++;
+            }
+        }
+        if (p > run) {
+            s.append(QString::fromUtf8(run, p - run));
+        }
+        return s;
+    }
+}
+
+QByteArray
+HarbourJson::Reader::utf8() const
+{
+    if (iToken != TOKEN_NAME && iToken != TOKEN_STRING) {
+        return QByteArray();
+    } else if (!iEscaped) {
+        return QByteArray(iTokenPtr, iTokenSize);
+    } else {
+        return string().toUtf8();
+    }
+}
+
+double
+HarbourJson::Reader::number() const
+{
+    if (iToken == TOKEN_NUMBER) {
+        // Small integers are exact, no need to go through strtod
+        if (iInteger && iTokenSize <= 15) {
+            return (double)integer();
+        }
+        // QByteArray::toDouble() doesn't depend on the locale
+        return QByteArray(iTokenPtr, iTokenSize).toDouble();
+    }
+    return 0;
+}
+
+qint64
+HarbourJson::Reader::integer() const
+{
+    if (iToken == TOKEN_NUMBER) {
+        if (iInteger && iTokenSize <= 18) {
+            const char* p = iTokenPtr;
+            const char* end = p + iTokenSize;
+            const bool negative = (*p == '-');
+            qint64 value = 0;
+
+            for (p += negative; p < end; p++) {
+                value = value * 10 + (*p - '0');
+            }
+            return negative ? -value : value;
+        } else {
+            const double d = number();
+
+            return (d >= 9.2e18) ? Q_INT64_C(0x7fffffffffffffff) :
+                (d <= -9.2e18) ? (-Q_INT64_C(0x7fffffffffffffff) - 1) :
+                (qint64)d;
+        }
+    }
+    return 0;
+}
+
+// Unlike the above, doesn't round or saturate anything
+bool
+HarbourJson::Reader::integer(
+    qint64* aValue) const
+{
+    if (iToken == TOKEN_NUMBER) {
+        if (iInteger) {
+            const char* p = iTokenPtr;
+            const char* end = p + iTokenSize;
+            const bool negative = (*p == '-');
+            const quint64 limit = negative ?
+                Q_UINT64_C(0x8000000000000000) :
+                Q_UINT64_C(0x7fffffffffffffff);
+            quint64 value = 0;
+
+            for (p += negative; p < end; p++) {
+                const int digit = *p - '0';
+
+                if (value > (limit - digit) / 10) {
+                    return false;
+                }
+                value = value * 10 + digit;
+            }
+            *aValue = (negative && value) ? (-(qint64)(value - 1) - 1) :
+                (qint64)value;
+            return true;
+        } else {
+            // Something like 1.0 or 1e3
+            const double d = number();
+
+            if (d == floor(d) && d >= -9223372036854775808.0 &&
+                d < 9223372036854775808.0) {
+                *aValue = (qint64)d;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool
+HarbourJson::Reader::skipValue()
+{
+    switch (iToken) {
+    case TOKEN_BEGIN_OBJECT:
+    case TOKEN_BEGIN_ARRAY:
+        {
+            // Until the matching end
+            const int depth = iStack.size();
+
+            while (iStack.size() >= depth) {
+                const Token t = next();
+
+                if (t == TOKEN_ERROR || t == TOKEN_END) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    case TOKEN_STRING:
+    case TOKEN_NUMBER:
+    case TOKEN_TRUE:
+    case TOKEN_FALSE:
+    case TOKEN_NULL:
+        // Already done
+        return true;
+    case TOKEN_ERROR:
+    case TOKEN_END:
+    case TOKEN_END_OBJECT:
+    case TOKEN_END_ARRAY:
+    case TOKEN_NAME:
+        break;
+    }
+    return false;
+}
+
+// ==========================================================================
+// HarbourJson::Writer
+// ==========================================================================
+
+HarbourJson::Writer::Writer(
+    bool aIndent) :
+    iDepth(0),
+    iIndent(aIndent),
+    iNeedComma(false),
+    iAfterName(false)
+{
+}
+
+void
+HarbourJson::Writer::clear()
+{
+    iBuf.clear();
+    iDepth = 0;
+    iNeedComma = false;
+    iAfterName = false;
+}
+
+QByteArray
+HarbourJson::Writer::data() const
+{
+    HASSERT(!iDepth);
+    return iBuf;
+}
+
+int
+HarbourJson::Writer::depth() const
+{
+    return iDepth;
+}
+
+void
+HarbourJson::Writer::newLine()
+{
+    iBuf.append('\n');
+    for (int i = 0; i < iDepth; i++) {
+        iBuf.append("    ", 4);
+    }
+}
+
+void
+HarbourJson::Writer::separate()
+{
+    if (iAfterName) {
+        iAfterName = false;
+    } else {
+        if (iNeedComma) {
+            iBuf.append(',');
+        }
+        if (iIndent && iDepth > 0) {
+            newLine();
+        }
+    }
+}
+
+void
+HarbourJson::Writer::appendString(
+    const char* aUtf8,
+    int aSize)
+{
+    const char* p = aUtf8;
+    const char* end = p + aSize;
+    const char* run = p;
+
+    iBuf.append('"');
+    for (; p < end; p++) {
+        const uchar c = *p;
+
+        if (c < 0x20 || c == '"' || c == '\\') {
+            if (p > run) {
+                iBuf.append(run, p - run);
+            }
+            run = p + 1;
+            iBuf.append('\\');
+            switch (c) {
+            case '"': iBuf.append('"'); break;
+            case '\\': iBuf.append('\\'); break;
+            case '\b': iBuf.append('b'); break;
+            case '\f': iBuf.append('f'); break;
+            case '\n': iBuf.append('n'); break;
+            case '\r': iBuf.append('r'); break;
+            case '\t': iBuf.append('t'); break;
+            default:
+                {
+                    static const char hex[] = "0123456789abcdef";
+                    const char u[5] = { 'u', '0', '0', hex[c >> 4],
+                        hex[c & 0x0f] };
+
+                    iBuf.append(u, sizeof(u));
+                }
+                break;
+            }
+        }
+    }
+    if (p > run) {
+        iBuf.append(run, p - run);
+    }
+    iBuf.append('"');
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::beginObject()
+{
+    separate();
+    iBuf.append('{');
+    iDepth++;
+    iNeedComma = false;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::endObject()
+{
+    HASSERT(iDepth > 0);
+    iDepth--;
+    if (iIndent && iNeedComma) {
+        newLine();
+    }
+    iBuf.append('}');
+    iNeedComma = true;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::beginArray()
+{
+    separate();
+    iBuf.append('[');
+    iDepth++;
+    iNeedComma = false;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::endArray()
+{
+    HASSERT(iDepth > 0);
+    iDepth--;
+    if (iIndent && iNeedComma) {
+        newLine();
+    }
+    iBuf.append(']');
+    iNeedComma = true;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::name(
+    const char* aLatin1)
+{
+    return name(aLatin1, strlen(aLatin1));
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::name(
+    const char* aLatin1,
+    int aLength)
+{
+    for (int i = 0; i < aLength; i++) {
+        if (aLatin1[i] & 0x80) {
+            // Not ASCII
+            return name(QString::fromLatin1(aLatin1, aLength));
+        }
+    }
+    separate();
+    appendString(aLatin1, aLength);
+    iBuf.append(iIndent ? ": " : ":");
+    iAfterName = true;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::name(
+    const QString& aName)
+{
+    const QByteArray utf8(aName.toUtf8());
+
+    separate();
+    appendString(utf8.constData(), utf8.size());
+    iBuf.append(iIndent ? ": " : ":");
+    iAfterName = true;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::value(
+    const QString& aValue)
+{
+    const QByteArray utf8(aValue.toUtf8());
+
+    separate();
+    appendString(utf8.constData(), utf8.size());
+    iNeedComma = true;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::value(
+    const char* aUtf8)
+{
+    separate();
+    appendString(aUtf8, strlen(aUtf8));
+    iNeedComma = true;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::value(
+    bool aValue)
+{
+    separate();
+    if (aValue) {
+        iBuf.append("true", 4);
+    } else {
+        iBuf.append("false", 5);
+    }
+    iNeedComma = true;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::value(
+    int aValue)
+{
+    return value((qint64)aValue);
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::value(
+    uint aValue)
+{
+    return value((qint64)aValue);
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::value(
+    qint64 aValue)
+{
+    separate();
+    iBuf.append(QByteArray::number(aValue));
+    iNeedComma = true;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::value(
+    quint64 aValue)
+{
+    separate();
+    iBuf.append(QByteArray::number(aValue));
+    iNeedComma = true;
+    return *this;
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::value(
+    double aValue)
+{
+    if (!qIsFinite(aValue)) {
+        // That's what QJsonDocument does too
+        return null();
+    } else if (qAbs(aValue) <= 9007199254740992.0 &&
+        aValue == (double)(qint64)aValue) {
+        return value((qint64)aValue);
+    } else {
+        separate();
+        iBuf.append(QByteArray::number(aValue, 'g', 17));
+        iNeedComma = true;
+        return *this;
+    }
+}
+
+// Does roughly what QJsonValue::fromVariant() does
+HarbourJson::Writer&
+HarbourJson::Writer::value(
+    const QVariant& aValue)
+{
+    switch (aValue.type()) {
+    case QVariant::Invalid:
+        return null();
+    case QVariant::Bool:
+        return value(aValue.toBool());
+    case QVariant::Int:
+    case QVariant::LongLong:
+        return value(aValue.toLongLong());
+    case QVariant::UInt:
+    case QVariant::ULongLong:
+        return value(aValue.toULongLong());
+    case QVariant::Double:
+        return value(aValue.toDouble());
+    case QVariant::Map:
+        {
+            const QVariantMap map(aValue.toMap());
+            QVariantMap::ConstIterator it = map.constBegin();
+
+            beginObject();
+            for (; it != map.constEnd(); ++it) {
+                name(it.key());
+                value(it.value());
+            }
+            return endObject();
+        }
+    case QVariant::List:
+    case QVariant::StringList:
+        {
+            const QVariantList list(aValue.toList());
+            QVariantList::ConstIterator it = list.constBegin();
+
+            beginArray();
+            for (; it != list.constEnd(); ++it) {
+                value(*it);
+            }
+            return endArray();
+        }
+    default:
+        return value(aValue.toString());
+    }
+}
+
+HarbourJson::Writer&
+HarbourJson::Writer::null()
+{
+    separate();
+    iBuf.append("null", 4);
+    iNeedComma = true;
+    return *this;
+}
@@ -1,6 +1,6 @@
 /*
  * Copyright (C) 2022 Jolla Ltd.
- * Copyright (C) 2022 Slava Monich <slava.monich@jolla.com>
+ * Copyright (C) 2022-2026 Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -33,6 +33,345 @@
 
 #include "HarbourDebug.h"
 #include "HarbourProtoBuf.h"
+#include "HarbourSimd.h"
+
+#include <QIODevice>
+
+#include <algorithm>
+
+#include <string.h>
+
+// ==========================================================================
+// Vector kernels
+//
+// Masked VByte style. The continuation bits of the next 12 bytes select
+// a precomputed shuffle which spreads up to 8 varints, each 1 or 2 bytes
+// long, into 16-bit lanes. Longer varints are left to parseVarInt().
+// Note that the varints are stored with the most significant group first.
+// ==========================================================================
+
+#if HARBOUR_SIMD_X86 || HARBOUR_SIMD_NEON
+
+struct HarbourProtoBufVarIntShuffle {
+    enum {
+        WINDOW = 12,    // Bytes examined per step
+        LANES = 8,      // Max number of varints decoded per step
+        BLOCK = 16      // Bytes loaded per step
+    };
+
+    quint8 shuffle[BLOCK];
+    quint8 count;
+    quint8 size;
+
+    static const HarbourProtoBufVarIntShuffle* table();
+};
+
+// Built once, on first use
+const HarbourProtoBufVarIntShuffle*
+HarbourProtoBufVarIntShuffle::table()
+{
+    static struct Table {
+        HarbourProtoBufVarIntShuffle entry[1 << WINDOW];
+
+        Table() {
+            for (int mask = 0; mask < (1 << WINDOW); mask++) {
+                HarbourProtoBufVarIntShuffle* e = entry + mask;
+                int n = 0, pos = 0;
+
+                // Out-of-range indices produce zeros
+                memset(e->shuffle, 0x80, sizeof(e->shuffle));
+                while (n < LANES && pos < WINDOW) {
+                    if (!(mask & (1 << pos))) {
+                        e->shuffle[2 * n] = pos++;
+                    } else if (pos + 1 < WINDOW &&
+                        !(mask & (1 << (pos + 1)))) {
+                        e->shuffle[2 * n] = pos + 1;
+                        e->shuffle[2 * n + 1] = pos;
+                        pos += 2;
+                    } else {
+                        break;
+                    }
+                    n++;
+                }
+                e->count = n;
+                e->size = pos;
+            }
+        }
+    } table;
+
+    return table.entry;
+}
+
+#endif
+
+#if HARBOUR_SIMD_X86
+
+// Decodes while there are at least 16 bytes of input and room for
+// 8 values (all 8 lanes get stored even if fewer values are decoded),
+// returns the number of values and advances the pointer.
+HARBOUR_TARGET("sse4.1")
+static
+int
+protoBufParseVarIntsSse41(
+    const guint8** aPtr,
+    const guint8* aEnd,
+    quint64* aOut,
+    int aMaxCount)
+{
+    const HarbourProtoBufVarIntShuffle* table =
+        HarbourProtoBufVarIntShuffle::table();
+    const __m128i lo = _mm_set1_epi16(0x7f);
+    const __m128i hi = _mm_set1_epi16(0x3f80);
+    const guint8* ptr = *aPtr;
+    int n = 0;
+
+    while ((aEnd - ptr) >= HarbourProtoBufVarIntShuffle::BLOCK &&
+        (aMaxCount - n) >= HarbourProtoBufVarIntShuffle::LANES) {
+        const __m128i in = _mm_loadu_si128((const __m128i*)ptr);
+        const HarbourProtoBufVarIntShuffle* e = table +
+            (_mm_movemask_epi8(in) & 0xfff);
+
+        if (!e->count) {
+            break;
+        }
+
+        // Each lane is (first << 8) | second, where first is zero
+        // for single-byte varints. The value is then combined from
+        // the low 7 bits of each byte.
+        __m128i* out = (__m128i*)(aOut + n);
+        const __m128i v = _mm_shuffle_epi8(in,
+            _mm_loadu_si128((const __m128i*)e->shuffle));
+        const __m128i w = _mm_or_si128(_mm_and_si128(v, lo),
+            _mm_and_si128(_mm_srli_epi16(v, 1), hi));
+
+        _mm_storeu_si128(out, _mm_cvtepu16_epi64(w));
+        _mm_storeu_si128(out + 1, _mm_cvtepu16_epi64(_mm_srli_si128(w, 4)));
+        _mm_storeu_si128(out + 2, _mm_cvtepu16_epi64(_mm_srli_si128(w, 8)));
+        _mm_storeu_si128(out + 3, _mm_cvtepu16_epi64(_mm_srli_si128(w, 12)));
+        n += e->count;
+        ptr += e->size;
+    }
+    *aPtr = ptr;
+    return n;
+}
+
+#endif // HARBOUR_SIMD_X86
+
+#if HARBOUR_SIMD_NEON
+
+// Same as the SSE4.1 version
+static
+int
+protoBufParseVarIntsNeon(
+    const guint8** aPtr,
+    const guint8* aEnd,
+    quint64* aOut,
+    int aMaxCount)
+{
+    static const int8_t bitShifts[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    const HarbourProtoBufVarIntShuffle* table =
+        HarbourProtoBufVarIntShuffle::table();
+    const int8x8_t shifts = vld1_s8(bitShifts);
+    const uint16x8_t lo = vdupq_n_u16(0x7f);
+    const uint16x8_t hi = vdupq_n_u16(0x3f80);
+    const guint8* ptr = *aPtr;
+    int n = 0;
+
+    while ((aEnd - ptr) >= HarbourProtoBufVarIntShuffle::BLOCK &&
+        (aMaxCount - n) >= HarbourProtoBufVarIntShuffle::LANES) {
+        uint8x8x2_t in;
+
+        in.val[0] = vld1_u8(ptr);
+        in.val[1] = vld1_u8(ptr + 8);
+
+        // There's no movemask, each byte contributes its own bit
+        // and then they are all added together
+        uint8x8_t m0 = vshl_u8(vshr_n_u8(in.val[0], 7), shifts);
+        uint8x8_t m1 = vshl_u8(vshr_n_u8(in.val[1], 7), shifts);
+        uint8x8_t m = vpadd_u8(m0, m1);
+
+        m = vpadd_u8(m, m);
+        m = vpadd_u8(m, m);
+
+        const HarbourProtoBufVarIntShuffle* e = table +
+            ((vget_lane_u8(m, 0) | (vget_lane_u8(m, 1) << 8)) & 0xfff);
+
+        if (!e->count) {
+            break;
+        }
+
+        const uint8x16_t v = vcombine_u8(vtbl2_u8(in, vld1_u8(e->shuffle)),
+            vtbl2_u8(in, vld1_u8(e->shuffle + 8)));
+        const uint16x8_t w = vorrq_u16(vandq_u16(vreinterpretq_u16_u8(v), lo),
+            vandq_u16(vshrq_n_u16(vreinterpretq_u16_u8(v), 1), hi));
+        const uint32x4_t w0 = vmovl_u16(vget_low_u16(w));
+        const uint32x4_t w1 = vmovl_u16(vget_high_u16(w));
+        quint64* out = aOut + n;
+
+        vst1q_u64((uint64_t*)out, vmovl_u32(vget_low_u32(w0)));
+        vst1q_u64((uint64_t*)(out + 2), vmovl_u32(vget_high_u32(w0)));
+        vst1q_u64((uint64_t*)(out + 4), vmovl_u32(vget_low_u32(w1)));
+        vst1q_u64((uint64_t*)(out + 6), vmovl_u32(vget_high_u32(w1)));
+        n += e->count;
+        ptr += e->size;
+    }
+    *aPtr = ptr;
+    return n;
+}
+
+#endif // HARBOUR_SIMD_NEON
+
+// ==========================================================================
+// HarbourProtoBuf::Private
+// ==========================================================================
+
+class HarbourProtoBuf::Private
+{
+public:
+    static int varIntSize(quint64);
+    static int parseVarIntBlocks(GUtilRange*, quint64*, int);
+
+    // Fixed size values are little-endian
+    template <typename T> static void putFixed(uchar*, T);
+    template <typename T> static T getFixed(const guint8*);
+    template <typename T> static bool parseFixed(GUtilRange*, T*);
+    template <typename T> static int parsePackedFixed(GUtilRange*, T*, int);
+    template <typename T>
+    static QByteArray* appendPackedFixedKeyValue(QByteArray*, quint64,
+        const T*, int);
+};
+
+int
+HarbourProtoBuf::Private::varIntSize(
+    quint64 aValue)
+{
+    int n = 1;
+
+    while (aValue >>= 7) {
+        n++;
+    }
+    return n;
+}
+
+// Decodes as many varints as the vector code can handle, stops at
+// anything unusual. Returns the number of values.
+inline
+int
+HarbourProtoBuf::Private::parseVarIntBlocks(
+    GUtilRange* aPos,
+    quint64* aValues,
+    int aMaxCount)
+{
+#if HARBOUR_SIMD_X86
+    if (HarbourSimd::has(HarbourSimd::SSE41)) {
+        return protoBufParseVarIntsSse41(&aPos->ptr, aPos->end, aValues,
+            aMaxCount);
+    }
+#elif HARBOUR_SIMD_NEON
+    return protoBufParseVarIntsNeon(&aPos->ptr, aPos->end, aValues,
+        aMaxCount);
+#endif
+    return 0;
+}
+
+template <typename T>
+inline
+void
+HarbourProtoBuf::Private::putFixed(
+    uchar* aOut,
+    T aValue)
+{
+    for (uint i = 0; i < sizeof(T); i++) {
+        aOut[i] = (uchar)(aValue >> (8 * i));
+    }
+}
+
+template <typename T>
+inline
+T
+HarbourProtoBuf::Private::getFixed(
+    const guint8* aPtr)
+{
+    T value = 0;
+
+    for (uint i = 0; i < sizeof(T); i++) {
+        value |= ((T)aPtr[i]) << (8 * i);
+    }
+    return value;
+}
+
+template <typename T>
+bool
+HarbourProtoBuf::Private::parseFixed(
+    GUtilRange* aPos,
+    T* aResult)
+{
+    if (aPos && (aPos->end - aPos->ptr) >= (int)sizeof(T)) {
+        if (aResult) {
+            *aResult = getFixed<T>(aPos->ptr);
+        }
+        aPos->ptr += sizeof(T);
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+int
+HarbourProtoBuf::Private::parsePackedFixed(
+    GUtilRange* aPos,
+    T* aValues,
+    int aMaxCount)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        GUtilData payload;
+
+        if (parseDelimitedValue(&pos, &payload) &&
+            !(payload.size % sizeof(T))) {
+            const int count = payload.size / sizeof(T);
+            const int n = qMin(count, aMaxCount);
+
+            for (int i = 0; i < n; i++) {
+                aValues[i] = getFixed<T>(payload.bytes + i * sizeof(T));
+            }
+            aPos->ptr = pos.ptr;
+            return count;
+        }
+    }
+    return -1;
+}
+
+template <typename T>
+QByteArray*
+HarbourProtoBuf::Private::appendPackedFixedKeyValue(
+    QByteArray* aOutput,
+    quint64 aKey,
+    const T* aValues,
+    int aCount)
+{
+    HASSERT((aKey & TYPE_MASK) == TYPE_DELIMITED);
+    if (aOutput) {
+        const int size = aCount * sizeof(T);
+
+        appendVarInt(appendVarInt(aOutput, aKey), size);
+
+        const int off = aOutput->size();
+
+        aOutput->resize(off + size);
+
+        uchar* out = (uchar*)aOutput->data() + off;
+
+        for (int i = 0; i < aCount; i++, out += sizeof(T)) {
+            putFixed<T>(out, aValues[i]);
+        }
+    }
+    return aOutput;
+}
+
+// ==========================================================================
+// HarbourProtoBuf
+// ==========================================================================
 
 // https://developers.google.com/protocol-buffers/docs/encoding
 
@@ -53,10 +392,7 @@ HarbourProtoBuf::appendVarInt(
             value >>= 7;
         }
 
-        const int n = sizeof(out) - i;
-
-        aOutput->reserve(aOutput->size() + n);
-        aOutput->append((char*)(out + i), n);
+        aOutput->append((char*)(out + i), sizeof(out) - i);
     }
     return aOutput;
 }
@@ -92,6 +428,135 @@ HarbourProtoBuf::appendDelimitedKeyValue(
     return appendDelimitedValue(appendVarInt(aOutput, aKey), aValue);
 }
 
+QByteArray*
+HarbourProtoBuf::appendSignedVarInt(
+    QByteArray* aOutput,
+    qint64 aValue)
+{
+    return appendVarInt(aOutput, zigZagEncode(aValue));
+}
+
+QByteArray*
+HarbourProtoBuf::appendSignedVarIntKeyValue(
+    QByteArray* aOutput,
+    quint64 aKey,
+    qint64 aValue)
+{
+    return appendVarIntKeyValue(aOutput, aKey, zigZagEncode(aValue));
+}
+
+QByteArray*
+HarbourProtoBuf::appendFixed32(
+    QByteArray* aOutput,
+    quint32 aValue)
+{
+    if (aOutput) {
+        uchar out[4];
+
+        Private::putFixed(out, aValue);
+        aOutput->append((char*)out, sizeof(out));
+    }
+    return aOutput;
+}
+
+QByteArray*
+HarbourProtoBuf::appendFixed32KeyValue(
+    QByteArray* aOutput,
+    quint64 aKey,
+    quint32 aValue)
+{
+    HASSERT((aKey & TYPE_MASK) == TYPE_FIXED32);
+    return appendFixed32(appendVarInt(aOutput, aKey), aValue);
+}
+
+QByteArray*
+HarbourProtoBuf::appendFixed64(
+    QByteArray* aOutput,
+    quint64 aValue)
+{
+    if (aOutput) {
+        uchar out[8];
+
+        Private::putFixed(out, aValue);
+        aOutput->append((char*)out, sizeof(out));
+    }
+    return aOutput;
+}
+
+QByteArray*
+HarbourProtoBuf::appendFixed64KeyValue(
+    QByteArray* aOutput,
+    quint64 aKey,
+    quint64 aValue)
+{
+    HASSERT((aKey & TYPE_MASK) == TYPE_FIXED64);
+    return appendFixed64(appendVarInt(aOutput, aKey), aValue);
+}
+
+QByteArray*
+HarbourProtoBuf::appendPackedVarIntKeyValue(
+    QByteArray* aOutput,
+    quint64 aKey,
+    const quint64* aValues,
+    int aCount)
+{
+    HASSERT((aKey & TYPE_MASK) == TYPE_DELIMITED);
+    if (aOutput) {
+        int size = 0;
+
+        for (int i = 0; i < aCount; i++) {
+            size += Private::varIntSize(aValues[i]);
+        }
+        appendVarInt(appendVarInt(aOutput, aKey), size);
+        for (int i = 0; i < aCount; i++) {
+            appendVarInt(aOutput, aValues[i]);
+        }
+    }
+    return aOutput;
+}
+
+QByteArray*
+HarbourProtoBuf::appendPackedSignedVarIntKeyValue(
+    QByteArray* aOutput,
+    quint64 aKey,
+    const qint64* aValues,
+    int aCount)
+{
+    HASSERT((aKey & TYPE_MASK) == TYPE_DELIMITED);
+    if (aOutput) {
+        int size = 0;
+
+        for (int i = 0; i < aCount; i++) {
+            size += Private::varIntSize(zigZagEncode(aValues[i]));
+        }
+        appendVarInt(appendVarInt(aOutput, aKey), size);
+        for (int i = 0; i < aCount; i++) {
+            appendSignedVarInt(aOutput, aValues[i]);
+        }
+    }
+    return aOutput;
+}
+
+QByteArray*
+HarbourProtoBuf::appendPackedFixed32KeyValue(
+    QByteArray* aOutput,
+    quint64 aKey,
+    const quint32* aValues,
+    int aCount)
+{
+    return Private::appendPackedFixedKeyValue(aOutput, aKey, aValues, aCount);
+}
+
+QByteArray*
+HarbourProtoBuf::appendPackedFixed64KeyValue(
+    QByteArray* aOutput,
+    quint64 aKey,
+    const quint64* aValues,
+    int aCount)
+{
+    return Private::appendPackedFixedKeyValue(aOutput, aKey, aValues, aCount);
+}
+
 bool
 HarbourProtoBuf::parseVarInt(
     GUtilRange* aPos,
@@ -142,3 +607,783 @@ HarbourProtoBuf::parseDelimitedValue(
     }
     return false;
 }
+
+// Same as calling parseVarInt() up to aMaxCount times, stops at the
+// end of the range or at the first malformed varint. Returns the number
+// of values parsed. Note that the values array may be modified beyond
+// the returned count.
+int
+HarbourProtoBuf::parseVarInts(
+    GUtilRange* aPos,
+    quint64* aValues,
+    int aMaxCount)
+{
+    int n = 0;
+
+    if (aPos && aValues) {
+        while (n < aMaxCount) {
+            n += Private::parseVarIntBlocks(aPos, aValues + n, aMaxCount - n);
+            if (n < aMaxCount && parseVarInt(aPos, aValues + n)) {
+                n++;
+            } else {
+                break;
+            }
+        }
+    }
+    return n;
+}
+
+bool
+HarbourProtoBuf::parseSignedVarInt(
+    GUtilRange* aPos,
+    qint64* aResult)
+{
+    quint64 value;
+
+    if (parseVarInt(aPos, &value)) {
+        if (aResult) {
+            *aResult = zigZagDecode(value);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool
+HarbourProtoBuf::parseFixed32(
+    GUtilRange* aPos,
+    quint32* aResult)
+{
+    return Private::parseFixed(aPos, aResult);
+}
+
+bool
+HarbourProtoBuf::parseFixed64(
+    GUtilRange* aPos,
+    quint64* aResult)
+{
+    return Private::parseFixed(aPos, aResult);
+}
+
+int
+HarbourProtoBuf::parsePackedVarInt(
+    GUtilRange* aPos,
+    quint64* aValues,
+    int aMaxCount)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        GUtilData payload;
+
+        if (parseDelimitedValue(&pos, &payload)) {
+            GUtilRange values;
+            int count;
+
+            values.end = (values.ptr = payload.bytes) + payload.size;
+            count = parseVarInts(&values, aValues, aMaxCount);
+
+            // Count the values that didn't fit (or find the bad one)
+            while (values.ptr < values.end) {
+                if (!parseVarInt(&values, Q_NULLPTR)) {
+                    return -1;
+                }
+                count++;
+            }
+            aPos->ptr = pos.ptr;
+            return count;
+        }
+    }
+    return -1;
+}
+
+int
+HarbourProtoBuf::parsePackedSignedVarInt(
+    GUtilRange* aPos,
+    qint64* aValues,
+    int aMaxCount)
+{
+    if (aPos) {
+        GUtilRange pos = *aPos;
+        GUtilData payload;
+
+        if (parseDelimitedValue(&pos, &payload)) {
+            GUtilRange values;
+            int count;
+
+            // Decode in place, qint64 and quint64 may alias each other
+            values.end = (values.ptr = payload.bytes) + payload.size;
+            count = parseVarInts(&values, (quint64*)aValues, aMaxCount);
+            for (int i = 0; i < count; i++) {
+                aValues[i] = zigZagDecode((quint64)aValues[i]);
+            }
+
+            // Count the values that didn't fit (or find the bad one)
+            while (values.ptr < values.end) {
+                if (!parseVarInt(&values, Q_NULLPTR)) {
+                    return -1;
+                }
+                count++;
+            }
+            aPos->ptr = pos.ptr;
+            return count;
+        }
+    }
+    return -1;
+}
+
+int
+HarbourProtoBuf::parsePackedFixed32(
+    GUtilRange* aPos,
+    quint32* aValues,
+    int aMaxCount)
+{
+    return Private::parsePackedFixed(aPos, aValues, aMaxCount);
+}
+
+int
+HarbourProtoBuf::parsePackedFixed64(
+    GUtilRange* aPos,
+    quint64* aValues,
+    int aMaxCount)
+{
+    return Private::parsePackedFixed(aPos, aValues, aMaxCount);
+}
+
+// Groups (deprecated wire types 3 and 4) aren't supported
+bool
+HarbourProtoBuf::skipField(
+    GUtilRange* aPos,
+    quint64 aKey)
+{
+    switch (aKey & TYPE_MASK) {
+    case TYPE_VARINT:
+        return parseVarInt(aPos, Q_NULLPTR);
+    case TYPE_FIXED64:
+        return parseFixed64(aPos, Q_NULLPTR);
+    case TYPE_DELIMITED:
+        return parseDelimitedValue(aPos, Q_NULLPTR);
+    case TYPE_FIXED32:
+        return parseFixed32(aPos, Q_NULLPTR);
+    }
+    HDEBUG("Unsupported wire type" << (aKey & TYPE_MASK));
+    return false;
+}
+
+// Maps signed integers to unsigned so that small absolute values
+// produce short varints: 0 => 0, -1 => 1, 1 => 2, -2 => 3 and so on
+quint64
+HarbourProtoBuf::zigZagEncode(
+    qint64 aValue)
+{
+    return ((quint64)aValue << 1) ^ (quint64)(aValue >> 63);
+}
+
+qint64
+HarbourProtoBuf::zigZagDecode(
+    quint64 aValue)
+{
+    return (qint64)((aValue >> 1) ^ (~(aValue & 1) + 1));
+}
+
+// ==========================================================================
+// HarbourProtoBuf::Writer
+// ==========================================================================
+
+HarbourProtoBuf::Writer::Writer(
+    int aInitialCapacity) :
+    iSize(0)
+{
+    if (aInitialCapacity > 0) {
+        iBuf.resize(aInitialCapacity);
+    }
+}
+
+int
+HarbourProtoBuf::Writer::size() const
+{
+    return iSize;
+}
+
+int
+HarbourProtoBuf::Writer::depth() const
+{
+    return iOpen.size();
+}
+
+void
+HarbourProtoBuf::Writer::clear()
+{
+    iSize = 0;
+    iOpen.resize(0);
+}
+
+QByteArray
+HarbourProtoBuf::Writer::data()
+{
+    HASSERT(iOpen.isEmpty());
+    // Shrinking doesn't reallocate
+    iBuf.resize(iSize);
+    return iBuf;
+}
+
+// Returns pointer to aCount bytes at the end of the data
+uchar*
+HarbourProtoBuf::Writer::reserve(
+    int aCount)
+{
+    const int size = iSize + aCount;
+
+    if (size > iBuf.size()) {
+        iBuf.resize(qMax(size, qMax(iBuf.size() * 2, 64)));
+    }
+
+    uchar* ptr = (uchar*)iBuf.data() + iSize;
+
+    iSize = size;
+    return ptr;
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendVarInt(
+    quint64 aValue)
+{
+    uchar out[10];
+    quint64 value = aValue;
+    int i = sizeof(out) - 1;
+
+    out[i] = value & 0x7f;
+    value >>= 7;
+    while (value) {
+        out[--i] = 0x80 | (uchar)value;
+        value >>= 7;
+    }
+    return appendRaw(out + i, sizeof(out) - i);
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendVarIntKeyValue(
+    quint64 aKey,
+    quint64 aValue)
+{
+    HASSERT((aKey & TYPE_MASK) == TYPE_VARINT);
+    return appendVarInt(aKey).appendVarInt(aValue);
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendDelimitedValue(
+    const QByteArray aValue)
+{
+    return appendDelimitedValue(aValue.constData(), aValue.size());
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendDelimitedValue(
+    const void* aData,
+    int aSize)
+{
+    return appendVarInt(aSize).appendRaw(aData, aSize);
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendDelimitedKeyValue(
+    quint64 aKey,
+    const QByteArray aValue)
+{
+    return appendDelimitedKeyValue(aKey, aValue.constData(), aValue.size());
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendDelimitedKeyValue(
+    quint64 aKey,
+    const void* aData,
+    int aSize)
+{
+    HASSERT((aKey & TYPE_MASK) == TYPE_DELIMITED);
+    return appendVarInt(aKey).appendDelimitedValue(aData, aSize);
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendSignedVarInt(
+    qint64 aValue)
+{
+    return appendVarInt(zigZagEncode(aValue));
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendSignedVarIntKeyValue(
+    quint64 aKey,
+    qint64 aValue)
+{
+    return appendVarIntKeyValue(aKey, zigZagEncode(aValue));
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendFixed32(
+    quint32 aValue)
+{
+    Private::putFixed(reserve(sizeof(aValue)), aValue);
+    return *this;
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendFixed32KeyValue(
+    quint64 aKey,
+    quint32 aValue)
+{
+    HASSERT((aKey & TYPE_MASK) == TYPE_FIXED32);
+    return appendVarInt(aKey).appendFixed32(aValue);
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendFixed64(
+    quint64 aValue)
+{
+    Private::putFixed(reserve(sizeof(aValue)), aValue);
+    return *this;
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendFixed64KeyValue(
+    quint64 aKey,
+    quint64 aValue)
+{
+    HASSERT((aKey & TYPE_MASK) == TYPE_FIXED64);
+    return appendVarInt(aKey).appendFixed64(aValue);
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::appendRaw(
+    const void* aData,
+    int aSize)
+{
+    if (aSize > 0) {
+        memcpy(reserve(aSize), aData, aSize);
+    }
+    return *this;
+}
+
+HarbourProtoBuf::Writer&
+HarbourProtoBuf::Writer::begin(
+    quint64 aKey)
+{
+    HASSERT((aKey & TYPE_MASK) == TYPE_DELIMITED);
+    appendVarInt(aKey);
+    iOpen.append(iSize);
+    reserve(LENGTH_SLOT);
+    return *this;
+}
+
+bool
+HarbourProtoBuf::Writer::end()
+{
+    if (!iOpen.isEmpty()) {
+        const int slot = iOpen.takeLast();
+        uint len = iSize - slot - LENGTH_SLOT;
+        uchar* out = (uchar*)iBuf.data() + slot;
+
+        // Big-endian groups of 7 bits, just like appendVarInt() writes
+        // them, except that the leading zero groups are kept
+        out[LENGTH_SLOT - 1] = len & 0x7f;
+        for (int i = LENGTH_SLOT - 2; i >= 0; i--) {
+            len >>= 7;
+            out[i] = 0x80 | (len & 0x7f);
+        }
+        return true;
+    }
+    return false;
+}
+
+// ==========================================================================
+// HarbourProtoBuf::StreamParser::Listener
+// ==========================================================================
+
+HarbourProtoBuf::StreamParser::Listener::~Listener()
+{
+}
+
+void
+HarbourProtoBuf::StreamParser::Listener::varIntField(
+    quint64,
+    quint64)
+{
+}
+
+void
+HarbourProtoBuf::StreamParser::Listener::fixed32Field(
+    quint64,
+    quint32)
+{
+}
+
+void
+HarbourProtoBuf::StreamParser::Listener::fixed64Field(
+    quint64,
+    quint64)
+{
+}
+
+void
+HarbourProtoBuf::StreamParser::Listener::delimitedField(
+    quint64,
+    quint64,
+    quint64,
+    const GUtilData*)
+{
+}
+
+// ==========================================================================
+// HarbourProtoBuf::StreamParser
+// ==========================================================================
+
+HarbourProtoBuf::StreamParser::StreamParser(
+    Listener* aListener,
+    int aChunkSize) :
+    iListener(aListener),
+    iChunkSize(qMax(aChunkSize, 1))
+{
+    reset();
+}
+
+void
+HarbourProtoBuf::StreamParser::reset()
+{
+    iState = STATE_KEY;
+    iPosition = 0;
+    iKey = 0;
+    iVarInt = 0;
+    iVarIntBytes = 0;
+    iFixedSize = 0;
+    iFixedCount = 0;
+    iPayloadSize = 0;
+    iPayloadOffset = 0;
+    iBuffered = 0;
+}
+
+bool
+HarbourProtoBuf::StreamParser::isFailed() const
+{
+    return iState == STATE_FAILED;
+}
+
+bool
+HarbourProtoBuf::StreamParser::atFieldBoundary() const
+{
+    return iState == STATE_KEY && !iVarIntBytes;
+}
+
+quint64
+HarbourProtoBuf::StreamParser::position() const
+{
+    return iPosition;
+}
+
+void
+HarbourProtoBuf::StreamParser::deliver(
+    const guint8* aData,
+    int aSize)
+{
+    GUtilData chunk;
+
+    chunk.bytes = aData;
+    chunk.size = aSize;
+    if (iListener) {
+        iListener->delimitedField(iKey, iPayloadSize, iPayloadOffset, &chunk);
+    }
+    iPayloadOffset += aSize;
+    if (iPayloadOffset == iPayloadSize) {
+        iState = STATE_KEY;
+    }
+}
+
+bool
+HarbourProtoBuf::StreamParser::parse(
+    const void* aData,
+    int aSize)
+{
+    const guint8* ptr = (const guint8*)aData;
+    const guint8* end = ptr + qMax(aSize, 0);
+
+    while (ptr < end && iState != STATE_FAILED) {
+        const guint8* start = ptr;
+
+        switch (iState) {
+        case STATE_KEY:
+        case STATE_VARINT:
+        case STATE_LENGTH:
+            // Same as parseVarInt() but one byte at a time
+            iVarInt = (iVarInt << 7) | (*ptr & 0x7f);
+            if (++iVarIntBytes > 10) {
+                HDEBUG("Varint is too long");
+                iState = STATE_FAILED;
+            } else if (!(*ptr++ & 0x80)) {
+                const quint64 value = iVarInt;
+
+                iVarInt = 0;
+                iVarIntBytes = 0;
+                if (iState == STATE_KEY) {
+                    iKey = value;
+                    switch (iKey & TYPE_MASK) {
+                    case TYPE_VARINT:
+                        iState = STATE_VARINT;
+                        break;
+                    case TYPE_FIXED64:
+                    case TYPE_FIXED32:
+                        iFixedSize = ((iKey & TYPE_MASK) == TYPE_FIXED64) ?
+                            8 : 4;
+                        iFixedCount = 0;
+                        iState = STATE_FIXED;
+                        break;
+                    case TYPE_DELIMITED:
+                        iState = STATE_LENGTH;
+                        break;
+                    default:
+                        HDEBUG("Unsupported wire type" << (iKey & TYPE_MASK));
+                        iState = STATE_FAILED;
+                        break;
+                    }
+                } else if (iState == STATE_VARINT) {
+                    iState = STATE_KEY;
+                    if (iListener) {
+                        iListener->varIntField(iKey, value);
+                    }
+                } else {
+                    iPayloadSize = value;
+                    iPayloadOffset = 0;
+                    iBuffered = 0;
+                    iState = STATE_PAYLOAD;
+                    if (!value) {
+                        deliver(ptr, 0);
+                    }
+                }
+            }
+            break;
+        case STATE_FIXED:
+            {
+                const int n = qMin(iFixedSize - iFixedCount, int(end - ptr));
+
+                memcpy(iFixed + iFixedCount, ptr, n);
+                ptr += n;
+                iFixedCount += n;
+                if (iFixedCount == iFixedSize) {
+                    iState = STATE_KEY;
+                    if (iListener) {
+                        if (iFixedSize == 8) {
+                            iListener->fixed64Field(iKey,
+                                Private::getFixed<quint64>(iFixed));
+                        } else {
+                            iListener->fixed32Field(iKey,
+                                Private::getFixed<quint32>(iFixed));
+                        }
+                    }
+                }
+            }
+            break;
+        case STATE_PAYLOAD:
+            {
+                // Size of the next chunk
+                const int want = (int)qMin(iPayloadSize - iPayloadOffset,
+                    (quint64)iChunkSize);
+                const int avail = end - ptr;
+
+                if (!iBuffered && avail >= want) {
+                    // Straight from the input
+                    ptr += want;
+                    deliver(start, want);
+                } else {
+                    const int n = qMin(want - iBuffered, avail);
+
+                    if (iBuffer.size() < iChunkSize) {
+                        iBuffer.resize(iChunkSize);
+                    }
+                    memcpy(iBuffer.data() + iBuffered, ptr, n);
+                    ptr += n;
+                    iBuffered += n;
+                    if (iBuffered == want) {
+                        iBuffered = 0;
+                        deliver((const guint8*)iBuffer.constData(), want);
+                    }
+                }
+            }
+            break;
+        case STATE_FAILED:
+            break;
+        }
+        iPosition += ptr - start;
+    }
+    return iState != STATE_FAILED;
+}
+
+bool
+HarbourProtoBuf::StreamParser::parse(
+    QIODevice* aDevice)
+{
+    if (aDevice) {
+        char buf[4096];
+        qint64 n;
+
+        while (iState != STATE_FAILED &&
+            (n = aDevice->read(buf, sizeof(buf))) > 0) {
+            parse(buf, (int)n);
+        }
+    }
+    return iState != STATE_FAILED;
+}
+
+// ==========================================================================
+// HarbourProtoBuf::Index
+// ==========================================================================
+
+HarbourProtoBuf::Index::Index()
+{
+    clear();
+}
+
+HarbourProtoBuf::Index::Index(
+    const GUtilData* aMessage)
+{
+    build(aMessage);
+}
+
+void
+HarbourProtoBuf::Index::clear()
+{
+    iData.bytes = Q_NULLPTR;
+    iData.size = 0;
+    iFields.resize(0);
+}
+
+bool
+HarbourProtoBuf::Index::build(
+    const GUtilData* aMessage)
+{
+    clear();
+    if (aMessage && aMessage->size <= 0xffffffff) {
+        const guint8* start = aMessage->bytes;
+        GUtilRange pos;
+        bool sorted = true;
+
+        pos.end = (pos.ptr = start) + aMessage->size;
+        while (pos.ptr < pos.end) {
+            quint64 key;
+            Field field;
+
+            if (!parseVarInt(&pos, &key) || (key >> TYPE_SHIFT) > 0x1fffffff) {
+                clear();
+                return false;
+            }
+
+            const guint8* value = pos.ptr;
+            GUtilData payload;
+
+            field.tag = (quint32)(key >> TYPE_SHIFT);
+            field.type = (quint32)(key & TYPE_MASK);
+            if (field.type == TYPE_DELIMITED) {
+                if (!parseDelimitedValue(&pos, &payload)) {
+                    clear();
+                    return false;
+                }
+                field.offset = payload.bytes - start;
+                field.length = payload.size;
+            } else if (skipField(&pos, key)) {
+                field.offset = value - start;
+                field.length = pos.ptr - value;
+            } else {
+                clear();
+                return false;
+            }
+
+            if (!iFields.isEmpty() && iFields.last().tag > field.tag) {
+                sorted = false;
+            }
+            iFields.append(field);
+        }
+
+        // Offsets grow, so sorting by (tag, offset) keeps the occurrences
+        // of the same field in their original order
+        if (!sorted) {
+            std::sort(iFields.begin(), iFields.end(),
+                [](const Field& aField1, const Field& aField2) {
+                    return (aField1.tag != aField2.tag) ?
+                        (aField1.tag < aField2.tag) :
+                        (aField1.offset < aField2.offset);
+                });
+        }
+        iData = *aMessage;
+        return true;
+    }
+    return false;
+}
+
+int
+HarbourProtoBuf::Index::count() const
+{
+    return iFields.count();
+}
+
+const HarbourProtoBuf::Index::Field*
+HarbourProtoBuf::Index::fieldAt(
+    int aIndex) const
+{
+    return (aIndex >= 0 && aIndex < iFields.count()) ?
+        (iFields.constData() + aIndex) : Q_NULLPTR;
+}
+
+const HarbourProtoBuf::Index::Field*
+HarbourProtoBuf::Index::find(
+    quint32 aTag) const
+{
+    const Field* first;
+
+    return findAll(aTag, &first) ? first : Q_NULLPTR;
+}
+
+// Returns the number of occurrences, they are adjacent in the index
+int
+HarbourProtoBuf::Index::findAll(
+    quint32 aTag,
+    const Field** aFirst) const
+{
+    const Field* begin = iFields.constData();
+    const Field* end = begin + iFields.count();
+    const Field* first = std::lower_bound(begin, end, aTag,
+        [](const Field& aField, quint32 aValue) {
+            return aField.tag < aValue;
+        });
+    const Field* last = std::upper_bound(first, end, aTag,
+        [](quint32 aValue, const Field& aField) {
+            return aValue < aField.tag;
+        });
+
+    if (aFirst) {
+        *aFirst = (first < last) ? first : Q_NULLPTR;
+    }
+    return last - first;
+}
+
+GUtilData
+HarbourProtoBuf::Index::value(
+    const Field* aField) const
+{
+    GUtilData data;
+
+    if (aField) {
+        data.bytes = iData.bytes + aField->offset;
+        data.size = aField->length;
+    } else {
+        data.bytes = Q_NULLPTR;
+        data.size = 0;
+    }
+    return data;
+}
+
+// Suitable for parseVarInt(), parseFixed32() and such
+GUtilRange
+HarbourProtoBuf::Index::range(
+    const Field* aField) const
+{
+    const GUtilData data(value(aField));
+    GUtilRange range;
+
+    range.end = (range.ptr = data.bytes) + data.size;
+    return range;
+}
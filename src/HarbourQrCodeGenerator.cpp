@@ -1,6 +1,6 @@
 /*
+ * Copyright (C) 2019-2026 Slava Monich <slava@monich.com>
  * Copyright (C) 2019-2021 Jolla Ltd.
- * Copyright (C) 2019-2021 Slava Monich <slava.monich@jolla.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -33,48 +33,12 @@
 
 #include "HarbourQrCodeGenerator.h"
 
+#include "HarbourAsyncValue.h"
 #include "HarbourBase32.h"
-#include "HarbourTask.h"
 #include "HarbourDebug.h"
 
-#include <QThreadPool>
-
 #include "qrencode.h"
 
-// ==========================================================================
-// HarbourQrCodeGenerator::Task
-// ==========================================================================
-
-class HarbourQrCodeGenerator::Task : public HarbourTask
-{
-    Q_OBJECT
-
-public:
-    Task(QThreadPool* aPool, QString aText, ECLevel aEcLevel);
-    void performTask() Q_DECL_OVERRIDE;
-
-public:
-    QString iText;
-    QString iCode;
-    ECLevel iEcLevel;
-};
-
-HarbourQrCodeGenerator::Task::Task(QThreadPool* aPool, QString aText,
-    ECLevel aEcLevel) :
-    HarbourTask(aPool),
-    iText(aText),
-    iEcLevel(aEcLevel)
-{
-}
-
-void HarbourQrCodeGenerator::Task::performTask()
-{
-    QByteArray bytes(generate(iText, iEcLevel));
-    if (!bytes.isEmpty()) {
-        iCode = HarbourBase32::toBase32(bytes);
-    }
-}
-
 // ==========================================================================
 // HarbourQrCodeGenerator::Private
 // ==========================================================================
@@ -84,8 +48,14 @@ class HarbourQrCodeGenerator::Private : public QObject
     Q_OBJECT
 
 public:
+    struct Input {
+        QString iText;
+        ECLevel iEcLevel;
+    };
+
+    typedef HarbourAsyncValue<Input,QString> AsyncCode;
+
     Private(HarbourQrCodeGenerator* aParent);
-    ~Private();
 
     HarbourQrCodeGenerator* parentObject() const;
     void setText(QString aValue);
@@ -93,32 +63,21 @@ public:
     void regenerate();
 
     static QRecLevel realEcLevel(ECLevel aEcLevel);
-
-public Q_SLOTS:
-    void onTaskDone();
+    static QString generateCode(const Input& aInput);
 
 public:
-    QThreadPool* iThreadPool;
-    Task* iTask;
+    AsyncCode* iCode;
     ECLevel iEcLevel;
     QString iText;
-    QString iCode;
 };
 
 HarbourQrCodeGenerator::Private::Private(HarbourQrCodeGenerator* aParent) :
     QObject(aParent),
-    iThreadPool(new QThreadPool(this)),
-    iTask(Q_NULLPTR),
+    iCode(new AsyncCode(generateCode, this)),
     iEcLevel(ECLevelDefault)
 {
-    // Serialize the tasks:
-    iThreadPool->setMaxThreadCount(1);
-}
-
-HarbourQrCodeGenerator::Private::~Private()
-{
-    if (iTask) iTask->release();
-    iThreadPool->waitForDone();
+    aParent->connect(iCode, SIGNAL(resultChanged()), SIGNAL(codeChanged()));
+    aParent->connect(iCode, SIGNAL(runningChanged()), SIGNAL(runningChanged()));
 }
 
 inline HarbourQrCodeGenerator* HarbourQrCodeGenerator::Private::parentObject() const
@@ -140,6 +99,13 @@ QRecLevel HarbourQrCodeGenerator::Private::realEcLevel(ECLevel aEcLevel)
     return QR_ECLEVEL_M; // default
 }
 
+// Runs on a worker thread
+QString HarbourQrCodeGenerator::Private::generateCode(const Input& aInput)
+{
+    QByteArray bytes(generate(aInput.iText, aInput.iEcLevel));
+    return bytes.isEmpty() ? QString() : HarbourBase32::toBase32(bytes);
+}
+
 void HarbourQrCodeGenerator::Private::setText(QString aText)
 {
     if (iText != aText) {
@@ -165,29 +131,10 @@ void HarbourQrCodeGenerator::Private::setEcLevel(int aValue)
 
 void HarbourQrCodeGenerator::Private::regenerate()
 {
-    HarbourQrCodeGenerator* obj = parentObject();
-    const bool wasRunning = (iTask != Q_NULLPTR);
-    if (iTask) iTask->release();
-    iTask = new Task(iThreadPool, iText, iEcLevel);
-    iTask->submit(this, SLOT(onTaskDone()));
-    if (!wasRunning) {
-        Q_EMIT obj->runningChanged();
-    }
-}
-
-void HarbourQrCodeGenerator::Private::onTaskDone()
-{
-    if (sender() == iTask) {
-        HarbourQrCodeGenerator* obj = parentObject();
-        const bool qrCodeChanged = (iCode != iTask->iCode);
-        iCode = iTask->iCode;
-        iTask->release();
-        iTask = NULL;
-        if (qrCodeChanged) {
-            Q_EMIT obj->codeChanged();
-        }
-        Q_EMIT obj->runningChanged();
-    }
+    Input input;
+    input.iText = iText;
+    input.iEcLevel = iEcLevel;
+    iCode->setInput(input);
 }
 
 // ==========================================================================
@@ -228,12 +175,12 @@ void HarbourQrCodeGenerator::setEcLevel(int aValue)
 
 QString HarbourQrCodeGenerator::code() const
 {
-    return iPrivate->iCode;
+    return iPrivate->iCode->result();
 }
 
 bool HarbourQrCodeGenerator::running() const
 {
-    return iPrivate->iTask != Q_NULLPTR;
+    return iPrivate->iCode->running();
 }
 
 QByteArray HarbourQrCodeGenerator::generate(QString aText, ECLevel aEcLevel)
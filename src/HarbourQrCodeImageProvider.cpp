@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2019-2025 Slava Monich <slava@monich.com>
+ * Copyright (C) 2019-2026 Slava Monich <slava@monich.com>
  * Copyright (C) 2019 Jolla Ltd.
  *
  * You may use this file under the terms of the BSD license as follows:
@@ -137,7 +137,7 @@ HarbourQrCodeImageProvider::requestImage(
     }
 
     // Decode BASE32
-    const QByteArray bits(HarbourBase32::fromBase32(base32.toLocal8Bit()));
+    const QByteArray bits(HarbourBase32::fromBase32(base32));
     HDEBUG(base32 << "=>" << bits.size() << "bytes");
 
     // Convert to image
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef HARBOUR_SIMD_H
+#define HARBOUR_SIMD_H
+
+#include <QtGlobal>
+
+// On x86 the vector kernels are compiled with per-function target
+// attributes and selected at runtime, the rest of the code is still
+// built for the baseline CPU. Older gcc can't use the intrinsics
+// without the matching -m option, so they get the scalar code only.
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#  define HARBOUR_SIMD_X86 1
+#  define HARBOUR_TARGET(x) __attribute__((target(x)))
+#  include <immintrin.h>
+#else
+#  define HARBOUR_SIMD_X86 0
+#endif
+
+// NEON is either enabled at compile time (armv7hl, aarch64) or not at all
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define HARBOUR_SIMD_NEON 1
+#  include <arm_neon.h>
+#else
+#  define HARBOUR_SIMD_NEON 0
+#endif
+
+class HarbourSimd
+{
+    HarbourSimd() Q_DECL_EQ_DELETE;
+
+public:
+    enum Feature {
+        SSSE3 = 0x01,
+        SSE41 = 0x02,
+        AVX2 = 0x04,
+        NEON = 0x08
+    };
+
+    // Detected once, the result is cached
+    static inline int features()
+    {
+        static const int value = detect();
+        return value;
+    }
+
+    static inline bool has(Feature aFeature)
+        { return (features() & aFeature) != 0; }
+
+private:
+    static inline int detect()
+    {
+        int f = 0;
+#if HARBOUR_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("ssse3")) f |= SSSE3;
+        if (__builtin_cpu_supports("sse4.1")) f |= SSE41;
+        if (__builtin_cpu_supports("avx2")) f |= AVX2;
+#endif
+#if HARBOUR_SIMD_NEON
+        f |= NEON;
+#endif
+        return f;
+    }
+};
+
+#endif // HARBOUR_SIMD_H
@@ -38,13 +38,80 @@
  */
 
 #include "HarbourTask.h"
+#include "HarbourTaskScheduler.h"
 #include "HarbourDebug.h"
 
 #include <QtCore/QAtomicInteger>
+#include <QtCore/QAtomicPointer>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QEvent>
 #include <QtCore/QPointer>
 #include <QtCore/QThreadPool>
 
+// ==========================================================================
+// HarbourTaskQuitWatcher
+// ==========================================================================
+
+//
+// Counts aboutToQuit signals. A task gets canceled by aboutToQuit only
+// if it has been created before the signal. The watcher gets connected
+// to the signal as soon as QCoreApplication is created, ahead of the
+// application's own handlers, so the tasks created by those handlers
+// see the updated count and still run.
+//
+class HarbourTaskQuitWatcher :
+    public QObject
+{
+    Q_OBJECT
+
+public:
+    static HarbourTaskQuitWatcher* instance();
+    static void attach();
+
+    static inline int count()
+        { return instance()->iCount.loadAcquire(); }
+
+private Q_SLOTS:
+    void onAboutToQuit();
+
+private:
+    QAtomicInt iCount;
+};
+
+HarbourTaskQuitWatcher*
+HarbourTaskQuitWatcher::instance()
+{
+    // Never deleted, workers may still be checking the count at exit
+    static HarbourTaskQuitWatcher* watcher = new HarbourTaskQuitWatcher;
+    return watcher;
+}
+
+void
+HarbourTaskQuitWatcher::attach()
+{
+    QCoreApplication* app = QCoreApplication::instance();
+
+    HDEBUG("Attaching to" << app);
+    connect(app, SIGNAL(aboutToQuit()), instance(), SLOT(onAboutToQuit()),
+        Qt::DirectConnection);
+}
+
+void
+HarbourTaskQuitWatcher::onAboutToQuit()
+{
+    HDEBUG("OK");
+    iCount.ref();
+}
+
+static
+void
+harbourTaskQuitWatcherAttach()
+{
+    HarbourTaskQuitWatcher::attach();
+}
+
+Q_COREAPP_STARTUP_FUNCTION(harbourTaskQuitWatcherAttach)
+
 // ==========================================================================
 // HarbourTask::Private
 // ==========================================================================
@@ -57,12 +124,17 @@ public:
 public:
     QThreadPool* iPool;
     QPointer<QObject> iTarget;
+    HarbourTaskScheduler* iScheduler;
+    // Link in the completion channel's stack or batch
+    HarbourTask* iNext;
+    // The number of aboutToQuit signals emitted before the task was created
+    const int iQuitCount;
     // These flags are set by the worker thread:
     QAtomicInteger<bool> iStarted;
     QAtomicInteger<bool> iFinished;
     // These are set by the main thread (and checked by the worker):
-    QAtomicInteger<bool> iAboutToQuit;
     QAtomicInteger<bool> iReleased;
+    QAtomicInteger<bool> iSkipped;
     // And these are manipulated only by the main thread:
     bool iSubmitted;
     bool iDone;
@@ -71,14 +143,169 @@ public:
 HarbourTask::Private::Private(
     QThreadPool* aPool) :
     iPool(aPool),
+    iScheduler(Q_NULLPTR),
+    iNext(Q_NULLPTR),
+    iQuitCount(HarbourTaskQuitWatcher::count()),
     iStarted(false),
     iFinished(false),
-    iAboutToQuit(false),
     iReleased(false),
+    iSkipped(false),
     iSubmitted(false),
     iDone(false)
 {}
 
+// ==========================================================================
+// HarbourTask::Channel
+// ==========================================================================
+
+//
+// Delivers finished tasks to the main thread. Workers push them onto
+// a lock-free stack (multiple producers, one consumer) and whoever finds
+// the stack empty posts an event. The main thread grabs the whole stack
+// at once and completes the tasks in the order they have finished.
+//
+class HarbourTask::Channel :
+    public QObject
+{
+    Q_OBJECT
+
+public:
+    Channel();
+
+    static Channel* instance();
+
+    void push(HarbourTask*);
+    void remove(HarbourTask*);
+    bool event(QEvent*) Q_DECL_OVERRIDE;
+
+private:
+    void post();
+    void splice(HarbourTask*, HarbourTask*);
+
+private:
+    const QEvent::Type iEventType;
+    QAtomicPointer<HarbourTask> iStack;
+    // Tasks taken from the stack but not completed yet (main thread only)
+    HarbourTask* iBatch;
+};
+
+HarbourTask::Channel::Channel() :
+    iEventType((QEvent::Type)QEvent::registerEventType()),
+    iBatch(Q_NULLPTR)
+{}
+
+HarbourTask::Channel*
+HarbourTask::Channel::instance()
+{
+    // Never deleted, workers may still be pushing tasks at exit
+    static Channel* channel = new Channel;
+    return channel;
+}
+
+void
+HarbourTask::Channel::post()
+{
+    QCoreApplication::postEvent(this, new QEvent(iEventType));
+}
+
+// Puts the chain [aFirst..aLast] on top of the stack
+void
+HarbourTask::Channel::splice(
+    HarbourTask* aFirst,
+    HarbourTask* aLast)
+{
+    HarbourTask* top;
+
+    do {
+        top = iStack.loadAcquire();
+        aLast->iPrivate->iNext = top;
+    } while (!iStack.testAndSetRelease(top, aFirst));
+
+    if (!top) {
+        // The stack was empty, nothing has been posted yet
+        post();
+    }
+}
+
+// Invoked on any thread
+void
+HarbourTask::Channel::push(
+    HarbourTask* aTask)
+{
+    splice(aTask, aTask);
+}
+
+// Invoked on the main thread by the task being destroyed before it has
+// been completed (e.g. together with its thread pool)
+void
+HarbourTask::Channel::remove(
+    HarbourTask* aTask)
+{
+    HarbourTask** ptr = &iBatch;
+
+    while (*ptr) {
+        if (*ptr == aTask) {
+            *ptr = aTask->iPrivate->iNext;
+            return;
+        }
+        ptr = &((*ptr)->iPrivate->iNext);
+    }
+
+    // Not in the batch, must be still on the stack. Take the whole
+    // thing, drop the task and put the rest back.
+    HarbourTask* first = iStack.fetchAndStoreAcquire(Q_NULLPTR);
+    HarbourTask* last = Q_NULLPTR;
+
+    ptr = &first;
+    while (*ptr) {
+        if (*ptr == aTask) {
+            *ptr = aTask->iPrivate->iNext;
+        } else {
+            last = *ptr;
+            ptr = &(last->iPrivate->iNext);
+        }
+    }
+    if (first) {
+        splice(first, last);
+    }
+}
+
+bool
+HarbourTask::Channel::event(
+    QEvent* aEvent)
+{
+    if (aEvent->type() == iEventType) {
+        // The stack is LIFO, reverse it and append to the batch
+        HarbourTask* top = iStack.fetchAndStoreAcquire(Q_NULLPTR);
+        HarbourTask* list = Q_NULLPTR;
+        HarbourTask** tail = &iBatch;
+
+        while (top) {
+            HarbourTask* next = top->iPrivate->iNext;
+
+            top->iPrivate->iNext = list;
+            list = top;
+            top = next;
+        }
+        while (*tail) {
+            tail = &((*tail)->iPrivate->iNext);
+        }
+        *tail = list;
+
+        // Completion handlers may destroy other tasks in the batch,
+        // those get removed from it by remove()
+        while (iBatch) {
+            HarbourTask* task = iBatch;
+
+            iBatch = task->iPrivate->iNext;
+            task->iPrivate->iNext = Q_NULLPTR;
+            task->onRunFinished();
+        }
+        return true;
+    }
+    return QObject::event(aEvent);
+}
+
 // ==========================================================================
 // HarbourTask
 // ==========================================================================
@@ -89,9 +316,8 @@ HarbourTask::HarbourTask(
     iPrivate(new Private(aPool))
 {
     setAutoDelete(false);
-    connect(qApp, SIGNAL(aboutToQuit()), SLOT(onAboutToQuit()));
-    connect(this, SIGNAL(runFinished()), SLOT(onRunFinished()),
-        Qt::QueuedConnection);
+    // Make sure that the channel gets created on the main thread
+    Channel::instance();
 }
 
 HarbourTask::~HarbourTask()
@@ -100,6 +326,13 @@ HarbourTask::~HarbourTask()
     // main thread and the target has a chance to release the task.
     HASSERT(iPrivate->iReleased || !iPrivate->iTarget);
     HASSERT(!iPrivate->iSubmitted || iPrivate->iFinished);
+    if (iPrivate->iFinished && !iPrivate->iDone) {
+        // Still waiting to be completed
+        Channel::instance()->remove(this);
+    }
+    if (iPrivate->iScheduler) {
+        iPrivate->iScheduler->taskDestroyed(this);
+    }
     delete iPrivate;
 }
 
@@ -112,7 +345,8 @@ HarbourTask::isStarted() const
 bool
 HarbourTask::isCanceled() const
 {
-    return iPrivate->iReleased || iPrivate->iAboutToQuit;
+    return iPrivate->iReleased || iPrivate->iSkipped ||
+        iPrivate->iQuitCount != HarbourTaskQuitWatcher::count();
 }
 
 void
@@ -130,11 +364,53 @@ void
 HarbourTask::submit(
     QObject* aTarget,
     const char* aSlot)
+{
+    setTarget(aTarget, aSlot);
+    submit();
+}
+
+void
+HarbourTask::setTarget(
+    QObject* aTarget,
+    const char* aSlot)
 {
     HASSERT(!iPrivate->iTarget);
     iPrivate->iTarget = aTarget;
     aTarget->connect(this, SIGNAL(done()), aSlot);
-    submit();
+}
+
+void
+HarbourTask::scheduled(
+    HarbourTaskScheduler* aScheduler)
+{
+    HASSERT(!iPrivate->iSubmitted);
+    iPrivate->iSubmitted = true;
+    iPrivate->iScheduler = aScheduler;
+}
+
+void
+HarbourTask::unscheduled()
+{
+    iPrivate->iScheduler = Q_NULLPTR;
+}
+
+// Invoked by the scheduler when it's this task's turn to run
+void
+HarbourTask::start()
+{
+    iPrivate->iPool->start(this);
+}
+
+// Completes the task without running it. That happens to the tasks
+// which get superseded or released while they are waiting in the
+// scheduler's queue. done() is still emitted (unless the task has
+// been released) but isCanceled() returns true.
+void
+HarbourTask::skip()
+{
+    iPrivate->iSkipped = true;
+    iPrivate->iFinished = true;
+    runFinished();
 }
 
 void
@@ -151,6 +427,9 @@ void
 HarbourTask::released()
 {
     iPrivate->iReleased = true;
+    if (iPrivate->iScheduler) {
+        iPrivate->iScheduler->taskReleased(this);
+    }
     if (!iPrivate->iSubmitted || iPrivate->iDone) {
         delete this;
     }
@@ -165,7 +444,14 @@ HarbourTask::run()
         performTask();
     }
     iPrivate->iFinished = true;
-    Q_EMIT runFinished();
+    runFinished();
+}
+
+// Invoked on the worker thread (or on the main thread by skip())
+void
+HarbourTask::runFinished()
+{
+    Channel::instance()->push(this);
 }
 
 void
@@ -177,14 +463,12 @@ HarbourTask::onRunFinished()
         Q_EMIT done();
     }
     iPrivate->iDone = true;
+    if (iPrivate->iScheduler) {
+        iPrivate->iScheduler->taskFinished(this);
+    }
     if (iPrivate->iReleased) {
         delete this;
     }
 }
 
-void
-HarbourTask::onAboutToQuit()
-{
-    HDEBUG("OK");
-    iPrivate->iAboutToQuit = true;
-}
+#include "HarbourTask.moc"
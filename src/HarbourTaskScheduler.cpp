@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourTaskScheduler.h"
+#include "HarbourTask.h"
+#include "HarbourDebug.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QThreadPool>
+
+// ==========================================================================
+// HarbourTaskScheduler::Private
+// ==========================================================================
+
+class HarbourTaskScheduler::Private
+{
+public:
+    enum { PRIORITY_COUNT = PriorityVisible + 1 };
+
+    struct Entry {
+        int iPriority;
+        QString iKey;
+    };
+
+    Private(QThreadPool*);
+
+    static int index(Priority);
+
+    void enqueue(HarbourTask*, Priority, const QString&);
+    bool dequeue(HarbourTask*);
+    HarbourTask* takeNext();
+    void dispatch();
+
+public:
+    QThreadPool* iPool;
+    QList<HarbourTask*> iQueue[PRIORITY_COUNT];
+    QHash<HarbourTask*,Entry> iQueued;
+    QHash<QString,HarbourTask*> iKeys;
+    QList<HarbourTask*> iRunning;
+};
+
+HarbourTaskScheduler::Private::Private(
+    QThreadPool* aPool) :
+    iPool(aPool)
+{
+}
+
+inline
+int
+HarbourTaskScheduler::Private::index(
+    Priority aPriority)
+{
+    return qBound(0, (int)aPriority, (int)PRIORITY_COUNT - 1);
+}
+
+void
+HarbourTaskScheduler::Private::enqueue(
+    HarbourTask* aTask,
+    Priority aPriority,
+    const QString& aKey)
+{
+    Entry entry;
+
+    entry.iPriority = index(aPriority);
+    entry.iKey = aKey;
+    iQueue[entry.iPriority].append(aTask);
+    iQueued.insert(aTask, entry);
+    if (!aKey.isEmpty()) {
+        iKeys.insert(aKey, aTask);
+    }
+}
+
+bool
+HarbourTaskScheduler::Private::dequeue(
+    HarbourTask* aTask)
+{
+    QHash<HarbourTask*,Entry>::Iterator it = iQueued.find(aTask);
+
+    if (it != iQueued.end()) {
+        const Entry& entry = it.value();
+
+        iQueue[entry.iPriority].removeOne(aTask);
+        if (!entry.iKey.isEmpty() && iKeys.value(entry.iKey) == aTask) {
+            iKeys.remove(entry.iKey);
+        }
+        iQueued.erase(it);
+        return true;
+    }
+    return false;
+}
+
+HarbourTask*
+HarbourTaskScheduler::Private::takeNext()
+{
+    for (int i = PRIORITY_COUNT - 1; i >= 0; i--) {
+        if (!iQueue[i].isEmpty()) {
+            HarbourTask* task = iQueue[i].first();
+
+            dequeue(task);
+            return task;
+        }
+    }
+    return Q_NULLPTR;
+}
+
+// Keeps at most as many tasks in the pool as it has threads, the rest
+// wait here where they can still be reordered
+void
+HarbourTaskScheduler::Private::dispatch()
+{
+    const int maxRunning = qMax(iPool->maxThreadCount(), 1);
+
+    while (iRunning.count() < maxRunning) {
+        HarbourTask* task = takeNext();
+
+        if (task) {
+            iRunning.append(task);
+            task->start();
+        } else {
+            break;
+        }
+    }
+}
+
+// ==========================================================================
+// HarbourTaskScheduler
+// ==========================================================================
+
+HarbourTaskScheduler::HarbourTaskScheduler(
+    QThreadPool* aPool,
+    QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private(aPool))
+{
+}
+
+HarbourTaskScheduler::~HarbourTaskScheduler()
+{
+    // Complete the queued tasks without running them
+    for (int i = Private::PRIORITY_COUNT - 1; i >= 0; i--) {
+        const QList<HarbourTask*> queue(iPrivate->iQueue[i]);
+        const int n = queue.count();
+
+        for (int k = 0; k < n; k++) {
+            HarbourTask* task = queue.at(k);
+
+            task->unscheduled();
+            task->skip();
+        }
+    }
+
+    // And forget about the running ones
+    const int n = iPrivate->iRunning.count();
+
+    for (int i = 0; i < n; i++) {
+        iPrivate->iRunning.at(i)->unscheduled();
+    }
+    delete iPrivate;
+}
+
+QThreadPool*
+HarbourTaskScheduler::threadPool() const
+{
+    return iPrivate->iPool;
+}
+
+int
+HarbourTaskScheduler::queuedCount() const
+{
+    return iPrivate->iQueued.count();
+}
+
+int
+HarbourTaskScheduler::runningCount() const
+{
+    return iPrivate->iRunning.count();
+}
+
+void
+HarbourTaskScheduler::submit(
+    HarbourTask* aTask,
+    Priority aPriority,
+    const QString aKey)
+{
+    aTask->scheduled(this);
+    if (!aKey.isEmpty()) {
+        HarbourTask* prev = iPrivate->iKeys.value(aKey);
+
+        if (prev) {
+            HDEBUG("superseding" << aKey);
+            iPrivate->dequeue(prev);
+            prev->unscheduled();
+            prev->skip();
+        }
+    }
+    iPrivate->enqueue(aTask, aPriority, aKey);
+    iPrivate->dispatch();
+}
+
+void
+HarbourTaskScheduler::submit(
+    HarbourTask* aTask,
+    QObject* aTarget,
+    const char* aSlot,
+    Priority aPriority,
+    const QString aKey)
+{
+    aTask->setTarget(aTarget, aSlot);
+    submit(aTask, aPriority, aKey);
+}
+
+bool
+HarbourTaskScheduler::isQueued(
+    HarbourTask* aTask) const
+{
+    return iPrivate->iQueued.contains(aTask);
+}
+
+bool
+HarbourTaskScheduler::setPriority(
+    HarbourTask* aTask,
+    Priority aPriority)
+{
+    QHash<HarbourTask*,Private::Entry>::Iterator it =
+        iPrivate->iQueued.find(aTask);
+
+    if (it != iPrivate->iQueued.end()) {
+        Private::Entry& entry = it.value();
+        const int priority = Private::index(aPriority);
+
+        if (entry.iPriority != priority) {
+            // Goes to the end of the new queue
+            iPrivate->iQueue[entry.iPriority].removeOne(aTask);
+            iPrivate->iQueue[priority].append(aTask);
+            entry.iPriority = priority;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool
+HarbourTaskScheduler::setPriority(
+    const QString aKey,
+    Priority aPriority)
+{
+    HarbourTask* task = iPrivate->iKeys.value(aKey);
+
+    return task && setPriority(task, aPriority);
+}
+
+// Invoked by HarbourTask on the main thread after emitting done()
+void
+HarbourTaskScheduler::taskFinished(
+    HarbourTask* aTask)
+{
+    if (iPrivate->iRunning.removeOne(aTask)) {
+        aTask->unscheduled();
+        iPrivate->dispatch();
+    }
+}
+
+void
+HarbourTaskScheduler::taskReleased(
+    HarbourTask* aTask)
+{
+    if (iPrivate->dequeue(aTask)) {
+        HDEBUG("dropping released task");
+        aTask->unscheduled();
+        aTask->skip();
+    }
+}
+
+void
+HarbourTaskScheduler::taskDestroyed(
+    HarbourTask* aTask)
+{
+    iPrivate->dequeue(aTask);
+    if (iPrivate->iRunning.removeOne(aTask)) {
+        iPrivate->dispatch();
+    }
+}
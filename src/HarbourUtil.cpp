@@ -39,6 +39,264 @@
 
 #include "HarbourUtil.h"
 
+#include "HarbourSimd.h"
+
+// ==========================================================================
+// Vector kernels
+//
+// Encoders convert 16 bytes into 32 hex digits per step, decoders go the
+// other way. Decoders stop at the first block containing anything but
+// hex digits, the scalar code then figures out what exactly is wrong.
+// ==========================================================================
+
+#if HARBOUR_SIMD_X86
+
+HARBOUR_TARGET("ssse3")
+static inline
+void
+hexStoreSsse3(
+    char* aOut,
+    __m128i aLow,
+    __m128i aHigh)
+{
+    _mm_storeu_si128((__m128i*)aOut, aLow);
+    _mm_storeu_si128((__m128i*)(aOut + 16), aHigh);
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+void
+hexStoreSsse3(
+    QChar* aOut,
+    __m128i aLow,
+    __m128i aHigh)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    _mm_storeu_si128((__m128i*)aOut, _mm_unpacklo_epi8(aLow, zero));
+    _mm_storeu_si128((__m128i*)(aOut + 8), _mm_unpackhi_epi8(aLow, zero));
+    _mm_storeu_si128((__m128i*)(aOut + 16), _mm_unpacklo_epi8(aHigh, zero));
+    _mm_storeu_si128((__m128i*)(aOut + 24), _mm_unpackhi_epi8(aHigh, zero));
+}
+
+template <typename C>
+HARBOUR_TARGET("ssse3")
+static
+int
+hexEncodeBlocksSsse3(
+    const uchar* aIn,
+    int aSize,
+    C* aOut)
+{
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6',
+        '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    int i = 0;
+
+    for (; (aSize - i) >= 16; i += 16, aOut += 32) {
+        const __m128i in = _mm_loadu_si128((const __m128i*)(aIn + i));
+        const __m128i hi = _mm_shuffle_epi8(digits,
+            _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        const __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(in, mask));
+
+        hexStoreSsse3(aOut, _mm_unpacklo_epi8(hi, lo),
+            _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+__m128i
+hexLoadSsse3(
+    const char* aIn)
+{
+    return _mm_loadu_si128((const __m128i*)aIn);
+}
+
+HARBOUR_TARGET("ssse3")
+static inline
+__m128i
+hexLoadSsse3(
+    const QChar* aIn)
+{
+    // Characters above 0xff saturate to either 0 or 0xff, both invalid
+    return _mm_packus_epi16(_mm_loadu_si128((const __m128i*)aIn),
+        _mm_loadu_si128((const __m128i*)(aIn + 8)));
+}
+
+// Converts 16 hex digits into 16 nibbles, returns false if some of
+// the characters aren't hex digits
+HARBOUR_TARGET("ssse3")
+static inline
+bool
+hexDecodeSsse3(
+    __m128i aChars,
+    __m128i* aNibbles)
+{
+    // Signed comparison, anything >= 0x80 fails all range checks
+    const __m128i d = _mm_sub_epi8(aChars, _mm_set1_epi8('0'));
+    const __m128i l = _mm_sub_epi8(_mm_or_si128(aChars,
+        _mm_set1_epi8(0x20)), _mm_set1_epi8('a' - 10));
+    const __m128i digit = _mm_and_si128(
+        _mm_cmpgt_epi8(aChars, _mm_set1_epi8('0' - 1)),
+        _mm_cmplt_epi8(aChars, _mm_set1_epi8('9' + 1)));
+    const __m128i letter = _mm_and_si128(
+        _mm_cmpgt_epi8(l, _mm_set1_epi8(9)),
+        _mm_cmplt_epi8(l, _mm_set1_epi8(16)));
+
+    if (_mm_movemask_epi8(_mm_or_si128(digit, letter)) != 0xffff) {
+        return false;
+    }
+    *aNibbles = _mm_or_si128(_mm_and_si128(digit, d),
+        _mm_and_si128(letter, l));
+    return true;
+}
+
+template <typename C>
+HARBOUR_TARGET("ssse3")
+static
+int
+hexDecodeBlocksSsse3(
+    const C* aIn,
+    int aLength,
+    uchar* aOut)
+{
+    // Each 16-bit lane gets (high << 4) + low
+    const __m128i mul = _mm_set1_epi16(0x0110);
+    __m128i a, b;
+    int i = 0;
+
+    for (; (aLength - i) >= 32 &&
+        hexDecodeSsse3(hexLoadSsse3(aIn + i), &a) &&
+        hexDecodeSsse3(hexLoadSsse3(aIn + i + 16), &b);
+        i += 32, aOut += 16) {
+        _mm_storeu_si128((__m128i*)aOut, _mm_packus_epi16(
+            _mm_maddubs_epi16(a, mul), _mm_maddubs_epi16(b, mul)));
+    }
+    return i;
+}
+
+#endif // HARBOUR_SIMD_X86
+
+#if HARBOUR_SIMD_NEON
+
+static inline
+void
+hexStoreNeon(
+    char* aOut,
+    uint8x16x2_t aChars)
+{
+    vst1q_u8((uchar*)aOut, aChars.val[0]);
+    vst1q_u8((uchar*)(aOut + 16), aChars.val[1]);
+}
+
+static inline
+void
+hexStoreNeon(
+    QChar* aOut,
+    uint8x16x2_t aChars)
+{
+    ushort* out = (ushort*)aOut;
+
+    vst1q_u16(out, vmovl_u8(vget_low_u8(aChars.val[0])));
+    vst1q_u16(out + 8, vmovl_u8(vget_high_u8(aChars.val[0])));
+    vst1q_u16(out + 16, vmovl_u8(vget_low_u8(aChars.val[1])));
+    vst1q_u16(out + 24, vmovl_u8(vget_high_u8(aChars.val[1])));
+}
+
+static inline
+uint8x16_t
+hexDigitsNeon(
+    uint8x16_t aNibbles)
+{
+    // 0..9 => digits, 10..15 => letters
+    return vaddq_u8(vaddq_u8(aNibbles, vdupq_n_u8('0')), vandq_u8(
+        vcgtq_u8(aNibbles, vdupq_n_u8(9)), vdupq_n_u8('a' - '0' - 10)));
+}
+
+template <typename C>
+static
+int
+hexEncodeBlocksNeon(
+    const uchar* aIn,
+    int aSize,
+    C* aOut)
+{
+    int i = 0;
+
+    for (; (aSize - i) >= 16; i += 16, aOut += 32) {
+        const uint8x16_t in = vld1q_u8(aIn + i);
+
+        hexStoreNeon(aOut, vzipq_u8(hexDigitsNeon(vshrq_n_u8(in, 4)),
+            hexDigitsNeon(vandq_u8(in, vdupq_n_u8(0x0f)))));
+    }
+    return i;
+}
+
+static inline
+uint8x16_t
+hexLoadNeon(
+    const char* aIn)
+{
+    return vld1q_u8((const uchar*)aIn);
+}
+
+static inline
+uint8x16_t
+hexLoadNeon(
+    const QChar* aIn)
+{
+    const ushort* in = (const ushort*)aIn;
+
+    return vcombine_u8(vqmovn_u16(vld1q_u16(in)), vqmovn_u16(vld1q_u16(in + 8)));
+}
+
+template <typename C>
+static
+int
+hexDecodeBlocksNeon(
+    const C* aIn,
+    int aLength,
+    uchar* aOut)
+{
+    int i = 0;
+
+    for (; (aLength - i) >= 32; i += 32, aOut += 16) {
+        // Separate high (even) and low (odd) digits
+        const uint8x16x2_t c = vuzpq_u8(hexLoadNeon(aIn + i),
+            hexLoadNeon(aIn + i + 16));
+        const uint8x16_t dh = vsubq_u8(c.val[0], vdupq_n_u8('0'));
+        const uint8x16_t dl = vsubq_u8(c.val[1], vdupq_n_u8('0'));
+        const uint8x16_t lh = vsubq_u8(vorrq_u8(c.val[0], vdupq_n_u8(0x20)),
+            vdupq_n_u8('a'));
+        const uint8x16_t ll = vsubq_u8(vorrq_u8(c.val[1], vdupq_n_u8(0x20)),
+            vdupq_n_u8('a'));
+        const uint8x16_t digith = vcltq_u8(dh, vdupq_n_u8(10));
+        const uint8x16_t digitl = vcltq_u8(dl, vdupq_n_u8(10));
+        const uint8x16_t letterh = vcltq_u8(lh, vdupq_n_u8(6));
+        const uint8x16_t letterl = vcltq_u8(ll, vdupq_n_u8(6));
+        const uint8x16_t valid = vandq_u8(vorrq_u8(digith, letterh),
+            vorrq_u8(digitl, letterl));
+        const uint8x8_t all = vand_u8(vget_low_u8(valid), vget_high_u8(valid));
+
+        if (vget_lane_u64(vreinterpret_u64_u8(all), 0) != ~Q_UINT64_C(0)) {
+            break;
+        }
+
+        const uint8x16_t ten = vdupq_n_u8(10);
+        const uint8x16_t hi = vorrq_u8(vandq_u8(digith, dh),
+            vandq_u8(letterh, vaddq_u8(lh, ten)));
+        const uint8x16_t lo = vorrq_u8(vandq_u8(digitl, dl),
+            vandq_u8(letterl, vaddq_u8(ll, ten)));
+
+        vst1q_u8(aOut, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    }
+    return i;
+}
+
+#endif // HARBOUR_SIMD_NEON
+
 // ==========================================================================
 // HarbourUtil::Private
 // ==========================================================================
@@ -47,10 +305,151 @@ class HarbourUtil::Private
 {
 public:
     static const char hex[];
+
+    static inline uint code(char aChar) { return (uchar)aChar; }
+    static inline uint code(QChar aChar) { return aChar.unicode(); }
+    static inline int hexDigit(uint);
+
+    template <typename C> static inline int encodeBlocks(const uchar*, int, C*);
+    template <typename C> static inline int decodeBlocks(const C*, int, uchar*);
+    template <typename C> static void encode(const uchar*, int, C*);
+    template <typename C> static int decode(const C*, int, void*, int, int*);
+    template <typename C> static QByteArray fromHex(const C*, int, int*);
 };
 
 const char HarbourUtil::Private::hex[] = "0123456789abcdef";
 
+// Returns the value of the hex digit, or -1 if it's not a hex digit
+inline
+int
+HarbourUtil::Private::hexDigit(
+    uint aChar)
+{
+    if (aChar >= '0' && aChar <= '9') {
+        return aChar - '0';
+    } else {
+        // Only affects ASCII letters, can't bring anything else in range
+        const uint c = aChar | 0x20;
+
+        return (c >= 'a' && c <= 'f') ? (c - 'a' + 10) : -1;
+    }
+}
+
+// Encodes as many bytes as the vector code can handle, returns the number
+// of bytes consumed (a multiple of 16), the output is 2 characters per byte
+template <typename C>
+inline
+int
+HarbourUtil::Private::encodeBlocks(
+    const uchar* aIn,
+    int aSize,
+    C* aOut)
+{
+#if HARBOUR_SIMD_X86
+    if (HarbourSimd::has(HarbourSimd::SSSE3)) {
+        return hexEncodeBlocksSsse3(aIn, aSize, aOut);
+    }
+#elif HARBOUR_SIMD_NEON
+    return hexEncodeBlocksNeon(aIn, aSize, aOut);
+#endif
+    return 0;
+}
+
+// Decodes as many characters as the vector code can handle, stops at
+// anything unusual. Returns the number of characters consumed (always
+// a multiple of 32), the output size is 1 byte per 2 characters.
+template <typename C>
+inline
+int
+HarbourUtil::Private::decodeBlocks(
+    const C* aIn,
+    int aLength,
+    uchar* aOut)
+{
+#if HARBOUR_SIMD_X86
+    if (HarbourSimd::has(HarbourSimd::SSSE3)) {
+        return hexDecodeBlocksSsse3(aIn, aLength, aOut);
+    }
+#elif HARBOUR_SIMD_NEON
+    return hexDecodeBlocksNeon(aIn, aLength, aOut);
+#endif
+    return 0;
+}
+
+// The output buffer must have room for exactly 2 * aSize characters
+template <typename C>
+void
+HarbourUtil::Private::encode(
+    const uchar* aIn,
+    int aSize,
+    C* aOut)
+{
+    const int done = encodeBlocks(aIn, aSize, aOut);
+    C* out = aOut + 2 * done;
+
+    for (int i = done; i < aSize; i++) {
+        const uchar b = aIn[i];
+
+        *out++ = C(hex[b >> 4]);
+        *out++ = C(hex[b & 0x0f]);
+    }
+}
+
+template <typename C>
+int
+HarbourUtil::Private::decode(
+    const C* aIn,
+    int aLength,
+    void* aBuf,
+    int aBufSize,
+    int* aErrorPos)
+{
+    const int size = aLength / 2;
+
+    if (aBufSize < size) {
+        if (aErrorPos) {
+            *aErrorPos = -1;
+        }
+        return -1;
+    }
+
+    uchar* out = (uchar*)aBuf;
+    int i = decodeBlocks(aIn, aLength, out);
+
+    out += i / 2;
+    for (; i < aLength; i += 2) {
+        const int hi = hexDigit(code(aIn[i]));
+        const int lo = (i + 1 < aLength) ? hexDigit(code(aIn[i + 1])) : -1;
+
+        if (hi < 0 || lo < 0) {
+            if (aErrorPos) {
+                // An unpaired last digit is invalid too
+                *aErrorPos = (hi < 0 || i + 1 == aLength) ? i : (i + 1);
+            }
+            return -1;
+        }
+        *out++ = (uchar)((hi << 4) | lo);
+    }
+    return size;
+}
+
+template <typename C>
+QByteArray
+HarbourUtil::Private::fromHex(
+    const C* aIn,
+    int aLength,
+    int* aErrorPos)
+{
+    if (aLength > 0) {
+        QByteArray out(aLength / 2, Qt::Uninitialized);
+
+        if (decode(aIn, aLength, out.data(), out.size(), aErrorPos) >= 0) {
+            return out;
+        }
+    }
+    return QByteArray();
+}
+
 // ==========================================================================
 // HarbourUtil
 // ==========================================================================
@@ -95,20 +494,13 @@ HarbourUtil::toHex(
     const void* aData,
     size_t aSize)
 {
-    QString hex;
-
     if (aSize > 0) {
-        const uchar* bytes = (const uchar*)aData;
+        QString hex((int)(2 * aSize), Qt::Uninitialized);
 
-        hex.reserve(2 * aSize);
-        for (size_t i = 0; i < aSize; i++) {
-            const uchar b = bytes[i];
-
-            hex.append(QChar(Private::hex[(b & 0xf0) >> 4]));
-            hex.append(QChar(Private::hex[b & 0x0f]));
-        }
+        Private::encode((const uchar*)aData, (int)aSize, hex.data());
+        return hex;
     }
-    return hex;
+    return QString();
 }
 
 QByteArray
@@ -116,9 +508,82 @@ HarbourUtil::toHexBytes(
     const void* aData,
     size_t aSize)
 {
-    return aSize ?
-        QByteArray::fromRawData((const char*) aData, (int) aSize).toHex() :
-        QByteArray();
+    if (aSize > 0) {
+        QByteArray hex((int)(2 * aSize), Qt::Uninitialized);
+
+        Private::encode((const uchar*)aData, (int)aSize, hex.data());
+        return hex;
+    }
+    return QByteArray();
+}
+
+QByteArray
+HarbourUtil::fromHex(
+    const QString aHex,
+    int* aErrorPos)
+{
+    return Private::fromHex(aHex.constData(), aHex.length(), aErrorPos);
+}
+
+QByteArray
+HarbourUtil::fromHex(
+    const QByteArray aHex,
+    int* aErrorPos)
+{
+    return Private::fromHex(aHex.constData(), aHex.size(), aErrorPos);
+}
+
+QByteArray
+HarbourUtil::fromHex(
+    const char* aHex,
+    int aLength,
+    int* aErrorPos)
+{
+    return Private::fromHex(aHex, aLength, aErrorPos);
+}
+
+int
+HarbourUtil::decodeHex(
+    const QString aHex,
+    void* aBuf,
+    int aBufSize,
+    int* aErrorPos)
+{
+    return Private::decode(aHex.constData(), aHex.length(), aBuf, aBufSize,
+        aErrorPos);
+}
+
+int
+HarbourUtil::decodeHex(
+    const QByteArray aHex,
+    void* aBuf,
+    int aBufSize,
+    int* aErrorPos)
+{
+    return Private::decode(aHex.constData(), aHex.size(), aBuf, aBufSize,
+        aErrorPos);
+}
+
+int
+HarbourUtil::decodeHex(
+    const char* aHex,
+    int aLength,
+    void* aBuf,
+    int aBufSize,
+    int* aErrorPos)
+{
+    return Private::decode(aHex, qMax(aLength, 0), aBuf, aBufSize, aErrorPos);
+}
+
+int
+HarbourUtil::decodeHex(
+    const QChar* aHex,
+    int aLength,
+    void* aBuf,
+    int aBufSize,
+    int* aErrorPos)
+{
+    return Private::decode(aHex, qMax(aLength, 0), aBuf, aBufSize, aErrorPos);
 }
 
 // Make sure that deleteLater() is invoked from Qt event loop.
@@ -0,0 +1,536 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourBase32.h"
+#include "HarbourBase45.h"
+#include "HarbourCbor.h"
+#include "HarbourProtoBuf.h"
+#include "HarbourQrCodeGenerator.h"
+#include "HarbourUtil.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_FORMAT_VERSION 1
+#define BENCH_DEFAULT_TIME_MS 200
+#define BENCH_DEFAULT_THRESHOLD 5.0
+#define BENCH_ROUNDS 3
+
+#define UNIT_MBPS "MB/s"
+#define UNIT_MOPS "Mops/s"
+#define UNIT_USEC "us"
+
+typedef struct bench_config {
+    qint64 timeMs;
+    const char* filter;
+} BenchConfig;
+
+// Keeps the compiler from optimizing the work away
+static volatile quint64 bench_sink;
+
+static const int bench_sizes[] = { 16, 256, 4096, 65536 };
+
+/*==========================================================================*
+ * Measurement
+ *==========================================================================*/
+
+// Runs the function in batches until the time runs out, returns the best
+// time of a single call in nanoseconds, measured over several rounds.
+template <typename F>
+static
+double
+bench_measure(
+    const BenchConfig* aConfig,
+    F aFunction)
+{
+    double best = 0;
+
+    // Warm up (and figure out the batch size)
+    QElapsedTimer timer;
+    qint64 batch = 1;
+
+    timer.start();
+    aFunction();
+    while (timer.nsecsElapsed() < 1000000) {
+        for (qint64 i = 0; i < batch; i++) {
+            aFunction();
+        }
+        batch *= 2;
+    }
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        const qint64 limit = aConfig->timeMs * 1000000 / BENCH_ROUNDS;
+        qint64 calls = 0;
+
+        timer.restart();
+        do {
+            for (qint64 i = 0; i < batch; i++) {
+                aFunction();
+            }
+            calls += batch;
+        } while (timer.nsecsElapsed() < limit);
+
+        const double ns = (double)timer.nsecsElapsed() / calls;
+
+        if (!round || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+static
+bool
+bench_selected(
+    const BenchConfig* aConfig,
+    const char* aName)
+{
+    return !aConfig->filter || strstr(aName, aConfig->filter);
+}
+
+static
+void
+bench_add(
+    QJsonArray* aResults,
+    const char* aName,
+    int aSize,
+    const char* aUnit,
+    double aValue)
+{
+    QJsonObject result;
+
+    result.insert("name", QString::fromLatin1(aName));
+    result.insert("size", aSize);
+    result.insert("unit", QString::fromLatin1(aUnit));
+    result.insert("value", aValue);
+    aResults->append(result);
+    fprintf(stderr, "%-24s %8d %12.2f %s\n", aName, aSize, aValue, aUnit);
+}
+
+// Throughput in MB/s for aBytes processed per call
+template <typename F>
+static
+void
+bench_throughput(
+    const BenchConfig* aConfig,
+    QJsonArray* aResults,
+    const char* aName,
+    int aBytes,
+    F aFunction)
+{
+    if (bench_selected(aConfig, aName)) {
+        const double ns = bench_measure(aConfig, aFunction);
+
+        bench_add(aResults, aName, aBytes, UNIT_MBPS, aBytes * 1000.0 / ns);
+    }
+}
+
+static
+QByteArray
+bench_random_bytes(
+    int aSize)
+{
+    QByteArray bytes;
+
+    bytes.resize(aSize);
+    for (int i = 0; i < aSize; i++) {
+        bytes.data()[i] = (char)rand();
+    }
+    return bytes;
+}
+
+/*==========================================================================*
+ * Benchmarks
+ *==========================================================================*/
+
+static
+void
+bench_base32(
+    const BenchConfig* aConfig,
+    QJsonArray* aResults)
+{
+    for (uint i = 0; i < G_N_ELEMENTS(bench_sizes); i++) {
+        const int size = bench_sizes[i];
+        const QByteArray data(bench_random_bytes(size));
+        const QString text(HarbourBase32::toBase32(data));
+
+        bench_throughput(aConfig, aResults, "base32.encode", size, [&]() {
+            bench_sink += HarbourBase32::toBase32(data).size();
+        });
+        bench_throughput(aConfig, aResults, "base32.decode", size, [&]() {
+            bench_sink += HarbourBase32::fromBase32(text).size();
+        });
+    }
+}
+
+static
+void
+bench_base45(
+    const BenchConfig* aConfig,
+    QJsonArray* aResults)
+{
+    for (uint i = 0; i < G_N_ELEMENTS(bench_sizes); i++) {
+        const int size = bench_sizes[i];
+        const QByteArray data(bench_random_bytes(size));
+        const QString text(HarbourBase45::toBase45(data));
+
+        bench_throughput(aConfig, aResults, "base45.encode", size, [&]() {
+            bench_sink += HarbourBase45::toBase45(data).size();
+        });
+        bench_throughput(aConfig, aResults, "base45.decode", size, [&]() {
+            bench_sink += HarbourBase45::fromBase45(text).size();
+        });
+    }
+}
+
+static
+void
+bench_hex(
+    const BenchConfig* aConfig,
+    QJsonArray* aResults)
+{
+    for (uint i = 0; i < G_N_ELEMENTS(bench_sizes); i++) {
+        const int size = bench_sizes[i];
+        const QByteArray data(bench_random_bytes(size));
+        const QString text(HarbourUtil::toHex(data));
+
+        bench_throughput(aConfig, aResults, "hex.encode", size, [&]() {
+            bench_sink += HarbourUtil::toHex(data).size();
+        });
+        bench_throughput(aConfig, aResults, "hex.decode", size, [&]() {
+            bench_sink += HarbourUtil::fromHex(text).size();
+        });
+    }
+}
+
+static
+void
+bench_cbor(
+    const BenchConfig* aConfig,
+    QJsonArray* aResults)
+{
+    for (uint i = 0; i < G_N_ELEMENTS(bench_sizes); i++) {
+        // An array of small maps
+        const int size = bench_sizes[i];
+        QByteArray data;
+
+        data.append((char)0x9f);
+        while (data.size() < size - 1) {
+            data.append("\xa2\x61" "a\x19\x01\x02\x61" "b\x43xyz", 12);
+        }
+        data.append((char)0xff);
+
+        bench_throughput(aConfig, aResults, "cbor.skip", data.size(), [&]() {
+            GUtilRange range;
+
+            range.ptr = (const guint8*)data.constData();
+            range.end = range.ptr + data.size();
+            bench_sink += HarbourCbor::skipItem(&range);
+        });
+    }
+}
+
+static
+void
+bench_protobuf(
+    const BenchConfig* aConfig,
+    QJsonArray* aResults)
+{
+    for (uint i = 0; i < G_N_ELEMENTS(bench_sizes); i++) {
+        // Mostly small values, like deltas in sensor logs
+        const int count = bench_sizes[i];
+        quint64* values = new quint64[count];
+        QByteArray data;
+
+        for (int k = 0; k < count; k++) {
+            HarbourProtoBuf::appendVarInt(&data, rand() % ((k % 4) ?
+                128 : 16384));
+        }
+
+        if (bench_selected(aConfig, "protobuf.varint")) {
+            const double ns = bench_measure(aConfig, [&]() {
+                GUtilRange range;
+                quint64 value;
+
+                range.ptr = (const guint8*)data.constData();
+                range.end = range.ptr + data.size();
+                while (HarbourProtoBuf::parseVarInt(&range, &value)) {
+                    bench_sink += value;
+                }
+            });
+
+            bench_add(aResults, "protobuf.varint", count, UNIT_MOPS,
+                count * 1000.0 / ns);
+        }
+
+        if (bench_selected(aConfig, "protobuf.varints")) {
+            const double ns = bench_measure(aConfig, [&]() {
+                GUtilRange range;
+
+                range.ptr = (const guint8*)data.constData();
+                range.end = range.ptr + data.size();
+                bench_sink += HarbourProtoBuf::parseVarInts(&range, values,
+                    count);
+            });
+
+            bench_add(aResults, "protobuf.varints", count, UNIT_MOPS,
+                count * 1000.0 / ns);
+        }
+        delete [] values;
+    }
+}
+
+static
+void
+bench_qrcode(
+    const BenchConfig* aConfig,
+    QJsonArray* aResults)
+{
+    static const int lengths[] = { 16, 256, 1024 };
+
+    if (bench_selected(aConfig, "qrcode.generate")) {
+        for (uint i = 0; i < G_N_ELEMENTS(lengths); i++) {
+            QString text;
+
+            while (text.length() < lengths[i]) {
+                text.append(QChar::fromLatin1('a' + rand() % 26));
+            }
+
+            const double ns = bench_measure(aConfig, [&]() {
+                bench_sink += HarbourQrCodeGenerator::generate(text).size();
+            });
+
+            bench_add(aResults, "qrcode.generate", lengths[i], UNIT_USEC,
+                ns / 1000);
+        }
+    }
+}
+
+/*==========================================================================*
+ * Comparison
+ *==========================================================================*/
+
+static
+QJsonArray
+bench_load(
+    const char* aFile)
+{
+    QFile f(QString::fromLocal8Bit(aFile));
+
+    if (f.open(QIODevice::ReadOnly)) {
+        const QJsonObject root(QJsonDocument::fromJson(f.readAll()).object());
+
+        if (root.value("version").toInt() == BENCH_FORMAT_VERSION) {
+            return root.value("results").toArray();
+        }
+        fprintf(stderr, "%s: unsupported format\n", aFile);
+    } else {
+        fprintf(stderr, "Can't open %s\n", aFile);
+    }
+    return QJsonArray();
+}
+
+static
+QString
+bench_key(
+    const QJsonObject& aResult)
+{
+    return aResult.value("name").toString() + QChar::fromLatin1(':') +
+        QString::number(aResult.value("size").toInt());
+}
+
+// Returns the number of regressions, or -1 on error
+static
+int
+bench_compare(
+    const char* aOldFile,
+    const char* aNewFile,
+    double aThreshold)
+{
+    const QJsonArray oldResults(bench_load(aOldFile));
+    const QJsonArray newResults(bench_load(aNewFile));
+    int regressions = 0;
+
+    if (oldResults.isEmpty() || newResults.isEmpty()) {
+        return -1;
+    }
+
+    QHash<QString,QJsonObject> oldMap;
+
+    for (int i = 0; i < oldResults.size(); i++) {
+        const QJsonObject result(oldResults.at(i).toObject());
+
+        oldMap.insert(bench_key(result), result);
+    }
+
+    for (int i = 0; i < newResults.size(); i++) {
+        const QJsonObject result(newResults.at(i).toObject());
+        const QString key(bench_key(result));
+
+        if (oldMap.contains(key)) {
+            const QJsonObject old(oldMap.value(key));
+            const QString unit(result.value("unit").toString());
+            const double was = old.value("value").toDouble();
+            const double now = result.value("value").toDouble();
+
+            if (was > 0 && unit == old.value("unit").toString()) {
+                // Latency is the only thing where less is better
+                const bool lowerIsBetter = (unit == QLatin1String(UNIT_USEC));
+                const double change = (now - was) * 100 / was;
+                const double loss = lowerIsBetter ? change : -change;
+                const bool regression = (loss > aThreshold);
+
+                printf("%-32s %12.2f %12.2f %+8.1f%% %s%s\n",
+                    qPrintable(key), was, now, change, qPrintable(unit),
+                    regression ? "  REGRESSION" : "");
+                if (regression) {
+                    regressions++;
+                }
+            }
+        }
+    }
+    return regressions;
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+static
+void
+bench_usage(
+    const char* aExe)
+{
+    fprintf(stderr,
+        "Usage: %s [-t MS] [-f FILTER] [-o FILE]\n"
+        "       %s -c OLD NEW [-r PERCENT]\n\n"
+        "  -t MS       Time per measurement (default %d ms)\n"
+        "  -f FILTER   Only run benchmarks containing FILTER in the name\n"
+        "  -o FILE     Write the results to FILE (default stdout)\n"
+        "  -c OLD NEW  Compare two result files\n"
+        "  -r PERCENT  Regression threshold (default %.0f%%)\n",
+        aExe, aExe, BENCH_DEFAULT_TIME_MS, BENCH_DEFAULT_THRESHOLD);
+}
+
+int main(int argc, char* argv[])
+{
+    BenchConfig config;
+    const char* output = NULL;
+    const char* compareOld = NULL;
+    const char* compareNew = NULL;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+
+    config.timeMs = BENCH_DEFAULT_TIME_MS;
+    config.filter = NULL;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if (!strcmp(arg, "-t") && i + 1 < argc) {
+            config.timeMs = qMax(atoi(argv[++i]), 1);
+        } else if (!strcmp(arg, "-f") && i + 1 < argc) {
+            config.filter = argv[++i];
+        } else if (!strcmp(arg, "-o") && i + 1 < argc) {
+            output = argv[++i];
+        } else if (!strcmp(arg, "-c") && i + 2 < argc) {
+            compareOld = argv[++i];
+            compareNew = argv[++i];
+        } else if (!strcmp(arg, "-r") && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else {
+            bench_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (compareOld) {
+        const int regressions = bench_compare(compareOld, compareNew,
+            threshold);
+
+        if (regressions < 0) {
+            return 2;
+        } else if (regressions > 0) {
+            printf("%d regression(s) over %.1f%%\n", regressions, threshold);
+            return 1;
+        }
+        return 0;
+    }
+
+    QJsonArray results;
+    QJsonObject root;
+
+    srand(1);
+    bench_base32(&config, &results);
+    bench_base45(&config, &results);
+    bench_hex(&config, &results);
+    bench_cbor(&config, &results);
+    bench_protobuf(&config, &results);
+    bench_qrcode(&config, &results);
+
+    root.insert("version", BENCH_FORMAT_VERSION);
+    root.insert("results", results);
+
+    const QByteArray json(QJsonDocument(root).toJson());
+
+    if (output) {
+        QFile f(QString::fromLocal8Bit(output));
+
+        if (!f.open(QIODevice::WriteOnly) || f.write(json) != json.size()) {
+            fprintf(stderr, "Failed to write %s\n", output);
+            return 2;
+        }
+    } else {
+        fwrite(json.constData(), 1, json.size(), stdout);
+    }
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourAsyncValue.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+
+#include <glib.h>
+
+typedef HarbourAsyncValue<int,int> TestValue;
+
+static QAtomicInt test_calls;
+static QSemaphore test_gate;
+
+// Negative input blocks until the gate is opened
+static
+int
+test_double(
+    const int& aInput)
+{
+    test_calls.ref();
+    if (aInput < 0) {
+        test_gate.acquire();
+    }
+    return aInput * 2;
+}
+
+/*==========================================================================*
+ * TestReceiver
+ *==========================================================================*/
+
+class TestReceiver :
+    public QObject
+{
+    Q_OBJECT
+
+public:
+    TestReceiver(TestValue* aValue) :
+        iValue(aValue),
+        iResultChanged(0),
+        iRunningChanged(0),
+        iDelayChanged(0)
+    {
+        connect(aValue, SIGNAL(resultChanged()), SLOT(onResultChanged()));
+        connect(aValue, SIGNAL(runningChanged()), SLOT(onRunningChanged()));
+        connect(aValue, SIGNAL(delayChanged()), SLOT(onDelayChanged()));
+    }
+
+    void
+    wait()
+    {
+        if (iValue->running()) {
+            iLoop.exec();
+        }
+        g_assert(!iValue->running());
+    }
+
+public Q_SLOTS:
+    void
+    onResultChanged()
+    {
+        iResultChanged++;
+    }
+
+    void
+    onRunningChanged()
+    {
+        iRunningChanged++;
+        if (!iValue->running()) {
+            iLoop.quit();
+        }
+    }
+
+    void
+    onDelayChanged()
+    {
+        iDelayChanged++;
+    }
+
+public:
+    TestValue* iValue;
+    QEventLoop iLoop;
+    int iResultChanged;
+    int iRunningChanged;
+    int iDelayChanged;
+};
+
+/*==========================================================================*
+ * basic
+ *==========================================================================*/
+
+static
+void
+test_basic(
+    void)
+{
+    QThreadPool pool;
+    TestValue value(test_double, Q_NULLPTR, &pool);
+    TestReceiver receiver(&value);
+
+    g_assert(value.threadPool() == &pool);
+    g_assert(!value.running());
+    g_assert_cmpint(value.result(), == ,0);
+
+    value.setInput(2);
+    g_assert(value.running());
+    g_assert_cmpint(receiver.iRunningChanged, == ,1);
+    receiver.wait();
+    g_assert_cmpint(receiver.iRunningChanged, == ,2);
+    g_assert_cmpint(receiver.iResultChanged, == ,1);
+    g_assert_cmpint(value.input(), == ,2);
+    g_assert_cmpint(value.result(), == ,4);
+
+    // Same result, no resultChanged
+    value.setInput(2);
+    receiver.wait();
+    g_assert_cmpint(receiver.iRunningChanged, == ,4);
+    g_assert_cmpint(receiver.iResultChanged, == ,1);
+}
+
+/*==========================================================================*
+ * supersede
+ *==========================================================================*/
+
+static
+void
+test_supersede(
+    void)
+{
+    QThreadPool pool;
+    TestValue value(test_double, Q_NULLPTR, &pool);
+    TestReceiver receiver(&value);
+
+    // The first computation gets stuck, the second one overtakes it
+    pool.setMaxThreadCount(2);
+    value.setInput(-1);
+    value.setInput(3);
+    receiver.wait();
+    g_assert_cmpint(receiver.iResultChanged, == ,1);
+    g_assert_cmpint(receiver.iRunningChanged, == ,2);
+    g_assert_cmpint(value.result(), == ,6);
+
+    // The abandoned one finishes too late to matter
+    test_gate.release();
+    pool.waitForDone();
+    QCoreApplication::processEvents();
+    g_assert_cmpint(receiver.iResultChanged, == ,1);
+    g_assert_cmpint(receiver.iRunningChanged, == ,2);
+    g_assert_cmpint(value.result(), == ,6);
+    g_assert(!value.running());
+}
+
+/*==========================================================================*
+ * stale
+ *==========================================================================*/
+
+static
+void
+test_stale(
+    void)
+{
+    QThreadPool pool;
+    TestValue value(test_double, Q_NULLPTR, &pool);
+    TestReceiver receiver(&value);
+
+    // The first result is ready but not delivered when the input
+    // changes, it must not flash through
+    value.setInput(1);
+    pool.waitForDone();
+    value.setInput(5);
+    receiver.wait();
+    g_assert_cmpint(receiver.iResultChanged, == ,1);
+    g_assert_cmpint(value.result(), == ,10);
+
+    // Destroying the value with a task in flight is fine too
+    TestValue* value2 = new TestValue(test_double, Q_NULLPTR, &pool);
+
+    value2->setInput(-1);
+    delete value2;
+    test_gate.release();
+    pool.waitForDone();
+    QCoreApplication::processEvents();
+}
+
+/*==========================================================================*
+ * debounce
+ *==========================================================================*/
+
+static
+void
+test_debounce(
+    void)
+{
+    QThreadPool pool;
+    TestValue value(test_double, Q_NULLPTR, &pool);
+    TestReceiver receiver(&value);
+
+    value.setDelay(-1);
+    g_assert_cmpint(value.delay(), == ,0);
+    g_assert_cmpint(receiver.iDelayChanged, == ,0);
+    value.setDelay(50);
+    value.setDelay(50);
+    g_assert_cmpint(value.delay(), == ,50);
+    g_assert_cmpint(receiver.iDelayChanged, == ,1);
+
+    // Only the last one gets computed
+    test_calls = 0;
+    value.setInput(1);
+    value.setInput(2);
+    value.setInput(3);
+    g_assert(value.running());
+    g_assert_cmpint(receiver.iRunningChanged, == ,1);
+    receiver.wait();
+    g_assert_cmpint(test_calls.loadAcquire(), == ,1);
+    g_assert_cmpint(receiver.iRunningChanged, == ,2);
+    g_assert_cmpint(receiver.iResultChanged, == ,1);
+    g_assert_cmpint(value.result(), == ,6);
+}
+
+/*==========================================================================*
+ * sharedPool
+ *==========================================================================*/
+
+static
+void
+test_sharedPool(
+    void)
+{
+    QThreadPool* pool = HarbourAsyncValueBase::sharedThreadPool();
+    TestValue value1(test_double);
+    TestValue value2(test_double);
+    TestReceiver receiver1(&value1);
+    TestReceiver receiver2(&value2);
+
+    g_assert(pool);
+    g_assert(pool->parent() == qApp);
+    g_assert(HarbourAsyncValueBase::sharedThreadPool() == pool);
+    g_assert(value1.threadPool() == pool);
+    g_assert(value2.threadPool() == pool);
+
+    value1.setInput(7);
+    value2.setInput(8);
+    receiver1.wait();
+    receiver2.wait();
+    g_assert_cmpint(value1.result(), == ,14);
+    g_assert_cmpint(value2.result(), == ,16);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_(name) "/HarbourAsyncValue/" name
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("supersede"), test_supersede);
+    g_test_add_func(TEST_("stale"), test_stale);
+    g_test_add_func(TEST_("debounce"), test_debounce);
+    g_test_add_func(TEST_("sharedPool"), test_sharedPool);
+    return g_test_run();
+}
+
+#include "TestHarbourAsyncValue.moc"
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
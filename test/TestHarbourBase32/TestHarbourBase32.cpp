@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2021-2025 Slava Monich <slava@monich.com>
+ * Copyright (C) 2021-2026 Slava Monich <slava@monich.com>
  * Copyright (C) 2021 Jolla Ltd.
  *
  * You may use this file under the terms of the BSD license as follows:
@@ -40,7 +40,10 @@
 #include "HarbourBase32.h"
 #include "HarbourDebug.h"
 
+#include <QtCore/QBuffer>
+
 #include <glib.h>
+#include <string.h>
 
 /*==========================================================================*
  * isValidBase45
@@ -145,6 +148,178 @@ test_fromBase32(
     g_assert(HarbourBase32::fromBase32("[]").isEmpty());
 }
 
+/*==========================================================================*
+ * latin1
+ *==========================================================================*/
+
+static
+void
+test_latin1(
+    void)
+{
+    static const char* valid[] = {
+        "AEBAGBAFAYDQQCIKBMGA2DQPCAIREEYUCULBOGI2DMOB2HQ7",
+        "aebagbaf aydqqcik bmga2dqp caireeyu culbogi2 dmob2hq7",
+        "ae======", "aeba====", "aebag===", "aebagba=", "ae= =====",
+        "aeba", "aebagbafay"
+    };
+    static const char* invalid[] = {
+        "", " ", "af", "ae=====", "aebagbaf========", "aebagb= x",
+        "01234567", "{}", "[]", "=", "ae\xe9", "ae\xc3\xa9"
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(valid); i++) {
+        const char* in = valid[i];
+        const QByteArray bytes(in);
+        const QByteArray out(HarbourBase32::fromBase32(QString(in)));
+
+        g_assert(!out.isEmpty());
+        g_assert(HarbourBase32::isValidBase32(in));
+        g_assert(HarbourBase32::isValidBase32(bytes));
+        g_assert(HarbourBase32::isValidBase32(in, (int)strlen(in)));
+        g_assert(HarbourBase32::fromBase32(in) == out);
+        g_assert(HarbourBase32::fromBase32(bytes) == out);
+        g_assert(HarbourBase32::fromBase32(in, (int)strlen(in)) == out);
+    }
+
+    for (guint i = 0; i < G_N_ELEMENTS(invalid); i++) {
+        const char* in = invalid[i];
+        const QByteArray bytes(in);
+
+        g_assert(!HarbourBase32::isValidBase32(QString(in)));
+        g_assert(!HarbourBase32::isValidBase32(in));
+        g_assert(!HarbourBase32::isValidBase32(bytes));
+        g_assert(!HarbourBase32::isValidBase32(in, (int)strlen(in)));
+        g_assert(HarbourBase32::fromBase32(in).isEmpty());
+        g_assert(HarbourBase32::fromBase32(bytes).isEmpty());
+    }
+
+    // Explicit length
+    g_assert(HarbourBase32::fromBase32("aeba====xyz", 8) ==
+        HarbourBase32::fromBase32("aeba"));
+    g_assert(!HarbourBase32::isValidBase32("aeba", 4, true));
+    g_assert(HarbourBase32::isValidBase32((const char*)NULL, 0) ==
+        HarbourBase32::isValidBase32(QString()));
+    g_assert(HarbourBase32::fromBase32((const char*)NULL).isEmpty());
+}
+
+/*==========================================================================*
+ * alphabets
+ *==========================================================================*/
+
+static
+void
+test_alphabets(
+    void)
+{
+    static const struct {
+        HarbourBase32::Alphabet alphabet;
+        const char* in;
+        const char* out;
+    } tests[] = {
+        // RFC 4648 section 10
+        { HarbourBase32::AlphabetBase32Hex, "", "" },
+        { HarbourBase32::AlphabetBase32Hex, "f", "CO======" },
+        { HarbourBase32::AlphabetBase32Hex, "fo", "CPNG====" },
+        { HarbourBase32::AlphabetBase32Hex, "foo", "CPNMU===" },
+        { HarbourBase32::AlphabetBase32Hex, "foob", "CPNMUOG=" },
+        { HarbourBase32::AlphabetBase32Hex, "fooba", "CPNMUOJ1" },
+        { HarbourBase32::AlphabetBase32Hex, "foobar", "CPNMUOJ1E8======" },
+        { HarbourBase32::AlphabetCrockford, "f", "CR" },
+        { HarbourBase32::AlphabetCrockford, "foo", "CSQPY" },
+        { HarbourBase32::AlphabetCrockford, "foobar", "CSQPYRK1E8" },
+        { HarbourBase32::AlphabetCrockford, "\x01\x11\x22", "048J4" },
+        { HarbourBase32::AlphabetZBase32, "\xf0\xbf\xc7", "6n9hq" },
+        { HarbourBase32::AlphabetZBase32, "\xd4\x7a\x04", "4t7ye" },
+        { HarbourBase32::AlphabetZBase32, "foobar", "c3zs6aubqe" },
+        { HarbourBase32::AlphabetRfc4648, "foobar", "MZXW6YTBOI======" }
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(tests); i++) {
+        const HarbourBase32::Alphabet alphabet = tests[i].alphabet;
+        const QByteArray in(tests[i].in);
+        const QString out(tests[i].out);
+
+        g_assert(HarbourBase32::toBase32(alphabet, in) == out);
+        g_assert(HarbourBase32::toBase32(alphabet, in,
+            HarbourBase32::EncodeLowerCase) == out.toLower());
+        g_assert(HarbourBase32::fromBase32(alphabet, out) == in);
+        g_assert(HarbourBase32::fromBase32(alphabet, out.toLower()) == in);
+        g_assert(HarbourBase32::fromBase32(alphabet, out.toUpper()) == in);
+        g_assert(HarbourBase32::fromBase32(alphabet, tests[i].out) == in);
+        g_assert(HarbourBase32::isValidBase32(alphabet, out) == !in.isEmpty());
+    }
+
+    // Padding (if the alphabet has one) can be omitted
+    const QByteArray foobar("foobar");
+    g_assert(HarbourBase32::toBase32(HarbourBase32::AlphabetBase32Hex, foobar,
+        HarbourBase32::EncodeNoPadding) == QString("CPNMUOJ1E8"));
+    g_assert(HarbourBase32::fromBase32(HarbourBase32::AlphabetBase32Hex,
+        "CPNMUOJ1E8") == foobar);
+    g_assert(HarbourBase32::fromBase32(HarbourBase32::AlphabetBase32Hex,
+        "CPNMUOJ1E8", true).isEmpty());
+    g_assert(HarbourBase32::fromBase32(HarbourBase32::AlphabetCrockford,
+        "CSQPYRK1E8", true) == foobar);
+
+    // But padding isn't allowed where there's no padding
+    g_assert(!HarbourBase32::isValidBase32(HarbourBase32::AlphabetCrockford,
+        "CR======"));
+    g_assert(!HarbourBase32::isValidBase32(HarbourBase32::AlphabetZBase32,
+        "ca======"));
+
+    // Digits from a wrong alphabet
+    g_assert(!HarbourBase32::isValidBase32(HarbourBase32::AlphabetBase32Hex,
+        "MZXW6YTBOI======"));
+    g_assert(!HarbourBase32::isValidBase32(HarbourBase32::AlphabetRfc4648,
+        "CPNMUOJ1E8======"));
+    g_assert(!HarbourBase32::isValidBase32(HarbourBase32::AlphabetCrockford,
+        "CSQPYRKUE8"));
+    g_assert(!HarbourBase32::isValidBase32(HarbourBase32::AlphabetZBase32,
+        "c3zs6aubq2"));
+
+    // Crockford aliases and hyphens
+    g_assert(HarbourBase32::fromBase32(HarbourBase32::AlphabetCrockford,
+        "csqp-yrki-e8") == foobar);
+    g_assert(HarbourBase32::fromBase32(HarbourBase32::AlphabetCrockford,
+        "CSQP-YRKL-E8") == foobar);
+    g_assert(HarbourBase32::fromBase32(HarbourBase32::AlphabetCrockford,
+        "OOl24") == QByteArray("\x00\x02\x22", 3));
+    g_assert(HarbourBase32::fromBase32(HarbourBase32::AlphabetCrockford,
+        QString("oo8j4")) == QByteArray("\x00\x11\x22", 3));
+    g_assert(HarbourBase32::fromBase32(HarbourBase32::AlphabetRfc4648,
+        "MZXW-6YTB-OI").isEmpty());
+
+    // Error reporting works the same way for all alphabets
+    char buf[8];
+    int size = -2, pos = -2;
+    g_assert_cmpint(HarbourBase32::decode(HarbourBase32::AlphabetCrockford,
+        "CSQPYRKUE8", 10, buf, sizeof(buf), &size, &pos), == ,
+        HarbourBase32::DecodeInvalidChar);
+    g_assert_cmpint(pos, == ,7);
+    g_assert_cmpint(size, == ,0);
+    g_assert_cmpint(HarbourBase32::decode(HarbourBase32::AlphabetZBase32,
+        QString("c3zs6aubqe"), buf, sizeof(buf), &size, &pos), == ,
+        HarbourBase32::DecodeOk);
+    g_assert_cmpint(pos, == ,-1);
+    g_assert_cmpint(size, == ,6);
+    g_assert(!memcmp(buf, "foobar", 6));
+
+    // Long random round trips (with and without vector code)
+    QByteArray data;
+    for (int n = 0; n < 100; n++) {
+        for (int k = 0; k < 4; k++) {
+            const HarbourBase32::Alphabet alphabet =
+                (HarbourBase32::Alphabet)k;
+            const QString str(HarbourBase32::toBase32(alphabet, data));
+
+            g_assert(HarbourBase32::fromBase32(alphabet, str) == data);
+            g_assert(HarbourBase32::fromBase32(alphabet,
+                str.toLatin1()) == data);
+        }
+        data.append((char)g_random_int());
+    }
+}
+
 /*==========================================================================*
  * base32pad
  *==========================================================================*/
@@ -223,6 +398,425 @@ test_rfc4648(
     }
 }
 
+/*==========================================================================*
+ * large
+ *==========================================================================*/
+
+static
+QString
+test_reference_base32(
+    const QByteArray aData,
+    bool aLowerCase,
+    bool aPad)
+{
+    // Straightforward bit-by-bit encoder
+    static const char upper[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    static const char lower[] = "abcdefghijklmnopqrstuvwxyz234567";
+    const char* alphabet = aLowerCase ? lower : upper;
+    const int bits = aData.size() * 8;
+    QString str;
+
+    for (int i = 0; i < bits; i += 5) {
+        int nibble = 0;
+
+        for (int k = i; k < i + 5; k++) {
+            nibble <<= 1;
+            if (k < bits && (aData.at(k / 8) & (0x80 >> (k % 8)))) {
+                nibble |= 1;
+            }
+        }
+        str.append(QChar::fromLatin1(alphabet[nibble]));
+    }
+    while (aPad && (str.length() % 8)) {
+        str.append(QChar::fromLatin1('='));
+    }
+    return str;
+}
+
+static
+void
+test_large(
+    void)
+{
+    QByteArray data;
+
+    // Long enough to go through the vector code (if there is any)
+    for (int n = 0; n < 300; n++) {
+        const QString upper(test_reference_base32(data, false, true));
+        const QString lower(test_reference_base32(data, true, true));
+        const QString nopad(test_reference_base32(data, false, false));
+
+        g_assert(HarbourBase32::toBase32(data) == upper);
+        g_assert(HarbourBase32::toBase32(data, true) == lower);
+        g_assert(HarbourBase32::toBase32(data, HarbourBase32::EncodeOptions
+            (HarbourBase32::EncodeNoPadding)) == nopad);
+        g_assert(HarbourBase32::fromBase32(upper) == data);
+        g_assert(HarbourBase32::fromBase32(lower) == data);
+        g_assert(HarbourBase32::fromBase32(nopad) == data);
+
+        if (n > 0) {
+            QString spaced;
+
+            // Spaces in random places
+            for (int i = 0; i < lower.length(); i++) {
+                if (!(g_random_int() % 13)) {
+                    spaced.append(QChar::fromLatin1(' '));
+                }
+                spaced.append(lower.at(i));
+            }
+            g_assert(HarbourBase32::fromBase32(spaced) == data);
+
+            // Invalid characters in random places
+            const int pos = g_random_int() % nopad.length();
+            QString bad(nopad);
+
+            bad[pos] = QChar::fromLatin1('1');
+            g_assert(HarbourBase32::fromBase32(bad).isEmpty());
+            bad[pos] = QChar(0x141); // Would be 'A' if truncated to 8 bits
+            g_assert(HarbourBase32::fromBase32(bad).isEmpty());
+            bad[pos] = QChar(0xff41);
+            g_assert(HarbourBase32::fromBase32(bad).isEmpty());
+        }
+
+        data.append((char)g_random_int());
+    }
+}
+
+/*==========================================================================*
+ * encoder
+ *==========================================================================*/
+
+static
+void
+test_encoder(
+    void)
+{
+    QByteArray data;
+
+    for (int n = 0; n < 300; n++) {
+        const QByteArray expected(HarbourBase32::toBase32(data).toLatin1());
+        const QByteArray nopad(HarbourBase32::toBase32(data,
+            HarbourBase32::EncodeOptions(HarbourBase32::EncodeLowerCase |
+            HarbourBase32::EncodeNoPadding)).toLatin1());
+        HarbourBase32::Encoder encoder;
+        HarbourBase32::Encoder nopadEncoder(HarbourBase32::EncodeLowerCase |
+            HarbourBase32::EncodeNoPadding);
+        QByteArray out, out2;
+        int i = 0;
+
+        // Random chunks
+        while (i < n) {
+            const int chunk = qMin(n - i, (int)(g_random_int() % 50));
+
+            encoder.encode(data.constData() + i, chunk, &out);
+            nopadEncoder.encode(data.constData() + i, chunk, &out2);
+            i += chunk;
+        }
+        encoder.finish(&out);
+        nopadEncoder.finish(&out2);
+        g_assert(out == expected);
+        g_assert(out2 == nopad);
+
+        // The encoder is reusable after finish()
+        out = encoder.encode(data);
+        out.append(encoder.finish());
+        g_assert(out == expected);
+
+        // And after reset()
+        encoder.encode(data.constData(), n, &out);
+        encoder.reset();
+        out = encoder.encode(data);
+        encoder.finish(&out);
+        g_assert(out == expected);
+
+        // QIODevice adapter
+        QBuffer in, buf;
+
+        in.setData(data);
+        in.open(QIODevice::ReadOnly);
+        buf.open(QIODevice::WriteOnly);
+        g_assert(encoder.encode(&in, &buf));
+        g_assert(buf.data() == expected);
+
+        data.append((char)g_random_int());
+    }
+}
+
+/*==========================================================================*
+ * decoder
+ *==========================================================================*/
+
+static
+void
+test_decoder(
+    void)
+{
+    QByteArray data;
+    HarbourBase32::Decoder decoder;
+    HarbourBase32::Decoder strictDecoder(true);
+    QByteArray out;
+
+    for (int n = 0; n < 300; n++) {
+        QString base32(HarbourBase32::toBase32(data, true));
+        int i = 0;
+
+        // Spaces in random places
+        for (int k = base32.length(); k > 0; k--) {
+            if (!(g_random_int() % 7)) {
+                base32 = base32.left(k) + QString(" ") + base32.mid(k);
+            }
+        }
+
+        const QByteArray chars(base32.toLatin1());
+
+        // Random chunks (as bytes and as string)
+        out.clear();
+        while (i < chars.size()) {
+            const int chunk = qMin(chars.size() - i,
+                (int)(g_random_int() % 50));
+
+            if (i % 2) {
+                g_assert(decoder.decode(chars.constData() + i, chunk, &out));
+            } else {
+                g_assert(decoder.decode(base32.mid(i, chunk), &out));
+            }
+            i += chunk;
+        }
+        g_assert(decoder.finish(&out));
+        g_assert(out == data);
+
+        // Padding may be required
+        out.clear();
+        g_assert(strictDecoder.decode(chars, &out));
+        g_assert(strictDecoder.finish(&out));
+        g_assert(out == data);
+
+        // QIODevice adapter
+        QBuffer in, buf;
+
+        in.setData(chars);
+        in.open(QIODevice::ReadOnly);
+        buf.open(QIODevice::WriteOnly);
+        g_assert(decoder.decode(&in, &buf));
+        g_assert(buf.data() == data);
+
+        data.append((char)g_random_int());
+    }
+
+    // Errors are sticky until reset() or finish()
+    out.clear();
+    g_assert(!decoder.decode(QString("aeb."), &out));
+    g_assert(!decoder.decode(QString("aebagbaf"), &out));
+    g_assert(!decoder.finish(&out));
+    g_assert(out.isEmpty());
+    g_assert(decoder.decode(QString("aebag"), &out));
+    decoder.reset();
+    g_assert(decoder.decode(QString("aeba"), &out));
+    g_assert(decoder.decode(QString("===="), &out));
+    g_assert(decoder.finish(&out));
+    g_assert(out == QByteArray("\x01\x02", 2));
+
+    // Various kinds of invalid input
+    static const char* invalid[] = {
+        "aeb", "af", "ae=====", "ae=======", "ae======a", "aebagb= x",
+        "aebagbaf========", "=", "01234567"
+    };
+
+    for (guint k = 0; k < G_N_ELEMENTS(invalid); k++) {
+        const char* bad = invalid[k];
+
+        out.clear();
+        decoder.reset();
+        g_assert(!(decoder.decode(bad, strlen(bad), &out) &&
+            decoder.finish(&out)));
+    }
+
+    out.clear();
+    g_assert(strictDecoder.decode(QString("aebagba"), &out));
+    g_assert(!strictDecoder.finish(&out));
+}
+
+/*==========================================================================*
+ * sequential
+ *==========================================================================*/
+
+// Behaves like a socket, the data arrive in bursts and read() returns
+// zero (with atEnd() returning true) until the next burst arrives
+class TestBursts :
+    public QIODevice
+{
+public:
+    TestBursts(const QByteArray aData, int aBurst) :
+        iData(aData), iBurst(aBurst), iPos(0), iAvailable(0), iWaits(0)
+        { open(QIODevice::ReadOnly); }
+
+    bool isSequential() const Q_DECL_OVERRIDE
+        { return true; }
+
+    bool
+    waitForReadyRead(
+        int) Q_DECL_OVERRIDE
+    {
+        if (iPos + iAvailable < iData.size()) {
+            iAvailable = qMin(iBurst, iData.size() - iPos);
+            iWaits++;
+            return true;
+        }
+        return false;
+    }
+
+protected:
+    qint64
+    readData(
+        char* aData,
+        qint64 aMaxSize) Q_DECL_OVERRIDE
+    {
+        const int n = (int)qMin(aMaxSize, (qint64)iAvailable);
+
+        memcpy(aData, iData.constData() + iPos, n);
+        iPos += n;
+        iAvailable -= n;
+        return n;
+    }
+
+    qint64
+    writeData(
+        const char*,
+        qint64) Q_DECL_OVERRIDE
+        { return -1; }
+
+public:
+    const QByteArray iData;
+    const int iBurst;
+    int iPos;
+    int iAvailable;
+    int iWaits;
+};
+
+static
+void
+test_sequential(
+    void)
+{
+    QByteArray data;
+
+    for (int i = 0; i < 1000; i++) {
+        data.append((char)g_random_int());
+    }
+
+    const QByteArray base32(HarbourBase32::toBase32(data).toLatin1());
+    static const int bursts[] = { 1, 7, 100, 1000 };
+
+    for (guint k = 0; k < G_N_ELEMENTS(bursts); k++) {
+        const int burst = bursts[k];
+        TestBursts in(data, burst);
+        TestBursts in2(base32, burst);
+        HarbourBase32::Encoder encoder;
+        HarbourBase32::Decoder decoder(true);
+        QBuffer out, out2;
+
+        out.open(QIODevice::WriteOnly);
+        g_assert(encoder.encode(&in, &out));
+        g_assert(out.data() == base32);
+        g_assert_cmpint(in.iWaits, == ,(data.size() + burst - 1) / burst);
+
+        out2.open(QIODevice::WriteOnly);
+        g_assert(decoder.decode(&in2, &out2));
+        g_assert(out2.data() == data);
+        g_assert_cmpint(in2.iWaits, == ,(base32.size() + burst - 1) / burst);
+    }
+}
+
+/*==========================================================================*
+ * decode
+ *==========================================================================*/
+
+static
+void
+test_decode(
+    void)
+{
+    static const struct {
+        const char* in;
+        bool requirePadding;
+        HarbourBase32::DecodeStatus status;
+        int pos;
+        int size;
+    } tests[] = {
+        { "MZXW6YTBOI======", false, HarbourBase32::DecodeOk, -1, 6 },
+        { " mzxw 6ytb oi== ====", true, HarbourBase32::DecodeOk, -1, 6 },
+        { "MZXW6YTBOI", false, HarbourBase32::DecodeOk, -1, 6 },
+        { "", false, HarbourBase32::DecodeEmpty, -1, 0 },
+        { "  ", false, HarbourBase32::DecodeEmpty, -1, 0 },
+        { "MZXW6YTBOI", true, HarbourBase32::DecodeMissingPadding, 10, 0 },
+        { "MZXW6Y1BOI", false, HarbourBase32::DecodeInvalidChar, 6, 0 },
+        { "MZXW6YTBO", false, HarbourBase32::DecodeInvalidLength, 8, 0 },
+        { "MZXW6YTBOJ", false, HarbourBase32::DecodeNonZeroBits, 9, 0 },
+        { "MZXW6YTBOI =====", false, HarbourBase32::DecodeInvalidPadding, 11, 0 },
+        { "MZXW6YTBOI=======", false, HarbourBase32::DecodeInvalidPadding, 16, 0 },
+        { "MZXW6YTBOI==x", false, HarbourBase32::DecodeInvalidPadding, 12, 0 },
+        { "MZXW6YTB=", false, HarbourBase32::DecodeInvalidPadding, 8, 0 },
+        { "=", false, HarbourBase32::DecodeInvalidPadding, 0, 0 }
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(tests); i++) {
+        const QString in(tests[i].in);
+        char buf[16];
+        int size = -2, pos = -2;
+
+        g_assert_cmpint(HarbourBase32::decode(in, buf, sizeof(buf), &size,
+            &pos, tests[i].requirePadding), == ,tests[i].status);
+        g_assert_cmpint(pos, == ,tests[i].pos);
+        g_assert_cmpint(size, == ,tests[i].size);
+        if (tests[i].status == HarbourBase32::DecodeOk) {
+            g_assert(!memcmp(buf, "foobar", size));
+        }
+
+        // 8-bit input must produce exactly the same results
+        size = pos = -2;
+        g_assert_cmpint(HarbourBase32::decode(tests[i].in,
+            (int)strlen(tests[i].in), buf, sizeof(buf), &size, &pos,
+            tests[i].requirePadding), == ,tests[i].status);
+        g_assert_cmpint(pos, == ,tests[i].pos);
+        g_assert_cmpint(size, == ,tests[i].size);
+        size = pos = -2;
+        g_assert_cmpint(HarbourBase32::decode(QByteArray(tests[i].in),
+            buf, sizeof(buf), &size, &pos, tests[i].requirePadding),
+            == ,tests[i].status);
+        g_assert_cmpint(pos, == ,tests[i].pos);
+        g_assert_cmpint(size, == ,tests[i].size);
+    }
+
+    // Output buffer is too small
+    QByteArray data;
+    char buf[128];
+    int size, pos;
+
+    data.resize(sizeof(buf));
+    for (int i = 0; i < data.size(); i++) {
+        data[i] = (char)g_random_int();
+    }
+    for (int n = 0; n <= data.size(); n++) {
+        const QByteArray bytes(data.left(n));
+        const QString base32(HarbourBase32::toBase32(bytes));
+
+        g_assert_cmpint(HarbourBase32::maxDecodedSize(base32.length()),
+            >= ,n);
+        g_assert_cmpint(HarbourBase32::decode(base32, buf, n, &size),
+            == ,n ? HarbourBase32::DecodeOk : HarbourBase32::DecodeEmpty);
+        g_assert_cmpint(size, == ,n);
+        g_assert(!memcmp(buf, bytes.constData(), n));
+        if (n) {
+            g_assert_cmpint(HarbourBase32::decode(base32, buf, n - 1, &size,
+                &pos), == ,HarbourBase32::DecodeBufferTooSmall);
+            g_assert_cmpint(size, == ,0);
+            g_assert_cmpint(pos, >= ,0);
+        }
+    }
+    g_assert_cmpint(HarbourBase32::maxDecodedSize(0), == ,0);
+    g_assert_cmpint(HarbourBase32::maxDecodedSize(-1), == ,0);
+}
+
 /*==========================================================================*
  * Common
  *==========================================================================*/
@@ -234,9 +828,16 @@ int main(int argc, char* argv[])
     g_test_init(&argc, &argv, NULL);
     g_test_add_func(TEST_("isValidBase32"), test_isValidBase32);
     g_test_add_func(TEST_("fromBase32"), test_fromBase32);
+    g_test_add_func(TEST_("latin1"), test_latin1);
+    g_test_add_func(TEST_("alphabets"), test_alphabets);
     g_test_add_func(TEST_("base32pad"), test_base32pad);
     g_test_add_func(TEST_("rfc4648"), test_rfc4648);
     g_test_add_func(TEST_("toBase32"), test_toBase32);
+    g_test_add_func(TEST_("decode"), test_decode);
+    g_test_add_func(TEST_("large"), test_large);
+    g_test_add_func(TEST_("encoder"), test_encoder);
+    g_test_add_func(TEST_("decoder"), test_decoder);
+    g_test_add_func(TEST_("sequential"), test_sequential);
     return g_test_run();
 }
 
@@ -1,6 +1,6 @@
 /*
  * Copyright (C) 2021 Jolla Ltd.
- * Copyright (C) 2021 Slava Monich <slava.monich@jolla.com>
+ * Copyright (C) 2021-2026 Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -35,6 +35,7 @@
 #include "HarbourDebug.h"
 
 #include <glib.h>
+#include <string.h>
 
 /*==========================================================================*
  * isValidBase45
@@ -58,6 +59,15 @@ test_isValidBase45(
     g_assert(!HarbourBase45::isValidBase45("A"));
     g_assert(!HarbourBase45::isValidBase45("ZZ"));
     g_assert(!HarbourBase45::isValidBase45("ZZZ"));
+
+    // UTF-16 and explicit length variants
+    g_assert(HarbourBase45::isValidBase45(QString()));
+    g_assert(HarbourBase45::isValidBase45(QString("%69 VD92EX0")));
+    g_assert(!HarbourBase45::isValidBase45(QString("A(A")));
+    g_assert(!HarbourBase45::isValidBase45(QString("ZZZ")));
+    g_assert(HarbourBase45::isValidBase45((const char*)NULL));
+    g_assert(HarbourBase45::isValidBase45("BB8(", 3));
+    g_assert(!HarbourBase45::isValidBase45("BB8(", 4));
 }
 
 /*==========================================================================*
@@ -103,6 +113,185 @@ test_fromBase45(
     g_assert(HarbourBase45::fromBase45(QByteArray("BB8")) == QByteArray("AB"));
     g_assert(HarbourBase45::fromBase45(QByteArray("%69 VD92EX0")) == QByteArray("Hello!!"));
     g_assert(HarbourBase45::fromBase45(QByteArray("UJCLQE7W581")) == QByteArray("base-45"));
+
+    // UTF-16 and plain C string variants
+    g_assert(HarbourBase45::fromBase45(QString("ZZZ")).isEmpty());
+    g_assert(HarbourBase45::fromBase45(QString("%69 VD92EX0")) == QByteArray("Hello!!"));
+    g_assert(HarbourBase45::fromBase45("UJCLQE7W581") == QByteArray("base-45"));
+    g_assert(HarbourBase45::fromBase45("BB8BB8", 3) == QByteArray("AB"));
+    g_assert(HarbourBase45::fromBase45((const char*)NULL).isEmpty());
+}
+
+/*==========================================================================*
+ * decode
+ *==========================================================================*/
+
+static
+void
+test_decode(
+    void)
+{
+    static const struct {
+        const char* in;
+        int result;
+        int pos;
+    } tests[] = {
+        { "", 0, -1 },
+        { "BB8", 2, -1 },
+        { "%69 VD92EX0", 7, -1 },
+        { "A", -1, 0 },
+        { "BB8A", -1, 3 },
+        { "ZZ", -1, 0 },
+        { "BB8ZZZ", -1, 3 },
+        { "BB8A(A", -1, 3 },
+        { "BB8A[", -1, 3 }
+    };
+    char buf[16];
+
+    g_assert_cmpint(HarbourBase45::decodedSize(0), == ,0);
+    g_assert_cmpint(HarbourBase45::decodedSize(1), == ,-1);
+    g_assert_cmpint(HarbourBase45::decodedSize(2), == ,1);
+    g_assert_cmpint(HarbourBase45::decodedSize(3), == ,2);
+    g_assert_cmpint(HarbourBase45::decodedSize(11), == ,7);
+
+    for (uint i = 0; i < G_N_ELEMENTS(tests); i++) {
+        const char* in = tests[i].in;
+        const QByteArray bytes(in);
+        const QString str(in);
+        int pos = -2;
+
+        memset(buf, 0, sizeof(buf));
+        g_assert_cmpint(HarbourBase45::decode(in, (int)strlen(in), buf,
+            sizeof(buf), &pos), == ,tests[i].result);
+        g_assert_cmpint(pos, == ,tests[i].pos);
+        if (tests[i].result > 0) {
+            g_assert(QByteArray(buf, tests[i].result) ==
+                HarbourBase45::fromBase45(in));
+        }
+        pos = -2;
+        g_assert_cmpint(HarbourBase45::decode(bytes, buf, sizeof(buf),
+            &pos), == ,tests[i].result);
+        g_assert_cmpint(pos, == ,tests[i].pos);
+        pos = -2;
+        g_assert_cmpint(HarbourBase45::decode(str, buf, sizeof(buf),
+            &pos), == ,tests[i].result);
+        g_assert_cmpint(pos, == ,tests[i].pos);
+        pos = -2;
+        g_assert_cmpint(HarbourBase45::decode(str.constData(), str.length(),
+            buf, sizeof(buf), &pos), == ,tests[i].result);
+        g_assert_cmpint(pos, == ,tests[i].pos);
+    }
+
+    // Buffer too small
+    int pos = -2;
+    g_assert_cmpint(HarbourBase45::decode("%69 VD92EX0", 11, buf, 6,
+        &pos), == ,-1);
+    g_assert_cmpint(pos, == ,-1);
+    g_assert_cmpint(HarbourBase45::decode("%69 VD92EX0", 11, buf, 7), == ,7);
+    g_assert(QByteArray(buf, 7) == QByteArray("Hello!!"));
+}
+
+/*==========================================================================*
+ * large
+ *==========================================================================*/
+
+static const char test_alphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+
+// Straightforward reference implementation
+static
+QString
+test_reference_base45(
+    const QByteArray aData)
+{
+    const uchar* ptr = (const uchar*)aData.constData();
+    const int n = aData.size();
+    QString str;
+    int i;
+
+    for (i = 0; (i + 1) < n; i += 2) {
+        const uint w = (uint)ptr[i] * 256 + ptr[i + 1];
+
+        str.append(QChar::fromLatin1(test_alphabet[w % 45]));
+        str.append(QChar::fromLatin1(test_alphabet[(w / 45) % 45]));
+        str.append(QChar::fromLatin1(test_alphabet[w / (45 * 45)]));
+    }
+    if (i < n) {
+        str.append(QChar::fromLatin1(test_alphabet[ptr[i] % 45]));
+        str.append(QChar::fromLatin1(test_alphabet[ptr[i] / 45]));
+    }
+    return str;
+}
+
+static
+void
+test_large(
+    void)
+{
+    QByteArray data;
+
+    // Every possible 16-bit word
+    data.resize(0x20000);
+    for (int i = 0; i < 0x10000; i++) {
+        data[2 * i] = (char)(i >> 8);
+        data[2 * i + 1] = (char)i;
+    }
+
+    QString str(HarbourBase45::toBase45(data));
+    g_assert(str == test_reference_base45(data));
+    g_assert(HarbourBase45::fromBase45(str) == data);
+    g_assert(HarbourBase45::fromBase45(str.toLatin1()) == data);
+
+    // Random lengths (vector code plus scalar tail)
+    data.resize(200);
+    for (int i = 0; i < data.size(); i++) {
+        data[i] = (char)g_random_int();
+    }
+    for (int n = 0; n <= data.size(); n++) {
+        const QByteArray bytes(data.left(n));
+
+        str = HarbourBase45::toBase45(bytes);
+        g_assert(str == test_reference_base45(bytes));
+        g_assert(HarbourBase45::fromBase45(str) == bytes);
+        g_assert(HarbourBase45::fromBase45(str.toLatin1()) == bytes);
+    }
+
+    // Errors anywhere inside a long string
+    static const char* bad[] = {
+        "GGW",      // 65536
+        "::W",      // 89144
+        "AB:",      // e > 32
+        "ab0",      // Lower case
+        "A\x01A",
+        "AA\x80"
+    };
+    str = HarbourBase45::toBase45(data);
+    for (guint k = 0; k < G_N_ELEMENTS(bad); k++) {
+        for (int i = 0; i < str.length(); i += 3) {
+            QString s1(str);
+            QByteArray s2(str.toLatin1());
+            char buf[256];
+            int pos = -2;
+
+            s1.replace(i, 3, QString::fromLatin1(bad[k]));
+            s2.replace(i, 3, QByteArray(bad[k]));
+            g_assert(!HarbourBase45::isValidBase45(s1));
+            g_assert(!HarbourBase45::isValidBase45(s2));
+            g_assert(HarbourBase45::fromBase45(s1).isEmpty());
+            g_assert_cmpint(HarbourBase45::decode(s1, buf, sizeof(buf),
+                &pos), == ,-1);
+            g_assert_cmpint(pos, == ,i);
+            pos = -2;
+            g_assert_cmpint(HarbourBase45::decode(s2, buf, sizeof(buf),
+                &pos), == ,-1);
+            g_assert_cmpint(pos, == ,i);
+        }
+    }
+
+    // Non-Latin-1 UTF-16 characters
+    str[30] = QChar(0x130);
+    g_assert(!HarbourBase45::isValidBase45(str));
+    str[30] = QChar(0x8030);
+    g_assert(!HarbourBase45::isValidBase45(str));
 }
 
 /*==========================================================================*
@@ -117,6 +306,8 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("isValidBase45"), test_isValidBase45);
     g_test_add_func(TEST_("fromBase45"), test_fromBase45);
     g_test_add_func(TEST_("toBase45"), test_toBase45);
+    g_test_add_func(TEST_("decode"), test_decode);
+    g_test_add_func(TEST_("large"), test_large);
     return g_test_run();
 }
 
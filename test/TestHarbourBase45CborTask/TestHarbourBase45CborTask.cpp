@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourBase45CborTask.h"
+#include "HarbourBase45.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QThreadPool>
+
+#include <glib.h>
+#include <string.h>
+#include <zlib.h>
+
+typedef HarbourBase45CborTask Task;
+
+static QThreadPool* test_pool = Q_NULLPTR;
+
+// 18([h'A10126', {}, h'DEADBEEF', h'0102'])
+static const uchar test_cose[] = {
+    0xd2, 0x84, 0x43, 0xa1, 0x01, 0x26, 0xa0, 0x44,
+    0xde, 0xad, 0xbe, 0xef, 0x42, 0x01, 0x02
+};
+
+static
+QByteArray
+test_compress(
+    const QByteArray aData)
+{
+    uLongf size = compressBound(aData.size());
+    QByteArray out;
+
+    out.resize((int)size);
+    g_assert_cmpint(compress((Bytef*)out.data(), &size,
+        (const Bytef*)aData.constData(), aData.size()), == ,Z_OK);
+    out.resize((int)size);
+    return out;
+}
+
+// A CBOR byte string which doesn't compress well
+static
+QByteArray
+test_random_bytes(
+    int aSize)
+{
+    QByteArray out;
+
+    g_assert_cmpint(aSize, < ,0x10000);
+    out.append((char)0x59);
+    out.append((char)(aSize >> 8));
+    out.append((char)aSize);
+    for (int i = 0; i < aSize; i++) {
+        out.append((char)g_random_int());
+    }
+    return out;
+}
+
+static
+Task*
+test_run(
+    const QString aBase45,
+    int aMaxSize = Task::DEFAULT_MAX_SIZE)
+{
+    Task* task = new Task(test_pool, aBase45, aMaxSize);
+    QEventLoop loop;
+
+    QObject::connect(task, SIGNAL(done()), &loop, SLOT(quit()));
+    task->submit();
+    loop.exec();
+    return task;
+}
+
+/*==========================================================================*
+ * plain
+ *==========================================================================*/
+
+static
+void
+test_plain(
+    void)
+{
+    const QByteArray cose((const char*)test_cose, sizeof(test_cose));
+    Task* task = test_run(HarbourBase45::toBase45(cose));
+    GUtilData data;
+
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(!task->isCompressed());
+    g_assert(task->cbor() == cose);
+    g_assert(task->isCoseSign1());
+
+    data = task->coseProtectedHeader();
+    g_assert_cmpuint(data.size, == ,3);
+    g_assert(!memcmp(data.bytes, test_cose + 3, 3));
+    data = task->coseUnprotectedHeader();
+    g_assert_cmpuint(data.size, == ,1);
+    g_assert_cmpuint(data.bytes[0], == ,0xa0);
+    data = task->cosePayload();
+    g_assert_cmpuint(data.size, == ,4);
+    g_assert(!memcmp(data.bytes, test_cose + 8, 4));
+    data = task->coseSignature();
+    g_assert_cmpuint(data.size, == ,2);
+    g_assert(!memcmp(data.bytes, test_cose + 13, 2));
+    task->release();
+
+    // Untagged COSE_Sign1 is fine too
+    task = test_run(HarbourBase45::toBase45(cose.mid(1)));
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(task->isCoseSign1());
+    task->release();
+
+    task = test_run(HarbourBase45::toBase45(QByteArray("\x83\x01\x02\x03")));
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(!task->isCoseSign1());
+    g_assert(!task->cosePayload().size);
+    task->release();
+}
+
+/*==========================================================================*
+ * compressed
+ *==========================================================================*/
+
+static
+void
+test_compressed(
+    void)
+{
+    const QByteArray cose((const char*)test_cose, sizeof(test_cose));
+    Task* task = test_run(HarbourBase45::toBase45(test_compress(cose)));
+    GUtilData data;
+
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(task->isCompressed());
+    g_assert(task->cbor() == cose);
+    g_assert(task->isCoseSign1());
+    data = task->cosePayload();
+    g_assert_cmpuint(data.size, == ,4);
+    g_assert(!memcmp(data.bytes, test_cose + 8, 4));
+    task->release();
+}
+
+/*==========================================================================*
+ * large
+ *==========================================================================*/
+
+static
+void
+test_large(
+    void)
+{
+    // Takes several chunks to decode and a few reallocations to inflate
+    QByteArray cbor(test_random_bytes(10000));
+    Task* task = test_run(HarbourBase45::toBase45(test_compress(cbor)));
+
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(task->isCompressed());
+    g_assert(task->cbor() == cbor);
+    g_assert(!task->isCoseSign1());
+    task->release();
+
+    // Compresses really well
+    cbor = QByteArray("\x5a\x00\x01\x00\x00", 5) + QByteArray(0x10000, 'x');
+    task = test_run(HarbourBase45::toBase45(test_compress(cbor)));
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(task->cbor() == cbor);
+    task->release();
+}
+
+/*==========================================================================*
+ * tooLarge
+ *==========================================================================*/
+
+static
+void
+test_tooLarge(
+    void)
+{
+    const QByteArray cbor(test_random_bytes(1000));
+    Task* task = test_run(HarbourBase45::toBase45(cbor), 1000);
+
+    g_assert_cmpint(task->error(), == ,Task::TooLargeError);
+    g_assert(task->cbor().isEmpty());
+    task->release();
+
+    task = test_run(HarbourBase45::toBase45(test_compress(cbor)), 1000);
+    g_assert_cmpint(task->error(), == ,Task::TooLargeError);
+    g_assert(task->cbor().isEmpty());
+    task->release();
+
+    // Exactly fits
+    task = test_run(HarbourBase45::toBase45(test_compress(cbor)), 1003);
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(task->cbor() == cbor);
+    task->release();
+}
+
+/*==========================================================================*
+ * truncated
+ *==========================================================================*/
+
+static
+void
+test_truncated(
+    void)
+{
+    const QByteArray z(test_compress(test_random_bytes(3000)));
+    Task* task = test_run(HarbourBase45::toBase45(z.left(z.size() - 4)));
+
+    g_assert_cmpint(task->error(), == ,Task::InflateError);
+    g_assert(task->isCompressed());
+    g_assert(task->cbor().isEmpty());
+    task->release();
+
+    // Corrupted stream
+    QByteArray bad(z);
+    bad[10] = ~bad[10];
+    bad[11] = ~bad[11];
+    task = test_run(HarbourBase45::toBase45(bad));
+    g_assert_cmpint(task->error(), == ,Task::InflateError);
+    task->release();
+
+    // Uncompressed CBOR which ends prematurely
+    const QByteArray cose((const char*)test_cose, sizeof(test_cose));
+    task = test_run(HarbourBase45::toBase45(cose.left(cose.size() - 1)));
+    g_assert_cmpint(task->error(), == ,Task::CborError);
+    g_assert(!task->isCoseSign1());
+    task->release();
+
+    // And the one with something after it, compressed or not
+    const QByteArray extra(cose + QByteArray(1, (char)0x00));
+    task = test_run(HarbourBase45::toBase45(extra));
+    g_assert_cmpint(task->error(), == ,Task::CborError);
+    g_assert(!task->isCoseSign1());
+    task->release();
+
+    task = test_run(HarbourBase45::toBase45(test_compress(extra)));
+    g_assert_cmpint(task->error(), == ,Task::CborError);
+    g_assert(task->isCompressed());
+    task->release();
+}
+
+/*==========================================================================*
+ * base45
+ *==========================================================================*/
+
+static
+void
+test_base45(
+    void)
+{
+    Task* task = test_run(QString("BB8A(A"));
+
+    g_assert_cmpint(task->error(), == ,Task::Base45Error);
+    g_assert_cmpint(task->errorPos(), == ,3);
+    task->release();
+
+    // Dangling character
+    task = test_run(QString("BB8A"));
+    g_assert_cmpint(task->error(), == ,Task::Base45Error);
+    g_assert_cmpint(task->errorPos(), == ,3);
+    task->release();
+
+    // Empty input isn't CBOR
+    task = test_run(QString());
+    g_assert_cmpint(task->error(), == ,Task::CborError);
+    task->release();
+}
+
+/*==========================================================================*
+ * trailing
+ *==========================================================================*/
+
+static
+void
+test_trailing(
+    void)
+{
+    // The compressed stream ends in the first chunk (1536 characters)
+    // and garbage follows in the second one. The task has to notice it.
+    const QByteArray cose((const char*)test_cose, sizeof(test_cose));
+    QByteArray z(test_compress(cose));
+
+    // Even number of bytes leaves no dangling pair of characters
+    // in front of the padding
+    if (z.size() % 2) {
+        z.append((char)0);
+    }
+
+    QString base45(HarbourBase45::toBase45(z));
+
+    g_assert_cmpint(base45.length(), < ,1536);
+    while (base45.length() < 1536) {
+        base45.append(QString("000"));
+    }
+
+    Task* task = test_run(base45);
+
+    // Valid trailing data is ignored
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(task->cbor() == cose);
+    task->release();
+
+    const int pos = base45.length();
+
+    base45.append(QString("A(A"));
+    task = test_run(base45);
+    g_assert_cmpint(task->error(), == ,Task::Base45Error);
+    g_assert_cmpint(task->errorPos(), == ,pos);
+    g_assert(task->cbor().isEmpty());
+    task->release();
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_(name) "/HarbourBase45CborTask/" name
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QThreadPool pool;
+    int ret;
+
+    test_pool = &pool;
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("plain"), test_plain);
+    g_test_add_func(TEST_("compressed"), test_compressed);
+    g_test_add_func(TEST_("large"), test_large);
+    g_test_add_func(TEST_("tooLarge"), test_tooLarge);
+    g_test_add_func(TEST_("truncated"), test_truncated);
+    g_test_add_func(TEST_("base45"), test_base45);
+    g_test_add_func(TEST_("trailing"), test_trailing);
+    ret = g_test_run();
+    pool.waitForDone();
+    test_pool = Q_NULLPTR;
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
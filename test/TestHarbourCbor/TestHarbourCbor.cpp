@@ -0,0 +1,480 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourCbor.h"
+
+#include <glib.h>
+#include <math.h>
+#include <string.h>
+
+#define HEX(s) test_hex(s)
+
+// Converts hex into a static buffer, good enough for tests
+static
+GUtilRange
+test_hex(
+    const char* aHex)
+{
+    static guint8 buf[1024];
+    static gsize used = 0;
+    const gsize n = strlen(aHex) / 2;
+    GUtilRange range;
+
+    if (used + n > sizeof(buf)) {
+        used = 0;
+    }
+    for (gsize i = 0; i < n; i++) {
+        char byte[3] = { aHex[2 * i], aHex[2 * i + 1], 0 };
+
+        buf[used + i] = (guint8)strtoul(byte, NULL, 16);
+    }
+    range.ptr = buf + used;
+    range.end = range.ptr + n;
+    used += n;
+    return range;
+}
+
+/*==========================================================================*
+ * null
+ *==========================================================================*/
+
+static
+void
+test_null(
+    void)
+{
+    GUtilRange empty;
+
+    empty.ptr = empty.end = NULL;
+    g_assert_cmpint(HarbourCbor::peekType(NULL), == ,-1);
+    g_assert_cmpint(HarbourCbor::peekType(&empty), == ,-1);
+    g_assert(!HarbourCbor::parseHead(NULL, NULL));
+    g_assert(!HarbourCbor::parseUInt(NULL, NULL));
+    g_assert(!HarbourCbor::parseInt(NULL, NULL));
+    g_assert(!HarbourCbor::parseBool(NULL, NULL));
+    g_assert(!HarbourCbor::parseNull(NULL));
+    g_assert(!HarbourCbor::parseFloat(NULL, NULL));
+    g_assert(!HarbourCbor::parseTag(NULL, NULL));
+    g_assert(!HarbourCbor::parseBytes(NULL, NULL));
+    g_assert(!HarbourCbor::parseText(NULL, NULL));
+    g_assert(!HarbourCbor::parseArray(NULL, NULL));
+    g_assert(!HarbourCbor::parseMap(NULL, NULL));
+    g_assert(!HarbourCbor::parseBreak(NULL));
+    g_assert(!HarbourCbor::skipItem(NULL));
+    g_assert(!HarbourCbor::parseItem(NULL, NULL));
+    g_assert(!HarbourCbor::parseHead(&empty, NULL));
+    g_assert(!HarbourCbor::skipItem(&empty));
+}
+
+/*==========================================================================*
+ * int
+ *==========================================================================*/
+
+static
+void
+test_int(
+    void)
+{
+    // RFC 8949, Appendix A
+    static const struct {
+        const char* hex;
+        qint64 value;
+    } tests[] = {
+        { "00", 0 },
+        { "17", 23 },
+        { "1818", 24 },
+        { "1903e8", 1000 },
+        { "1a000f4240", 1000000 },
+        { "1b000000e8d4a51000", Q_INT64_C(1000000000000) },
+        { "20", -1 },
+        { "29", -10 },
+        { "3863", -100 },
+        { "3903e7", -1000 },
+        { "3b7fffffffffffffff", Q_INT64_C(-0x7fffffffffffffff) - 1 }
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(tests); i++) {
+        GUtilRange range = HEX(tests[i].hex);
+        qint64 value = 42;
+
+        g_assert(HarbourCbor::parseInt(&range, &value));
+        g_assert(range.ptr == range.end);
+        g_assert_cmpint(value, == ,tests[i].value);
+    }
+
+    GUtilRange range = HEX("1bffffffffffffffff");
+    const guint8* start = range.ptr;
+    quint64 u = 0;
+
+    g_assert(!HarbourCbor::parseInt(&range, NULL));
+    g_assert(range.ptr == start);
+    g_assert(HarbourCbor::parseUInt(&range, &u));
+    g_assert(range.ptr == range.end);
+    g_assert_cmpuint(u, == ,Q_UINT64_C(0xffffffffffffffff));
+
+    range = HEX("3bffffffffffffffff");
+    g_assert(!HarbourCbor::parseInt(&range, NULL));
+    g_assert(!HarbourCbor::parseUInt(&range, NULL));
+    g_assert_cmpint(HarbourCbor::peekType(&range), == ,
+        HarbourCbor::TYPE_NEGINT);
+
+    // Truncated and reserved
+    range = HEX("1903");
+    g_assert(!HarbourCbor::parseUInt(&range, NULL));
+    range = HEX("1c");
+    g_assert(!HarbourCbor::parseUInt(&range, NULL));
+    range = HEX("1f");
+    g_assert(!HarbourCbor::parseUInt(&range, NULL));
+}
+
+/*==========================================================================*
+ * simple
+ *==========================================================================*/
+
+static
+void
+test_simple(
+    void)
+{
+    static const struct {
+        const char* hex;
+        double value;
+    } floats[] = {
+        { "f90000", 0.0 },
+        { "f93c00", 1.0 },
+        { "f93e00", 1.5 },
+        { "f97bff", 65504.0 },
+        { "f90001", 5.960464477539063e-8 },
+        { "f90400", 0.00006103515625 },
+        { "f9c400", -4.0 },
+        { "fa47c35000", 100000.0 },
+        { "fa7f7fffff", 3.4028234663852886e+38 },
+        { "fb3ff199999999999a", 1.1 },
+        { "fbc010666666666666", -4.1 }
+    };
+    GUtilRange range;
+    HarbourCbor::Head head;
+    double d;
+    bool b;
+
+    for (guint i = 0; i < G_N_ELEMENTS(floats); i++) {
+        range = HEX(floats[i].hex);
+        g_assert(HarbourCbor::parseFloat(&range, &d));
+        g_assert(range.ptr == range.end);
+        g_assert(d == floats[i].value);
+    }
+
+    range = HEX("f97c00");
+    g_assert(HarbourCbor::parseFloat(&range, &d));
+    g_assert(isinf(d) && d > 0);
+    range = HEX("f9fc00");
+    g_assert(HarbourCbor::parseFloat(&range, &d));
+    g_assert(isinf(d) && d < 0);
+    range = HEX("f97e00");
+    g_assert(HarbourCbor::parseFloat(&range, &d));
+    g_assert(isnan(d));
+    range = HEX("00");
+    g_assert(!HarbourCbor::parseFloat(&range, &d));
+
+    range = HEX("f4f5f6f7");
+    g_assert(!HarbourCbor::parseNull(&range));
+    g_assert(HarbourCbor::parseBool(&range, &b));
+    g_assert(!b);
+    g_assert(!HarbourCbor::parseFloat(&range, &d));
+    g_assert(HarbourCbor::parseBool(&range, &b));
+    g_assert(b);
+    g_assert(!HarbourCbor::parseBool(&range, &b));
+    g_assert(HarbourCbor::parseNull(&range));
+    g_assert(HarbourCbor::parseHead(&range, &head));
+    g_assert(range.ptr == range.end);
+    g_assert_cmpint(head.type, == ,HarbourCbor::TYPE_SIMPLE);
+    g_assert_cmpuint(head.value, == ,HarbourCbor::SIMPLE_UNDEFINED);
+
+    // Two-byte simple values below 32 are not well-formed
+    range = HEX("f8ff");
+    g_assert(HarbourCbor::parseHead(&range, &head));
+    g_assert_cmpuint(head.value, == ,255);
+    range = HEX("f818");
+    g_assert(!HarbourCbor::parseHead(&range, &head));
+    g_assert(!HarbourCbor::skipItem(&range));
+}
+
+/*==========================================================================*
+ * string
+ *==========================================================================*/
+
+static
+void
+test_string(
+    void)
+{
+    GUtilRange range = HEX("40" "4401020304" "60" "6449455446");
+    const guint8* start = range.ptr;
+    GUtilData data;
+
+    g_assert(!HarbourCbor::parseText(&range, &data));
+    g_assert(HarbourCbor::parseBytes(&range, &data));
+    g_assert_cmpuint(data.size, == ,0);
+    g_assert(HarbourCbor::parseBytes(&range, &data));
+    g_assert_cmpuint(data.size, == ,4);
+    g_assert(data.bytes == start + 2); // View into the input
+    g_assert(!memcmp(data.bytes, "\x01\x02\x03\x04", 4));
+    g_assert(HarbourCbor::parseText(&range, NULL));
+    g_assert(HarbourCbor::parseText(&range, &data));
+    g_assert(range.ptr == range.end);
+    g_assert_cmpuint(data.size, == ,4);
+    g_assert(!memcmp(data.bytes, "IETF", 4));
+
+    // Truncated
+    range = HEX("4401020304");
+    range.end--;
+    start = range.ptr;
+    g_assert(!HarbourCbor::parseBytes(&range, &data));
+    g_assert(range.ptr == start);
+    g_assert(!HarbourCbor::skipItem(&range));
+    g_assert(range.ptr == start);
+
+    // Indefinite-length, chunk by chunk
+    HarbourCbor::Head head;
+    range = HEX("7f657374726561646d696e67ff");
+    g_assert(!HarbourCbor::parseText(&range, &data));
+    g_assert(HarbourCbor::parseHead(&range, &head));
+    g_assert_cmpint(head.type, == ,HarbourCbor::TYPE_TEXT);
+    g_assert(head.indefinite);
+    g_assert(HarbourCbor::parseText(&range, &data));
+    g_assert_cmpuint(data.size, == ,5);
+    g_assert(!memcmp(data.bytes, "strea", 5));
+    g_assert(!HarbourCbor::parseBreak(&range));
+    g_assert(HarbourCbor::parseText(&range, &data));
+    g_assert_cmpuint(data.size, == ,4);
+    g_assert(!memcmp(data.bytes, "ming", 4));
+    g_assert(HarbourCbor::parseBreak(&range));
+    g_assert(range.ptr == range.end);
+
+    range = HEX("5f42010243030405ff");
+    g_assert(HarbourCbor::skipItem(&range));
+    g_assert(range.ptr == range.end);
+
+    // Chunks must be definite strings of the same type
+    range = HEX("5f4201026103ff");
+    g_assert(!HarbourCbor::skipItem(&range));
+    range = HEX("5f5f4102ffff");
+    g_assert(!HarbourCbor::skipItem(&range));
+    range = HEX("5f420102");
+    g_assert(!HarbourCbor::skipItem(&range));
+}
+
+/*==========================================================================*
+ * array
+ *==========================================================================*/
+
+static
+void
+test_array(
+    void)
+{
+    GUtilRange range = HEX("8301820203820405");
+    qint64 n = 0;
+    quint64 v;
+
+    // [1, [2, 3], [4, 5]]
+    g_assert(!HarbourCbor::parseMap(&range, &n));
+    g_assert(HarbourCbor::parseArray(&range, &n));
+    g_assert_cmpint(n, == ,3);
+    g_assert(HarbourCbor::parseUInt(&range, &v));
+    g_assert_cmpuint(v, == ,1);
+    g_assert(HarbourCbor::skipItem(&range));
+    g_assert(HarbourCbor::parseArray(&range, &n));
+    g_assert_cmpint(n, == ,2);
+    g_assert(HarbourCbor::parseUInt(&range, &v));
+    g_assert_cmpuint(v, == ,4);
+    g_assert(HarbourCbor::parseUInt(&range, &v));
+    g_assert_cmpuint(v, == ,5);
+    g_assert(range.ptr == range.end);
+
+    // [_ 1, [2, 3], [_ 4, 5]]
+    range = HEX("9f018202039f0405ffff");
+    g_assert(HarbourCbor::parseArray(&range, &n));
+    g_assert_cmpint(n, == ,HarbourCbor::INDEFINITE);
+    g_assert(HarbourCbor::skipItem(&range));
+    g_assert(HarbourCbor::skipItem(&range));
+    g_assert(HarbourCbor::skipItem(&range));
+    g_assert(HarbourCbor::parseBreak(&range));
+    g_assert(range.ptr == range.end);
+
+    range = HEX("9fff");
+    g_assert(HarbourCbor::skipItem(&range));
+    g_assert(range.ptr == range.end);
+
+    // Missing break, stray break, impossible size
+    range = HEX("9f01");
+    g_assert(!HarbourCbor::skipItem(&range));
+    range = HEX("ff");
+    g_assert(!HarbourCbor::skipItem(&range));
+    range = HEX("9bffffffffffffffff00");
+    g_assert(!HarbourCbor::parseArray(&range, &n));
+    g_assert(!HarbourCbor::skipItem(&range));
+    range = HEX("830102");
+    g_assert(!HarbourCbor::skipItem(&range));
+
+    // Nesting depth is limited
+    char hex[2 * 100 + 3];
+    for (int i = 0; i < 60; i++) {
+        memcpy(hex + 2 * i, "81", 2);
+    }
+    strcpy(hex + 2 * 60, "00");
+    range = HEX(hex);
+    g_assert(HarbourCbor::skipItem(&range));
+    g_assert(range.ptr == range.end);
+
+    for (int i = 0; i < 100; i++) {
+        memcpy(hex + 2 * i, "81", 2);
+    }
+    strcpy(hex + 2 * 100, "00");
+    range = HEX(hex);
+    g_assert(!HarbourCbor::skipItem(&range));
+}
+
+/*==========================================================================*
+ * map
+ *==========================================================================*/
+
+static
+void
+test_map(
+    void)
+{
+    // {"a": 1, "b": [2, 3]}
+    GUtilRange range = HEX("a26161016162820203");
+    const guint8* start = range.ptr;
+    GUtilData item;
+    qint64 n = 0;
+
+    g_assert(HarbourCbor::parseItem(&range, &item));
+    g_assert(range.ptr == range.end);
+    g_assert(item.bytes == start);
+    g_assert_cmpuint(item.size, == ,9);
+
+    range.ptr = start;
+    g_assert(HarbourCbor::parseMap(&range, &n));
+    g_assert_cmpint(n, == ,2);
+    g_assert(HarbourCbor::parseText(&range, &item));
+    g_assert_cmpuint(item.size, == ,1);
+    g_assert_cmpint(item.bytes[0], == ,'a');
+
+    // {_ "a": 1, "b": [_ 2, 3]}
+    range = HEX("bf61610161629f0203ffff");
+    g_assert(HarbourCbor::skipItem(&range));
+    g_assert(range.ptr == range.end);
+
+    // Odd number of items
+    range = HEX("bf616101ff");
+    g_assert(HarbourCbor::skipItem(&range));
+    range = HEX("bf6161ff");
+    g_assert(!HarbourCbor::skipItem(&range));
+    range = HEX("a16161");
+    g_assert(!HarbourCbor::skipItem(&range));
+}
+
+/*==========================================================================*
+ * tag
+ *==========================================================================*/
+
+static
+void
+test_tag(
+    void)
+{
+    // 0("2013-03-21T20:04:00Z")
+    GUtilRange range = HEX("c074323031332d30332d32315432303a30343a30305a");
+    GUtilRange pos = range;
+    GUtilData text;
+    quint64 tag = 42;
+
+    g_assert(HarbourCbor::skipItem(&pos));
+    g_assert(pos.ptr == pos.end);
+    g_assert(HarbourCbor::parseTag(&range, &tag));
+    g_assert_cmpuint(tag, == ,HarbourCbor::TAG_DATETIME);
+    g_assert(HarbourCbor::parseText(&range, &text));
+    g_assert(range.ptr == range.end);
+    g_assert_cmpuint(text.size, == ,20);
+
+    // 18([h'', {}, h'01', h''])
+    range = HEX("d28440a0410140");
+    g_assert_cmpint(HarbourCbor::peekType(&range), == ,
+        HarbourCbor::TYPE_TAG);
+    g_assert(HarbourCbor::parseTag(&range, &tag));
+    g_assert_cmpuint(tag, == ,HarbourCbor::TAG_COSE_SIGN1);
+    g_assert(HarbourCbor::skipItem(&range));
+    g_assert(range.ptr == range.end);
+
+    // Tag without content
+    range = HEX("d8");
+    g_assert(!HarbourCbor::parseTag(&range, &tag));
+    range = HEX("c0");
+    g_assert(HarbourCbor::parseTag(&range, NULL));
+    range = HEX("c0");
+    g_assert(!HarbourCbor::skipItem(&range));
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_(name) "/HarbourCbor/" name
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("int"), test_int);
+    g_test_add_func(TEST_("simple"), test_simple);
+    g_test_add_func(TEST_("string"), test_string);
+    g_test_add_func(TEST_("array"), test_array);
+    g_test_add_func(TEST_("map"), test_map);
+    g_test_add_func(TEST_("tag"), test_tag);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
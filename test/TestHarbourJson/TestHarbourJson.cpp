@@ -0,0 +1,507 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourJson.h"
+#include "HarbourJsonSaver.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTimer>
+
+#include <glib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+static const char TEST_SIDECAR_SUFFIX[] = ".cbor";
+
+static
+QVariantMap
+test_map(
+    void)
+{
+    QVariantMap map, nested;
+    QVariantList list;
+
+    list.append(1);
+    list.append(QString("two"));
+    list.append(3.5);
+    list.append(QVariantMap());
+    list.append(QVariantList());
+    nested.insert("int", -42);
+    nested.insert("big", Q_INT64_C(1234567890123));
+    nested.insert("double", 0.1);
+    nested.insert("true", true);
+    nested.insert("false", false);
+    nested.insert("list", list);
+    map.insert("string", QString("Hello, \xd0\xbc\xd0\xb8\xd1\x80"));
+    map.insert("empty", QString(""));
+    map.insert("nested", nested);
+    map.insert("number", 7);
+    return map;
+}
+
+static
+QByteArray
+test_read(
+    const QString& aPath)
+{
+    QFile f(aPath);
+
+    g_assert(f.open(QIODevice::ReadOnly));
+    return f.readAll();
+}
+
+static
+void
+test_write(
+    const QString& aPath,
+    const QByteArray& aData)
+{
+    QFile f(aPath);
+
+    g_assert(f.open(QIODevice::WriteOnly));
+    g_assert_cmpint(f.write(aData), == ,aData.size());
+    f.close();
+}
+
+static
+void
+test_get_mtime(
+    const QString& aPath,
+    struct timespec* aTime)
+{
+    struct stat st;
+
+    g_assert(!stat(aPath.toLocal8Bit().constData(), &st));
+    *aTime = st.st_mtim;
+}
+
+static
+void
+test_set_mtime(
+    const QString& aPath,
+    const struct timespec* aTime)
+{
+    struct timespec times[2];
+
+    times[0] = *aTime;
+    times[1] = *aTime;
+    g_assert(!utimensat(AT_FDCWD, aPath.toLocal8Bit().constData(), times, 0));
+}
+
+// What text parsing produces, the sidecar must give the same thing
+static
+QVariantMap
+test_parse(
+    const QString& aPath)
+{
+    QVariantMap map;
+
+    g_assert(HarbourJson::parse(test_read(aPath), map));
+    return map;
+}
+
+/*==========================================================================*
+ * TestSaverReceiver
+ *==========================================================================*/
+
+class TestSaverReceiver :
+    public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSaverReceiver(HarbourJsonSaver* aSaver) :
+        iExpected(0),
+        iFailed(0)
+    {
+        connect(aSaver, SIGNAL(saved(QString,bool)),
+            SLOT(onSaved(QString,bool)));
+    }
+
+    void
+    wait(
+        int aCount)
+    {
+        iExpected = aCount;
+        if (iSaved.count() < iExpected) {
+            iLoop.exec();
+        }
+    }
+
+public Q_SLOTS:
+    void
+    onSaved(
+        QString aPath,
+        bool aSuccess)
+    {
+        iSaved.append(aPath);
+        if (!aSuccess) {
+            iFailed++;
+        }
+        if (iSaved.count() == iExpected) {
+            iLoop.quit();
+        }
+    }
+
+public:
+    QEventLoop iLoop;
+    QStringList iSaved;
+    int iExpected;
+    int iFailed;
+};
+
+/*==========================================================================*
+ * sidecar
+ *==========================================================================*/
+
+static
+void
+test_sidecar(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    const QString sidecar(path + TEST_SIDECAR_SUFFIX);
+    const QVariantMap map(test_map());
+    QVariantMap loaded;
+
+    // No sidecar without SaveSidecar
+    g_assert(HarbourJson::save(path, map));
+    g_assert(!QFile::exists(sidecar));
+    g_assert(!HarbourJson::loadSidecar(path, loaded));
+
+    g_assert(HarbourJson::save(path, map, HarbourJson::SaveSidecar));
+    g_assert(QFile::exists(sidecar));
+    g_assert(test_read(sidecar).startsWith("HJSC"));
+    g_assert(HarbourJson::loadSidecar(path, loaded));
+    g_assert(loaded == test_parse(path));
+    loaded.clear();
+    g_assert(HarbourJson::load(path, loaded));
+    g_assert(loaded == test_parse(path));
+
+    // Saving without SaveSidecar removes it
+    g_assert(HarbourJson::save(path, map, HarbourJson::SaveCompact));
+    g_assert(!QFile::exists(sidecar));
+
+    // So does saving an empty map (which removes the file)
+    g_assert(HarbourJson::save(path, map, HarbourJson::SaveSidecar));
+    g_assert(QFile::exists(sidecar));
+    g_assert(!HarbourJson::save(path, QVariantMap()));
+    g_assert(!QFile::exists(path));
+    g_assert(!QFile::exists(sidecar));
+}
+
+/*==========================================================================*
+ * unchanged
+ *==========================================================================*/
+
+static
+void
+test_unchanged(
+    void)
+{
+    const HarbourJson::SaveOptions options(HarbourJson::SaveSidecar |
+        HarbourJson::SaveIfChanged | HarbourJson::SaveAtomic);
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    const QString sidecar(path + TEST_SIDECAR_SUFFIX);
+    const QVariantMap map(test_map());
+    QVariantMap loaded;
+
+    // The file is unchanged but the sidecar is missing, it gets recreated
+    g_assert(HarbourJson::save(path, map, options));
+    g_assert(QFile::remove(sidecar));
+    g_assert(HarbourJson::save(path, map, options));
+    g_assert(QFile::exists(sidecar));
+    g_assert(HarbourJson::loadSidecar(path, loaded));
+    g_assert(loaded == test_parse(path));
+}
+
+/*==========================================================================*
+ * stale
+ *==========================================================================*/
+
+static
+void
+test_stale(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    const QVariantMap map(test_map());
+    QVariantMap loaded;
+    struct timespec mtime;
+
+    // Different size
+    g_assert(HarbourJson::save(path, map, HarbourJson::SaveSidecar));
+    test_write(path, QByteArray("{\"a\":1}"));
+    g_assert(!HarbourJson::loadSidecar(path, loaded));
+    g_assert(HarbourJson::load(path, loaded));
+    g_assert_cmpint(loaded.count(), == ,1);
+    g_assert_cmpint(loaded.value("a").toInt(), == ,1);
+
+    // Same size and timestamp, different contents
+    g_assert(HarbourJson::save(path, map, HarbourJson::SaveSidecar));
+    QByteArray json(test_read(path));
+    const int pos = json.indexOf("Hello");
+
+    g_assert_cmpint(pos, > ,0);
+    json[pos] = 'J';
+    test_get_mtime(path, &mtime);
+    test_write(path, json);
+    test_set_mtime(path, &mtime);
+    g_assert(!HarbourJson::loadSidecar(path, loaded));
+    loaded.clear();
+    g_assert(HarbourJson::load(path, loaded));
+    g_assert(loaded.value("string").toString().startsWith("Jello"));
+}
+
+/*==========================================================================*
+ * broken
+ *==========================================================================*/
+
+static
+void
+test_broken(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    const QString sidecar(path + TEST_SIDECAR_SUFFIX);
+    const QVariantMap map(test_map());
+    QVariantMap loaded;
+
+    g_assert(HarbourJson::save(path, map, HarbourJson::SaveSidecar));
+
+    // Damaged CBOR fails the checksum
+    QByteArray data(test_read(sidecar));
+
+    data[data.size() - 1] = data[data.size() - 1] ^ 0x55;
+    test_write(sidecar, data);
+    g_assert(!HarbourJson::loadSidecar(path, loaded));
+    g_assert(HarbourJson::load(path, loaded));
+    g_assert(loaded == test_parse(path));
+
+    // Truncated sidecar
+    test_write(sidecar, data.left(20));
+    g_assert(!HarbourJson::loadSidecar(path, loaded));
+    g_assert(HarbourJson::load(path, loaded));
+    g_assert(loaded == test_parse(path));
+}
+
+/*==========================================================================*
+ * foreign
+ *==========================================================================*/
+
+static
+void
+test_foreign(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    const QString other(path + TEST_SIDECAR_SUFFIX);
+    const QByteArray data("Not ours");
+    QVariantMap loaded;
+
+    // A file which happens to have the sidecar's name is left alone
+    test_write(other, data);
+    g_assert(HarbourJson::save(path, test_map()));
+    g_assert(HarbourJson::saveData(path, QByteArray("{}")));
+    g_assert(!HarbourJson::save(path, QVariantMap()));
+    g_assert(test_read(other) == data);
+
+    g_assert(HarbourJson::saveData(path, QByteArray("{\"a\":true}")));
+    g_assert(!HarbourJson::loadSidecar(path, loaded));
+    g_assert(HarbourJson::load(path, loaded));
+    g_assert(loaded.value("a").toBool());
+}
+
+/*==========================================================================*
+ * saverCoalesce
+ *==========================================================================*/
+
+static
+void
+test_saverCoalesce(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path1(dir.path() + "/test1.json");
+    const QString path2(dir.path() + "/test2.json");
+    HarbourJsonSaver saver;
+    TestSaverReceiver receiver(&saver);
+    QVariantMap map1, map2, map3, loaded;
+
+    map1.insert("a", 1);
+    map2.insert("a", 2);
+    map3.insert("b", 3);
+    saver.setDelay(100);
+    g_assert_cmpint(saver.delay(), == ,100);
+    g_assert(!saver.busy());
+
+    // Only the last snapshot within the window gets written
+    saver.save(path1, map1);
+    saver.save(path2, map3);
+    saver.save(path1, map2);
+    g_assert(saver.busy());
+    g_assert(!QFile::exists(path1));
+    g_assert(!QFile::exists(path2));
+    receiver.wait(2);
+    g_assert_cmpint(receiver.iSaved.count(), == ,2);
+    g_assert_cmpint(receiver.iSaved.count(path1), == ,1);
+    g_assert_cmpint(receiver.iSaved.count(path2), == ,1);
+    g_assert_cmpint(receiver.iFailed, == ,0);
+    g_assert(HarbourJson::load(path1, loaded));
+    g_assert_cmpint(loaded.value("a").toInt(), == ,2);
+    g_assert(HarbourJson::load(path2, loaded));
+    g_assert_cmpint(loaded.value("b").toInt(), == ,3);
+
+    // Nothing else is coming
+    QTimer::singleShot(200, &receiver.iLoop, SLOT(quit()));
+    receiver.iLoop.exec();
+    g_assert_cmpint(receiver.iSaved.count(), == ,2);
+    g_assert(!saver.busy());
+
+    // The next save opens a new window
+    saver.save(path1, map1);
+    receiver.wait(3);
+    g_assert(HarbourJson::load(path1, loaded));
+    g_assert_cmpint(loaded.value("a").toInt(), == ,1);
+}
+
+/*==========================================================================*
+ * saverFlush
+ *==========================================================================*/
+
+static
+void
+test_saverFlush(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    HarbourJsonSaver saver;
+    TestSaverReceiver receiver(&saver);
+    QVariantMap map, loaded;
+
+    map.insert("a", 1);
+    saver.setDelay(60000);
+    saver.save(path, map);
+    g_assert(saver.busy());
+
+    // Written before flush() returns
+    saver.flush();
+    g_assert(!saver.busy());
+    g_assert_cmpint(receiver.iSaved.count(), == ,1);
+    g_assert(receiver.iSaved.at(0) == path);
+    g_assert(HarbourJson::load(path, loaded));
+    g_assert(loaded == test_parse(path));
+
+    // Nothing to flush
+    saver.flush();
+    g_assert_cmpint(receiver.iSaved.count(), == ,1);
+}
+
+/*==========================================================================*
+ * saverCanceled
+ *==========================================================================*/
+
+static
+void
+test_saverCanceled(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    HarbourJsonSaver saver;
+    TestSaverReceiver receiver(&saver);
+    QVariantMap map, loaded;
+
+    // After aboutToQuit the worker doesn't write anything, flush()
+    // has to do it on the spot
+    QTimer::singleShot(0, qApp, SLOT(quit()));
+    QCoreApplication::exec();
+
+    map.insert("a", 1);
+    saver.save(path, map);
+    saver.flush();
+    g_assert(!saver.busy());
+    g_assert_cmpint(receiver.iSaved.count(), == ,1);
+    g_assert_cmpint(receiver.iFailed, == ,0);
+    g_assert(HarbourJson::load(path, loaded));
+    g_assert_cmpint(loaded.value("a").toInt(), == ,1);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_(name) "/HarbourJson/" name
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("sidecar"), test_sidecar);
+    g_test_add_func(TEST_("unchanged"), test_unchanged);
+    g_test_add_func(TEST_("stale"), test_stale);
+    g_test_add_func(TEST_("broken"), test_broken);
+    g_test_add_func(TEST_("foreign"), test_foreign);
+    g_test_add_func(TEST_("saverCoalesce"), test_saverCoalesce);
+    g_test_add_func(TEST_("saverFlush"), test_saverFlush);
+    // Must be the last one, it triggers aboutToQuit
+    g_test_add_func(TEST_("saverCanceled"), test_saverCanceled);
+    return g_test_run();
+}
+
+#include "TestHarbourJson.moc"
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
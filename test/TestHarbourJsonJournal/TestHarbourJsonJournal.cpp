@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourJsonJournal.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+
+#include <glib.h>
+
+static
+QByteArray
+test_read(
+    const QString aPath)
+{
+    QFile f(aPath);
+
+    g_assert(f.open(QIODevice::ReadOnly));
+    return f.readAll();
+}
+
+static
+void
+test_write(
+    const QString aPath,
+    const QByteArray aData)
+{
+    QFile f(aPath);
+
+    g_assert(f.open(QIODevice::WriteOnly));
+    g_assert_cmpint(f.write(aData), == ,aData.size());
+}
+
+static
+void
+test_append(
+    const QString aPath,
+    const QByteArray aData)
+{
+    QFile f(aPath);
+
+    g_assert(f.open(QIODevice::WriteOnly | QIODevice::Append));
+    g_assert_cmpint(f.write(aData), == ,aData.size());
+}
+
+/*==========================================================================*
+ * replay
+ *==========================================================================*/
+
+static
+void
+test_replay(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    QStringList nested;
+    QVariantMap data;
+
+    nested.append("a/b");
+    nested.append("c~d");
+
+    HarbourJsonJournal* journal = new HarbourJsonJournal(path);
+
+    g_assert(journal->path() == path);
+    g_assert(journal->journalPath() == path + ".journal");
+    g_assert(journal->data().isEmpty());
+    g_assert(!journal->load());
+    g_assert(journal->setValue("x", 1));
+    g_assert(journal->setValue("y", QString("y")));
+    g_assert(journal->setValue(nested, true));
+    g_assert(journal->setValue("x", 2));
+    g_assert(journal->remove("y"));
+    g_assert(journal->remove("nothing"));
+    g_assert_cmpint(journal->value("x").toInt(), == ,2);
+    g_assert(!journal->value("y").isValid());
+    g_assert(journal->value(nested).toBool());
+    data = journal->data();
+    delete journal;
+
+    // Nothing has been compacted
+    g_assert(!QFile::exists(path));
+    g_assert(QFile::exists(path + ".journal"));
+
+    journal = new HarbourJsonJournal(path);
+    g_assert(journal->data() == data);
+    g_assert_cmpint(journal->value("x").toInt(), == ,2);
+    g_assert(journal->value(nested).toBool());
+
+    // Removing the whole nested map
+    g_assert(journal->remove(nested.at(0)));
+    g_assert(journal->load());
+    g_assert(!journal->value(nested).isValid());
+    g_assert_cmpint(journal->data().count(), == ,1);
+    delete journal;
+}
+
+/*==========================================================================*
+ * torn
+ *==========================================================================*/
+
+static
+void
+test_torn(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    const QString journalPath(path + ".journal");
+    HarbourJsonJournal* journal = new HarbourJsonJournal(path);
+    qint64 size;
+
+    g_assert(journal->setValue("a", 1));
+    g_assert(journal->setValue("b", 2));
+    delete journal;
+
+    // The last record has been interrupted by a crash
+    size = QFileInfo(journalPath).size();
+    test_append(journalPath, QByteArray("{\"op\":\"add\",\"path\":\"/c\",\"va"));
+
+    journal = new HarbourJsonJournal(path);
+    g_assert_cmpint(journal->data().count(), == ,2);
+    g_assert_cmpint(journal->value("a").toInt(), == ,1);
+    g_assert_cmpint(journal->value("b").toInt(), == ,2);
+    g_assert(!journal->value("c").isValid());
+    g_assert_cmpint(QFileInfo(journalPath).size(), == ,size);
+
+    // The next change isn't glued to the garbage
+    g_assert(journal->setValue("c", 3));
+    g_assert(journal->load());
+    g_assert_cmpint(journal->value("c").toInt(), == ,3);
+    delete journal;
+}
+
+/*==========================================================================*
+ * compact
+ *==========================================================================*/
+
+static
+void
+test_compact(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    const QString journalPath(path + ".journal");
+    HarbourJsonJournal* journal = new HarbourJsonJournal(path);
+    QEventLoop loop;
+    QVariantMap data;
+    int i;
+
+    journal->connect(journal, SIGNAL(compacted(bool)), &loop, SLOT(quit()));
+
+    // Keep rewriting the same few keys until it gets compacted
+    for (i = 0; !journal->busy(); i++) {
+        g_assert(journal->setValue(QString::number(i % 4), i));
+    }
+    g_assert_cmpint(i, > ,1);
+    g_assert(QFile::exists(path + ".journal.old"));
+
+    // This one goes to the new journal
+    g_assert(journal->setValue("last", i));
+    loop.exec();
+    g_assert(!journal->busy());
+    g_assert(!QFile::exists(path + ".journal.old"));
+    g_assert(QFile::exists(path));
+    g_assert_cmpint(QFileInfo(journalPath).size(), < ,100);
+    data = journal->data();
+    g_assert_cmpint(data.count(), == ,5);
+    delete journal;
+
+    journal = new HarbourJsonJournal(path);
+    g_assert(journal->data() == data);
+
+    // Explicit compaction
+    journal->compact();
+    g_assert(journal->busy());
+    journal->flush();
+    g_assert(!journal->busy());
+    g_assert(!QFile::exists(journalPath));
+    delete journal;
+
+    journal = new HarbourJsonJournal(path);
+    g_assert(journal->data() == data);
+
+    // Nothing to compact
+    journal->compact();
+    g_assert(!journal->busy());
+    delete journal;
+}
+
+/*==========================================================================*
+ * restore
+ *==========================================================================*/
+
+static
+void
+test_restore(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    HarbourJsonJournal* journal = new HarbourJsonJournal(path);
+    QEventLoop loop;
+    QVariantMap data;
+
+    g_assert(journal->setValue("a", 1));
+    g_assert(journal->setValue("b", 2));
+
+    // A directory in place of the snapshot makes compaction fail
+    g_assert(QDir(dir.path()).mkdir("test.json"));
+    journal->connect(journal, SIGNAL(compacted(bool)), &loop, SLOT(quit()));
+    journal->compact();
+    g_assert(journal->busy());
+    g_assert(journal->setValue("c", 3));
+    loop.exec();
+    g_assert(!journal->busy());
+
+    // Both journals have been merged back into one
+    g_assert(!QFile::exists(path + ".journal.old"));
+    g_assert(QFile::exists(path + ".journal"));
+    g_assert(journal->setValue("d", 4));
+    data = journal->data();
+    g_assert_cmpint(data.count(), == ,4);
+    delete journal;
+
+    g_assert(QDir(dir.path()).rmdir("test.json"));
+    journal = new HarbourJsonJournal(path);
+    g_assert(journal->data() == data);
+    delete journal;
+}
+
+/*==========================================================================*
+ * recover
+ *==========================================================================*/
+
+static
+void
+test_recover(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    HarbourJsonJournal* journal;
+
+    // Crashed in the middle of compaction. The old journal may or may
+    // not have already been applied to the snapshot.
+    test_write(path, QByteArray("{\"a\":1,\"b\":2}"));
+    test_write(path + ".journal.old", QByteArray(
+        "{\"op\":\"add\",\"path\":\"/b\",\"value\":2}\n"
+        "{\"op\":\"add\",\"path\":\"/c\",\"value\":{\"d\":3}}\n"));
+    test_write(path + ".journal", QByteArray(
+        "{\"op\":\"remove\",\"path\":\"/a\"}\n"
+        "{\"op\":\"add\",\"path\":\"/c/e\",\"value\":4}\n"));
+
+    journal = new HarbourJsonJournal(path);
+    g_assert(!QFile::exists(path + ".journal.old"));
+    g_assert(!QFile::exists(path + ".journal"));
+    g_assert_cmpint(journal->data().count(), == ,2);
+    g_assert(!journal->value("a").isValid());
+    g_assert_cmpint(journal->value("b").toInt(), == ,2);
+    g_assert_cmpint(journal->value(QString("c/d").split('/')).toInt(), == ,3);
+    g_assert_cmpint(journal->value(QString("c/e").split('/')).toInt(), == ,4);
+    delete journal;
+
+    // Everything has been written to the snapshot
+    g_assert(test_read(path).contains("\"e\""));
+    journal = new HarbourJsonJournal(path);
+    g_assert_cmpint(journal->value(QString("c/e").split('/')).toInt(), == ,4);
+    delete journal;
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_(name) "/HarbourJsonJournal/" name
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("replay"), test_replay);
+    g_test_add_func(TEST_("torn"), test_torn);
+    g_test_add_func(TEST_("compact"), test_compact);
+    g_test_add_func(TEST_("restore"), test_restore);
+    g_test_add_func(TEST_("recover"), test_recover);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
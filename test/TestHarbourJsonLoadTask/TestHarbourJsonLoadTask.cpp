@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourJsonLoadTask.h"
+#include "HarbourJson.h"
+#include "HarbourTaskScheduler.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QSemaphore>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
+#include <glib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+typedef HarbourJsonLoadTask Task;
+
+static QThreadPool* test_pool = Q_NULLPTR;
+
+static
+Task*
+test_run(
+    const QString aPath)
+{
+    Task* task = new Task(test_pool, aPath);
+    QEventLoop loop;
+
+    QObject::connect(task, SIGNAL(done()), &loop, SLOT(quit()));
+    task->submit();
+    loop.exec();
+    return task;
+}
+
+/*==========================================================================*
+ * GateTask
+ *==========================================================================*/
+
+class GateTask :
+    public HarbourTask
+{
+public:
+    GateTask(QThreadPool* aPool) : HarbourTask(aPool) {}
+
+protected:
+    void performTask() Q_DECL_OVERRIDE { iGate.acquire(); }
+
+public:
+    QSemaphore iGate;
+};
+
+/*==========================================================================*
+ * success
+ *==========================================================================*/
+
+static
+void
+test_success(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    QVariantMap map;
+    QString big;
+    Task* task;
+
+    map.insert("a", 1);
+    map.insert("b", QString("x"));
+    g_assert(HarbourJson::save(path, map));
+    task = test_run(path);
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(task->errorString().isEmpty());
+    g_assert(task->path() == path);
+    g_assert(task->data() == map);
+    task->release();
+
+    // From the sidecar
+    g_assert(HarbourJson::save(path, map, HarbourJson::SaveSidecar));
+    task = test_run(path);
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(task->data() == map);
+    task->release();
+
+    // Larger than a chunk
+    big.fill(QChar('z'), 3 * Task::CHUNK_SIZE / 2);
+    map.insert("c", big);
+    g_assert(HarbourJson::save(path, map));
+    task = test_run(path);
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(task->data() == map);
+    task->release();
+
+    // Empty object is fine too
+    g_assert(HarbourJson::saveData(path, QByteArray("{}")));
+    task = test_run(path);
+    g_assert_cmpint(task->error(), == ,Task::NoError);
+    g_assert(task->data().isEmpty());
+    task->release();
+}
+
+/*==========================================================================*
+ * parseError
+ *==========================================================================*/
+
+static
+void
+test_parseError(
+    void)
+{
+    static const char* tests[] = { "", "{", "{\"a\":}", "[1]", "1" };
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+
+    for (guint i = 0; i < G_N_ELEMENTS(tests); i++) {
+        Task* task;
+
+        g_assert(HarbourJson::saveData(path, QByteArray(tests[i])));
+        task = test_run(path);
+        g_assert_cmpint(task->error(), == ,Task::ParseError);
+        g_assert(!task->errorString().isEmpty());
+        g_assert(task->data().isEmpty());
+        task->release();
+    }
+}
+
+/*==========================================================================*
+ * missing
+ *==========================================================================*/
+
+static
+void
+test_missing(
+    void)
+{
+    QTemporaryDir dir;
+    Task* task = test_run(dir.path() + "/missing.json");
+
+    g_assert_cmpint(task->error(), == ,Task::FileError);
+    g_assert(!task->errorString().isEmpty());
+    g_assert(task->data().isEmpty());
+    task->release();
+}
+
+/*==========================================================================*
+ * superseded
+ *==========================================================================*/
+
+static
+void
+test_superseded(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/test.json");
+    QThreadPool pool;
+    HarbourTaskScheduler scheduler(&pool);
+    GateTask* gate = new GateTask(&pool);
+    Task* task1 = new Task(&pool, path);
+    Task* task2 = new Task(&pool, path);
+    QVariantMap map;
+    QEventLoop loop;
+
+    // The gate keeps the only thread busy while the second task
+    // supersedes the first one in the queue
+    map.insert("a", 1);
+    g_assert(HarbourJson::save(path, map));
+    pool.setMaxThreadCount(1);
+    scheduler.submit(gate);
+    scheduler.submit(task1, HarbourTaskScheduler::PriorityNormal, path);
+    scheduler.submit(task2, HarbourTaskScheduler::PriorityNormal, path);
+    QObject::connect(task2, SIGNAL(done()), &loop, SLOT(quit()));
+    gate->iGate.release();
+    loop.exec();
+
+    g_assert(task1->isCanceled());
+    g_assert(!task1->isStarted());
+    g_assert_cmpint(task1->error(), == ,Task::CanceledError);
+    g_assert(task1->data().isEmpty());
+    g_assert_cmpint(task2->error(), == ,Task::NoError);
+    g_assert(task2->data() == map);
+    gate->release();
+    task1->release();
+    task2->release();
+}
+
+/*==========================================================================*
+ * cancel
+ *==========================================================================*/
+
+static
+void
+test_cancel(
+    void)
+{
+    // The task gets stuck reading the pipe until we tell it to continue
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/fifo");
+    const QByteArray fname(path.toLocal8Bit());
+    QByteArray chunk(Task::CHUNK_SIZE, ' ');
+    Task* task = new Task(test_pool, path);
+    QEventLoop loop;
+    int fd;
+
+    g_assert(!mkfifo(fname.constData(), 0600));
+    QObject::connect(task, SIGNAL(done()), &loop, SLOT(quit()));
+    task->submit();
+    fd = open(fname.constData(), O_WRONLY);
+    g_assert(fd >= 0);
+    chunk[0] = '{';
+    g_assert_cmpint(write(fd, chunk.constData(), chunk.size()), == ,
+        chunk.size());
+
+    // Cancel and let it read some more
+    QTimer::singleShot(0, qApp, SLOT(quit()));
+    QCoreApplication::exec();
+    g_assert(task->isCanceled());
+
+    // The task may have already noticed that while reading the rest
+    // of the first chunk and closed the pipe, hence SIG_IGN
+    signal(SIGPIPE, SIG_IGN);
+    if (write(fd, "}", 1) < 0) {
+        g_assert_cmpint(errno, == ,EPIPE);
+    }
+    close(fd);
+
+    loop.exec();
+    g_assert(task->isStarted());
+    g_assert_cmpint(task->error(), == ,Task::CanceledError);
+    g_assert(task->data().isEmpty());
+    task->release();
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_(name) "/HarbourJsonLoadTask/" name
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QThreadPool pool;
+    int ret;
+
+    test_pool = &pool;
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("success"), test_success);
+    g_test_add_func(TEST_("parseError"), test_parseError);
+    g_test_add_func(TEST_("missing"), test_missing);
+    g_test_add_func(TEST_("superseded"), test_superseded);
+    // Must be the last one, tasks are canceled after that
+    g_test_add_func(TEST_("cancel"), test_cancel);
+    ret = g_test_run();
+    pool.waitForDone();
+    test_pool = Q_NULLPTR;
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,928 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourJsonSchema.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <glib.h>
+#include <string.h>
+
+typedef HarbourJson::Reader Reader;
+typedef HarbourJson::Writer Writer;
+
+static
+void
+test_tokens(
+    const char* aJson,
+    const Reader::Token* aTokens)
+{
+    Reader reader(aJson, strlen(aJson));
+
+    for (const Reader::Token* t = aTokens; *t != Reader::TOKEN_END; t++) {
+        g_assert_cmpint(reader.next(), == ,*t);
+    }
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_END);
+    g_assert_cmpint(reader.depth(), == ,0);
+}
+
+/*==========================================================================*
+ * reader/basic
+ *==========================================================================*/
+
+static
+void
+test_reader_basic(
+    void)
+{
+    static const Reader::Token tokens1[] = {
+        Reader::TOKEN_BEGIN_OBJECT,
+        Reader::TOKEN_NAME, Reader::TOKEN_NUMBER,
+        Reader::TOKEN_NAME, Reader::TOKEN_BEGIN_ARRAY,
+            Reader::TOKEN_TRUE, Reader::TOKEN_FALSE, Reader::TOKEN_NULL,
+            Reader::TOKEN_BEGIN_OBJECT, Reader::TOKEN_END_OBJECT,
+            Reader::TOKEN_BEGIN_ARRAY, Reader::TOKEN_END_ARRAY,
+        Reader::TOKEN_END_ARRAY,
+        Reader::TOKEN_NAME, Reader::TOKEN_STRING,
+        Reader::TOKEN_END_OBJECT,
+        Reader::TOKEN_END
+    };
+    static const Reader::Token tokens2[] = {
+        Reader::TOKEN_STRING,
+        Reader::TOKEN_END
+    };
+    static const Reader::Token tokens3[] = {
+        Reader::TOKEN_NUMBER,
+        Reader::TOKEN_END
+    };
+
+    test_tokens("{\"a\":1,\"b\":[true,false,null,{},[]],\"c\":\"x\"}",
+        tokens1);
+    test_tokens(" \r\n\t{ \"a\" : 1 , \"b\" : [ true , false , null , "
+        "{ } , [ ] ] , \"c\" : \"x\" }\n", tokens1);
+    test_tokens("\xef\xbb\xbf\"x\"", tokens2);
+    test_tokens("-0.5e+10", tokens3);
+
+    Reader reader(QByteArray("{\"foo\":[\"bar\"]}"));
+
+    g_assert_cmpint(reader.token(), == ,Reader::TOKEN_END);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_BEGIN_OBJECT);
+    g_assert_cmpint(reader.depth(), == ,1);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_NAME);
+    g_assert_cmpint(reader.position(), == ,2);
+    g_assert_cmpint(reader.tokenSize(), == ,3);
+    g_assert(!memcmp(reader.tokenData(), "foo", 3));
+    g_assert(reader.equals("foo"));
+    g_assert(!reader.equals("fo"));
+    g_assert(!reader.equals("bar"));
+    g_assert(reader.string() == QString("foo"));
+    g_assert(reader.number() == 0);
+    g_assert(!reader.skipValue());
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_BEGIN_ARRAY);
+    g_assert_cmpint(reader.depth(), == ,2);
+    g_assert(!reader.equals("foo"));
+    g_assert(reader.string().isNull());
+    g_assert(reader.utf8().isNull());
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_STRING);
+    g_assert(reader.equals("bar"));
+    g_assert(reader.utf8() == QByteArray("bar"));
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_END_ARRAY);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_END_OBJECT);
+    g_assert_cmpint(reader.depth(), == ,0);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_END);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_END);
+}
+
+/*==========================================================================*
+ * reader/string
+ *==========================================================================*/
+
+static
+void
+test_reader_string(
+    void)
+{
+    static const char json[] = "[\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\","
+        "\"\\u0041\\u00e4\\u20AC\",\"\\ud83d\\ude00\",\"\xc3\xa4\",\"\"]";
+    static const ushort smile[] = { 0xd83d, 0xde00 };
+    static const ushort latin[] = { 0x41, 0xe4, 0x20ac };
+    Reader reader(json, sizeof(json) - 1);
+
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_BEGIN_ARRAY);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_STRING);
+    g_assert(reader.isEscaped());
+    g_assert(reader.equals("a\"b\\c/d\b\f\n\r\t"));
+    g_assert(reader.string() == QString("a\"b\\c/d\b\f\n\r\t"));
+    g_assert(reader.utf8() == QByteArray("a\"b\\c/d\b\f\n\r\t"));
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_STRING);
+    g_assert(reader.string() == QString((const QChar*)latin,
+        G_N_ELEMENTS(latin)));
+    g_assert(reader.utf8() == QByteArray("A\xc3\xa4\xe2\x82\xac"));
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_STRING);
+    g_assert(reader.string() == QString((const QChar*)smile,
+        G_N_ELEMENTS(smile)));
+    g_assert(reader.utf8() == QByteArray("\xf0\x9f\x98\x80"));
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_STRING);
+    g_assert(!reader.isEscaped());
+    g_assert_cmpint(reader.string().length(), == ,1);
+    g_assert_cmpint(reader.string().at(0).unicode(), == ,0xe4);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_STRING);
+    g_assert_cmpint(reader.tokenSize(), == ,0);
+    g_assert(reader.string().isEmpty());
+    g_assert(!reader.string().isNull());
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_END_ARRAY);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_END);
+}
+
+/*==========================================================================*
+ * reader/number
+ *==========================================================================*/
+
+static
+void
+test_reader_number(
+    void)
+{
+    static const struct {
+        const char* json;
+        double number;
+        qint64 integer;
+        gboolean exact;
+    } tests[] = {
+        { "0", 0, 0, TRUE },
+        { "-0", 0, 0, TRUE },
+        { "1", 1, 1, TRUE },
+        { "-12", -12, -12, TRUE },
+        { "2.5", 2.5, 2, FALSE },
+        { "-2.5", -2.5, -2, FALSE },
+        { "2.0", 2, 2, TRUE },
+        { "1e3", 1000, 1000, TRUE },
+        { "1.5E-1", 0.15, 0, FALSE },
+        { "9007199254740993", 9007199254740992.0, 9007199254740993LL, TRUE },
+        { "123456789012345678", 123456789012345678.0, 123456789012345678LL,
+          TRUE },
+        { "9223372036854775807", 9223372036854775807.0,
+          Q_INT64_C(0x7fffffffffffffff), TRUE },
+        { "-9223372036854775808", -9223372036854775808.0,
+          -Q_INT64_C(0x7fffffffffffffff) - 1, TRUE },
+        { "9223372036854775808", 9223372036854775808.0,
+          Q_INT64_C(0x7fffffffffffffff), FALSE },
+        { "100000000000000000000", 1e20, Q_INT64_C(0x7fffffffffffffff),
+          FALSE },
+        { "-100000000000000000000", -1e20,
+          -Q_INT64_C(0x7fffffffffffffff) - 1, FALSE }
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(tests); i++) {
+        const char* json = tests[i].json;
+        Reader reader(json, strlen(json));
+        qint64 value = 0;
+
+        g_assert_cmpint(reader.next(), == ,Reader::TOKEN_NUMBER);
+        g_assert_cmpint(reader.tokenSize(), == ,strlen(json));
+        g_assert(reader.number() == tests[i].number);
+        g_assert_cmpint(reader.integer(), == ,tests[i].integer);
+        if (tests[i].exact) {
+            g_assert(reader.integer(&value));
+            g_assert_cmpint(value, == ,tests[i].integer);
+        } else {
+            g_assert(!reader.integer(&value));
+        }
+        g_assert(reader.skipValue());
+        g_assert_cmpint(reader.next(), == ,Reader::TOKEN_END);
+        g_assert(reader.number() == 0);
+        g_assert_cmpint(reader.integer(), == ,0);
+        g_assert(!reader.integer(&value));
+    }
+}
+
+/*==========================================================================*
+ * reader/error
+ *==========================================================================*/
+
+static
+void
+test_reader_error(
+    void)
+{
+    static const struct {
+        const char* json;
+        int position;
+    } tests[] = {
+        { "", 0 },
+        { "  ", 2 },
+        { "x", 0 },
+        { "nul", 0 },
+        { "truex", 4 },
+        { "1 2", 2 },
+        { "01", 1 },
+        { "-", 1 },
+        { "1.", 2 },
+        { "1.e5", 2 },
+        { "1e", 2 },
+        { "1e+", 3 },
+        { "+1", 0 },
+        { "\"abc", 0 },
+        { "\"a\\x\"", 2 },
+        { "\"a\\u12\"", 2 },
+        { "\"a\nb\"", 2 },
+        { "{", 1 },
+        { "{1:2}", 1 },
+        { "{\"a\"}", 4 },
+        { "{\"a\":}", 5 },
+        { "{\"a\":1,}", 7 },
+        { "{\"a\":1 \"b\":2}", 7 },
+        { "{\"a\":1]", 6 },
+        { "[", 1 },
+        { "[1,]", 3 },
+        { "[1}", 2 },
+        { "[1 2]", 3 },
+        { "]", 0 },
+        { "{}}", 2 }
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(tests); i++) {
+        const char* json = tests[i].json;
+        Reader reader(json, strlen(json));
+        Reader::Token token;
+
+        while ((token = reader.next()) != Reader::TOKEN_ERROR) {
+            g_assert_cmpint(token, != ,Reader::TOKEN_END);
+        }
+        g_assert_cmpint(reader.position(), == ,tests[i].position);
+        g_assert_cmpint(reader.tokenSize(), == ,0);
+        g_assert(!reader.skipValue());
+
+        // The error is sticky
+        g_assert_cmpint(reader.next(), == ,Reader::TOKEN_ERROR);
+        g_assert_cmpint(reader.token(), == ,Reader::TOKEN_ERROR);
+    }
+}
+
+/*==========================================================================*
+ * reader/depth
+ *==========================================================================*/
+
+static
+void
+test_reader_depth(
+    void)
+{
+    QByteArray json;
+    int i;
+
+    for (i = 0; i < Reader::MAX_DEPTH; i++) {
+        json.append('[');
+    }
+    for (i = 0; i < Reader::MAX_DEPTH; i++) {
+        json.append(']');
+    }
+
+    Reader ok(json);
+
+    g_assert_cmpint(ok.next(), == ,Reader::TOKEN_BEGIN_ARRAY);
+    g_assert(ok.skipValue());
+    g_assert_cmpint(ok.next(), == ,Reader::TOKEN_END);
+
+    json.prepend('[');
+    json.append(']');
+
+    Reader tooDeep(json);
+
+    g_assert_cmpint(tooDeep.next(), == ,Reader::TOKEN_BEGIN_ARRAY);
+    g_assert(!tooDeep.skipValue());
+    g_assert_cmpint(tooDeep.token(), == ,Reader::TOKEN_ERROR);
+    g_assert_cmpint(tooDeep.position(), == ,Reader::MAX_DEPTH);
+}
+
+/*==========================================================================*
+ * reader/skip
+ *==========================================================================*/
+
+static
+void
+test_reader_skip(
+    void)
+{
+    static const char json[] = "{\"a\":{\"b\":[1,{\"c\":[]}],\"d\":\"}\"},"
+        "\"e\":[[],[[]]],\"f\":true,\"g\":[1,}";
+    Reader reader(json, sizeof(json) - 1);
+
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_BEGIN_OBJECT);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_NAME);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_BEGIN_OBJECT);
+    g_assert(reader.skipValue());
+    g_assert_cmpint(reader.token(), == ,Reader::TOKEN_END_OBJECT);
+    g_assert_cmpint(reader.depth(), == ,1);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_NAME);
+    g_assert(reader.equals("e"));
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_BEGIN_ARRAY);
+    g_assert(reader.skipValue());
+    g_assert_cmpint(reader.token(), == ,Reader::TOKEN_END_ARRAY);
+    g_assert_cmpint(reader.depth(), == ,1);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_NAME);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_TRUE);
+    g_assert(reader.skipValue());
+    g_assert_cmpint(reader.token(), == ,Reader::TOKEN_TRUE);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_NAME);
+    g_assert(reader.equals("g"));
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_BEGIN_ARRAY);
+    g_assert(!reader.skipValue());
+    g_assert_cmpint(reader.token(), == ,Reader::TOKEN_ERROR);
+}
+
+/*==========================================================================*
+ * writer/compact
+ *==========================================================================*/
+
+static
+void
+test_writer_compact(
+    void)
+{
+    Writer writer;
+
+    writer.beginObject().
+        name("a").value(1).
+        name("b").beginArray().
+            value(true).value(false).null().
+            beginObject().endObject().
+            beginArray().endArray().
+        endArray().
+        name(QString("c")).value("x").
+        name("d", 1).value(QString("y")).
+        endObject();
+    g_assert_cmpint(writer.depth(), == ,0);
+    g_assert_cmpstr(writer.data().constData(), == ,
+        "{\"a\":1,\"b\":[true,false,null,{},[]],\"c\":\"x\",\"d\":\"y\"}");
+
+    writer.clear();
+    g_assert(writer.data().isEmpty());
+    writer.value("x");
+    g_assert_cmpstr(writer.data().constData(), == ,"\"x\"");
+}
+
+/*==========================================================================*
+ * writer/indent
+ *==========================================================================*/
+
+static
+void
+test_writer_indent(
+    void)
+{
+    Writer writer(true);
+
+    writer.beginObject().
+        name("a").value(1).
+        name("b").beginArray().
+            value(true).
+            beginObject().endObject().
+            beginObject().name("c").beginArray().endArray().endObject().
+        endArray().
+        endObject();
+    g_assert_cmpstr(writer.data().constData(), == ,
+        "{\n"
+        "    \"a\": 1,\n"
+        "    \"b\": [\n"
+        "        true,\n"
+        "        {},\n"
+        "        {\n"
+        "            \"c\": []\n"
+        "        }\n"
+        "    ]\n"
+        "}");
+}
+
+/*==========================================================================*
+ * writer/string
+ *==========================================================================*/
+
+static
+void
+test_writer_string(
+    void)
+{
+    static const ushort smile[] = { 0xd83d, 0xde00 };
+    Writer writer;
+
+    writer.beginArray().
+        value("a\"b\\c/d\b\f\n\r\t\x01\x1f").
+        value(QString((const QChar*)smile, G_N_ELEMENTS(smile))).
+        value("").
+        endArray();
+    g_assert_cmpstr(writer.data().constData(), == ,
+        "[\"a\\\"b\\\\c/d\\b\\f\\n\\r\\t\\u0001\\u001f\","
+        "\"\xf0\x9f\x98\x80\",\"\"]");
+
+    // Non-ASCII Latin1 name
+    writer.clear();
+    writer.beginObject().name("\xe4").value(0).endObject();
+    g_assert_cmpstr(writer.data().constData(), == ,"{\"\xc3\xa4\":0}");
+
+    // And the reader should be able to read all that back
+    Reader reader(writer.data());
+
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_BEGIN_OBJECT);
+    g_assert_cmpint(reader.next(), == ,Reader::TOKEN_NAME);
+    g_assert(reader.string() == QString::fromLatin1("\xe4"));
+}
+
+/*==========================================================================*
+ * writer/number
+ *==========================================================================*/
+
+static
+void
+test_writer_number(
+    void)
+{
+    Writer writer;
+
+    writer.beginArray().
+        value((int)-1).
+        value((uint)0xffffffff).
+        value(Q_INT64_C(-9223372036854775807) - 1).
+        value(Q_UINT64_C(18446744073709551615)).
+        value(2.0).
+        value(-0.5).
+        value(1e300).
+        value(0.1).
+        value(NAN).
+        value(INFINITY).
+        endArray();
+    g_assert_cmpstr(writer.data().constData(), == ,
+        "[-1,4294967295,-9223372036854775808,18446744073709551615,2,-0.5,"
+        "1.0000000000000001e+300,0.10000000000000001,null,null]");
+}
+
+/*==========================================================================*
+ * writer/variant
+ *==========================================================================*/
+
+static
+void
+test_writer_variant(
+    void)
+{
+    QVariantMap map, inner;
+    QVariantList list;
+    Writer writer;
+
+    list.append(QVariant(1));
+    list.append(QVariant(true));
+    list.append(QVariant());
+    list.append(QVariant(QString("x")));
+    inner.insert("d", QVariant(0.5));
+    inner.insert("u", QVariant(Q_UINT64_C(18446744073709551615)));
+    map.insert("a", list);
+    map.insert("b", inner);
+    map.insert("c", QVariantMap());
+    map.insert("e", QVariantList());
+    map.insert("i", QVariant(Q_INT64_C(-12345678901)));
+    writer.value(QVariant(map));
+    g_assert_cmpstr(writer.data().constData(), == ,
+        "{\"a\":[1,true,null,\"x\"],"
+        "\"b\":{\"d\":0.5,\"u\":18446744073709551615},"
+        "\"c\":{},\"e\":[],\"i\":-12345678901}");
+}
+
+/*==========================================================================*
+ * schema
+ *==========================================================================*/
+
+struct TestPoint {
+    int x;
+    int y;
+};
+
+typedef HarbourJsonSchema::Object<TestPoint,
+    HARBOUR_JSON_FIELD(Int, TestPoint, x),
+    HARBOUR_JSON_FIELD(Int, TestPoint, y)> TestPointSchema;
+
+struct TestData {
+    int count;
+    qint64 size;
+    double ratio;
+    bool enabled;
+    QString title;
+    TestPoint origin;
+    QList<int> numbers;
+    QVector<QString> names;
+    QList<TestPoint> points;
+};
+
+typedef HarbourJsonSchema::Object<TestData,
+    HARBOUR_JSON_FIELD(Int, TestData, count),
+    HARBOUR_JSON_FIELD(Int, TestData, size),
+    HARBOUR_JSON_FIELD(Double, TestData, ratio),
+    HARBOUR_JSON_FIELD(Bool, TestData, enabled),
+    HARBOUR_JSON_NAMED_FIELD("window-title", String, TestData, title),
+    HARBOUR_JSON_FIELD(Nested<TestPointSchema>, TestData, origin),
+    HARBOUR_JSON_LIST(Int, TestData, numbers),
+    HARBOUR_JSON_LIST(String, TestData, names),
+    HARBOUR_JSON_NAMED_LIST("p", Nested<TestPointSchema>, TestData, points)>
+    TestDataSchema;
+
+static
+void
+test_data_init(
+    TestData* aData)
+{
+    aData->count = 0;
+    aData->size = 0;
+    aData->ratio = 0;
+    aData->enabled = false;
+    aData->title = QString();
+    aData->origin.x = aData->origin.y = 0;
+    aData->numbers.clear();
+    aData->names.clear();
+    aData->points.clear();
+}
+
+/*==========================================================================*
+ * schema/decode
+ *==========================================================================*/
+
+static
+void
+test_schema_decode(
+    void)
+{
+    TestData data;
+
+    // Fields in random order, some unknown, some escaped
+    test_data_init(&data);
+    g_assert(TestDataSchema::decode(QByteArray("{"
+        "\"p\": [{\"y\":2,\"x\":1},{\"x\":3}],"
+        "\"unknown\": {\"count\":[1,2,3]},"
+        "\"enabled\": true,"
+        "\"window\\u002dtitle\": \"Title\","
+        "\"numbers\": [1,-2,3.0],"
+        "\"\\u0063ount\": 7,"
+        "\"size\": 12345678901234,"
+        "\"names\": [\"a\",\"b\"],"
+        "\"origin\": {\"x\":-1,\"y\":-2,\"z\":-3},"
+        "\"ratio\": 0.25}"), &data));
+    g_assert_cmpint(data.count, == ,7);
+    g_assert_cmpint(data.size, == ,Q_INT64_C(12345678901234));
+    g_assert(data.ratio == 0.25);
+    g_assert(data.enabled);
+    g_assert(data.title == QString("Title"));
+    g_assert_cmpint(data.origin.x, == ,-1);
+    g_assert_cmpint(data.origin.y, == ,-2);
+    g_assert_cmpint(data.numbers.count(), == ,3);
+    g_assert_cmpint(data.numbers.at(0), == ,1);
+    g_assert_cmpint(data.numbers.at(1), == ,-2);
+    g_assert_cmpint(data.numbers.at(2), == ,3);
+    g_assert_cmpint(data.names.count(), == ,2);
+    g_assert(data.names.at(0) == QString("a"));
+    g_assert(data.names.at(1) == QString("b"));
+    g_assert_cmpint(data.points.count(), == ,2);
+    g_assert_cmpint(data.points.at(0).x, == ,1);
+    g_assert_cmpint(data.points.at(0).y, == ,2);
+    g_assert_cmpint(data.points.at(1).x, == ,3);
+    g_assert_cmpint(data.points.at(1).y, == ,0);
+
+    // Nulls and missing fields leave the values alone
+    g_assert(TestDataSchema::decode(QByteArray("{\"count\":null,"
+        "\"window-title\":null,\"origin\":null}"), &data));
+    g_assert_cmpint(data.count, == ,7);
+    g_assert(data.title == QString("Title"));
+    g_assert_cmpint(data.origin.x, == ,-1);
+    g_assert_cmpint(data.size, == ,Q_INT64_C(12345678901234));
+    g_assert_cmpint(data.numbers.count(), == ,3);
+
+    // Lists get replaced rather than appended to
+    g_assert(TestDataSchema::decode(QByteArray("{\"numbers\":[5],"
+        "\"names\":[],\"p\":[{\"x\":4}]}"), &data));
+    g_assert_cmpint(data.numbers.count(), == ,1);
+    g_assert_cmpint(data.numbers.at(0), == ,5);
+    g_assert(data.names.isEmpty());
+    g_assert_cmpint(data.points.count(), == ,1);
+    g_assert_cmpint(data.points.at(0).x, == ,4);
+
+    // And left alone if something is wrong with them
+    g_assert(!TestDataSchema::decode(QByteArray("{\"numbers\":[6,\"7\"]}"),
+        &data));
+    g_assert_cmpint(data.numbers.count(), == ,1);
+    g_assert_cmpint(data.numbers.at(0), == ,5);
+
+    // Empty object
+    test_data_init(&data);
+    g_assert(TestDataSchema::decode(QByteArray(" {} "), &data));
+    g_assert_cmpint(data.count, == ,0);
+}
+
+/*==========================================================================*
+ * schema/invalid
+ *==========================================================================*/
+
+static
+void
+test_schema_invalid(
+    void)
+{
+    static const char* tests[] = {
+        "",
+        "[]",
+        "{",
+        "{} {}",
+        "{\"count\":\"1\"}",
+        "{\"count\":1.5}",
+        "{\"count\":2147483648}",
+        "{\"count\":-2147483649}",
+        "{\"count\":1e100}",
+        "{\"size\":9223372036854775808}",
+        "{\"numbers\":[3.5]}",
+        "{\"ratio\":true}",
+        "{\"enabled\":1}",
+        "{\"window-title\":1}",
+        "{\"origin\":[]}",
+        "{\"origin\":{\"x\":[]}}",
+        "{\"numbers\":{}}",
+        "{\"numbers\":[null]}",
+        "{\"names\":[1]}",
+        "{\"p\":[1]}",
+        "{\"unknown\":[}",
+        "{\"count\":1,}"
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(tests); i++) {
+        TestData data;
+
+        test_data_init(&data);
+        g_assert(!TestDataSchema::decode(QByteArray(tests[i]), &data));
+    }
+}
+
+/*==========================================================================*
+ * schema/encode
+ *==========================================================================*/
+
+static
+void
+test_schema_encode(
+    void)
+{
+    TestData data, data2;
+    TestPoint p;
+
+    test_data_init(&data);
+    data.count = 1;
+    data.size = Q_INT64_C(-12345678901234);
+    data.ratio = 1.5;
+    data.enabled = true;
+    data.title = "\"Title\"";
+    data.origin.x = 2;
+    data.origin.y = 3;
+    data.numbers.append(4);
+    data.numbers.append(5);
+    data.names.append("x");
+    p.x = 6;
+    p.y = 7;
+    data.points.append(p);
+
+    const QByteArray json(TestDataSchema::encode(data));
+
+    g_assert_cmpstr(json.constData(), == ,"{"
+        "\"count\":1,"
+        "\"size\":-12345678901234,"
+        "\"ratio\":1.5,"
+        "\"enabled\":true,"
+        "\"window-title\":\"\\\"Title\\\"\","
+        "\"origin\":{\"x\":2,\"y\":3},"
+        "\"numbers\":[4,5],"
+        "\"names\":[\"x\"],"
+        "\"p\":[{\"x\":6,\"y\":7}]}");
+
+    // Round trip, indented
+    test_data_init(&data2);
+    g_assert(TestDataSchema::decode(TestDataSchema::encode(data, true),
+        &data2));
+    g_assert_cmpint(data2.count, == ,data.count);
+    g_assert_cmpint(data2.size, == ,data.size);
+    g_assert(data2.ratio == data.ratio);
+    g_assert(data2.enabled == data.enabled);
+    g_assert(data2.title == data.title);
+    g_assert_cmpint(data2.origin.x, == ,data.origin.x);
+    g_assert_cmpint(data2.origin.y, == ,data.origin.y);
+    g_assert(data2.numbers == data.numbers);
+    g_assert_cmpint(data2.names.count(), == ,1);
+    g_assert(data2.names.at(0) == data.names.at(0));
+    g_assert_cmpint(data2.points.count(), == ,1);
+    g_assert_cmpint(data2.points.at(0).x, == ,p.x);
+    g_assert_cmpint(data2.points.at(0).y, == ,p.y);
+
+    // Writing a nested object in the middle of something else
+    Writer writer;
+
+    writer.beginArray();
+    TestPointSchema::encode(writer, p);
+    writer.endArray();
+    g_assert_cmpstr(writer.data().constData(), == ,"[{\"x\":6,\"y\":7}]");
+}
+
+/*==========================================================================*
+ * schema/range
+ *==========================================================================*/
+
+enum TestMode { TestModeOff, TestModeOn };
+enum TestByte : unsigned char { TestByteMin, TestByteMax = 255 };
+
+struct TestRange {
+    qint8 s8;
+    quint16 u16;
+    quint32 u32;
+    TestMode mode;
+    TestByte byte;
+};
+
+typedef HarbourJsonSchema::Object<TestRange,
+    HARBOUR_JSON_FIELD(Int, TestRange, s8),
+    HARBOUR_JSON_FIELD(Int, TestRange, u16),
+    HARBOUR_JSON_FIELD(Int, TestRange, u32),
+    HARBOUR_JSON_FIELD(Int, TestRange, mode),
+    HARBOUR_JSON_FIELD(Int, TestRange, byte)> TestRangeSchema;
+
+static
+void
+test_schema_range(
+    void)
+{
+    static const char* valid = "{\"s8\":-128,\"u16\":65535,"
+        "\"u32\":4294967295,\"mode\":1,\"byte\":255}";
+    static const char* invalid[] = {
+        "{\"s8\":128}",
+        "{\"s8\":-129}",
+        "{\"u16\":-1}",
+        "{\"u16\":65536}",
+        "{\"u32\":4294967296}",
+        "{\"u32\":1e10}",
+        "{\"byte\":256}",
+        "{\"byte\":-1}"
+    };
+    TestRange r;
+
+    memset(&r, 0, sizeof(r));
+    g_assert(TestRangeSchema::decode(QByteArray(valid), &r));
+    g_assert_cmpint(r.s8, == ,-128);
+    g_assert_cmpuint(r.u16, == ,65535);
+    g_assert_cmpuint(r.u32, == ,0xffffffff);
+    g_assert_cmpint(r.mode, == ,TestModeOn);
+    g_assert_cmpint(r.byte, == ,TestByteMax);
+
+    for (guint i = 0; i < G_N_ELEMENTS(invalid); i++) {
+        memset(&r, 0, sizeof(r));
+        g_assert(!TestRangeSchema::decode(QByteArray(invalid[i]), &r));
+    }
+}
+
+/*==========================================================================*
+ * schema/file
+ *==========================================================================*/
+
+static
+void
+test_schema_file(
+    void)
+{
+    QTemporaryDir dir;
+    const QString path(dir.path() + "/data.json");
+    const QString missing(dir.path() + "/missing.json");
+    TestData data, data2;
+    QVariantMap map;
+    TestPoint p;
+
+    test_data_init(&data);
+    data.count = 3;
+    data.size = Q_INT64_C(9876543210);
+    data.ratio = 0.125;
+    data.enabled = true;
+    data.title = QString("Title");
+    data.origin.x = -5;
+    data.numbers.append(8);
+    data.names.append("y");
+    p.x = 1;
+    p.y = 2;
+    data.points.append(p);
+
+    g_assert(!TestDataSchema::load(missing, &data2));
+
+    // Both indented and compact
+    for (int i = 0; i < 2; i++) {
+        g_assert(TestDataSchema::save(path, data, i ?
+            HarbourJson::SaveCompact : HarbourJson::SaveAtomic));
+
+        test_data_init(&data2);
+        g_assert(TestDataSchema::load(path, &data2));
+        g_assert_cmpint(data2.count, == ,data.count);
+        g_assert_cmpint(data2.size, == ,data.size);
+        g_assert(data2.ratio == data.ratio);
+        g_assert(data2.enabled);
+        g_assert(data2.title == data.title);
+        g_assert_cmpint(data2.origin.x, == ,data.origin.x);
+        g_assert_cmpint(data2.origin.y, == ,data.origin.y);
+        g_assert(data2.numbers == data.numbers);
+        g_assert_cmpint(data2.names.count(), == ,1);
+        g_assert(data2.names.at(0) == data.names.at(0));
+        g_assert_cmpint(data2.points.count(), == ,1);
+        g_assert_cmpint(data2.points.at(0).x, == ,p.x);
+        g_assert_cmpint(data2.points.at(0).y, == ,p.y);
+
+        // It's a normal JSON file
+        g_assert(HarbourJson::load(path, map));
+        g_assert_cmpint(map.value("count").toInt(), == ,data.count);
+        g_assert(map.value("window-title").toString() == data.title);
+    }
+
+    // Loading again into the same struct doesn't duplicate anything
+    g_assert(TestDataSchema::load(path, &data2));
+    g_assert(data2.numbers == data.numbers);
+    g_assert_cmpint(data2.names.count(), == ,1);
+    g_assert_cmpint(data2.points.count(), == ,1);
+
+    // SaveIfChanged doesn't touch the file
+    g_assert(TestDataSchema::save(path, data, HarbourJson::SaveIfChanged |
+        HarbourJson::SaveCompact));
+
+    // Not a valid TestData
+    g_assert(HarbourJson::saveData(path, QByteArray("{\"count\":1.5}")));
+    test_data_init(&data2);
+    g_assert(!TestDataSchema::load(path, &data2));
+
+    // Empty file
+    g_assert(HarbourJson::saveData(path, QByteArray()));
+    g_assert(!TestDataSchema::load(path, &data2));
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_(name) "/HarbourJsonSchema/" name
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("reader/basic"), test_reader_basic);
+    g_test_add_func(TEST_("reader/string"), test_reader_string);
+    g_test_add_func(TEST_("reader/number"), test_reader_number);
+    g_test_add_func(TEST_("reader/error"), test_reader_error);
+    g_test_add_func(TEST_("reader/depth"), test_reader_depth);
+    g_test_add_func(TEST_("reader/skip"), test_reader_skip);
+    g_test_add_func(TEST_("writer/compact"), test_writer_compact);
+    g_test_add_func(TEST_("writer/indent"), test_writer_indent);
+    g_test_add_func(TEST_("writer/string"), test_writer_string);
+    g_test_add_func(TEST_("writer/number"), test_writer_number);
+    g_test_add_func(TEST_("writer/variant"), test_writer_variant);
+    g_test_add_func(TEST_("schema/decode"), test_schema_decode);
+    g_test_add_func(TEST_("schema/invalid"), test_schema_invalid);
+    g_test_add_func(TEST_("schema/encode"), test_schema_encode);
+    g_test_add_func(TEST_("schema/range"), test_schema_range);
+    g_test_add_func(TEST_("schema/file"), test_schema_file);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
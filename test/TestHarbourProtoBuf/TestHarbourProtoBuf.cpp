@@ -1,6 +1,6 @@
 /*
  * Copyright (C) 2022 Jolla Ltd.
- * Copyright (C) 2022 Slava Monich <slava.monich@jolla.com>
+ * Copyright (C) 2022-2026 Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -32,8 +32,14 @@
  */
 
 #include "HarbourProtoBuf.h"
+#include "HarbourProtoBufSchema.h"
+
+#include <QBuffer>
+#include <QList>
 
 #include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 /*==========================================================================*
  * null
@@ -49,8 +55,21 @@ test_null(
     g_assert(!HarbourProtoBuf::appendDelimitedValue(NULL, QByteArray()));
     g_assert(!HarbourProtoBuf::appendDelimitedKeyValue(NULL,
         HarbourProtoBuf::TYPE_DELIMITED, QByteArray()));
+    g_assert(!HarbourProtoBuf::appendSignedVarInt(NULL, 0));
+    g_assert(!HarbourProtoBuf::appendFixed32(NULL, 0));
+    g_assert(!HarbourProtoBuf::appendFixed64(NULL, 0));
+    g_assert(!HarbourProtoBuf::appendPackedVarIntKeyValue(NULL,
+        HarbourProtoBuf::TYPE_DELIMITED, NULL, 0));
+    g_assert(!HarbourProtoBuf::appendPackedFixed32KeyValue(NULL,
+        HarbourProtoBuf::TYPE_DELIMITED, NULL, 0));
     g_assert(!HarbourProtoBuf::parseVarInt(NULL, NULL));
+    g_assert(!HarbourProtoBuf::parseSignedVarInt(NULL, NULL));
+    g_assert(!HarbourProtoBuf::parseFixed32(NULL, NULL));
+    g_assert(!HarbourProtoBuf::parseFixed64(NULL, NULL));
     g_assert(!HarbourProtoBuf::parseDelimitedValue(NULL, NULL));
+    g_assert_cmpint(HarbourProtoBuf::parsePackedVarInt(NULL, NULL, 0), == ,-1);
+    g_assert_cmpint(HarbourProtoBuf::parsePackedFixed64(NULL, NULL, 0), == ,-1);
+    g_assert(!HarbourProtoBuf::skipField(NULL, 0));
 }
 
 /*==========================================================================*
@@ -144,6 +163,839 @@ test_delimited(
     g_assert(!memcmp(payload.bytes, value, sizeof(value)));
 }
 
+/*==========================================================================*
+ * varints
+ *==========================================================================*/
+
+static
+void
+test_varints_check(
+    const QByteArray aData,
+    int aMaxCount)
+{
+    GUtilRange r1, r2;
+    quint64* v1 = g_new(quint64, aMaxCount + 1);
+    quint64* v2 = g_new(quint64, aMaxCount + 1);
+    int n1 = 0, n2;
+
+    r1.ptr = r2.ptr = (const guint8*)aData.constData();
+    r1.end = r2.end = r1.ptr + aData.size();
+    while (n1 < aMaxCount && HarbourProtoBuf::parseVarInt(&r1, v1 + n1)) {
+        n1++;
+    }
+    n2 = HarbourProtoBuf::parseVarInts(&r2, v2, aMaxCount);
+    g_assert_cmpint(n1, == ,n2);
+    g_assert(r1.ptr == r2.ptr);
+    g_assert(!memcmp(v1, v2, sizeof(quint64) * n1));
+    g_free(v1);
+    g_free(v2);
+}
+
+static
+void
+test_varints(
+    void)
+{
+    static const quint64 maxValue[] = {
+        0x7f, 0x3fff, 0x1fffff, Q_UINT64_C(0xffffffffffffffff)
+    };
+    static const int sizeWeight[] = { 8, 6, 1, 1 };
+    QByteArray buf;
+    quint64 values[4];
+    GUtilRange range;
+
+    g_assert_cmpint(HarbourProtoBuf::parseVarInts(NULL, values, 4), == ,0);
+    g_assert_cmpint(HarbourProtoBuf::parseVarInts(&range, NULL, 4), == ,0);
+
+    // Mostly one and two byte values, which the vector code handles
+    srand(1);
+    for (int i = 0; i < 10000; i++) {
+        int w = rand() % 16, k = 0;
+
+        while (w >= sizeWeight[k]) {
+            w -= sizeWeight[k++];
+        }
+        HarbourProtoBuf::appendVarInt(&buf, (((quint64)rand() << 32) ^
+            rand()) & maxValue[k]);
+    }
+
+    test_varints_check(buf, 10000);
+    test_varints_check(buf, 9999);
+    test_varints_check(buf, 7);
+    test_varints_check(buf, 0);
+    for (int i = 1; i < 40; i++) {
+        // Truncated, possibly in the middle of a varint
+        test_varints_check(buf.left(buf.size() - i), 10000);
+        test_varints_check(buf.left(i), 10000);
+    }
+
+    // Overly long varint in the middle
+    QByteArray bad(buf.left(1000));
+    bad.append(QByteArray(11, (char)0x80));
+    bad.append(buf.mid(1000));
+    test_varints_check(bad, 10000);
+
+    // Packed field
+    const quint64 key = (1 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_DELIMITED;
+    QByteArray packed;
+    quint64* v = g_new(quint64, 10000);
+
+    HarbourProtoBuf::appendDelimitedKeyValue(&packed, key, buf);
+    range.ptr = (const guint8*)packed.constData() + 1;
+    range.end = (const guint8*)packed.constData() + packed.size();
+    g_assert_cmpint(HarbourProtoBuf::parsePackedVarInt(&range, v, 5000),
+        == ,10000);
+    g_assert(range.ptr == range.end);
+    range.ptr = (const guint8*)buf.constData();
+    range.end = range.ptr + buf.size();
+    for (int i = 0; i < 5000; i++) {
+        quint64 value;
+
+        g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+        g_assert_cmpuint(value, == ,v[i]);
+    }
+    g_free(v);
+}
+
+/*==========================================================================*
+ * zigzag
+ *==========================================================================*/
+
+static
+void
+test_zigzag(
+    void)
+{
+    static const struct {
+        qint64 value;
+        quint64 encoded;
+    } tests[] = {
+        { 0, 0 },
+        { -1, 1 },
+        { 1, 2 },
+        { -2, 3 },
+        { 2147483647, Q_UINT64_C(4294967294) },
+        { -2147483647 - 1, Q_UINT64_C(4294967295) },
+        { Q_INT64_C(0x7fffffffffffffff), Q_UINT64_C(0xfffffffffffffffe) },
+        { Q_INT64_C(-0x7fffffffffffffff) - 1, Q_UINT64_C(0xffffffffffffffff) }
+    };
+
+    for (uint i = 0; i < G_N_ELEMENTS(tests); i++) {
+        QByteArray buf;
+        GUtilRange range;
+        qint64 value = 42;
+
+        g_assert_cmpuint(HarbourProtoBuf::zigZagEncode(tests[i].value), == ,
+            tests[i].encoded);
+        g_assert_cmpint(HarbourProtoBuf::zigZagDecode(tests[i].encoded), == ,
+            tests[i].value);
+        g_assert(HarbourProtoBuf::appendSignedVarInt(&buf, tests[i].value));
+        range.ptr = (const guint8*)buf.constData();
+        range.end = range.ptr + buf.size();
+        g_assert(HarbourProtoBuf::parseSignedVarInt(&range, &value));
+        g_assert(range.ptr == range.end);
+        g_assert_cmpint(value, == ,tests[i].value);
+    }
+}
+
+/*==========================================================================*
+ * fixed
+ *==========================================================================*/
+
+static
+void
+test_fixed(
+    void)
+{
+    const quint64 key32 = (1 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_FIXED32;
+    const quint64 key64 = (2 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_FIXED64;
+    static const guint8 enc[] = {
+        0x0d, 0x04, 0x03, 0x02, 0x01,
+        0x11, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01
+    };
+    QByteArray buf;
+    GUtilRange range;
+    quint32 v32 = 0;
+    quint64 v64 = 0, key;
+
+    HarbourProtoBuf::appendFixed32KeyValue(&buf, key32, 0x01020304);
+    HarbourProtoBuf::appendFixed64KeyValue(&buf, key64,
+        Q_UINT64_C(0x0102030405060708));
+    g_assert(buf == QByteArray::fromRawData((char*)enc, sizeof(enc)));
+
+    range.end = (range.ptr = enc) + sizeof(enc);
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &key));
+    g_assert_cmpuint(key, == ,key32);
+    g_assert(HarbourProtoBuf::parseFixed32(&range, &v32));
+    g_assert_cmphex(v32, == ,0x01020304);
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &key));
+    g_assert_cmpuint(key, == ,key64);
+    g_assert(HarbourProtoBuf::parseFixed64(&range, &v64));
+    g_assert_cmphex(v64, == ,Q_UINT64_C(0x0102030405060708));
+    g_assert(range.ptr == range.end);
+
+    // Not enough data
+    range.end = (range.ptr = enc + 1) + 3;
+    g_assert(!HarbourProtoBuf::parseFixed32(&range, &v32));
+    g_assert(range.ptr == enc + 1);
+    range.end = (range.ptr = enc + 6) + 7;
+    g_assert(!HarbourProtoBuf::parseFixed64(&range, &v64));
+    g_assert(range.ptr == enc + 6);
+
+    // Writer produces the same thing
+    HarbourProtoBuf::Writer writer;
+    writer.appendFixed32KeyValue(key32, 0x01020304);
+    writer.appendFixed64KeyValue(key64, Q_UINT64_C(0x0102030405060708));
+    g_assert(writer.data() == buf);
+}
+
+/*==========================================================================*
+ * packed
+ *==========================================================================*/
+
+static
+void
+test_packed(
+    void)
+{
+    const quint64 key = (4 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_DELIMITED;
+    static const quint64 u[] = { 3, 270, 86942 };
+    static const qint64 s[] = { 0, -1, 1, -150, 150 };
+    static const quint32 f32[] = { 1, 0xffffffff };
+    static const quint64 f64[] = { 1, Q_UINT64_C(0xffffffffffffffff), 0 };
+    quint64 u2[G_N_ELEMENTS(u)];
+    qint64 s2[G_N_ELEMENTS(s)];
+    quint32 f32_2[G_N_ELEMENTS(f32)];
+    quint64 f64_2[G_N_ELEMENTS(f64)];
+    QByteArray buf;
+    GUtilRange range;
+    quint64 value;
+
+    HarbourProtoBuf::appendPackedVarIntKeyValue(&buf, key, u,
+        G_N_ELEMENTS(u));
+    HarbourProtoBuf::appendPackedSignedVarIntKeyValue(&buf, key, s,
+        G_N_ELEMENTS(s));
+    HarbourProtoBuf::appendPackedFixed32KeyValue(&buf, key, f32,
+        G_N_ELEMENTS(f32));
+    HarbourProtoBuf::appendPackedFixed64KeyValue(&buf, key, f64,
+        G_N_ELEMENTS(f64));
+    HarbourProtoBuf::appendPackedVarIntKeyValue(&buf, key, u, 0);
+
+    range.ptr = (const guint8*)buf.constData();
+    range.end = range.ptr + buf.size();
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpuint(value, == ,key);
+    g_assert_cmpint(HarbourProtoBuf::parsePackedVarInt(&range, u2,
+        G_N_ELEMENTS(u2)), == ,G_N_ELEMENTS(u));
+    g_assert(!memcmp(u, u2, sizeof(u)));
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+
+    // The array is too small, the values that don't fit are dropped
+    memset(s2, 0, sizeof(s2));
+    g_assert_cmpint(HarbourProtoBuf::parsePackedSignedVarInt(&range, s2, 2),
+        == ,G_N_ELEMENTS(s));
+    g_assert_cmpint(s2[0], == ,s[0]);
+    g_assert_cmpint(s2[1], == ,s[1]);
+    g_assert_cmpint(s2[2], == ,0);
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpint(HarbourProtoBuf::parsePackedFixed32(&range, f32_2,
+        G_N_ELEMENTS(f32_2)), == ,G_N_ELEMENTS(f32));
+    g_assert(!memcmp(f32, f32_2, sizeof(f32)));
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpint(HarbourProtoBuf::parsePackedFixed64(&range, f64_2,
+        G_N_ELEMENTS(f64_2)), == ,G_N_ELEMENTS(f64));
+    g_assert(!memcmp(f64, f64_2, sizeof(f64)));
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpint(HarbourProtoBuf::parsePackedVarInt(&range, NULL, 0),
+        == ,0);
+    g_assert(range.ptr == range.end);
+
+    // Malformed data doesn't advance the range
+    static const guint8 badVarInt[] = { 0x02, 0x01, 0x81 };
+    static const guint8 badFixed[] = { 0x03, 0x01, 0x02, 0x03 };
+
+    range.end = (range.ptr = badVarInt) + sizeof(badVarInt);
+    g_assert_cmpint(HarbourProtoBuf::parsePackedVarInt(&range, u2,
+        G_N_ELEMENTS(u2)), == ,-1);
+    g_assert_cmpint(HarbourProtoBuf::parsePackedSignedVarInt(&range, s2,
+        G_N_ELEMENTS(s2)), == ,-1);
+    g_assert(range.ptr == badVarInt);
+    range.end = (range.ptr = badFixed) + sizeof(badFixed);
+    g_assert_cmpint(HarbourProtoBuf::parsePackedFixed32(&range, f32_2,
+        G_N_ELEMENTS(f32_2)), == ,-1);
+    g_assert_cmpint(HarbourProtoBuf::parsePackedFixed64(&range, f64_2,
+        G_N_ELEMENTS(f64_2)), == ,-1);
+    g_assert(range.ptr == badFixed);
+}
+
+/*==========================================================================*
+ * skip
+ *==========================================================================*/
+
+static
+void
+test_skip(
+    void)
+{
+    static const guint8 msg[] = {
+        0x08, 0x96, 0x01,                           // 1: varint
+        0x11, 1, 2, 3, 4, 5, 6, 7, 8,               // 2: fixed64
+        0x1a, 0x02, 0x01, 0x02,                     // 3: delimited
+        0x25, 1, 2, 3, 4,                           // 4: fixed32
+        0x2b                                        // 5: start group
+    };
+    GUtilRange range;
+    quint64 key;
+    int n = 0;
+
+    range.end = (range.ptr = msg) + sizeof(msg);
+    while (HarbourProtoBuf::parseVarInt(&range, &key) &&
+        HarbourProtoBuf::skipField(&range, key)) {
+        n++;
+    }
+    g_assert_cmpint(n, == ,4);
+    g_assert(range.ptr == range.end);
+
+    // Truncated fields
+    range.end = (range.ptr = msg + 4) + 7;
+    g_assert(!HarbourProtoBuf::skipField(&range, 0x11));
+    range.end = (range.ptr = msg + 19) + 3;
+    g_assert(!HarbourProtoBuf::skipField(&range, 0x25));
+    g_assert(range.ptr == msg + 19);
+}
+
+/*==========================================================================*
+ * writer
+ *==========================================================================*/
+
+static
+void
+test_writer(
+    void)
+{
+    const quint64 keyInt = (1 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_VARINT;
+    const quint64 keyMsg = (2 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_DELIMITED;
+    const QByteArray bytes("test");
+    HarbourProtoBuf::Writer writer;
+    QByteArray inner, outer;
+
+    // Same thing as appending to QByteArray
+    g_assert(!writer.end());
+    writer.appendVarInt(0).appendVarInt(257).appendVarIntKeyValue(keyInt, 1);
+    writer.appendDelimitedValue(bytes).appendDelimitedKeyValue(keyMsg, bytes);
+    HarbourProtoBuf::appendVarInt(&outer, 0);
+    HarbourProtoBuf::appendVarInt(&outer, 257);
+    HarbourProtoBuf::appendVarIntKeyValue(&outer, keyInt, 1);
+    HarbourProtoBuf::appendDelimitedValue(&outer, bytes);
+    HarbourProtoBuf::appendDelimitedKeyValue(&outer, keyMsg, bytes);
+    g_assert_cmpint(writer.size(), == ,outer.size());
+    g_assert(writer.data() == outer);
+
+    // { 1: 1, 2: { 1: 300, 2: { 2: "test" } }, 1: 2 }
+    writer.clear();
+    g_assert_cmpint(writer.size(), == ,0);
+    writer.appendVarIntKeyValue(keyInt, 1);
+    writer.begin(keyMsg).appendVarIntKeyValue(keyInt, 300);
+    writer.begin(keyMsg).appendDelimitedKeyValue(keyMsg, bytes);
+    g_assert_cmpint(writer.depth(), == ,2);
+    g_assert(writer.end());
+    g_assert(writer.end());
+    g_assert(!writer.end());
+    g_assert_cmpint(writer.depth(), == ,0);
+    writer.appendVarIntKeyValue(keyInt, 2);
+
+    const QByteArray data(writer.data());
+    GUtilRange range, msg;
+    GUtilData payload;
+    quint64 value;
+
+    range.ptr = (const guint8*)data.constData();
+    range.end = range.ptr + data.size();
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpuint(value, == ,keyInt);
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpuint(value, == ,1);
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpuint(value, == ,keyMsg);
+    g_assert(HarbourProtoBuf::parseDelimitedValue(&range, &payload));
+    msg.end = (msg.ptr = payload.bytes) + payload.size;
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpuint(value, == ,keyInt);
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpuint(value, == ,2);
+    g_assert(range.ptr == range.end);
+
+    // Inner message
+    HarbourProtoBuf::appendDelimitedKeyValue(&inner, keyMsg, bytes);
+    g_assert(HarbourProtoBuf::parseVarInt(&msg, &value));
+    g_assert_cmpuint(value, == ,keyInt);
+    g_assert(HarbourProtoBuf::parseVarInt(&msg, &value));
+    g_assert_cmpuint(value, == ,300);
+    g_assert(HarbourProtoBuf::parseVarInt(&msg, &value));
+    g_assert_cmpuint(value, == ,keyMsg);
+    g_assert(HarbourProtoBuf::parseDelimitedValue(&msg, &payload));
+    g_assert(msg.ptr == msg.end);
+    g_assert(QByteArray((char*)payload.bytes, payload.size) == inner);
+
+    // Large nested message
+    QByteArray large;
+    writer.clear();
+    writer.begin(keyMsg);
+    for (int i = 0; i < 100000; i++) {
+        writer.appendVarInt(i);
+        HarbourProtoBuf::appendVarInt(&large, i);
+    }
+    g_assert(writer.end());
+    outer = writer.data();
+    range.ptr = (const guint8*)outer.constData();
+    range.end = range.ptr + outer.size();
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpuint(value, == ,keyMsg);
+    g_assert(HarbourProtoBuf::parseDelimitedValue(&range, &payload));
+    g_assert(range.ptr == range.end);
+    g_assert(QByteArray((char*)payload.bytes, payload.size) == large);
+}
+
+/*==========================================================================*
+ * stream
+ *==========================================================================*/
+
+class TestStreamListener :
+    public HarbourProtoBuf::StreamParser::Listener
+{
+public:
+    TestStreamListener() : iChunks(0) {}
+
+    void log(char aType, quint64 aKey, quint64 aValue)
+    {
+        char buf[64];
+
+        snprintf(buf, sizeof(buf), "%c%llu:%llu;", aType,
+            (unsigned long long)aKey, (unsigned long long)aValue);
+        iLog.append(buf);
+    }
+
+    void varIntField(quint64 aKey, quint64 aValue) Q_DECL_OVERRIDE
+    {
+        log('v', aKey, aValue);
+    }
+
+    void fixed32Field(quint64 aKey, quint32 aValue) Q_DECL_OVERRIDE
+    {
+        log('f', aKey, aValue);
+    }
+
+    void fixed64Field(quint64 aKey, quint64 aValue) Q_DECL_OVERRIDE
+    {
+        log('F', aKey, aValue);
+    }
+
+    void delimitedField(quint64 aKey, quint64 aSize, quint64 aOffset,
+        const GUtilData* aChunk) Q_DECL_OVERRIDE
+    {
+        if (!aOffset) {
+            log('d', aKey, aSize);
+            iPayload.clear();
+        }
+        g_assert_cmpuint(aOffset, == ,iPayload.size());
+        g_assert_cmpuint(aOffset + aChunk->size, <= ,aSize);
+        iPayload.append((const char*)aChunk->bytes, aChunk->size);
+        iChunks++;
+        if (aOffset + aChunk->size == aSize) {
+            iPayloads.append(iPayload);
+        }
+    }
+
+public:
+    QByteArray iLog;
+    QByteArray iPayload;
+    QList<QByteArray> iPayloads;
+    int iChunks;
+};
+
+static
+void
+test_stream(
+    void)
+{
+    const int chunk = 7;
+    const quint64 keyVarInt = (1 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_VARINT;
+    const quint64 keyFixed32 = (2 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_FIXED32;
+    const quint64 keyFixed64 = (3 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_FIXED64;
+    const quint64 keyDelimited = (4 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_DELIMITED;
+    const QByteArray small("small");
+    QByteArray large;
+    HarbourProtoBuf::Writer writer;
+
+    for (int i = 0; i < 100; i++) {
+        large.append((char)i);
+    }
+    writer.appendVarIntKeyValue(keyVarInt, 300);
+    writer.appendFixed32KeyValue(keyFixed32, 0x01020304);
+    writer.appendDelimitedKeyValue(keyDelimited, small);
+    writer.appendFixed64KeyValue(keyFixed64, Q_UINT64_C(0x0102030405060708));
+    writer.appendDelimitedKeyValue(keyDelimited, QByteArray());
+    writer.appendDelimitedKeyValue(keyDelimited, large);
+    writer.appendVarIntKeyValue(keyVarInt, Q_UINT64_C(0xffffffffffffffff));
+
+    const QByteArray data(writer.data());
+    const QByteArray log("v8:300;f21:16909060;d34:5;F25:72623859790382856;"
+        "d34:0;d34:100;v8:18446744073709551615;");
+
+    // All at once
+    TestStreamListener l1;
+    HarbourProtoBuf::StreamParser p1(&l1, chunk);
+
+    g_assert(p1.atFieldBoundary());
+    g_assert(p1.parse(data.constData(), data.size()));
+    g_assert(p1.atFieldBoundary());
+    g_assert(!p1.isFailed());
+    g_assert_cmpuint(p1.position(), == ,data.size());
+    g_assert(l1.iLog == log);
+    g_assert_cmpint(l1.iPayloads.size(), == ,3);
+    g_assert(l1.iPayloads.at(0) == small);
+    g_assert(l1.iPayloads.at(1).isEmpty());
+    g_assert(l1.iPayloads.at(2) == large);
+    // Small one in one piece, the empty one and then the large one
+    g_assert_cmpint(l1.iChunks, == ,1 + 1 + (100 + chunk - 1) / chunk);
+
+    // Byte by byte
+    TestStreamListener l2;
+    HarbourProtoBuf::StreamParser p2(&l2, chunk);
+
+    for (int i = 0; i < data.size(); i++) {
+        g_assert(p2.parse(data.constData() + i, 1));
+        g_assert_cmpuint(p2.position(), == ,i + 1);
+    }
+    g_assert(p2.atFieldBoundary());
+    g_assert(l2.iLog == log);
+    g_assert_cmpint(l2.iChunks, == ,l1.iChunks);
+    g_assert(l2.iPayloads == l1.iPayloads);
+
+    // Random pieces
+    srand(2);
+    for (int k = 0; k < 20; k++) {
+        TestStreamListener l;
+        HarbourProtoBuf::StreamParser p(&l, chunk);
+        int pos = 0;
+
+        while (pos < data.size()) {
+            const int n = qMin(rand() % 20, data.size() - pos);
+
+            g_assert(p.parse(data.constData() + pos, n));
+            pos += n;
+        }
+        g_assert(p.atFieldBoundary());
+        g_assert(l.iLog == log);
+        g_assert(l.iPayloads == l1.iPayloads);
+    }
+
+    // From QIODevice
+    QByteArray bufData(data);
+    QBuffer buf(&bufData);
+    TestStreamListener l3;
+    HarbourProtoBuf::StreamParser p3(&l3);
+
+    g_assert(p3.parse((QIODevice*)NULL));
+    buf.open(QIODevice::ReadOnly);
+    g_assert(p3.parse(&buf));
+    g_assert(p3.atFieldBoundary());
+    g_assert(l3.iLog == log);
+    g_assert_cmpint(l3.iChunks, == ,3);
+
+    // Truncated input
+    HarbourProtoBuf::StreamParser p4(NULL);
+
+    g_assert(p4.parse(data.constData(), data.size() - 1));
+    g_assert(!p4.atFieldBoundary());
+
+    // Unsupported wire type and overly long varint
+    static const guint8 group[] = { 0x0b };
+    static const guint8 tooLong[] = {
+        0x08, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01
+    };
+
+    p4.reset();
+    g_assert(!p4.parse(group, sizeof(group)));
+    g_assert(p4.isFailed());
+    g_assert(!p4.parse(data.constData(), data.size()));
+    p4.reset();
+    g_assert(!p4.parse(tooLong, sizeof(tooLong)));
+    g_assert_cmpuint(p4.position(), == ,sizeof(tooLong) - 1);
+}
+
+/*==========================================================================*
+ * index
+ *==========================================================================*/
+
+static
+void
+test_index(
+    void)
+{
+    const quint64 key1 = (1 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_VARINT;
+    const quint64 key2 = (2 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_DELIMITED;
+    const quint64 key3 = (3 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_FIXED32;
+    HarbourProtoBuf::Writer writer;
+    HarbourProtoBuf::Index index;
+    const HarbourProtoBuf::Index::Field* field;
+    GUtilData msg, value;
+    GUtilRange range;
+    quint64 v;
+    quint32 v32;
+
+    g_assert(!index.build(NULL));
+    g_assert_cmpint(index.count(), == ,0);
+    g_assert(!index.find(1));
+    g_assert(!index.fieldAt(0));
+    g_assert_cmpint(index.findAll(1, NULL), == ,0);
+    value = index.value(NULL);
+    g_assert(!value.bytes);
+    g_assert_cmpuint(value.size, == ,0);
+
+    // Fields out of order, some repeated
+    writer.appendDelimitedKeyValue(key2, QByteArray("a"));
+    writer.appendFixed32KeyValue(key3, 42);
+    writer.appendVarIntKeyValue(key1, 300);
+    writer.appendDelimitedKeyValue(key2, QByteArray("bc"));
+    writer.appendVarIntKeyValue(key1, 1);
+    writer.appendDelimitedKeyValue(key2, QByteArray("def"));
+
+    const QByteArray data(writer.data());
+
+    msg.bytes = (const guint8*)data.constData();
+    msg.size = data.size();
+    g_assert(index.build(&msg));
+    g_assert_cmpint(index.count(), == ,6);
+    g_assert(!index.find(4));
+    g_assert(!index.find(0));
+
+    g_assert_cmpint(index.findAll(1, &field), == ,2);
+    g_assert_cmpint(field[0].type, == ,HarbourProtoBuf::TYPE_VARINT);
+    range = index.range(field);
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &v));
+    g_assert(range.ptr == range.end);
+    g_assert_cmpuint(v, == ,300);
+    range = index.range(field + 1);
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &v));
+    g_assert_cmpuint(v, == ,1);
+
+    g_assert_cmpint(index.findAll(2, &field), == ,3);
+    g_assert(field == index.fieldAt(2));
+    value = index.value(field);
+    g_assert(value.bytes == msg.bytes + 2);
+    g_assert_cmpuint(value.size, == ,1);
+    g_assert(!memcmp(value.bytes, "a", 1));
+    value = index.value(field + 1);
+    g_assert_cmpuint(value.size, == ,2);
+    g_assert(!memcmp(value.bytes, "bc", 2));
+    value = index.value(field + 2);
+    g_assert_cmpuint(value.size, == ,3);
+    g_assert(!memcmp(value.bytes, "def", 3));
+
+    field = index.find(3);
+    g_assert(field);
+    g_assert_cmpint(field->tag, == ,3);
+    g_assert_cmpint(field->type, == ,HarbourProtoBuf::TYPE_FIXED32);
+    g_assert_cmpuint(field->length, == ,4);
+    range = index.range(field);
+    g_assert(HarbourProtoBuf::parseFixed32(&range, &v32));
+    g_assert_cmpuint(v32, == ,42);
+
+    // Malformed message
+    msg.size--;
+    g_assert(!index.build(&msg));
+    g_assert_cmpint(index.count(), == ,0);
+
+    // Empty message
+    msg.size = 0;
+    g_assert(index.build(&msg));
+    g_assert_cmpint(index.count(), == ,0);
+}
+
+/*==========================================================================*
+ * schema
+ *==========================================================================*/
+
+struct TestPoint {
+    qint32 x;
+    qint32 y;
+    QString label;
+};
+
+typedef HarbourProtoBufSchema::Message<TestPoint,
+    HARBOUR_PROTOBUF_FIELD(1, SInt, TestPoint, x),
+    HARBOUR_PROTOBUF_FIELD(2, SInt, TestPoint, y),
+    HARBOUR_PROTOBUF_FIELD(3, String, TestPoint, label)> TestPointSchema;
+
+struct TestShape {
+    quint64 id;
+    bool closed;
+    float scale;
+    double angle;
+    quint32 color;
+    qint64 time;
+    qint32 level;
+    QByteArray blob;
+    TestPoint origin;
+    QVector<TestPoint> points;
+    QVector<qint32> deltas;
+    QList<QString> tags;
+};
+
+typedef HarbourProtoBufSchema::Message<TestShape,
+    HARBOUR_PROTOBUF_FIELD(1, UInt, TestShape, id),
+    HARBOUR_PROTOBUF_FIELD(2, Bool, TestShape, closed),
+    HARBOUR_PROTOBUF_FIELD(3, Float, TestShape, scale),
+    HARBOUR_PROTOBUF_FIELD(4, Double, TestShape, angle),
+    HARBOUR_PROTOBUF_FIELD(5, Fixed32, TestShape, color),
+    HARBOUR_PROTOBUF_FIELD(6, Fixed64, TestShape, time),
+    HARBOUR_PROTOBUF_FIELD(7, UInt, TestShape, level),
+    HARBOUR_PROTOBUF_FIELD(8, Bytes, TestShape, blob),
+    HARBOUR_PROTOBUF_FIELD(9, Nested<TestPointSchema>, TestShape, origin),
+    HARBOUR_PROTOBUF_REPEATED(10, Nested<TestPointSchema>, TestShape, points),
+    HARBOUR_PROTOBUF_REPEATED(11, SInt, TestShape, deltas),
+    HARBOUR_PROTOBUF_REPEATED(12, String, TestShape, tags)> TestShapeSchema;
+
+static
+void
+test_schema_init_point(
+    TestPoint* aPoint,
+    qint32 aX,
+    qint32 aY,
+    const char* aLabel)
+{
+    aPoint->x = aX;
+    aPoint->y = aY;
+    aPoint->label = QString::fromUtf8(aLabel);
+}
+
+static
+bool
+test_schema_equal_points(
+    const TestPoint& aPoint1,
+    const TestPoint& aPoint2)
+{
+    return aPoint1.x == aPoint2.x && aPoint1.y == aPoint2.y &&
+        aPoint1.label == aPoint2.label;
+}
+
+static
+void
+test_schema(
+    void)
+{
+    TestShape in, out;
+    TestPoint p;
+
+    in.id = Q_UINT64_C(1234567890123);
+    in.closed = true;
+    in.scale = 1.5f;
+    in.angle = -0.25;
+    in.color = 0xff00ff00;
+    in.time = -2;
+    in.level = -1;
+    in.blob = QByteArray("\x01\x02\x03");
+    test_schema_init_point(&in.origin, -10, 20, "origin");
+    test_schema_init_point(&p, 1, 2, "");
+    in.points.append(p);
+    test_schema_init_point(&p, -3, 4, "\xd1\x82\xd0\xbe\xd1\x87\xd0\xba\xd0\xb0");
+    in.points.append(p);
+    in.deltas.append(0);
+    in.deltas.append(-1);
+    in.deltas.append(150);
+    in.deltas.append(-2147483647 - 1);
+    in.tags.append(QString::fromUtf8("a"));
+    in.tags.append(QString());
+
+    const QByteArray data(TestShapeSchema::encode(in));
+
+    out.id = 0;
+    out.closed = false;
+    out.scale = 0;
+    out.angle = 0;
+    out.color = 0;
+    out.time = 0;
+    out.level = 0;
+    test_schema_init_point(&out.origin, 0, 0, "");
+    g_assert(TestShapeSchema::decode(data, &out));
+    g_assert_cmpuint(out.id, == ,in.id);
+    g_assert(out.closed);
+    g_assert(out.scale == in.scale);
+    g_assert(out.angle == in.angle);
+    g_assert_cmpuint(out.color, == ,in.color);
+    g_assert_cmpint(out.time, == ,in.time);
+    g_assert_cmpint(out.level, == ,in.level);
+    g_assert(out.blob == in.blob);
+    g_assert(test_schema_equal_points(out.origin, in.origin));
+    g_assert_cmpint(out.points.size(), == ,in.points.size());
+    for (int i = 0; i < in.points.size(); i++) {
+        g_assert(test_schema_equal_points(out.points.at(i), in.points.at(i)));
+    }
+    g_assert_cmpint(out.deltas.size(), == ,in.deltas.size());
+    for (int i = 0; i < in.deltas.size(); i++) {
+        g_assert_cmpint(out.deltas.at(i), == ,in.deltas.at(i));
+    }
+    g_assert(out.tags == in.tags);
+
+    // Negative int32 takes 10 bytes, just like in protobuf
+    GUtilRange range;
+    quint64 value;
+    const quint64 levelKey = (7 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_VARINT;
+    HarbourProtoBuf::Index index;
+    GUtilData msg;
+
+    msg.bytes = (const guint8*)data.constData();
+    msg.size = data.size();
+    g_assert(index.build(&msg));
+    range = index.range(index.find(7));
+    g_assert_cmpuint(range.end - range.ptr, == ,10);
+    g_assert(HarbourProtoBuf::parseVarInt(&range, &value));
+    g_assert_cmpuint(value, == ,Q_UINT64_C(0xffffffffffffffff));
+
+    // Unpacked repeated scalars and unknown fields are fine too
+    HarbourProtoBuf::Writer writer;
+    TestShape shape;
+    const quint64 deltaKey = (11 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_VARINT;
+    const quint64 unknownKey = (100 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_FIXED32;
+
+    writer.appendSignedVarIntKeyValue(deltaKey, -5);
+    writer.appendFixed32KeyValue(unknownKey, 0);
+    writer.appendSignedVarIntKeyValue(deltaKey, 5);
+    writer.appendVarIntKeyValue(levelKey, 3);
+    shape.level = 0;
+    g_assert(TestShapeSchema::decode(writer.data(), &shape));
+    g_assert_cmpint(shape.level, == ,3);
+    g_assert_cmpint(shape.deltas.size(), == ,2);
+    g_assert_cmpint(shape.deltas.at(0), == ,-5);
+    g_assert_cmpint(shape.deltas.at(1), == ,5);
+
+    // Wire type mismatch
+    writer.clear();
+    writer.appendFixed32KeyValue((7 << HarbourProtoBuf::TYPE_SHIFT) |
+        HarbourProtoBuf::TYPE_FIXED32, 3);
+    g_assert(!TestShapeSchema::decode(writer.data(), &shape));
+
+    // Truncated
+    g_assert(!TestShapeSchema::decode(data.left(data.size() - 1), &shape));
+}
+
 /*==========================================================================*
  * Common
  *==========================================================================*/
@@ -156,6 +1008,15 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("null"), test_null);
     g_test_add_func(TEST_("int"), test_int);
     g_test_add_func(TEST_("delimited"), test_delimited);
+    g_test_add_func(TEST_("varints"), test_varints);
+    g_test_add_func(TEST_("zigzag"), test_zigzag);
+    g_test_add_func(TEST_("fixed"), test_fixed);
+    g_test_add_func(TEST_("packed"), test_packed);
+    g_test_add_func(TEST_("skip"), test_skip);
+    g_test_add_func(TEST_("writer"), test_writer);
+    g_test_add_func(TEST_("stream"), test_stream);
+    g_test_add_func(TEST_("index"), test_index);
+    g_test_add_func(TEST_("schema"), test_schema);
     return g_test_run();
 }
 
@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourTask.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
+#include <glib.h>
+
+static QThreadPool* test_pool = Q_NULLPTR;
+static HarbourTask* test_early_task = Q_NULLPTR;
+
+/*==========================================================================*
+ * TestTask
+ *==========================================================================*/
+
+class TestTask :
+    public HarbourTask
+{
+public:
+    TestTask(QThreadPool* aPool) : HarbourTask(aPool), iPerformed(false) {}
+
+protected:
+    void performTask() Q_DECL_OVERRIDE { iPerformed = true; }
+
+public:
+    bool iPerformed;
+};
+
+/*==========================================================================*
+ * TestReceiver
+ *==========================================================================*/
+
+class TestReceiver :
+    public QObject
+{
+    Q_OBJECT
+
+public:
+    TestReceiver(int aExpected) :
+        iExpected(aExpected),
+        iDeletePool(Q_NULLPTR),
+        iQuitTask(Q_NULLPTR),
+        iDestroyed(0)
+    {}
+
+    void
+    wait()
+    {
+        if (iDone.count() < iExpected) {
+            iLoop.exec();
+        }
+    }
+
+public Q_SLOTS:
+    void
+    onDone()
+    {
+        iDone.append(qobject_cast<HarbourTask*>(sender()));
+        if (iDeletePool) {
+            // Destroys the tasks which may be waiting in the same batch
+            delete iDeletePool;
+            iDeletePool = Q_NULLPTR;
+        }
+        if (iDone.count() == iExpected) {
+            iLoop.quit();
+        }
+    }
+
+    void
+    onDestroyed()
+    {
+        iDestroyed++;
+    }
+
+    void
+    onAboutToQuit()
+    {
+        iQuitTask = new TestTask(test_pool);
+        iQuitTask->submit(this, SLOT(onDone()));
+    }
+
+public:
+    const int iExpected;
+    QEventLoop iLoop;
+    QList<HarbourTask*> iDone;
+    QThreadPool* iDeletePool;
+    TestTask* iQuitTask;
+    int iDestroyed;
+};
+
+/*==========================================================================*
+ * basic
+ *==========================================================================*/
+
+static
+void
+test_basic(
+    void)
+{
+    TestReceiver receiver(1);
+    TestTask* task = new TestTask(test_pool);
+
+    g_assert(!task->isStarted());
+    g_assert(!task->isCanceled());
+    task->submit(&receiver, SLOT(onDone()));
+    receiver.wait();
+    g_assert_cmpint(receiver.iDone.count(), == ,1);
+    g_assert(receiver.iDone.at(0) == task);
+    g_assert(task->isStarted());
+    g_assert(task->iPerformed);
+    task->release();
+
+    // Released before it has been submitted
+    task = new TestTask(test_pool);
+    task->connect(task, SIGNAL(destroyed()), &receiver, SLOT(onDestroyed()));
+    task->release();
+    g_assert_cmpint(receiver.iDestroyed, == ,1);
+}
+
+/*==========================================================================*
+ * order
+ *==========================================================================*/
+
+static
+void
+test_order(
+    void)
+{
+    // The whole lot finishes before the main thread gets to drain
+    // the stack, they still have to be completed in the right order
+    const int n = 10;
+    QThreadPool pool;
+    TestReceiver receiver(n);
+    QList<HarbourTask*> tasks;
+
+    pool.setMaxThreadCount(1);
+    for (int i = 0; i < n; i++) {
+        HarbourTask* task = new TestTask(&pool);
+
+        task->submit(&receiver, SLOT(onDone()));
+        tasks.append(task);
+    }
+    pool.waitForDone();
+    receiver.wait();
+    g_assert(receiver.iDone == tasks);
+    for (int i = 0; i < n; i++) {
+        tasks.at(i)->release();
+    }
+}
+
+/*==========================================================================*
+ * stress
+ *==========================================================================*/
+
+static
+void
+test_stress(
+    void)
+{
+    // Many producers racing each other
+    const int n = 2000;
+    QThreadPool pool;
+    TestReceiver receiver(n);
+    QList<HarbourTask*> tasks;
+
+    pool.setMaxThreadCount(8);
+    for (int i = 0; i < n; i++) {
+        HarbourTask* task = new TestTask(&pool);
+
+        task->submit(&receiver, SLOT(onDone()));
+        tasks.append(task);
+    }
+    receiver.wait();
+    g_assert_cmpint(receiver.iDone.count(), == ,n);
+    for (int i = 0; i < n; i++) {
+        HarbourTask* task = tasks.at(i);
+
+        g_assert_cmpint(receiver.iDone.count(task), == ,1);
+        task->release();
+    }
+}
+
+/*==========================================================================*
+ * removeFromBatch
+ *==========================================================================*/
+
+static
+void
+test_removeFromBatch(
+    void)
+{
+    QThreadPool* pool2 = new QThreadPool;
+    TestReceiver receiver(2);
+    HarbourTask* task1 = new TestTask(test_pool);
+    HarbourTask* task2 = new TestTask(pool2);
+    HarbourTask* task3 = new TestTask(test_pool);
+
+    // All three end up in the same batch, the first completion
+    // handler destroys the second task together with its pool
+    task2->connect(task2, SIGNAL(destroyed()), &receiver, SLOT(onDestroyed()));
+    task1->submit(&receiver, SLOT(onDone()));
+    test_pool->waitForDone();
+    task2->submit();
+    pool2->waitForDone();
+    task3->submit(&receiver, SLOT(onDone()));
+    test_pool->waitForDone();
+
+    receiver.iDeletePool = pool2;
+    receiver.wait();
+    g_assert_cmpint(receiver.iDestroyed, == ,1);
+    g_assert_cmpint(receiver.iDone.count(), == ,2);
+    g_assert(receiver.iDone.at(0) == task1);
+    g_assert(receiver.iDone.at(1) == task3);
+    task1->release();
+    task3->release();
+}
+
+/*==========================================================================*
+ * removeFromStack
+ *==========================================================================*/
+
+static
+void
+test_removeFromStack(
+    void)
+{
+    QThreadPool* pool2 = new QThreadPool;
+    TestReceiver receiver(1);
+    HarbourTask* task1 = new TestTask(pool2);
+    HarbourTask* task2 = new TestTask(test_pool);
+    HarbourTask* task3 = new TestTask(pool2);
+
+    // The stack is [task3, task2, task1] when the pool goes away,
+    // that removes both ends of it and leaves task2 alone
+    task1->submit();
+    pool2->waitForDone();
+    task2->submit(&receiver, SLOT(onDone()));
+    test_pool->waitForDone();
+    task3->submit();
+    pool2->waitForDone();
+    delete pool2;
+
+    receiver.wait();
+    g_assert_cmpint(receiver.iDone.count(), == ,1);
+    g_assert(receiver.iDone.at(0) == task2);
+    task2->release();
+}
+
+/*==========================================================================*
+ * aboutToQuit
+ *==========================================================================*/
+
+static
+void
+test_aboutToQuit(
+    void)
+{
+    // This one has been created before QCoreApplication
+    HarbourTask* task = test_early_task;
+    HarbourTask* task2 = new TestTask(test_pool);
+    TestTask* task3;
+    TestReceiver receiver(2);
+
+    g_assert(!task->isCanceled());
+    g_assert(!task2->isCanceled());
+    receiver.connect(qApp, SIGNAL(aboutToQuit()), SLOT(onAboutToQuit()));
+    QTimer::singleShot(0, qApp, SLOT(quit()));
+    QCoreApplication::exec();
+    g_assert(task->isCanceled());
+    g_assert(task2->isCanceled());
+
+    // Tasks created by the aboutToQuit handler and after that still run
+    g_assert(receiver.iQuitTask);
+    g_assert(!receiver.iQuitTask->isCanceled());
+    task3 = new TestTask(test_pool);
+    task3->submit(&receiver, SLOT(onDone()));
+    receiver.wait();
+    g_assert(receiver.iQuitTask->iPerformed);
+    g_assert(task3->iPerformed);
+    g_assert(!task3->isCanceled());
+
+    test_early_task = Q_NULLPTR;
+    task->release();
+    task2->release();
+    task3->release();
+    receiver.iQuitTask->release();
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_(name) "/HarbourTask/" name
+
+int main(int argc, char* argv[])
+{
+    QThreadPool pool;
+    int ret;
+
+    // Before QCoreApplication on purpose
+    test_early_task = new TestTask(&pool);
+
+    QCoreApplication app(argc, argv);
+
+    test_pool = &pool;
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("order"), test_order);
+    g_test_add_func(TEST_("stress"), test_stress);
+    g_test_add_func(TEST_("removeFromBatch"), test_removeFromBatch);
+    g_test_add_func(TEST_("removeFromStack"), test_removeFromStack);
+    // Must be the last one, the existing tasks are canceled after that
+    g_test_add_func(TEST_("aboutToQuit"), test_aboutToQuit);
+    ret = g_test_run();
+    pool.waitForDone();
+    test_pool = Q_NULLPTR;
+    return ret;
+}
+
+#include "TestHarbourTask.moc"
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HarbourTask.h"
+#include "HarbourTaskScheduler.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+
+#include <glib.h>
+
+typedef HarbourTaskScheduler Scheduler;
+
+static QMutex test_mutex;
+static QList<HarbourTask*> test_started;
+static QAtomicInt test_running;
+static QAtomicInt test_max_running;
+
+/*==========================================================================*
+ * TestTask
+ *==========================================================================*/
+
+class TestTask :
+    public HarbourTask
+{
+public:
+    TestTask(QThreadPool* aPool, QSemaphore* aGate = Q_NULLPTR) :
+        HarbourTask(aPool), iGate(aGate), iPerformed(false) {}
+
+protected:
+    void performTask() Q_DECL_OVERRIDE;
+
+public:
+    QSemaphore* iGate;
+    bool iPerformed;
+};
+
+void
+TestTask::performTask()
+{
+    const int running = test_running.fetchAndAddOrdered(1) + 1;
+    int max;
+
+    do {
+        max = test_max_running.loadAcquire();
+    } while (running > max &&
+        !test_max_running.testAndSetOrdered(max, running));
+
+    test_mutex.lock();
+    test_started.append(this);
+    test_mutex.unlock();
+    if (iGate) {
+        iGate->acquire();
+    }
+    iPerformed = true;
+    test_running.fetchAndAddOrdered(-1);
+}
+
+/*==========================================================================*
+ * TestReceiver
+ *==========================================================================*/
+
+class TestReceiver :
+    public QObject
+{
+    Q_OBJECT
+
+public:
+    TestReceiver(int aExpected) :
+        iExpected(aExpected)
+    {}
+
+    void
+    wait()
+    {
+        if (iDone.count() < iExpected) {
+            iLoop.exec();
+        }
+    }
+
+public Q_SLOTS:
+    void
+    onDone()
+    {
+        iDone.append(qobject_cast<HarbourTask*>(sender()));
+        if (iDone.count() == iExpected) {
+            iLoop.quit();
+        }
+    }
+
+public:
+    const int iExpected;
+    QEventLoop iLoop;
+    QList<HarbourTask*> iDone;
+};
+
+static
+void
+test_reset(
+    void)
+{
+    test_started.clear();
+    test_running = 0;
+    test_max_running = 0;
+}
+
+static
+void
+test_release(
+    const QList<HarbourTask*> aTasks)
+{
+    for (int i = 0; i < aTasks.count(); i++) {
+        aTasks.at(i)->release();
+    }
+}
+
+/*==========================================================================*
+ * priority
+ *==========================================================================*/
+
+static
+void
+test_priority(
+    void)
+{
+    QThreadPool pool;
+    Scheduler scheduler(&pool);
+    QSemaphore gate;
+    TestReceiver receiver(6);
+    TestTask* busy = new TestTask(&pool, &gate);
+    TestTask* idle = new TestTask(&pool);
+    TestTask* background = new TestTask(&pool);
+    TestTask* normal1 = new TestTask(&pool);
+    TestTask* visible = new TestTask(&pool);
+    TestTask* normal2 = new TestTask(&pool);
+    QList<HarbourTask*> expected;
+
+    test_reset();
+    pool.setMaxThreadCount(1);
+    g_assert(scheduler.threadPool() == &pool);
+
+    // The first one occupies the only thread, the rest get queued
+    scheduler.submit(busy, &receiver, SLOT(onDone()));
+    scheduler.submit(idle, &receiver, SLOT(onDone()), Scheduler::PriorityIdle);
+    scheduler.submit(background, &receiver, SLOT(onDone()),
+        Scheduler::PriorityBackground);
+    scheduler.submit(normal1, &receiver, SLOT(onDone()));
+    scheduler.submit(visible, &receiver, SLOT(onDone()),
+        Scheduler::PriorityVisible);
+    scheduler.submit(normal2, &receiver, SLOT(onDone()));
+    g_assert_cmpint(scheduler.runningCount(), == ,1);
+    g_assert_cmpint(scheduler.queuedCount(), == ,5);
+    g_assert(!scheduler.isQueued(busy));
+    g_assert(scheduler.isQueued(idle));
+
+    // Bumped to the end of the visible queue
+    g_assert(scheduler.setPriority(idle, Scheduler::PriorityVisible));
+    g_assert(!scheduler.setPriority(busy, Scheduler::PriorityIdle));
+
+    gate.release();
+    receiver.wait();
+
+    expected << busy << visible << idle << normal1 << normal2 << background;
+    g_assert(test_started == expected);
+    g_assert(receiver.iDone == expected);
+    g_assert_cmpint(scheduler.runningCount(), == ,0);
+    g_assert_cmpint(scheduler.queuedCount(), == ,0);
+    test_release(expected);
+}
+
+/*==========================================================================*
+ * dedup
+ *==========================================================================*/
+
+static
+void
+test_dedup(
+    void)
+{
+    const QString key("key");
+    QThreadPool pool;
+    Scheduler scheduler(&pool);
+    QSemaphore gate;
+    TestReceiver receiver(3);
+    TestTask* busy = new TestTask(&pool, &gate);
+    TestTask* task1 = new TestTask(&pool);
+    TestTask* task2 = new TestTask(&pool);
+
+    test_reset();
+    pool.setMaxThreadCount(1);
+    scheduler.submit(busy, &receiver, SLOT(onDone()));
+    scheduler.submit(task1, &receiver, SLOT(onDone()),
+        Scheduler::PriorityNormal, key);
+    g_assert(scheduler.isQueued(task1));
+
+    // The second one supersedes the first one
+    scheduler.submit(task2, &receiver, SLOT(onDone()),
+        Scheduler::PriorityNormal, key);
+    g_assert(!scheduler.isQueued(task1));
+    g_assert(scheduler.isQueued(task2));
+    g_assert(task1->isCanceled());
+    g_assert(!task2->isCanceled());
+    g_assert_cmpint(scheduler.queuedCount(), == ,1);
+    g_assert(scheduler.setPriority(key, Scheduler::PriorityVisible));
+    g_assert(!scheduler.setPriority(QString("foo"), Scheduler::PriorityIdle));
+
+    gate.release();
+    receiver.wait();
+
+    // The superseded one has been completed without running
+    g_assert(receiver.iDone.contains(task1));
+    g_assert(!task1->isStarted());
+    g_assert(!task1->iPerformed);
+    g_assert(task2->iPerformed);
+    g_assert(!test_started.contains(task1));
+    g_assert(!scheduler.setPriority(key, Scheduler::PriorityIdle));
+    test_release(receiver.iDone);
+}
+
+/*==========================================================================*
+ * maxThreads
+ *==========================================================================*/
+
+static
+void
+test_maxThreads(
+    void)
+{
+    const int n = 20;
+    const int maxThreads = 3;
+    QThreadPool pool;
+    Scheduler scheduler(&pool);
+    QSemaphore gate;
+    TestReceiver receiver(n);
+    QList<HarbourTask*> tasks;
+
+    test_reset();
+    pool.setMaxThreadCount(maxThreads);
+    for (int i = 0; i < n; i++) {
+        HarbourTask* task = new TestTask(&pool, &gate);
+
+        scheduler.submit(task, &receiver, SLOT(onDone()));
+        tasks.append(task);
+    }
+    g_assert_cmpint(scheduler.runningCount(), == ,maxThreads);
+    g_assert_cmpint(scheduler.queuedCount(), == ,n - maxThreads);
+
+    gate.release(n);
+    receiver.wait();
+    g_assert_cmpint(test_started.count(), == ,n);
+    g_assert_cmpint(test_max_running.loadAcquire(), <= ,maxThreads);
+    g_assert_cmpint(scheduler.runningCount(), == ,0);
+    test_release(tasks);
+}
+
+/*==========================================================================*
+ * cancel
+ *==========================================================================*/
+
+static
+void
+test_cancel(
+    void)
+{
+    QThreadPool pool;
+    Scheduler* scheduler = new Scheduler(&pool);
+    QSemaphore gate;
+    TestReceiver receiver(2);
+    TestTask* busy = new TestTask(&pool, &gate);
+    TestTask* released = new TestTask(&pool);
+    TestTask* skipped = new TestTask(&pool);
+    QPointer<HarbourTask> releasedPtr(released);
+
+    test_reset();
+    pool.setMaxThreadCount(1);
+    scheduler->submit(busy, &receiver, SLOT(onDone()));
+    scheduler->submit(released, &receiver, SLOT(onDone()));
+    scheduler->submit(skipped, &receiver, SLOT(onDone()));
+    g_assert_cmpint(scheduler->queuedCount(), == ,2);
+
+    // Releasing a queued task takes it out of the queue
+    released->release();
+    g_assert_cmpint(scheduler->queuedCount(), == ,1);
+    g_assert(!scheduler->isQueued(released));
+
+    // Destroying the scheduler completes the queued ones
+    delete scheduler;
+    gate.release();
+    receiver.wait();
+
+    g_assert(!releasedPtr);
+    g_assert(receiver.iDone.contains(busy));
+    g_assert(receiver.iDone.contains(skipped));
+    g_assert(busy->iPerformed);
+    g_assert(!skipped->isStarted());
+    g_assert(skipped->isCanceled());
+    g_assert_cmpint(test_started.count(), == ,1);
+    test_release(receiver.iDone);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_(name) "/HarbourTaskScheduler/" name
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("priority"), test_priority);
+    g_test_add_func(TEST_("dedup"), test_dedup);
+    g_test_add_func(TEST_("maxThreads"), test_maxThreads);
+    g_test_add_func(TEST_("cancel"), test_cancel);
+    return g_test_run();
+}
+
+#include "TestHarbourTaskScheduler.moc"
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -1,6 +1,6 @@
 /*
+ * Copyright (C) 2022-2026 Slava Monich <slava@monich.com>
  * Copyright (C) 2022 Jolla Ltd.
- * Copyright (C) 2022 Slava Monich <slava.monich@jolla.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -91,6 +91,165 @@ test_toHex(
     g_assert_cmpstr(out.constData(), == ,hex.constData());
 }
 
+/*==========================================================================*
+ * toHexLong
+ *==========================================================================*/
+
+static
+void
+test_toHexLong(
+    void)
+{
+    static const char digits[] = "0123456789abcdef";
+    QByteArray data;
+    QByteArray hex;
+
+    // Long enough for the vector code, plus a tail
+    for (int i = 0; i < 300; i++) {
+        const uchar b = (uchar)(i * 37 + 11);
+
+        data.append((char)b);
+        hex.append(digits[b >> 4]);
+        hex.append(digits[b & 0x0f]);
+    }
+
+    for (int n = 0; n <= data.size(); n += 7) {
+        const QByteArray expected(hex.left(2 * n));
+
+        g_assert(HarbourUtil::toHexBytes(data.constData(), n) == expected);
+        g_assert(HarbourUtil::toHex(data.constData(), n) ==
+            QString::fromLatin1(expected));
+    }
+}
+
+/*==========================================================================*
+ * fromHex
+ *==========================================================================*/
+
+static
+void
+test_fromHex(
+    void)
+{
+    static const uchar data[] = {
+        0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+    };
+    const QByteArray bytes((const char*)data, sizeof(data));
+    int pos = 0;
+
+    g_assert(HarbourUtil::fromHex(QByteArray()).isEmpty());
+    g_assert(HarbourUtil::fromHex(QString()).isEmpty());
+    g_assert(HarbourUtil::fromHex(Q_NULLPTR, 0).isEmpty());
+    g_assert(HarbourUtil::fromHex(QByteArray("0123456789abcdef")) == bytes);
+    g_assert(HarbourUtil::fromHex(QByteArray("0123456789ABCDEF")) == bytes);
+    g_assert(HarbourUtil::fromHex(QString("0123456789AbCdEf")) == bytes);
+    g_assert(HarbourUtil::fromHex("0123456789abcdefxx", 16) == bytes);
+
+    // Invalid characters
+    g_assert(HarbourUtil::fromHex(QByteArray("0123g5"), &pos).isEmpty());
+    g_assert_cmpint(pos, == ,4);
+    g_assert(HarbourUtil::fromHex(QByteArray("012 45"), &pos).isEmpty());
+    g_assert_cmpint(pos, == ,3);
+    g_assert(HarbourUtil::fromHex(QByteArray("0x1234"), &pos).isEmpty());
+    g_assert_cmpint(pos, == ,1);
+    g_assert(HarbourUtil::fromHex(QByteArray("\\xff00"), &pos).isEmpty());
+    g_assert_cmpint(pos, == ,0);
+
+    // Characters which only look like hex digits in the lower 8 bits
+    QString str("0123");
+    str.append(QChar((ushort)0x0161));
+    str.append(QChar((ushort)0x0130));
+    g_assert(HarbourUtil::fromHex(str, &pos).isEmpty());
+    g_assert_cmpint(pos, == ,4);
+
+    // Odd length
+    g_assert(HarbourUtil::fromHex(QByteArray("123"), &pos).isEmpty());
+    g_assert_cmpint(pos, == ,2);
+    g_assert(HarbourUtil::fromHex(QByteArray("1"), &pos).isEmpty());
+    g_assert_cmpint(pos, == ,0);
+    g_assert(HarbourUtil::fromHex(QByteArray("12x"), &pos).isEmpty());
+    g_assert_cmpint(pos, == ,2);
+}
+
+/*==========================================================================*
+ * fromHexLong
+ *==========================================================================*/
+
+static
+void
+test_fromHexLong(
+    void)
+{
+    QByteArray data;
+
+    for (int i = 0; i < 200; i++) {
+        data.append((char)(i * 53 + 7));
+    }
+
+    const QByteArray lower(HarbourUtil::toHexBytes(data.constData(),
+        data.size()));
+    const QByteArray upper(lower.toUpper());
+    int pos = 0;
+
+    g_assert(HarbourUtil::fromHex(lower) == data);
+    g_assert(HarbourUtil::fromHex(upper) == data);
+    g_assert(HarbourUtil::fromHex(QString::fromLatin1(lower)) == data);
+    g_assert(HarbourUtil::fromHex(QString::fromLatin1(upper)) == data);
+
+    // Bad characters at every position, both 8 and 16 bit
+    for (int i = 0; i < lower.size(); i++) {
+        QByteArray bad(lower);
+        QString badStr(QString::fromLatin1(lower));
+
+        bad[i] = (i % 3) ? 'g' : (char)0xc0;
+        pos = -2;
+        g_assert(HarbourUtil::fromHex(bad, &pos).isEmpty());
+        g_assert_cmpint(pos, == ,i);
+
+        badStr[i] = QChar((ushort)((i % 2) ? 0x0141 : 0x0100));
+        pos = -2;
+        g_assert(HarbourUtil::fromHex(badStr, &pos).isEmpty());
+        g_assert_cmpint(pos, == ,i);
+    }
+}
+
+/*==========================================================================*
+ * decodeHex
+ *==========================================================================*/
+
+static
+void
+test_decodeHex(
+    void)
+{
+    const QString hex("00ff7F80");
+    const QByteArray hex8(hex.toLatin1());
+    uchar buf[4];
+    int pos = 0;
+
+    memset(buf, 0, sizeof(buf));
+    g_assert_cmpint(HarbourUtil::decodeHex(hex, buf, sizeof(buf)), == ,4);
+    g_assert_cmphex(buf[0], == ,0x00);
+    g_assert_cmphex(buf[1], == ,0xff);
+    g_assert_cmphex(buf[2], == ,0x7f);
+    g_assert_cmphex(buf[3], == ,0x80);
+
+    memset(buf, 0, sizeof(buf));
+    g_assert_cmpint(HarbourUtil::decodeHex(hex8, buf, sizeof(buf)), == ,4);
+    g_assert_cmphex(buf[1], == ,0xff);
+    g_assert_cmpint(HarbourUtil::decodeHex(hex.constData(), 4, buf, 2), == ,2);
+    g_assert_cmpint(HarbourUtil::decodeHex(hex8.constData(), 0, buf, 0), == ,0);
+
+    // Buffer too small
+    g_assert_cmpint(HarbourUtil::decodeHex(hex, buf, 3, &pos), == ,-1);
+    g_assert_cmpint(pos, == ,-1);
+
+    // Invalid input
+    g_assert_cmpint(HarbourUtil::decodeHex(QString("00f-"), buf,
+        sizeof(buf), &pos), == ,-1);
+    g_assert_cmpint(pos, == ,3);
+}
+
 /*==========================================================================*
  * Common
  *==========================================================================*/
@@ -103,6 +262,10 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("object"), test_object);
     g_test_add_func(TEST_("invertColor"), test_invertColor);
     g_test_add_func(TEST_("toHex"), test_toHex);
+    g_test_add_func(TEST_("toHexLong"), test_toHexLong);
+    g_test_add_func(TEST_("fromHex"), test_fromHex);
+    g_test_add_func(TEST_("fromHexLong"), test_fromHexLong);
+    g_test_add_func(TEST_("decodeHex"), test_decodeHex);
     return g_test_run();
 }
 